@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+
+##########################################################################
+# basf2 (Belle II Analysis Software Framework)                           #
+# Author: The Belle II Collaboration                                     #
+#                                                                        #
+# See git log for contributors and copyright holders.                    #
+# This file is licensed under LGPL-3.0, see LICENSE.md.                  #
+##########################################################################
+
+# --------------------------------------------------------------------
+# Validation of the tabulated acceptance map of the ARICH reconstruction
+# (parameter useAcceptanceMap of ARICHReconstructor).
+# Pion and kaon tracks are simulated and reconstructed once, afterwards
+# ARICHReconstructor is run on the same events with and without the map.
+# The map only replaces the acceptance computation for photons in bins which
+# are not crossed by a border of the active area, so the likelihoods of both
+# runs have to be identical. They are compared track by track and the
+# reconstruction time per track is printed. Histograms of the kaon-pion
+# log likelihood difference are stored in the output file.
+# --------------------------------------------------------------------
+
+import math
+from optparse import OptionParser
+
+import basf2 as b2
+from simulation import add_simulation
+from tracking import add_tracking_reconstruction
+from ROOT import Belle2, TFile, TH1F
+
+parser = OptionParser()
+parser.add_option('-n', '--nevents', dest='nevents', default=1000,
+                  help='Number of events to process')
+parser.add_option('-f', '--file', dest='filename',
+                  default='ARICHAcceptanceMapValidation.root')
+(options, args) = parser.parse_args()
+
+b2.set_log_level(b2.LogLevel.ERROR)
+b2.set_random_seed('arich')
+
+eventsFile = 'ARICHAcceptanceMapValidationEvents.root'
+
+
+class CollectLikelihoods(b2.Module):
+    """Collect the pion and kaon log likelihoods and expected pion photons of all ARICHLikelihoods"""
+
+    def __init__(self):
+        """Constructor"""
+        super().__init__()
+        #: list of (logL pion, logL kaon, expected photons pion) per track
+        self.likelihoods = []
+
+    def event(self):
+        """Store the values of all likelihoods of the event"""
+        for likelihood in Belle2.PyStoreArray('ARICHLikelihoods'):
+            self.likelihoods.append((likelihood.getLogL(Belle2.Const.pion),
+                                     likelihood.getLogL(Belle2.Const.kaon),
+                                     likelihood.getExpPhot(Belle2.Const.pion)))
+
+
+def simulate():
+    """Simulate and reconstruct the tracks up to the ARICH hits"""
+    main = b2.create_path()
+    main.add_module('EventInfoSetter', evtNumList=[int(options.nevents)], runList=[1])
+    main.add_module('ParticleGun', pdgCodes=[211, -211, 321, -321], nTracks=1,
+                    momentumGeneration='uniform', momentumParams=[0.5, 4],
+                    thetaGeneration='uniformCos', thetaParams=[17, 35],
+                    phiGeneration='uniform', phiParams=[0, 360])
+    add_simulation(main, usePXDDataReduction=False)
+    add_tracking_reconstruction(main)
+    main.add_module('Ext')
+    main.add_module('ARICHFillHits')
+    main.add_module('RootOutput', outputFileName=eventsFile)
+    b2.process(main)
+
+
+def reconstruct(useAcceptanceMap):
+    """Run the ARICH reconstruction and return the likelihoods and the time per track in ms"""
+    main = b2.create_path()
+    main.add_module('RootInput', inputFileName=eventsFile)
+    main.add_module('Gearbox')
+    main.add_module('Geometry')
+    arichreco = main.add_module('ARICHReconstructor', useAcceptanceMap=useAcceptanceMap)
+    collector = CollectLikelihoods()
+    main.add_module(collector)
+    b2.process(main, calculateStatistics=True)
+
+    nTracks = max(len(collector.likelihoods), 1)
+    time = b2.statistics.get(arichreco).time_sum(b2.statistics.EVENT) * 1e-6 / nTracks
+    return collector.likelihoods, time
+
+
+simulate()
+reference, referenceTime = reconstruct(False)
+tabulated, tabulatedTime = reconstruct(True)
+
+if len(reference) != len(tabulated):
+    b2.B2FATAL('Different number of ARICHLikelihoods with and without the acceptance map')
+
+output = TFile(options.filename, 'recreate')
+hReference = TH1F('dLogL_reference', 'logL(K) - logL(#pi) per track;#Delta log L;tracks', 200, -100, 100)
+hTabulated = TH1F('dLogL_map', 'logL(K) - logL(#pi) per track with acceptance map;#Delta log L;tracks', 200, -100, 100)
+hDifference = TH1F('dLogL_difference', 'Change of logL(K) - logL(#pi) with acceptance map;change;tracks', 200, -1, 1)
+hExpPhot = TH1F('expPhot_ratio', 'Expected pion photons with / without acceptance map;ratio;tracks', 200, 0.9, 1.1)
+
+nChanged = 0
+nDifferent = 0
+sumSquares = 0.
+for (piRef, kRef, expRef), (piMap, kMap, expMap) in zip(reference, tabulated):
+    if (piRef, kRef, expRef) != (piMap, kMap, expMap):
+        nDifferent += 1
+    dRef = kRef - piRef
+    dMap = kMap - piMap
+    hReference.Fill(dRef)
+    hTabulated.Fill(dMap)
+    hDifference.Fill(dMap - dRef)
+    sumSquares += (dMap - dRef) ** 2
+    if expRef > 0:
+        hExpPhot.Fill(expMap / expRef)
+    if (dRef > 0) != (dMap > 0):
+        nChanged += 1
+
+nTracks = max(len(reference), 1)
+print(f'tracks with ARICHLikelihood:                 {len(reference)}')
+print(f'time per track without / with map [ms]:     {referenceTime:.3f} / {tabulatedTime:.3f}')
+print(f'RMS change of logL(K) - logL(pi):            {math.sqrt(sumSquares / nTracks):.4f}')
+print(f'tracks with changed K/pi preference:         {nChanged} ({100. * nChanged / nTracks:.2f}%)')
+print(f'mean ratio of expected pion photons:         {hExpPhot.GetMean():.5f} (RMS {hExpPhot.GetRMS():.5f})')
+print(f'tracks with different likelihoods:           {nDifferent}')
+
+output.Write()
+output.Close()
+
+if nDifferent > 0:
+    b2.B2ERROR('The acceptance map changes the likelihoods')
@@ -22,6 +22,9 @@
 
 #include <Math/Vector3D.h>
 
+#include <cstdint>
+#include <vector>
+
 namespace Belle2 {
 
   /**
@@ -38,7 +41,11 @@ namespace Belle2 {
    * the active area of the detection inside a HAPD
    * and the intersection point with the active area is determined.
    * Whether the photon was detected or not is determined by numerical
-   * simulation of the module's geometric acceptance.
+   * simulation of the module's geometric acceptance. The acceptance is looked
+   * up in a map of the active area on the detector plane, which is tabulated
+   * once per run. Only for bins of the map which are crossed by a border of
+   * the active area it is computed for the photon itself, so that the map
+   * does not change the result.
    */
   class ARICHReconstruction {
 
@@ -93,6 +100,14 @@ namespace Belle2 {
       m_alignMirrors = align;
     };
 
+    /**
+     * Use the tabulated acceptance map of the detector plane or not.
+     */
+    void useAcceptanceMap(bool use)
+    {
+      m_useAcceptanceMap = use;
+    };
+
     /**
      * Correct mean emission point z position.
      */
@@ -129,6 +144,47 @@ namespace Belle2 {
     int m_storePhot; /**< set to 1 to store individual reconstructed photon information */
     double m_tilePars[124][2] = {{0}}; /**< array of tile parameters */
 
+    /**
+     * Acceptance of a bin of the acceptance map.
+     */
+    enum EAcceptance {
+      c_Inactive = 0, /**< no point of the bin is on an active channel */
+      c_Active = 1,   /**< all points of the bin are on active channels */
+      c_Mixed = 2     /**< the bin is crossed by a border of a module, chip or masked channel */
+    };
+
+    static constexpr double c_acceptanceMapBinSize = 0.1; /**< bin size of the acceptance map in cm */
+    bool m_useAcceptanceMap = true; /**< if set to true the acceptance is taken from the tabulated map */
+    double m_acceptanceMapRange = 0; /**< the map covers x and y from -range to range */
+    unsigned m_acceptanceMapNBins = 0; /**< number of bins of the map in x and y */
+    std::vector<uint64_t> m_acceptanceMap; /**< two bits per bin with its EAcceptance */
+
+    /**
+     * Tabulates the active area of the detector plane (photo-sensitive and
+     * not masked channels) in the acceptance map.
+     */
+    void buildAcceptanceMap();
+
+    /**
+     * Determines the acceptance of the area between the given corners, which
+     * is the same as the one of every point inside (see buildAcceptanceMap).
+     */
+    EAcceptance getAreaAcceptance(const double (&x)[4], const double (&y)[4]);
+
+    /**
+     * Returns the acceptance of the bin of the acceptance map which contains
+     * the point on the detector plane.
+     */
+    EAcceptance getMapAcceptance(double x, double y) const
+    {
+      const double fx = (x + m_acceptanceMapRange) / c_acceptanceMapBinSize;
+      const double fy = (y + m_acceptanceMapRange) / c_acceptanceMapBinSize;
+      // outside of the map pointSlotID finds no module
+      if (!(fx >= 0 && fy >= 0 && fx < m_acceptanceMapNBins && fy < m_acceptanceMapNBins)) return c_Inactive;
+      const uint64_t bin = uint64_t(fy) * m_acceptanceMapNBins + uint64_t(fx);
+      return EAcceptance((m_acceptanceMap[bin / 32] >> (2 * (bin % 32))) & 3);
+    }
+
     /**
      * Returns 1 if vector "a" lies on "copyno"-th detector active surface
      * of detector and 0 else.
@@ -119,6 +119,9 @@ namespace Belle2 {
     /** Whether alignment constants for mirrors are used. */
     bool m_alignMirrors;
 
+    /** Whether the acceptance is taken from the tabulated map of the detector plane. */
+    bool m_useAcceptanceMap;
+
   };
 
 } // Belle2 namespace
@@ -21,6 +21,7 @@
 #include <framework/gearbox/Const.h>
 #include <framework/geometry/VectorUtil.h>
 
+#include <algorithm>
 #include <cmath>
 #include <vector>
 #include <Math/Vector3D.h>
@@ -100,6 +101,120 @@ namespace Belle2 {
         }
       }
     }
+
+    // evaluate all hasChanged, as each call resets the flag
+    bool acceptanceChanged = m_arichgp.hasChanged();
+    acceptanceChanged |= m_chnMask.hasChanged();
+    acceptanceChanged |= m_chnMap.hasChanged();
+    if (m_useAcceptanceMap && (acceptanceChanged || m_acceptanceMap.empty())) buildAcceptanceMap();
+  }
+
+
+  void ARICHReconstruction::buildAcceptanceMap()
+  {
+    const ARICHGeoDetectorPlane& detectorPlane = m_arichgp->getDetectorPlane();
+    const unsigned nRings = detectorPlane.getNRings();
+    const double apdSize = m_arichgp->getHAPDGeometry().getAPDSizeX();
+
+    // the map covers the outermost module ring, which is where pointSlotID stops finding slots
+    m_acceptanceMapRange = detectorPlane.getRingR(nRings) + apdSize;
+    if (nRings > 1) m_acceptanceMapRange += (detectorPlane.getRingR(nRings) - detectorPlane.getRingR(nRings - 1)) / 2.;
+    m_acceptanceMapNBins = unsigned(2 * m_acceptanceMapRange / c_acceptanceMapBinSize) + 1;
+    const uint64_t nBins = uint64_t(m_acceptanceMapNBins) * m_acceptanceMapNBins;
+    m_acceptanceMap.assign((nBins + 31) / 32, 0);
+
+    // The corners of each bin are moved outwards by this margin. The borders of the active area are
+    // straight lines (modules, chips, channels, azimuthal borders of the module slots) and circles with
+    // radii of tens of cm (radial borders of the slots). If the four corners are on the same side of such
+    // a border, the whole bin is, as the circles deviate from a straight line by much less than the margin
+    // over a bin. Like this the acceptance of a bin which is not c_Mixed is the one of each of its points.
+    const double margin = 0.001;
+
+    // only the bins around the photo-sensitive area of each module can be active
+    const double halfDiagonal = apdSize / std::sqrt(2.);
+    const int lastBin = int(m_acceptanceMapNBins) - 1;
+    unsigned nActive = 0, nMixed = 0;
+    for (unsigned slot = 1; slot <= detectorPlane.getNSlots(); slot++) {
+      const double slotX = detectorPlane.getSlotR(slot) * std::cos(detectorPlane.getSlotPhi(slot));
+      const double slotY = detectorPlane.getSlotR(slot) * std::sin(detectorPlane.getSlotPhi(slot));
+      const int ixMin = std::max(0, int((slotX - halfDiagonal + m_acceptanceMapRange) / c_acceptanceMapBinSize));
+      const int ixMax = std::min(lastBin, int((slotX + halfDiagonal + m_acceptanceMapRange) / c_acceptanceMapBinSize));
+      const int iyMin = std::max(0, int((slotY - halfDiagonal + m_acceptanceMapRange) / c_acceptanceMapBinSize));
+      const int iyMax = std::min(lastBin, int((slotY + halfDiagonal + m_acceptanceMapRange) / c_acceptanceMapBinSize));
+      for (int iy = iyMin; iy <= iyMax; iy++) {
+        const double yLow = iy * c_acceptanceMapBinSize - m_acceptanceMapRange - margin;
+        const double yHigh = (iy + 1) * c_acceptanceMapBinSize - m_acceptanceMapRange + margin;
+        for (int ix = ixMin; ix <= ixMax; ix++) {
+          const uint64_t bin = uint64_t(iy) * m_acceptanceMapNBins + ix;
+          uint64_t& word = m_acceptanceMap[bin / 32];
+          const unsigned shift = 2 * (bin % 32);
+          // already filled for a neighbouring slot
+          if ((word >> shift) & 3) continue;
+          const double xLow = ix * c_acceptanceMapBinSize - m_acceptanceMapRange - margin;
+          const double xHigh = (ix + 1) * c_acceptanceMapBinSize - m_acceptanceMapRange + margin;
+          const EAcceptance acceptance = getAreaAcceptance({xLow, xHigh, xHigh, xLow}, {yLow, yLow, yHigh, yHigh});
+          word |= uint64_t(acceptance) << shift;
+          if (acceptance == c_Active) nActive++;
+          if (acceptance == c_Mixed) nMixed++;
+        }
+      }
+    }
+    B2DEBUG(20, "ARICHReconstruction: acceptance map with " << m_acceptanceMapNBins << "^2 bins, "
+            << nActive << " of them active and " << nMixed << " mixed");
+  }
+
+
+  ARICHReconstruction::EAcceptance ARICHReconstruction::getAreaAcceptance(const double (&x)[4], const double (&y)[4])
+  {
+    const ARICHGeoDetectorPlane& detectorPlane = m_arichgp->getDetectorPlane();
+    const ARICHGeoHAPD& hapd = m_arichgp->getHAPDGeometry();
+
+    // the module slot, as in likelihood2
+    const unsigned slot = detectorPlane.pointSlotID(x[0], y[0]);
+    for (int i = 1; i < 4; i++) {
+      if (detectorPlane.pointSlotID(x[i], y[i]) != slot) return c_Mixed;
+    }
+    if (slot == 0) return c_Inactive;
+
+    // bounding box of the corners in the frame of the module, as in InsideDetector
+    const double phi = detectorPlane.getSlotPhi(slot);
+    const double originX = detectorPlane.getSlotR(slot) * std::cos(phi);
+    const double originY = detectorPlane.getSlotR(slot) * std::sin(phi);
+    double uMin = INFINITY, uMax = -INFINITY, vMin = INFINITY, vMax = -INFINITY;
+    for (int i = 0; i < 4; i++) {
+      const double u = (x[i] - originX) * std::cos(phi) + (y[i] - originY) * std::sin(phi);
+      const double v = -(x[i] - originX) * std::sin(phi) + (y[i] - originY) * std::cos(phi);
+      uMin = std::min(uMin, u);
+      uMax = std::max(uMax, u);
+      vMin = std::min(vMin, v);
+      vMax = std::max(vMax, v);
+    }
+
+    // photo-sensitive area of the module
+    const double halfSize = hapd.getAPDSizeX() / 2.;
+    if (uMax <= -halfSize || uMin >= halfSize || vMax <= -halfSize || vMin >= halfSize) return c_Inactive;
+    if (uMin <= -halfSize || uMax >= halfSize || vMin <= -halfSize || vMax >= halfSize) return c_Mixed;
+
+    // gaps between the chips
+    const double halfGap = hapd.getChipGap() / 2.;
+    if ((uMin >= -halfGap && uMax <= halfGap) || (vMin >= -halfGap && vMax <= halfGap)) return c_Inactive;
+    if ((uMin <= halfGap && uMax >= -halfGap) || (vMin <= halfGap && vMax >= -halfGap)) return c_Mixed;
+
+    // channels, the channel numbers increase with the coordinates on both sides of the gaps
+    int chXMin, chYMin, chXMax, chYMax;
+    hapd.getXYChannel(uMin, vMin, chXMin, chYMin);
+    hapd.getXYChannel(uMax, vMax, chXMax, chYMax);
+    if (chXMin < 0 || chXMax < 0) return c_Mixed;
+    bool anyActive = false, anyInactive = false;
+    for (int chX = chXMin; chX <= chXMax; chX++) {
+      for (int chY = chYMin; chY <= chYMax; chY++) {
+        const int asicChannel = m_chnMap->getAsicFromXY(chX, chY);
+        if (asicChannel >= 0 && m_chnMask->isActive(slot, asicChannel)) anyActive = true;
+        else anyInactive = true;
+      }
+    }
+    if (anyActive && anyInactive) return c_Mixed;
+    return anyActive ? c_Active : c_Inactive;
   }
 
 
@@ -392,6 +507,9 @@ namespace Belle2 {
     float nphot_scaling = 20.; // number of photons to be traced is (expected number of emitted photons * nphot_scaling)
     int nStep = 5;             // number of steps in one aerogel layer
 
+    // transformation from track to global system, the same for all photons
+    const ROOT::Math::Rotation3D trackToGlobal = TransformFromFixed(edir);
+
     // loop over all particle hypotheses
     for (int iHyp = 0; iHyp < c_noOfHypotheses; iHyp++) {
 
@@ -426,13 +544,18 @@ namespace Belle2 {
           for (unsigned int iPhoton = 0; iPhoton < genPhot; iPhoton++) {
             double fi = 2 * M_PI * iPhoton / float(genPhot); // uniformly distributed in phi
             ROOT::Math::XYZVector adirf = setThetaPhi(thetaCh[iHyp][iAerogel], fi); // photon direction in track system
-            adirf =  TransformFromFixed(edir) * adirf;  // photon direction in global system
+            adirf = trackToGlobal * adirf;  // photon direction in global system
             int ifi = int (fi * 20 / 2. / M_PI); // phi bin
             // track photon from emission point to the detector plane
             ROOT::Math::XYZVector dposition = FastTracking(adirf, epoint, &m_refractiveInd[iAerogel], &m_zaero[iAerogel],
                                                            m_nAerogelLayers - iAerogel, 1);
             if (dposition.R() > 1.0) {nSig_wo_acc[iHyp][iAerogel][ifi] += 1; nSig_wo_accInt[iHyp][iAerogel] += 1;}
             else continue;
+            if (m_useAcceptanceMap) {
+              const EAcceptance acceptance = getMapAcceptance(dposition.X(), dposition.Y());
+              if (acceptance == c_Active) nSig_w_acc[iHyp][iAerogel] += 1;
+              if (acceptance != c_Mixed) continue;
+            }
             unsigned  copyno =  m_arichgp->getDetectorPlane().pointSlotID(dposition.X(), dposition.Y());
             if (!copyno) continue;
             // check if photon fell on photosensitive area
@@ -532,6 +655,7 @@ namespace Belle2 {
                               m_nAerogelLayers - iAerogel, mirrors[mirr]) < 0) break;
 
           ROOT::Math::XYZVector dirch = TransformToFixed(edirr) * photonDirection;
+          const ROOT::Math::Rotation3D trackToGlobalHit = TransformFromFixed(edirr);
           double fi_cer = dirch.Phi();
           double th_cer = dirch.Theta();
 
@@ -565,7 +689,7 @@ namespace Belle2 {
 
             // track a photon from the mean emission point to the detector surface
             ROOT::Math::XYZVector photonDirection1 = setThetaPhi(thetaCh[iHyp][iAerogel], fi_cer);  // particle system
-            photonDirection1 = TransformFromFixed(edirr) * photonDirection1;  // global system
+            photonDirection1 = trackToGlobalHit * photonDirection1;  // global system
             int ifi = int (fi_cer * 20 / 2. / M_PI);
             ROOT::Math::XYZVector detector_position;
 
@@ -60,6 +60,10 @@ namespace Belle2 {
     addParam("storePhotons", m_storePhot, "Set to 1 to store reconstructed photon information (Ch. angle,...)", 0);
     addParam("useAlignment", m_align, "Use ARICH global position alignment constants", true);
     addParam("useMirrorAlignment", m_alignMirrors, "Use ARICH mirror alignment constants", true);
+    addParam("useAcceptanceMap", m_useAcceptanceMap,
+             "Take the geometrical acceptance of the expected photons from a map of the active detector area tabulated per run "
+             "(1 mm bins) instead of computing it for every traced photon. Photons in bins crossed by a border of the active "
+             "area are still computed one by one, so the result is the same.", true);
   }
 
   ARICHReconstructorModule::~ARICHReconstructorModule()
@@ -75,6 +79,7 @@ namespace Belle2 {
     m_ana->setTrackPositionResolution(m_trackPositionResolution);
     m_ana->setTrackAngleResolution(m_trackAngleResolution);
     m_ana->useMirrorAlignment(m_alignMirrors);
+    m_ana->useAcceptanceMap(m_useAcceptanceMap);
 
     // Input: ARICHDigits
     m_ARICHHits.isRequired();
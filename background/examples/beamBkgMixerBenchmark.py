@@ -0,0 +1,74 @@
+#!/usr/bin/env python3
+
+##########################################################################
+# basf2 (Belle II Analysis Software Framework)                           #
+# Author: The Belle II Collaboration                                     #
+#                                                                        #
+# See git log for contributors and copyright holders.                    #
+# This file is licensed under LGPL-3.0, see LICENSE.md.                  #
+##########################################################################
+
+"""Measures the time per event of BeamBkgMixer for nominal and 2x nominal
+   background levels, reading the samples event by event and from memory
+   (parameter preload). The numbers of mixed SimHits must not depend on
+   the preloading, this is checked as well.
+
+   Usage: basf2 beamBkgMixerBenchmark.py [number of events]
+   The environment variable BELLE2_BACKGROUND_MIXING_DIR must point to
+   the directory with the BG mixing samples.
+"""
+
+import basf2 as b2
+import os
+import sys
+import glob
+from ROOT import Belle2
+
+if 'BELLE2_BACKGROUND_MIXING_DIR' not in os.environ:
+    b2.B2FATAL('BELLE2_BACKGROUND_MIXING_DIR variable is not set - it must contain the path to BG mixing samples')
+
+bg = glob.glob(os.environ['BELLE2_BACKGROUND_MIXING_DIR'] + '/*.root')
+if len(bg) == 0:
+    b2.B2FATAL('No files found in ', os.environ['BELLE2_BACKGROUND_MIXING_DIR'])
+
+numEvents = int(sys.argv[1]) if len(sys.argv) > 1 else 100
+
+#: names of the mixed collections
+collections = ['PXDSimHits', 'SVDSimHits', 'CDCSimHits', 'TOPSimHits', 'ARICHSimHits', 'ECLHits', 'KLMSimHits']
+
+
+class CountSimHits(b2.Module):
+    """Collect the numbers of mixed SimHits per event"""
+
+    def __init__(self):
+        """Constructor"""
+        super().__init__()
+        #: list of the numbers of SimHits per collection for each event
+        self.counts = []
+
+    def event(self):
+        """Store the numbers of SimHits of the event"""
+        self.counts.append([Belle2.PyStoreArray(name).getEntries() for name in collections])
+
+
+def runMixer(scaleFactor, preload):
+    """Run BeamBkgMixer and return the numbers of SimHits and the time per event in ms"""
+    main = b2.create_path()
+    main.add_module('EventInfoSetter', evtNumList=[numEvents])
+    mixer = main.add_module('BeamBkgMixer', backgroundFiles=bg, overallScaleFactor=scaleFactor, preload=preload)
+    counter = CountSimHits()
+    main.add_module(counter)
+    b2.set_random_seed('beamBkgMixerBenchmark')
+    b2.process(main, calculateStatistics=True)
+    return counter.counts, b2.statistics.get(mixer).time_mean(b2.statistics.EVENT) * 1e-6
+
+
+b2.set_log_level(b2.LogLevel.ERROR)
+for scaleFactor in [1.0, 2.0]:
+    counts, time = runMixer(scaleFactor, False)
+    preloadedCounts, preloadedTime = runMixer(scaleFactor, True)
+    if counts != preloadedCounts:
+        b2.B2FATAL('Different numbers of SimHits with and without preloading')
+    numHits = sum(sum(event) for event in counts) / max(len(counts), 1)
+    print(f'background level {scaleFactor:.0f}x nominal: {numHits:.0f} SimHits per event')
+    print(f'  time per event from files / preloaded [ms]: {time:.3f} / {preloadedTime:.3f}')
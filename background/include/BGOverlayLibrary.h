@@ -0,0 +1,96 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#pragma once
+
+/* Basf2 headers. */
+#include <framework/datastore/DataStore.h>
+
+/* C++ headers. */
+#include <cstddef>
+#include <vector>
+
+namespace Belle2 {
+
+  /**
+   * In-memory library of BG overlay events with random access by event index.
+   *
+   * Each object of each event (i.e. the collection of a detector) is streamed and compressed
+   * separately into one contiguous buffer, so that an event is restored by uncompressing only
+   * its own blocks. If the library is filled before the fork of multiprocessing, the workers
+   * share its memory pages.
+   */
+  class BGOverlayLibrary {
+
+  public:
+
+    /**
+     * Constructor
+     * @param compressionLevel compression algorithm * 100 + level as for ROOT files, 0 means no compression
+     */
+    explicit BGOverlayLibrary(int compressionLevel);
+
+    /**
+     * Appends an event
+     * @param entries store entries holding the objects of the event, a null object is stored as such
+     */
+    void appendEvent(const std::vector<DataStore::StoreEntry*>& entries);
+
+    /**
+     * Restores an event into the objects of the store entries, which must have been reset with
+     * StoreEntry::resetForGetEntry(); the object of an entry stored as null is deleted and set to nullptr,
+     * as TTree::GetEntry() does.
+     * @param index event index
+     * @param entries store entries in the same order as in appendEvent()
+     */
+    void readEvent(unsigned index, const std::vector<DataStore::StoreEntry*>& entries) const;
+
+    /**
+     * Removes all events
+     */
+    void clear();
+
+    /**
+     * Returns number of events
+     * @return number of events
+     */
+    unsigned getNumEvents() const {return m_numEntries > 0 ? m_blocks.size() / m_numEntries : 0;}
+
+    /**
+     * Returns size of the library
+     * @return size of the stored blocks [bytes]
+     */
+    size_t getSize() const {return m_data.size();}
+
+    /**
+     * Returns size of the streamed objects before compression
+     * @return uncompressed size [bytes]
+     */
+    size_t getUncompressedSize() const {return m_uncompressedSize;}
+
+  private:
+
+    /**
+     * Stored object
+     */
+    struct Block {
+      size_t offset = 0; /**< position in m_data */
+      int size = 0; /**< stored size in bytes, 0 for a null object */
+      int rawSize = 0; /**< size of the streamed object, equal to size if not compressed */
+    };
+
+    int m_compressionLevel = 0; /**< compression algorithm * 100 + level */
+    size_t m_numEntries = 0; /**< number of objects per event */
+    std::vector<Block> m_blocks; /**< stored objects, index = event * m_numEntries + entry */
+    std::vector<char> m_data; /**< contiguous storage of all blocks */
+    size_t m_uncompressedSize = 0; /**< total size of the streamed objects */
+    mutable std::vector<char> m_buffer; /**< uncompression buffer */
+
+  };
+
+} // Belle2 namespace
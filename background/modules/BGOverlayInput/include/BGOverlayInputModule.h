@@ -13,6 +13,7 @@
 #include <framework/datastore/DataStore.h>
 #include <framework/datastore/StoreObjPtr.h>
 #include <framework/dataobjects/EventMetaData.h>
+#include <background/BGOverlayLibrary.h>
 
 /* ROOT headers. */
 #include <TChain.h>
@@ -21,6 +22,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <memory>
 
 namespace Belle2 {
 
@@ -75,11 +77,20 @@ namespace Belle2 {
      */
     void connectBranches();
 
+    /**
+     * Read all events of the sample into the in-memory library
+     */
+    void preloadSample();
+
     std::vector<std::string> m_inputFileNames; /**< list of file names */
     std::string m_extensionName; /**< name added to default branch names */
     std::string m_BackgroundInfoInstanceName = ""; /**< name of BackgroundInfo branch */
     bool m_skipExperimentCheck = false; /**< flag for skipping the check on the experiment number */
     bool m_ignoreRunNumbers = false; /**< flag for ignoring the run numbers in run-dependent MC */
+    std::string m_sampling; /**< sampling of overlay events: sequential or random */
+    bool m_preload = false; /**< read the sample into memory */
+    int m_preloadCompressionLevel = 404; /**< compression of the in-memory library */
+    bool m_randomSampling = false; /**< true for random sampling */
 
     TChain* m_tree = 0;            /**< tree pointer */
     unsigned m_numEvents = 0;      /**< number of events (tree entries) in the sample */
@@ -94,6 +105,7 @@ namespace Belle2 {
     StoreObjPtr<EventMetaData> m_eventMetaData; /**< event meta data */
     std::map<int, std::vector<std::string>> m_runFileNamesMap; /**< Map between runs and file names */
     bool m_runByRun = false; /**< internal flag for steering between run-independent (false) and run-dependent (true) overlay */
+    std::unique_ptr<BGOverlayLibrary> m_library; /**< in-memory library of the sample if preloaded */
   };
 
 } // Belle2 namespace
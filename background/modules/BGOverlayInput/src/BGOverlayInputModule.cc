@@ -10,6 +10,7 @@
 #include <background/modules/BGOverlayInput/BGOverlayInputModule.h>
 
 /* Basf2 headers. */
+#include <framework/core/Environment.h>
 #include <framework/dataobjects/BackgroundInfo.h>
 #include <framework/dataobjects/BackgroundMetaData.h>
 #include <framework/dataobjects/FileMetaData.h>
@@ -60,6 +61,20 @@ BGOverlayInputModule::BGOverlayInputModule() : Module()
   addParam("ignoreRunNumbers", m_ignoreRunNumbers,
            "If True, ignore run numbers in case of run-dependend MC (experiments 1 to 999).",
            false);
+  addParam("sampling", m_sampling,
+           "Sampling of the overlay events: 'sequential' (starting at a random event) or 'random' "
+           "(each event drawn independently; reproducible and independent of the number of processes "
+           "with event dependent random seeds).",
+           string("sequential"));
+  addParam("preload", m_preload,
+           "If True, read the whole overlay sample into memory, each collection of each event compressed separately. "
+           "The run-independent sample is read in initialize(), so that the memory is shared between the parallel "
+           "processes. For run-dependent overlay the sample is read in each process, so preloading is then only done "
+           "without multiprocessing.",
+           false);
+  addParam("preloadCompressionLevel", m_preloadCompressionLevel,
+           "Compression of the preloaded sample: algorithm * 100 + level as for ROOT files, 0 for no compression.",
+           m_preloadCompressionLevel);
 }
 
 void BGOverlayInputModule::initialize()
@@ -75,6 +90,12 @@ void BGOverlayInputModule::initialize()
     files not suitabile for the experiment number you selected.)RAW");
   }
 
+  if (m_sampling == "random") {
+    m_randomSampling = true;
+  } else if (m_sampling != "sequential") {
+    B2FATAL("Unknown sampling of BG overlay events, must be 'sequential' or 'random'" << LogVar("sampling", m_sampling));
+  }
+
   // expand possible wildcards
   m_inputFileNames = RootIOUtilities::expandWordExpansions(m_inputFileNames);
   if (m_inputFileNames.empty()) {
@@ -139,7 +160,15 @@ void BGOverlayInputModule::initialize()
 
   // set flag for steering between run-independent (false) and run-dependent (true) overlay
   m_runByRun = experiment > 0 and experiment < 1000 and not m_runFileNamesMap.empty();
-  if (m_runByRun) return;
+  if (m_runByRun) {
+    // run-dependent samples are read in beginRun(), i.e. after the fork, so every process would hold its own copy
+    if (m_preload and Environment::Instance().getNumberProcesses() > 0) {
+      B2WARNING("BGOverlayInput: preloading is switched off for run-dependent overlay with multiprocessing, "
+                "since each process would hold its own copy of the sample.");
+      m_preload = false;
+    }
+    return;
+  }
 
   // run-independent overlay: choose randomly the first event and connect branches
   m_firstEvent = gRandom->Integer(m_numEvents);
@@ -147,6 +176,7 @@ void BGOverlayInputModule::initialize()
   m_eventCount = m_firstEvent;
   m_start = true;
   connectBranches();
+  if (m_preload) preloadSample();
 
   // add description to BackgroundInfo
   BackgroundInfo::BackgroundDescr descr;
@@ -182,6 +212,7 @@ void BGOverlayInputModule::beginRun()
   m_eventCount = m_firstEvent;
   m_start = true;
   connectBranches();
+  if (m_preload) preloadSample();
 
   // add description for this run to BackgroundInfo
   BackgroundInfo::BackgroundDescr descr;
@@ -209,7 +240,13 @@ void BGOverlayInputModule::event()
   }
   m_start = false;
 
-  m_tree->GetEntry(m_eventCount);
+  // random sampling: reuse is still counted per m_numEvents events
+  unsigned index = m_randomSampling ? gRandom->Integer(m_numEvents) : m_eventCount;
+  if (m_library) {
+    m_library->readEvent(index, m_storeEntries);
+  } else {
+    m_tree->GetEntry(index);
+  }
   m_eventCount++;
   if (m_eventCount >= m_numEvents) {
     m_eventCount = 0;
@@ -314,6 +351,26 @@ bool BGOverlayInputModule::registerBranches()
 }
 
 
+void BGOverlayInputModule::preloadSample()
+{
+  m_library = std::make_unique<BGOverlayLibrary>(m_preloadCompressionLevel);
+  for (unsigned i = 0; i < m_numEvents; i++) {
+    for (auto entry : m_storeEntries) {
+      entry->resetForGetEntry();
+    }
+    m_tree->GetEntry(i);
+    m_library->appendEvent(m_storeEntries);
+    // the next resetForGetEntry() needs objects, as in event()
+    for (auto entry : m_storeEntries) {
+      entry->recoverFromNullObject();
+    }
+  }
+  B2INFO("BGOverlayInput: " << m_numEvents << " events preloaded"
+         << LogVar("size [MB]", m_library->getSize() / 1e6)
+         << LogVar("uncompressed size [MB]", m_library->getUncompressedSize() / 1e6));
+}
+
+
 void BGOverlayInputModule::connectBranches()
 {
   for (size_t i = 0; i < m_storeEntries.size(); i++) {
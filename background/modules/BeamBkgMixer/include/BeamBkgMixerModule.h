@@ -14,6 +14,8 @@
 #include <framework/dataobjects/BackgroundMetaData.h>
 #include <string>
 #include <map>
+#include <memory>
+#include <vector>
 
 #include <TChain.h>
 #include <TClonesArray.h>
@@ -74,6 +76,79 @@ namespace Belle2 {
       {}
     };
 
+    /**
+     * A range of background SimHits in a TClonesArray
+     */
+    struct HitRange {
+      TClonesArray* hits = nullptr; /**< array holding the SimHits, null if none */
+      int first = 0; /**< index of the first SimHit */
+      int last = 0;  /**< index after the last SimHit */
+
+      /**
+       * default constructor: empty range
+       */
+      HitRange() = default;
+
+      /**
+       * constructor for all SimHits of an array
+       * @param cloneArray array of SimHits or null
+       */
+      explicit HitRange(TClonesArray* cloneArray):
+        hits(cloneArray), last(cloneArray ? cloneArray->GetEntriesFast() : 0)
+      {}
+    };
+
+    /**
+     * SimHits of a single background event
+     */
+    struct BkgEvent {
+      HitRange PXD; /**< PXD SimHits */
+      HitRange SVD; /**< SVD SimHits */
+      HitRange CDC; /**< CDC SimHits */
+      HitRange TOP; /**< TOP SimHits */
+      HitRange ARICH; /**< ARICH SimHits */
+      HitRange ECL; /**< ECL SimHits */
+      HitRange KLM; /**< KLM SimHits */
+      HitRange BeamBackHits; /**< BeamBackHits */
+      bool accepted = true; /**< false if event is rejected by acceptEvent() */
+    };
+
+    /**
+     * SimHits of one detector for all events of a preloaded sample
+     */
+    struct HitBuffer {
+      std::unique_ptr<TClonesArray> hits; /**< SimHits of all events, one event after another */
+      std::vector<int> firstHit; /**< index of the first SimHit of each event, total number at the end */
+
+      /**
+       * Appends the SimHits of an event; they are moved out of the input array
+       * @param cloneArray SimHits of the event read from a file, or null if not available
+       */
+      void append(TClonesArray* cloneArray);
+
+      /**
+       * Returns the SimHits of an event
+       * @param index event index
+       * @return range of the SimHits
+       */
+      HitRange getEvent(unsigned index) const;
+    };
+
+    /**
+     * In-memory copy of a background sample
+     */
+    struct BkgBuffers {
+      HitBuffer PXD; /**< PXD SimHits */
+      HitBuffer SVD; /**< SVD SimHits */
+      HitBuffer CDC; /**< CDC SimHits */
+      HitBuffer TOP; /**< TOP SimHits */
+      HitBuffer ARICH; /**< ARICH SimHits */
+      HitBuffer ECL; /**< ECL SimHits */
+      HitBuffer KLM; /**< KLM SimHits */
+      HitBuffer BeamBackHits; /**< BeamBackHits */
+      std::vector<bool> accepted; /**< result of acceptEvent() for each event */
+    };
+
     /**
      * structure to hold samples of a particular background type
      */
@@ -90,13 +165,15 @@ namespace Belle2 {
       unsigned eventCount;     /**< current event (tree entry) */
       double rate;             /**< background rate of the sample */
       unsigned index;          /**< index of this element in the std::vector */
+      std::unique_ptr<BkgBuffers> buffers; /**< preloaded sample, null if not preloaded */
 
       /**
        * default constructor
        */
       BkgFiles(): tag(BackgroundMetaData::bg_none), realTime(0.0), scaleFactor(1.0),
         fileType(BackgroundMetaData::c_Usual),
-        tree(nullptr), numFiles(0), numEvents(0), eventCount(0), rate(0.0), index(0)
+        tree(nullptr), numFiles(0), numEvents(0), eventCount(0), rate(0.0), index(0),
+        buffers(nullptr)
       {}
       /**
        * useful constructor
@@ -117,7 +194,8 @@ namespace Belle2 {
                unsigned indx = 0):
         tag(bkgTag), type(bkgType), realTime(time), scaleFactor(scaleFac),
         fileType(fileTyp),
-        tree(nullptr), numFiles(0), numEvents(0), eventCount(0), rate(0.0), index(indx)
+        tree(nullptr), numFiles(0), numEvents(0), eventCount(0), rate(0.0), index(indx),
+        buffers(nullptr)
       {
         fileNames.push_back(fileName);
       }
@@ -127,24 +205,25 @@ namespace Belle2 {
     /**
      * functions that add background SimHits to those in the DataStore
      * @param simHits a reference to DataStore SimHits
-     * @param cloneArray a pointer to background SimHits read from a file
+     * @param range background SimHits read from a file or taken from the preloaded sample
      * @param timeShift time shift to be applied to background SimHits
      * @param minTime time window left edge
      * @param maxTime time window right edge
      */
     template<class SIMHIT>
     void addSimHits(StoreArray<SIMHIT>& simHits,
-                    TClonesArray* cloneArray,
+                    const HitRange& range,
                     double timeShift,
                     double minTime,
                     double maxTime)
     {
-      if (!cloneArray) return;
+      if (range.first >= range.last) return;
       if (!simHits.isValid()) return;
 
-      int numEntries = cloneArray->GetEntriesFast();
-      for (int i = 0; i < numEntries; i++) {
-        SIMHIT* bkgSimHit = static_cast<SIMHIT*>(cloneArray->AddrAt(i));
+      reserve(simHits.getPtr(), range.last - range.first);
+      const double windowSize = maxTime - minTime;
+      for (int i = range.first; i < range.last; i++) {
+        const SIMHIT* bkgSimHit = static_cast<SIMHIT*>(range.hits->AddrAt(i));
         SIMHIT* simHit = simHits.appendNew(*bkgSimHit);
         simHit->shiftInTime(timeShift);
         if (simHit->getBackgroundTag() == 0) // should be properly set at bkg simulation
@@ -152,7 +231,6 @@ namespace Belle2 {
         if (m_wrapAround) {
           double time = simHit->getGlobalTime();
           if (time > maxTime) {
-            double windowSize = maxTime - minTime;
             double shift = int((time - minTime) / windowSize) * windowSize;
             simHit->shiftInTime(-shift);
           }
@@ -164,25 +242,26 @@ namespace Belle2 {
     /**
      * functions that add BeamBackHits to those in the DataStore
      * @param hits a reference to DataStore BeamBackHits
-     * @param cloneArray a pointer to BeamBackHits read from a file
+     * @param range BeamBackHits read from a file or taken from the preloaded sample
      * @param timeShift time shift to be applied to BeamBackHits
      * @param minTime time window left edge
      * @param maxTime time window right edge
      */
     template<class HIT>
-    void addBeamBackHits(StoreArray<HIT>& hits, TClonesArray* cloneArray,
+    void addBeamBackHits(StoreArray<HIT>& hits, const HitRange& range,
                          double timeShift, double minTime, double maxTime)
     {
       // Match SubDet id from BeamBackHits to whether we keep it or not
       bool keep[] = {false, m_PXD, m_SVD, m_CDC, m_ARICH, m_TOP, m_ECL, m_KLM};
-      if (!cloneArray) return;
+      if (range.first >= range.last) return;
       if (!hits.isValid()) return;
       // this is basically a copy of addSimHits but we only add the
       // BeamBackHits from the specified sub detectors so we have to check
       // each if it is from one of the enabled subdetectors
-      int numEntries = cloneArray->GetEntriesFast();
-      for (int i = 0; i < numEntries; i++) {
-        HIT* bkgHit =  static_cast<HIT*>(cloneArray->AddrAt(i));
+      reserve(hits.getPtr(), range.last - range.first);
+      const double windowSize = maxTime - minTime;
+      for (int i = range.first; i < range.last; i++) {
+        const HIT* bkgHit = static_cast<HIT*>(range.hits->AddrAt(i));
         //Only keep selected
         if (!keep[bkgHit->getSubDet()]) continue;
         HIT* hit = hits.appendNew(*bkgHit);
@@ -192,7 +271,6 @@ namespace Belle2 {
         if (m_wrapAround) {
           double time = hit->getTime();
           if (time > maxTime) {
-            double windowSize = maxTime - minTime;
             double shift = int((time - minTime) / windowSize) * windowSize;
             hit->shiftInTime(-shift);
           }
@@ -200,6 +278,27 @@ namespace Belle2 {
       }
     }
 
+    /**
+     * Enlarges the capacity of a DataStore array at once for the hits to be appended
+     * @param cloneArray DataStore array
+     * @param numHits number of hits to be appended
+     */
+    static void reserve(TClonesArray* cloneArray, int numHits);
+
+    /**
+     * Returns the SimHits of the current event of a sample, either read from the file
+     * or taken from the preloaded sample.
+     * @param bkg background sample
+     * @return SimHits of the event (valid until the next call)
+     */
+    const BkgEvent& getEvent(BkgFiles& bkg);
+
+    /**
+     * Reads all events of a sample into memory
+     * @param bkg background sample
+     */
+    void preloadSample(BkgFiles& bkg);
+
     /**
      * Returns true if a component is found in components or the list is empty.
      * If found a component is erased from components.
@@ -245,9 +344,11 @@ namespace Belle2 {
     double m_maxTimePXD;  /**< maximal time shift of background event for PXD */
     double m_maxEdepECL;  /**< maximal allowed deposited energy in ECL */
     int m_cacheSize;  /**< file cache size in Mbytes */
+    bool m_preload = false; /**< if true read background samples into memory */
 
     std::vector<BkgFiles> m_backgrounds;  /**< container for background samples */
     BkgHits m_simHits;         /**< input event buffer */
+    BkgEvent m_event;          /**< SimHits of the current background event */
 
     bool m_PXD = false; /**< true if found in m_components */
     bool m_SVD = false; /**< true if found in m_components */
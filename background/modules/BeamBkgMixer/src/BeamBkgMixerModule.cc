@@ -37,6 +37,7 @@
 
 //std::find
 #include <algorithm>
+#include <tuple>
 
 using namespace std;
 using namespace Belle2;
@@ -97,6 +98,11 @@ BeamBkgMixerModule::BeamBkgMixerModule() : Module()
 
   addParam("cacheSize", m_cacheSize,
            "file cache size in Mbytes. If negative, use root default", 0);
+
+  addParam("preload", m_preload,
+           "If true, read all background samples into memory at initialization "
+           "(before the fork of multiprocessing). Needs the memory for all SimHits of the "
+           "samples, but the files are then not read event by event.", false);
 }
 
 
@@ -256,6 +262,8 @@ void BeamBkgMixerModule::initialize()
     if (m_BeamBackHits and bkg.tree->GetBranch("BeamBackHits"))
       bkg.tree->SetBranchAddress("BeamBackHits", &m_simHits.BeamBackHits);
 
+    if (m_preload) preloadSample(bkg);
+
     // print INFO
     std::string unit(" ns");
     double realTime = bkg.realTime;
@@ -352,17 +360,17 @@ void BeamBkgMixerModule::event()
 
     for (int iev = 0; iev < nev; iev++) {
       double timeShift = gRandom->Rndm() * (m_maxTime - m_minTime) + m_minTime;
-      bkg.tree->GetEntry(bkg.eventCount);
-
-      if (acceptEvent(m_simHits.ECL)) {
-        addSimHits(pxdSimHits, m_simHits.PXD, timeShift, m_minTime, m_maxTime);
-        addSimHits(svdSimHits, m_simHits.SVD, timeShift, m_minTime, m_maxTime);
-        addSimHits(cdcSimHits, m_simHits.CDC, timeShift, m_minTime, m_maxTime);
-        addSimHits(topSimHits, m_simHits.TOP, timeShift, m_minTime, m_maxTime);
-        addSimHits(arichSimHits, m_simHits.ARICH, timeShift, m_minTime, m_maxTime);
-        addSimHits(eclHits, m_simHits.ECL, timeShift, m_minTime, m_maxTime);
-        addSimHits(klmSimHits, m_simHits.KLM, timeShift, m_minTime, m_maxTime);
-        addBeamBackHits(beamBackHits, m_simHits.BeamBackHits, timeShift,
+      const auto& event = getEvent(bkg);
+
+      if (event.accepted) {
+        addSimHits(pxdSimHits, event.PXD, timeShift, m_minTime, m_maxTime);
+        addSimHits(svdSimHits, event.SVD, timeShift, m_minTime, m_maxTime);
+        addSimHits(cdcSimHits, event.CDC, timeShift, m_minTime, m_maxTime);
+        addSimHits(topSimHits, event.TOP, timeShift, m_minTime, m_maxTime);
+        addSimHits(arichSimHits, event.ARICH, timeShift, m_minTime, m_maxTime);
+        addSimHits(eclHits, event.ECL, timeShift, m_minTime, m_maxTime);
+        addSimHits(klmSimHits, event.KLM, timeShift, m_minTime, m_maxTime);
+        addBeamBackHits(beamBackHits, event.BeamBackHits, timeShift,
                         m_minTime, m_maxTime);
       } else {
         iev--;
@@ -400,9 +408,9 @@ void BeamBkgMixerModule::event()
     for (int iev = 0; iev < nev; iev++) {
       double timeShift = gRandom->Rndm() * (m_maxTimeECL - m_minTimeECL) + m_minTimeECL;
       if (timeShift > m_minTime and timeShift < m_maxTime) continue;
-      bkg.tree->GetEntry(bkg.eventCount);
+      const auto& event = getEvent(bkg);
 
-      if (acceptEvent(m_simHits.ECL)) {
+      if (event.accepted) {
         double minTime = m_minTimeECL;
         double maxTime = m_maxTimeECL;
         if (timeShift <= m_minTime) {
@@ -410,7 +418,7 @@ void BeamBkgMixerModule::event()
         } else {
           minTime = m_maxTime;
         }
-        addSimHits(eclHits, m_simHits.ECL, timeShift, minTime, maxTime);
+        addSimHits(eclHits, event.ECL, timeShift, minTime, maxTime);
       } else {
         iev--;
         std::string message = "BeamBkgMixer: event " + to_string(bkg.eventCount)
@@ -448,7 +456,7 @@ void BeamBkgMixerModule::event()
     for (int iev = 0; iev < nev; iev++) {
       double timeShift = gRandom->Rndm() * (m_maxTimePXD - m_minTimePXD) + m_minTimePXD;
       if (timeShift > m_minTime and timeShift < m_maxTime) continue;
-      bkg.tree->GetEntry(bkg.eventCount);
+      const auto& event = getEvent(bkg);
 
       double minTime = m_minTimePXD;
       double maxTime = m_maxTimePXD;
@@ -457,7 +465,7 @@ void BeamBkgMixerModule::event()
       } else {
         minTime = m_maxTime;
       }
-      addSimHits(pxdSimHits, m_simHits.PXD, timeShift, minTime, maxTime);
+      addSimHits(pxdSimHits, event.PXD, timeShift, minTime, maxTime);
 
       bkg.eventCount++;
       if (bkg.eventCount >= bkg.numEvents) {
@@ -540,3 +548,104 @@ bool BeamBkgMixerModule::acceptEvent(TClonesArray* cloneArrayECL)
   }
   return true;
 }
+
+
+void BeamBkgMixerModule::reserve(TClonesArray* cloneArray, int numHits)
+{
+  int size = cloneArray->GetEntriesFast() + numHits;
+  if (size > cloneArray->GetSize()) cloneArray->Expand(std::max(size, 2 * cloneArray->GetSize()));
+}
+
+
+const BeamBkgMixerModule::BkgEvent& BeamBkgMixerModule::getEvent(BkgFiles& bkg)
+{
+  if (bkg.buffers) {
+    const auto& buffers = *bkg.buffers;
+    unsigned index = bkg.eventCount;
+    m_event.PXD = buffers.PXD.getEvent(index);
+    m_event.SVD = buffers.SVD.getEvent(index);
+    m_event.CDC = buffers.CDC.getEvent(index);
+    m_event.TOP = buffers.TOP.getEvent(index);
+    m_event.ARICH = buffers.ARICH.getEvent(index);
+    m_event.ECL = buffers.ECL.getEvent(index);
+    m_event.KLM = buffers.KLM.getEvent(index);
+    m_event.BeamBackHits = buffers.BeamBackHits.getEvent(index);
+    m_event.accepted = buffers.accepted[index];
+    return m_event;
+  }
+
+  bkg.tree->GetEntry(bkg.eventCount);
+  m_event.PXD = HitRange(m_simHits.PXD);
+  m_event.SVD = HitRange(m_simHits.SVD);
+  m_event.CDC = HitRange(m_simHits.CDC);
+  m_event.TOP = HitRange(m_simHits.TOP);
+  m_event.ARICH = HitRange(m_simHits.ARICH);
+  m_event.ECL = HitRange(m_simHits.ECL);
+  m_event.KLM = HitRange(m_simHits.KLM);
+  m_event.BeamBackHits = HitRange(m_simHits.BeamBackHits);
+  m_event.accepted = acceptEvent(m_simHits.ECL);
+  return m_event;
+}
+
+
+void BeamBkgMixerModule::preloadSample(BkgFiles& bkg)
+{
+  bkg.buffers.reset(new BkgBuffers());
+  auto& buffers = *bkg.buffers;
+
+  // take only the branches of this sample, the input buffers of the others hold hits of other samples
+  const std::vector<std::tuple<std::string, TClonesArray**, HitBuffer*>> detectors = {
+    {"PXDSimHits", &m_simHits.PXD, &buffers.PXD},
+    {"SVDSimHits", &m_simHits.SVD, &buffers.SVD},
+    {"CDCSimHits", &m_simHits.CDC, &buffers.CDC},
+    {"TOPSimHits", &m_simHits.TOP, &buffers.TOP},
+    {"ARICHSimHits", &m_simHits.ARICH, &buffers.ARICH},
+    {"ECLHits", &m_simHits.ECL, &buffers.ECL},
+    {"KLMSimHits", &m_simHits.KLM, &buffers.KLM},
+    {"BeamBackHits", &m_simHits.BeamBackHits, &buffers.BeamBackHits}
+  };
+  std::vector<std::pair<TClonesArray**, HitBuffer*>> inputs;
+  for (const auto& detector : detectors) {
+    if (bkg.tree->GetBranch(std::get<0>(detector).c_str()))
+      inputs.push_back(std::make_pair(std::get<1>(detector), std::get<2>(detector)));
+  }
+
+  for (unsigned k = 0; k < bkg.numEvents; k++) {
+    bkg.tree->GetEntry(k);
+    buffers.accepted.push_back(acceptEvent(m_simHits.ECL));
+    for (auto& input : inputs) input.second->append(*input.first);
+  }
+
+  // files are not needed anymore
+  bkg.tree.reset();
+
+  int numHits = 0;
+  for (const auto& input : inputs) {
+    if (!input.second->firstHit.empty()) numHits += input.second->firstHit.back();
+  }
+  B2INFO("BeamBkgMixer: " << bkg.type << " preloaded"
+         << LogVar("events", bkg.numEvents)
+         << LogVar("SimHits", numHits));
+}
+
+
+void BeamBkgMixerModule::HitBuffer::append(TClonesArray* cloneArray)
+{
+  if (firstHit.empty()) firstHit.push_back(0);
+  if (cloneArray and cloneArray->GetEntriesFast() > 0) {
+    if (!hits) hits.reset(new TClonesArray(cloneArray->GetClass()));
+    hits->AbsorbObjects(cloneArray);
+  }
+  firstHit.push_back(hits ? hits->GetEntriesFast() : 0);
+}
+
+
+BeamBkgMixerModule::HitRange BeamBkgMixerModule::HitBuffer::getEvent(unsigned index) const
+{
+  HitRange range;
+  if (!hits) return range;
+  range.hits = hits.get();
+  range.first = firstHit[index];
+  range.last = firstHit[index + 1];
+  return range;
+}
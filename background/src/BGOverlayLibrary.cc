@@ -0,0 +1,138 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+/* Own header. */
+#include <background/BGOverlayLibrary.h>
+
+/* Basf2 headers. */
+#include <framework/logging/Logger.h>
+
+/* ROOT headers. */
+#include <TBufferFile.h>
+#include <RZip.h>
+
+/* C++ headers. */
+#include <algorithm>
+
+using namespace Belle2;
+
+namespace {
+  /** Maximal size of a block compressed by a single call of R__zip */
+  const int c_maxZipChunk = 0xffffff;
+}
+
+BGOverlayLibrary::BGOverlayLibrary(int compressionLevel):
+  m_compressionLevel(compressionLevel)
+{
+}
+
+void BGOverlayLibrary::appendEvent(const std::vector<DataStore::StoreEntry*>& entries)
+{
+  if (m_blocks.empty()) m_numEntries = entries.size();
+  if (entries.size() != m_numEntries) B2FATAL("BGOverlayLibrary: number of objects differs between events");
+
+  TBufferFile buffer(TBuffer::kWrite);
+  for (const auto* entry : entries) {
+    Block block;
+    block.offset = m_data.size();
+    if (not entry->object) {
+      m_blocks.push_back(block);
+      continue;
+    }
+
+    buffer.Reset();
+    entry->object->Streamer(buffer);
+    int rawSize = buffer.Length();
+    block.rawSize = rawSize;
+    m_uncompressedSize += rawSize;
+
+    // compress chunk by chunk, store uncompressed if compression does not help
+    if (m_compressionLevel > 0) {
+      const int algorithm = m_compressionLevel / 100;
+      const int level = m_compressionLevel % 100;
+      m_data.resize(block.offset + rawSize);
+      char* src = buffer.Buffer();
+      int done = 0;
+      int size = 0;
+      while (done < rawSize) {
+        int nin = std::min(rawSize - done, c_maxZipChunk);
+        int nout = rawSize - size;
+        int irep = 0;
+        R__zipMultipleAlgorithm(level, &nin, src + done, &nout, m_data.data() + block.offset + size, &irep,
+                                (ROOT::RCompressionSetting::EAlgorithm::EValues) algorithm);
+        if (irep <= 0) {
+          size = rawSize;
+          break;
+        }
+        done += nin;
+        size += irep;
+      }
+      if (size < rawSize) {
+        block.size = size;
+        m_data.resize(block.offset + size);
+        m_blocks.push_back(block);
+        continue;
+      }
+      m_data.resize(block.offset);
+    }
+
+    m_data.insert(m_data.end(), buffer.Buffer(), buffer.Buffer() + rawSize);
+    block.size = rawSize;
+    m_blocks.push_back(block);
+  }
+}
+
+void BGOverlayLibrary::readEvent(unsigned index, const std::vector<DataStore::StoreEntry*>& entries) const
+{
+  if (index >= getNumEvents()) B2FATAL("BGOverlayLibrary: event index out of range" << LogVar("index", index));
+  if (entries.size() != m_numEntries) B2FATAL("BGOverlayLibrary: number of objects differs from the stored ones");
+
+  for (size_t k = 0; k < m_numEntries; k++) {
+    const auto& block = m_blocks[index * m_numEntries + k];
+    auto* entry = entries[k];
+    if (block.size == 0) {
+      // null object: as TTree::GetEntry() does, leave no object, so that the caller sets the entry invalid
+      delete entry->object;
+      entry->object = nullptr;
+      continue;
+    }
+
+    // uncompress if needed; ROOT wants non-const pointers although it only reads the input
+    char* data = const_cast<char*>(m_data.data()) + block.offset;
+    if (block.size < block.rawSize) {
+      m_buffer.resize(block.rawSize);
+      auto* zipptr = reinterpret_cast<unsigned char*>(data);
+      const auto* zipend = zipptr + block.size;
+      int size = 0;
+      while (zipptr < zipend) {
+        int nzip = 0, nout = 0, irep = 0;
+        if (R__unzip_header(&nzip, zipptr, &nout) != 0) B2FATAL("BGOverlayLibrary: cannot uncompress block header");
+        if (nout <= 0 or size + nout > block.rawSize or zipend - zipptr < nzip)
+          B2FATAL("BGOverlayLibrary: corrupted block");
+        R__unzip(&nzip, zipptr, &nout, reinterpret_cast<unsigned char*>(m_buffer.data() + size), &irep);
+        if (irep <= 0) B2FATAL("BGOverlayLibrary: cannot uncompress block");
+        zipptr += nzip;
+        size += irep;
+      }
+      data = m_buffer.data();
+    }
+
+    entry->recoverFromNullObject();
+    TBufferFile buffer(TBuffer::kRead, block.rawSize, data, false);
+    entry->object->Streamer(buffer);
+  }
+}
+
+void BGOverlayLibrary::clear()
+{
+  m_numEntries = 0;
+  m_blocks.clear();
+  m_data.clear();
+  m_data.shrink_to_fit();
+  m_uncompressedSize = 0;
+}
@@ -0,0 +1,138 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#include <background/BGOverlayLibrary.h>
+#include <framework/dataobjects/EventMetaData.h>
+
+#include <TClonesArray.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace std;
+
+namespace Belle2 {
+
+  /** Store entries with an array and a single object, filled as by BGOverlayInput */
+  class BGOverlayLibraryTest : public ::testing::TestWithParam<int> {
+  protected:
+    /** Create the entries */
+    BGOverlayLibraryTest() :
+      m_array(true, EventMetaData::Class(), "array", true),
+      m_object(false, EventMetaData::Class(), "object", true),
+      m_entries{&m_array, &m_object}
+    {
+    }
+
+    /** Reset the entries for the next event, as BGOverlayInput does */
+    void reset()
+    {
+      for (auto entry : m_entries) {
+        entry->recoverFromNullObject();
+        entry->resetForGetEntry();
+      }
+    }
+
+    /** Fill the entries with event i; every third event has no object and a large (compressible) array */
+    void fill(int i)
+    {
+      reset();
+      auto* array = static_cast<TClonesArray*>(m_array.object);
+      const int nElements = i % 3 == 0 ? 1000 : i % 2;
+      for (int k = 0; k < nElements; k++) new((*array)[k]) EventMetaData(k, i, 0);
+      if (i % 3 != 0) m_object.object = new EventMetaData(i, i + 1, i + 2);
+    }
+
+    /** Check that the entries hold event i */
+    void check(int i)
+    {
+      const auto* array = static_cast<TClonesArray*>(m_array.object);
+      const int nElements = i % 3 == 0 ? 1000 : i % 2;
+      ASSERT_EQ(array->GetEntriesFast(), nElements);
+      for (int k = 0; k < nElements; k++) {
+        const auto* element = static_cast<const EventMetaData*>(array->At(k));
+        EXPECT_EQ(element->getEvent(), static_cast<unsigned>(k));
+        EXPECT_EQ(element->getRun(), i);
+      }
+      if (i % 3 == 0) {
+        EXPECT_EQ(m_object.object, nullptr);
+      } else {
+        ASSERT_NE(m_object.object, nullptr);
+        const auto* object = static_cast<const EventMetaData*>(m_object.object);
+        EXPECT_EQ(object->getEvent(), static_cast<unsigned>(i));
+        EXPECT_EQ(object->getRun(), i + 1);
+        EXPECT_EQ(object->getExperiment(), i + 2);
+      }
+    }
+
+    DataStore::StoreEntry m_array; /**< entry of an array */
+    DataStore::StoreEntry m_object; /**< entry of a single object */
+    vector<DataStore::StoreEntry*> m_entries; /**< both entries */
+  };
+
+  /** Events read back in any order are identical to the stored ones, including null objects and uncompressed blocks */
+  TEST_P(BGOverlayLibraryTest, RoundTrip)
+  {
+    const int compressionLevel = GetParam();
+    const int nEvents = 10;
+    BGOverlayLibrary library(compressionLevel);
+    for (int i = 0; i < nEvents; i++) {
+      fill(i);
+      library.appendEvent(m_entries);
+    }
+    EXPECT_EQ(library.getNumEvents(), static_cast<unsigned>(nEvents));
+    if (compressionLevel == 0) {
+      EXPECT_EQ(library.getSize(), library.getUncompressedSize());
+    } else {
+      EXPECT_LT(library.getSize(), library.getUncompressedSize());
+    }
+
+    for (int i = nEvents - 1; i >= 0; i--) {
+      reset();
+      library.readEvent(i, m_entries);
+      check(i);
+    }
+
+    library.clear();
+    EXPECT_EQ(library.getNumEvents(), 0u);
+    EXPECT_EQ(library.getSize(), 0u);
+  }
+
+  /** Null objects, also of arrays, are restored as null, so that the store entries are set invalid as with the TTree */
+  TEST_P(BGOverlayLibraryTest, NullObjects)
+  {
+    BGOverlayLibrary library(GetParam());
+    fill(1);
+    library.appendEvent(m_entries);
+    reset();
+    delete m_array.object;
+    m_array.object = nullptr;
+    library.appendEvent(m_entries);
+
+    for (int i : {1, 0, 1}) {
+      reset();
+      library.readEvent(i, m_entries);
+      // as in BGOverlayInputModule::event()
+      for (auto entry : m_entries) {
+        if (entry->object) {
+          entry->ptr = entry->object;
+        } else {
+          entry->recoverFromNullObject();
+          entry->ptr = nullptr;
+        }
+      }
+      EXPECT_EQ(m_array.ptr == nullptr, i == 1);
+      EXPECT_EQ(m_object.ptr == nullptr, i == 1);
+    }
+  }
+
+  /** Uncompressed and LZ4 compressed libraries */
+  INSTANTIATE_TEST_SUITE_P(CompressionLevels, BGOverlayLibraryTest, ::testing::Values(0, 404));
+
+} // Belle2 namespace
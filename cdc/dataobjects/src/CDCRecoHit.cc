@@ -197,9 +197,9 @@ std::vector<genfit::MeasurementOnPlane*> CDCRecoHit::constructMeasurementsOnPlan
                                                              true, //right
                                                              z, alpha, theta);
 
-  // static to avoid constructing these over and over.
-  static TVectorD m(1);
-  static TMatrixDSym cov(1);
+  // not static, the fits of several tracks may run in parallel threads
+  TVectorD m(1);
+  TMatrixDSym cov(1);
 
   m(0) = mR;
   cov(0, 0) = VR;
@@ -45,6 +45,10 @@ namespace Belle2 {
     std::string m_outputAddress;
     /// Parameter: Do not wait for a ready worker if set to true, but dismiss the incoming event
     bool m_lax = false;
+    /// Parameter: number of shared memory slots for local connections (0 = no shared memory)
+    unsigned int m_sharedMemorySlots = 0;
+    /// Parameter: size of a shared memory slot in bytes
+    unsigned int m_sharedMemorySlotSize = 4'000'000;
     /// Parameter: how long to wait after no events come anymore
     unsigned int m_stopWaitingTime = 2;
   };
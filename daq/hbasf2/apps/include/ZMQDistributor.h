@@ -50,6 +50,12 @@ namespace Belle2 {
     bool m_expressRecoMode = false;
     /// Parameter: Do not wait for a ready worker if set to true, but dismiss the incoming event
     bool m_lax = false;
+    /// Parameter: maximal number of not yet started events per worker (0 = no limit)
+    unsigned int m_maximalInFlightEvents = 0;
+    /// Parameter: number of shared memory slots for local connections (0 = no shared memory)
+    unsigned int m_sharedMemorySlots = 0;
+    /// Parameter: size of a shared memory slot in bytes
+    unsigned int m_sharedMemorySlotSize = 4'000'000;
     /// Parameter: how long to wait after no events come anymore
     unsigned int m_stopWaitingTime = 2;
   };
@@ -52,6 +52,7 @@ namespace Belle2 {
    * confirmation message. Periodically or on stop/terminate, merge them and send them out to the
    * next histogram server. Good for building up hierarchical structures e.g. because not all
    * histograms can be handled at the same time.
+   * With the delta transport enabled, only the histograms changed since the last sending are sent to the next server.
    * Apart from the connection-typical behavior, it reacts on termination messages by terminating.
    * Behaves as a collector:
    * When receiving a stop on monitoring, it merges the histograms (even if not all clients have sent a stop already).
@@ -77,6 +78,10 @@ namespace Belle2 {
     std::string m_outputAddress;
     /// Parameter: size of the temporary internal compression buffer
     unsigned int m_maximalUncompressedBufferSize = 128'000'000;
+    /// Parameter: only send the histograms which changed since the last sending
+    bool m_deltaTransport = false;
+    /// Parameter: with delta transport, send all histograms every this many sendings
+    unsigned int m_fullUpdateInterval = 10;
   };
 
   /**
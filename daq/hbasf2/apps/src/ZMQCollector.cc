@@ -20,6 +20,12 @@ void ZMQCollector::addOptions(po::options_description& desc)
    "where to send the events to")
   ("lax", boost::program_options::bool_switch(&m_lax)->default_value(m_lax),
    "dismiss events if no worker is ready (lax) or not")
+  ("sharedMemorySlots",
+   boost::program_options::value<unsigned int>(&m_sharedMemorySlots)->default_value(m_sharedMemorySlots),
+   "number of shared memory slots (a power of two) for receiving the event data from local (ipc) workers, 0 = send everything over ZMQ")
+  ("sharedMemorySlotSize",
+   boost::program_options::value<unsigned int>(&m_sharedMemorySlotSize)->default_value(m_sharedMemorySlotSize),
+   "size of a single shared memory slot in bytes. Larger events are sent over ZMQ")
   ("stopWaitingTime",
    boost::program_options::value<unsigned int>(&m_stopWaitingTime)->default_value(m_stopWaitingTime),
    "how long to wait after no events come anymore");
@@ -29,6 +35,9 @@ void ZMQCollector::initialize()
 {
   ZMQStandardApp::initialize();
   m_input.reset(new ZMQConfirmedInput(m_inputAddress, m_parent));
+  if (m_sharedMemorySlots > 0) {
+    m_input->createSharedMemoryPool(m_inputAddress, m_sharedMemorySlots, m_sharedMemorySlotSize);
+  }
   m_output.reset(new ZMQLoadBalancedOutput(m_outputAddress, m_lax, m_parent));
 }
 
@@ -22,9 +22,18 @@ void ZMQDistributor::addOptions(po::options_description& desc)
    "express reco mode: send out event messages (instead of raw messages)")
   ("lax", boost::program_options::bool_switch(&m_lax)->default_value(m_lax),
    "lax mode: dismiss events if no worker is ready")
+  ("maximalInFlightEvents",
+   boost::program_options::value<unsigned int>(&m_maximalInFlightEvents)->default_value(m_maximalInFlightEvents),
+   "maximal number of not yet started events per worker (0 = only limited by the ready messages of the worker)")
   ("maximalBufferSize",
    boost::program_options::value<unsigned int>(&m_maximalBufferSize)->default_value(m_maximalBufferSize),
    "size of the input buffer")
+  ("sharedMemorySlots",
+   boost::program_options::value<unsigned int>(&m_sharedMemorySlots)->default_value(m_sharedMemorySlots),
+   "number of shared memory slots (a power of two) for passing the event data to local (ipc) workers, 0 = send everything over ZMQ")
+  ("sharedMemorySlotSize",
+   boost::program_options::value<unsigned int>(&m_sharedMemorySlotSize)->default_value(m_sharedMemorySlotSize),
+   "size of a single shared memory slot in bytes. Larger events are sent over ZMQ")
   ("stopWaitingTime",
    boost::program_options::value<unsigned int>(&m_stopWaitingTime)->default_value(m_stopWaitingTime),
    "how long to wait after no events come anymore");
@@ -34,7 +43,10 @@ void ZMQDistributor::initialize()
 {
   ZMQStandardApp::initialize();
   m_input.reset(new ZMQRawInput(m_inputAddress, m_maximalBufferSize, m_expressRecoMode, m_parent));
-  m_output.reset(new ZMQLoadBalancedOutput(m_outputAddress, m_lax, m_parent));
+  m_output.reset(new ZMQLoadBalancedOutput(m_outputAddress, m_lax, m_parent, m_maximalInFlightEvents));
+  if (m_sharedMemorySlots > 0) {
+    m_output->createSharedMemoryPool(m_outputAddress, m_sharedMemorySlots, m_sharedMemorySlotSize);
+  }
 }
 
 void ZMQDistributor::handleExternalSignal(EMessageTypes type)
@@ -75,7 +75,8 @@ void ZMQHistogramToZMQServer::initialize()
 {
   ZMQStandardApp::initialize();
   m_input.reset(new ZMQConfirmedInput(m_inputAddress, m_parent));
-  m_output.reset(new ZMQHistoServerToZMQ(m_maximalUncompressedBufferSize, m_outputAddress, m_parent));
+  m_output.reset(new ZMQHistoServerToZMQ(m_maximalUncompressedBufferSize, m_outputAddress, m_parent,
+                                         m_deltaTransport, m_fullUpdateInterval));
 }
 
 void ZMQHistogramToZMQServer::addOptions(po::options_description& desc)
@@ -91,7 +92,11 @@ void ZMQHistogramToZMQServer::addOptions(po::options_description& desc)
   ("maximalUncompressedBufferSize",
    boost::program_options::value<unsigned int>(&m_maximalUncompressedBufferSize)->default_value(
      m_maximalUncompressedBufferSize),
-   "size of the uncompress buffer");
+   "size of the uncompress buffer")
+  ("deltaTransport", boost::program_options::bool_switch(&m_deltaTransport)->default_value(m_deltaTransport),
+   "only send the histograms which changed since the last sending")
+  ("fullUpdateInterval", boost::program_options::value<unsigned int>(&m_fullUpdateInterval)->default_value(m_fullUpdateInterval),
+   "with delta transport: send all histograms every this many sendings");
 }
 
 void ZMQHistogramToZMQServer::handleExternalSignal(EMessageTypes type)
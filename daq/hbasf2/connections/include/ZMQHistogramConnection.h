@@ -9,6 +9,7 @@
 
 #include <framework/pcore/zmq/connections/ZMQConnection.h>
 #include <daq/hbasf2/utils/HistogramMapping.h>
+#include <daq/hbasf2/utils/HistogramDeltaSelector.h>
 
 #include <framework/pcore/zmq/connections/ZMQNullConnection.h>
 #include <framework/pcore/zmq/connections/ZMQConfirmedConnection.h>
@@ -45,9 +46,9 @@ namespace Belle2 {
     ZMQHistoServerToFileOutput(const std::string& dqmFileName,
                                const std::string& rootFileName);
 
-    /// Merge the given histograms into a single set of histograms and store them to file/shm
-    void mergeAndSend(const std::map<std::string, HistogramMapping>& storedMessages, const std::optional<unsigned int>& experiment,
-                      const std::optional<unsigned int>& run,
+    /// Store the merged histograms to file/shm
+    void mergeAndSend(const std::map<std::string, HistogramMapping>& storedMessages, const HistogramMapping& mergedHistograms,
+                      const std::optional<unsigned int>& experiment, const std::optional<unsigned int>& run,
                       EMessageTypes messageType);
     /// Clear the shared memory
     void clear();
@@ -72,18 +73,23 @@ namespace Belle2 {
    * As additional message the event meta data is passed.
    *
    * This connection allows to built hierarchies of histogram servers with ZMQ.
+   *
+   * If the delta transport is enabled, only the histograms whose content changed since the last
+   * sending are sent (as compressed delta message). Every fullUpdateInterval-th sending and after each clear,
+   * all histograms are sent, so a restarted receiver is back in sync after some time.
    */
   class ZMQHistoServerToZMQOutput : public ZMQConnection {
   public:
     /// Initialize the ZMQConfirmedOutput with the given address
-    ZMQHistoServerToZMQOutput(const std::string& outputAddress, const std::shared_ptr<ZMQParent>& parent);
+    ZMQHistoServerToZMQOutput(const std::string& outputAddress, const std::shared_ptr<ZMQParent>& parent,
+                              bool deltaTransport = false, unsigned int fullUpdateInterval = 10);
 
-    /// Merge the histograms and send them via the connection. Stop/Terminate messages are sent after that.
-    void mergeAndSend(const std::map<std::string, HistogramMapping>& storedMessages, const std::optional<unsigned int>& experiment,
-                      const std::optional<unsigned int>& run,
+    /// Send the merged histograms via the connection (all or only the changed ones). Stop/Terminate messages are sent after that.
+    void mergeAndSend(const std::map<std::string, HistogramMapping>& storedMessages, const HistogramMapping& mergedHistograms,
+                      const std::optional<unsigned int>& experiment, const std::optional<unsigned int>& run,
                       EMessageTypes messageType);
-    /// Nothing to do on clear.
-    void clear() {}
+    /// Forget what was already sent, so the next sending includes all histograms
+    void clear();
 
     /// The monitoring JSON is just passed from the ZMQConfirmedOutput
     std::string getMonitoringJSON() const final { return m_output.getMonitoringJSON(); }
@@ -103,6 +109,9 @@ namespace Belle2 {
     std::vector<char> m_outputBuffer;
     /// Maximal size of the compression buffer
     unsigned int m_maximalCompressedSize = 100'000'000;
+
+    /// Decides which histograms are sent (all or only the changed ones)
+    HistogramDeltaSelector m_deltaSelector;
   };
 
   /**
@@ -117,9 +126,9 @@ namespace Belle2 {
     /// Create a new raw output with the given address
     ZMQHistoServerToRawOutput(const std::string& outputAddress, const std::shared_ptr<ZMQParent>& parent);
 
-    /// Merge the histograms and send them via the connection. Stop/Terminate messages are not sent.
-    void mergeAndSend(const std::map<std::string, HistogramMapping>& storedMessages, const std::optional<unsigned int>& experiment,
-                      const std::optional<unsigned int>& run,
+    /// Send the merged histograms via the connection. Stop/Terminate messages are not sent.
+    void mergeAndSend(const std::map<std::string, HistogramMapping>& storedMessages, const HistogramMapping& mergedHistograms,
+                      const std::optional<unsigned int>& experiment, const std::optional<unsigned int>& run,
                       EMessageTypes messageType);
     /// Nothing to do on clear
     void clear() {}
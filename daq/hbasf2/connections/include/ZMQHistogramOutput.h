@@ -24,6 +24,7 @@
 #include <string>
 #include <memory>
 #include <map>
+#include <set>
 #include <optional>
 
 namespace Belle2 {
@@ -42,6 +43,11 @@ namespace Belle2 {
    * * After that (or for uncompressed messages) the received histograms in the message
    *   are stored in the message map with the identity as key. In this way only ever the latest
    *   message for each sender is stored (and used when merging).
+   * * Compressed delta messages only include the histograms which changed since the last sending.
+   *   They only replace these histograms in the stored mapping of the sender.
+   *
+   * The merged histograms are kept between merges and only the histograms which changed
+   * since the last merge (by any sender) are summed up again.
    *
    * Data messages are supposed to have the run and experiment number stored as JSON-transformed
    * EventMetaData in the additional messages. This sent event meta data is compared with the
@@ -67,9 +73,18 @@ namespace Belle2 {
 
     /// The stored histograms for each sender identity
     std::map<std::string, HistogramMapping> m_storedMessages;
+    /// The sum of the stored histograms of all identities
+    HistogramMapping m_mergedHistograms;
+    /// Names of the histograms which changed since the last merge
+    std::set<std::string> m_changedHistograms;
     /// The buffer used during decompression
     std::vector<char> m_uncompressedBuffer;
 
+    /// Decompress the data message into the uncompressed buffer and return the histograms in it
+    HistogramMapping decompress(const zmq::message_t& dataMessage);
+    /// Replace all stored histograms of the given identity and mark the old and new ones as changed
+    void storeFullMessage(const std::string& identity, HistogramMapping&& histograms);
+
     /// If already received: the experiment number of the data (on mismatch, everything is cleared)
     std::optional<int> m_storedExperiment = {};
     /// If already received: the run number of the data (on mismatch, everything is cleared)
@@ -87,6 +102,8 @@ namespace Belle2 {
     AConnectionClass::log("uncompressed_size", 0.0);
     AConnectionClass::log("stored_identities", 0l);
     AConnectionClass::log("histogram_clears", 0l);
+    AConnectionClass::log("delta_updates", 0l);
+    AConnectionClass::log("remerged_histograms", 0.0);
     AConnectionClass::log("last_clear", "");
   }
 
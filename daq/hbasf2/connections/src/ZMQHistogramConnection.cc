@@ -37,6 +37,7 @@ ZMQHistoServerToFileOutput::ZMQHistoServerToFileOutput(const std::string& dqmFil
 }
 
 void ZMQHistoServerToFileOutput::mergeAndSend(const std::map<std::string, HistogramMapping>& storedMessages,
+                                              const HistogramMapping& mergedHistograms,
                                               const std::optional<unsigned int>& experiment,
                                               const std::optional<unsigned int>& run, EMessageTypes /*messageType*/)
 {
@@ -56,20 +57,11 @@ void ZMQHistoServerToFileOutput::mergeAndSend(const std::map<std::string, Histog
   memFile.cd();
 
   // We do not care if this is the run end, or run start or anything. We just write it out.
-  HistogramMapping mergeHistograms;
-
   log("last_merged_histograms", static_cast<long>(storedMessages.size()));
   average("average_merged_histograms", static_cast<double>(storedMessages.size()));
 
   logTime("last_merge");
-  for (const auto& keyValue : storedMessages) {
-    const auto& histogram = keyValue.second;
-    mergeHistograms += histogram;
-  }
-
-  memFile.Write();
-
-  mergeHistograms.clear();
+  mergedHistograms.write();
 
   memFile.Close();
 
@@ -109,8 +101,9 @@ void ZMQHistoServerToFileOutput::clear()
   std::filesystem::rename("/dev/shm/tmp_" + m_dqmMemFileName, "/dev/shm/" + m_dqmMemFileName);
 }
 
-ZMQHistoServerToZMQOutput::ZMQHistoServerToZMQOutput(const std::string& outputAddress, const std::shared_ptr<ZMQParent>& parent) :
-  m_output(outputAddress, parent)
+ZMQHistoServerToZMQOutput::ZMQHistoServerToZMQOutput(const std::string& outputAddress, const std::shared_ptr<ZMQParent>& parent,
+                                                     bool deltaTransport, unsigned int fullUpdateInterval) :
+  m_output(outputAddress, parent), m_deltaSelector(deltaTransport, fullUpdateInterval)
 {
   m_output.log("histogram_merges", 0l);
   m_output.log("last_merged_histograms", 0l);
@@ -118,22 +111,25 @@ ZMQHistoServerToZMQOutput::ZMQHistoServerToZMQOutput(const std::string& outputAd
   m_output.log("last_merge", "");
   m_output.log("size_before_compression", 0.0);
   m_output.log("size_after_compression", 0.0);
+  m_output.log("sent_histograms", 0.0);
+  m_output.log("skipped_sendings", 0l);
 }
 
 void ZMQHistoServerToZMQOutput::mergeAndSend(const std::map<std::string, HistogramMapping>& storedMessages,
+                                             const HistogramMapping& mergedHistograms,
                                              const std::optional<unsigned int>& experiment,
                                              const std::optional<unsigned int>& run, EMessageTypes messageType)
 {
   if (messageType == EMessageTypes::c_lastEventMessage) {
     // merge one last time
-    mergeAndSend(storedMessages, experiment, run, EMessageTypes::c_eventMessage);
+    mergeAndSend(storedMessages, mergedHistograms, experiment, run, EMessageTypes::c_eventMessage);
     // and then send out a stop signal by ourself
     auto message = ZMQMessageFactory::createMessage(EMessageTypes::c_lastEventMessage);
     m_output.handleEvent(std::move(message));
     return;
   } else if (messageType == EMessageTypes::c_terminateMessage) {
     // merge one last time
-    mergeAndSend(storedMessages, experiment, run, EMessageTypes::c_eventMessage);
+    mergeAndSend(storedMessages, mergedHistograms, experiment, run, EMessageTypes::c_eventMessage);
     // and send out a terminate message
     auto message = ZMQMessageFactory::createMessage(EMessageTypes::c_terminateMessage);
     m_output.handleEvent(std::move(message));
@@ -151,18 +147,20 @@ void ZMQHistoServerToZMQOutput::mergeAndSend(const std::map<std::string, Histogr
 
   m_output.increment("histogram_merges");
 
-  HistogramMapping mergeHistograms;
-
   m_output.log("last_merged_histograms", static_cast<long>(storedMessages.size()));
   m_output.average("average_merged_histograms", static_cast<double>(storedMessages.size()));
   m_output.logTime("last_merge");
 
-  for (const auto& keyValue : storedMessages) {
-    const auto& histogram = keyValue.second;
-    mergeHistograms += histogram;
+  std::set<std::string> changedNames;
+  const bool sendDelta = m_deltaSelector.selectDelta(mergedHistograms, changedNames);
+  if (sendDelta and changedNames.empty()) {
+    // The receiver already knows everything
+    m_output.increment("skipped_sendings");
+    return;
   }
 
-  auto eventMessage = mergeHistograms.toMessage();
+  auto eventMessage = sendDelta ? mergedHistograms.toMessage(changedNames) : mergedHistograms.toMessage();
+  m_output.average("sent_histograms", sendDelta ? changedNames.size() : mergedHistograms.getNames().size());
 
   if (m_outputBuffer.empty()) {
     m_outputBuffer.resize(m_maximalCompressedSize, 0);
@@ -180,11 +178,16 @@ void ZMQHistoServerToZMQOutput::mergeAndSend(const std::map<std::string, Histogr
   auto eventInformationString = TBufferJSON::ToJSON(&eventMetaData);
   zmq::message_t additionalEventMessage(eventInformationString.Data(), eventInformationString.Length());
 
-  auto zmqMessage = ZMQMessageFactory::createMessage(EMessageTypes::c_compressedDataMessage, std::move(message),
-                                                     std::move(additionalEventMessage));
+  const auto messageType = sendDelta ? EMessageTypes::c_compressedDeltaDataMessage : EMessageTypes::c_compressedDataMessage;
+  auto zmqMessage = ZMQMessageFactory::createMessage(messageType, std::move(message), std::move(additionalEventMessage));
   m_output.handleEvent(std::move(zmqMessage), true, 20000);
 }
 
+void ZMQHistoServerToZMQOutput::clear()
+{
+  m_deltaSelector.reset();
+}
+
 ZMQHistoServerToRawOutput::ZMQHistoServerToRawOutput(const std::string& outputAddress, const std::shared_ptr<ZMQParent>& parent) :
   m_output(outputAddress, false, parent)
 {
@@ -196,17 +199,18 @@ ZMQHistoServerToRawOutput::ZMQHistoServerToRawOutput(const std::string& outputAd
 }
 
 void ZMQHistoServerToRawOutput::mergeAndSend(const std::map<std::string, HistogramMapping>& storedMessages,
+                                             const HistogramMapping& mergedHistograms,
                                              const std::optional<unsigned int>& experiment,
                                              const std::optional<unsigned int>& run, EMessageTypes messageType)
 {
   if (messageType == EMessageTypes::c_lastEventMessage) {
     // merge one last time
-    mergeAndSend(storedMessages, experiment, run, EMessageTypes::c_eventMessage);
+    mergeAndSend(storedMessages, mergedHistograms, experiment, run, EMessageTypes::c_eventMessage);
     // but do not send out any message
     return;
   } else if (messageType == EMessageTypes::c_terminateMessage) {
     // merge one last time
-    mergeAndSend(storedMessages, experiment, run, EMessageTypes::c_eventMessage);
+    mergeAndSend(storedMessages, mergedHistograms, experiment, run, EMessageTypes::c_eventMessage);
     return;
   }
 
@@ -221,18 +225,11 @@ void ZMQHistoServerToRawOutput::mergeAndSend(const std::map<std::string, Histogr
 
   m_output.increment("histogram_merges");
 
-  HistogramMapping mergeHistograms;
-
   m_output.log("last_merged_histograms", static_cast<long>(storedMessages.size()));
   m_output.average("average_merged_histograms", static_cast<double>(storedMessages.size()));
   m_output.logTime("last_merge");
 
-  for (const auto& keyValue : storedMessages) {
-    const auto& histogram = keyValue.second;
-    mergeHistograms += histogram;
-  }
-
-  auto eventMessage = mergeHistograms.toMessage();
+  auto eventMessage = mergedHistograms.toMessage();
 
   m_output.average("size_before_compression", eventMessage->size());
 
@@ -60,26 +60,22 @@ void ZMQHistogramOutput<AConnectionClass>::handleEvent(std::unique_ptr<ZMQIdMess
   m_storedExperiment = eventMetaDataPtr->getExperiment();
   m_storedRun = eventMetaDataPtr->getRun();
 
-  if (message->isMessage(Belle2::EMessageTypes::c_compressedDataMessage)) {
-    int uncompressedSize = LZ4_decompress_safe(dataMessage.data<char>(), &m_uncompressedBuffer[0],
-                                               dataMessage.size(), m_maximalUncompressedBufferSize);
-    B2ASSERT("Decompression failed", uncompressedSize > 0);
-
-    std::unique_ptr<Belle2::EvtMessage> msg(new Belle2::EvtMessage(&m_uncompressedBuffer[0]));
-
-    AConnectionClass::average("uncompressed_size", msg->size());
-
-    B2DEBUG(10,
-            "After decompression, the size is " << uncompressedSize << " and the message itself says " << msg->size());
-    HistogramMapping histogram(std::move(msg));
+  if (message->isMessage(Belle2::EMessageTypes::c_compressedDeltaDataMessage)) {
+    // Only the changed histograms are included, all others stay as they are
+    HistogramMapping histogram = decompress(dataMessage);
+    const auto updatedNames = m_storedMessages[identity].update(std::move(histogram));
+    m_changedHistograms.insert(updatedNames.begin(), updatedNames.end());
+    AConnectionClass::increment("delta_updates");
+  } else if (message->isMessage(Belle2::EMessageTypes::c_compressedDataMessage)) {
+    HistogramMapping histogram = decompress(dataMessage);
     if (not histogram.empty()) {
-      m_storedMessages[identity] = std::move(histogram);
+      storeFullMessage(identity, std::move(histogram));
     }
   } else if (message->isMessage(Belle2::EMessageTypes::c_rawDataMessage)) {
     std::unique_ptr<Belle2::EvtMessage> msg(new Belle2::EvtMessage(dataMessage.data<char>()));
     HistogramMapping histogram(std::move(msg));
     if (not histogram.empty()) {
-      m_storedMessages[identity] = std::move(histogram);
+      storeFullMessage(identity, std::move(histogram));
     }
   } else {
     B2FATAL("Unknown message type!");
@@ -88,10 +84,58 @@ void ZMQHistogramOutput<AConnectionClass>::handleEvent(std::unique_ptr<ZMQIdMess
   AConnectionClass::log("stored_identities", static_cast<long>(m_storedMessages.size()));
 }
 
+template<class AConnectionClass>
+HistogramMapping ZMQHistogramOutput<AConnectionClass>::decompress(const zmq::message_t& dataMessage)
+{
+  int uncompressedSize = LZ4_decompress_safe(dataMessage.data<char>(), &m_uncompressedBuffer[0],
+                                             dataMessage.size(), m_maximalUncompressedBufferSize);
+  B2ASSERT("Decompression failed", uncompressedSize > 0);
+
+  std::unique_ptr<Belle2::EvtMessage> msg(new Belle2::EvtMessage(&m_uncompressedBuffer[0]));
+
+  AConnectionClass::average("uncompressed_size", msg->size());
+
+  B2DEBUG(10,
+          "After decompression, the size is " << uncompressedSize << " and the message itself says " << msg->size());
+  return HistogramMapping(std::move(msg));
+}
+
+template<class AConnectionClass>
+void ZMQHistogramOutput<AConnectionClass>::storeFullMessage(const std::string& identity, HistogramMapping&& histograms)
+{
+  // A new exporter of a shared histogram store (e.g. after a crashed worker) sends the same shared
+  // histograms as the previous one, whose copy must not be merged a second time
+  const std::string& sharedStoreID = histograms.getSharedStoreID();
+  if (not sharedStoreID.empty()) {
+    for (auto& [otherIdentity, otherHistograms] : m_storedMessages) {
+      if (otherIdentity != identity and otherHistograms.getSharedStoreID() == sharedStoreID) {
+        const auto removedNames = otherHistograms.removeSharedHistograms();
+        m_changedHistograms.insert(removedNames.begin(), removedNames.end());
+        AConnectionClass::increment("shared_histogram_takeovers");
+      }
+    }
+  }
+
+  // Histograms only present in the old message need to be removed from the merged result, so they are changed as well
+  auto& storedHistograms = m_storedMessages[identity];
+  const auto oldNames = storedHistograms.getNames();
+  const auto newNames = histograms.getNames();
+  m_changedHistograms.insert(oldNames.begin(), oldNames.end());
+  m_changedHistograms.insert(newNames.begin(), newNames.end());
+
+  storedHistograms = std::move(histograms);
+}
+
 template<class AConnectionClass>
 void ZMQHistogramOutput<AConnectionClass>::mergeAndSend(EMessageTypes messageType)
 {
-  AConnectionClass::mergeAndSend(m_storedMessages, m_storedExperiment, m_storedRun, messageType);
+  AConnectionClass::average("remerged_histograms", static_cast<double>(m_changedHistograms.size()));
+  for (const auto& name : m_changedHistograms) {
+    m_mergedHistograms.mergeHistogram(name, m_storedMessages);
+  }
+  m_changedHistograms.clear();
+
+  AConnectionClass::mergeAndSend(m_storedMessages, m_mergedHistograms, m_storedExperiment, m_storedRun, messageType);
 }
 
 template<class AConnectionClass>
@@ -103,6 +147,8 @@ void ZMQHistogramOutput<AConnectionClass>::clear()
   AConnectionClass::clear();
 
   m_storedMessages.clear();
+  m_mergedHistograms.clear();
+  m_changedHistograms.clear();
   m_storedExperiment.reset();
   m_storedRun.reset();
 }
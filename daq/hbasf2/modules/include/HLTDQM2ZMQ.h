@@ -33,12 +33,18 @@ namespace Belle2 {
    * so all the usual conventions for a confirmed connection apply.
    * This module does only makes sense to run on the HLT, it is not useful for local
    * file writeout.
+   * Optionally, a SharedHistogramStore is created before the workers are forked. Histograms
+   * registered there are filled by all workers directly and only sent out by one of them.
+   * They are reset for a new run once all workers have finished the previous one.
    */
   class HLTDQM2ZMQModule : public Module {
   public:
     /// Register the module parameters
     HLTDQM2ZMQModule();
 
+    /// Create the shared histogram store (if requested). This happens before forking.
+    void initialize() override;
+
     /**
      * On the first event, initialize the connection and the streamer.
      * If the write out interval time is reached, serialize all defined histograms and
@@ -52,7 +58,7 @@ namespace Belle2 {
     /// Stream the histograms one last time and send out a run end message. We rely on all histogram modules to clear their own state.
     void endRun() override;
 
-    /// Call the defineHisto function of all histogram modules registered at the RbTupleManager singleton.
+    /// Reset the shared histograms for a new run and call the defineHisto function of all histogram modules registered at the RbTupleManager singleton.
     void beginRun() override;
 
     /// Stream the histograms one last time and send out a terminate message. We rely on all histogram modules to clear their own state.
@@ -63,6 +69,8 @@ namespace Belle2 {
     std::string m_param_output;
     /// Module parameter: send out interval in seconds
     unsigned int m_param_sendOutInterval = 30;
+    /// Module parameter: size of the shared histogram memory in MB (0 disables it)
+    unsigned int m_param_sharedHistogramMemorySize = 0;
 
     /// ZMQ Parent needed for the connections
     std::shared_ptr<ZMQParent> m_parent;
@@ -82,5 +90,7 @@ namespace Belle2 {
 
     /// Helper function to serialize and send out the histograms
     void sendOutHistograms();
+    /// Tell the shared histogram store that this worker is done with the current run
+    void markEndOfRun();
   };
 }
\ No newline at end of file
@@ -8,7 +8,11 @@
 #include <daq/hbasf2/modules/HLTDQM2ZMQ.h>
 #include <framework/pcore/zmq/messages/ZMQMessageFactory.h>
 #include <framework/pcore/RbTuple.h>
+#include <framework/pcore/SharedHistogramStore.h>
 #include <framework/core/HistoModule.h>
+#include <framework/core/Environment.h>
+
+#include <algorithm>
 
 using namespace std;
 using namespace Belle2;
@@ -28,7 +32,9 @@ HLTDQM2ZMQModule::HLTDQM2ZMQModule() : Module()
     "The histogram sending is handled via a confirmed connection (output in this case), "
     "so all the usual conventions for a confirmed connection apply. "
     "This module does only makes sense to run on the HLT, it is not useful for local "
-    "file writeout."
+    "file writeout. "
+    "Optionally, a shared histogram memory is created before the workers are forked. Histograms "
+    "registered there are filled by all workers directly and only sent out by one of them."
   );
   setPropertyFlags(EModulePropFlags::c_ParallelProcessingCertified);
 
@@ -37,6 +43,20 @@ HLTDQM2ZMQModule::HLTDQM2ZMQModule() : Module()
            "Please note that the full stack of DQM histo servers"
            "could delay this, as each of them have a timeout.",
            m_param_sendOutInterval);
+  addParam("sharedHistogramMemorySize", m_param_sharedHistogramMemorySize,
+           "Size in MB of the shared memory for histograms registered in the SharedHistogramStore. "
+           "0 disables the shared histograms.",
+           m_param_sharedHistogramMemorySize);
+}
+
+void HLTDQM2ZMQModule::initialize()
+{
+  if (m_param_sharedHistogramMemorySize > 0) {
+    auto& sharedHistogramStore = SharedHistogramStore::Instance();
+    sharedHistogramStore.create(static_cast<std::size_t>(m_param_sharedHistogramMemorySize) * 1024 * 1024);
+    // The bins are only reset for a new run once all workers are done with the previous one
+    sharedHistogramStore.setNumberOfProcesses(std::max(Environment::Instance().getNumberProcesses(), 1));
+  }
 }
 
 void HLTDQM2ZMQModule::event()
@@ -70,6 +90,10 @@ void HLTDQM2ZMQModule::event()
 
 void HLTDQM2ZMQModule::beginRun()
 {
+  if (m_eventMetaData.isValid()) {
+    SharedHistogramStore::Instance().beginRun(m_eventMetaData->getExperiment(), m_eventMetaData->getRun());
+  }
+
   if (m_histogramsDefined) {
     return;
   }
@@ -87,12 +111,15 @@ void HLTDQM2ZMQModule::beginRun()
 void HLTDQM2ZMQModule::endRun()
 {
   if (m_firstEvent) {
+    markEndOfRun();
     return;
   }
 
   try {
     B2DEBUG(10, "Sending out old run message");
     sendOutHistograms();
+    // Only after the last sending, so the shared histograms of this run are not reset before
+    markEndOfRun();
     auto message = ZMQMessageFactory::createMessage(EMessageTypes::c_lastEventMessage);
     m_output->handleEvent(std::move(message), false, 1000);
   } catch (zmq::error_t& error) {
@@ -118,6 +145,7 @@ void HLTDQM2ZMQModule::terminate()
     B2DEBUG(10, "Sending out terminate message");
     auto message = ZMQMessageFactory::createMessage(EMessageTypes::c_terminateMessage);
     m_output->handleEvent(std::move(message));
+    SharedHistogramStore::Instance().releaseExportLease();
   } catch (zmq::error_t& error) {
     if (error.num() == EINTR) {
       // Well, that is probably ok. It will be handled by the framework, just go out here.
@@ -129,6 +157,13 @@ void HLTDQM2ZMQModule::terminate()
   }
 }
 
+void HLTDQM2ZMQModule::markEndOfRun()
+{
+  if (m_eventMetaData.isValid()) {
+    SharedHistogramStore::Instance().endRun(m_eventMetaData->getExperiment(), m_eventMetaData->getRun());
+  }
+}
+
 void HLTDQM2ZMQModule::sendOutHistograms()
 {
   if (m_firstEvent) {
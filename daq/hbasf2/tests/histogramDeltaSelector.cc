@@ -0,0 +1,110 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+#include <daq/hbasf2/utils/HistogramDeltaSelector.h>
+#include <framework/pcore/MsgHandler.h>
+
+#include <TH1D.h>
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+using namespace Belle2;
+
+namespace {
+  /// Create the merged histograms of a histogram server, each filled once with the given value
+  HistogramMapping createHistograms(const std::map<std::string, double>& values)
+  {
+    MsgHandler msgHandler;
+    std::map<std::string, std::unique_ptr<TH1D>> histograms;
+    for (const auto& [name, value] : values) {
+      auto& histogram = histograms[name] = std::make_unique<TH1D>(name.c_str(), name.c_str(), 10, 0, 10);
+      histogram->SetDirectory(nullptr);
+      histogram->Fill(value);
+      msgHandler.add(histogram.get(), name);
+    }
+    return HistogramMapping(std::unique_ptr<EvtMessage>(msgHandler.encode_msg(MSG_EVENT)));
+  }
+
+  /// Without delta transport all histograms are sent every time
+  TEST(HistogramDeltaSelectorTest, NoDeltaTransport)
+  {
+    HistogramDeltaSelector selector(false, 3);
+    const auto histograms = createHistograms({{"a", 1}, {"b", 2}});
+
+    std::set<std::string> changedNames;
+    for (int sending = 0; sending < 5; sending++) {
+      EXPECT_FALSE(selector.selectDelta(histograms, changedNames));
+    }
+  }
+
+  /// A delta only includes the changed histograms, unchanged histograms are not sent at all
+  TEST(HistogramDeltaSelectorTest, ChangedHistograms)
+  {
+    HistogramDeltaSelector selector(true, 10);
+    std::set<std::string> changedNames;
+
+    // The first sending includes everything
+    EXPECT_FALSE(selector.selectDelta(createHistograms({{"a", 1}, {"b", 2}}), changedNames));
+
+    // Nothing has changed, so the sending can be skipped
+    EXPECT_TRUE(selector.selectDelta(createHistograms({{"a", 1}, {"b", 2}}), changedNames));
+    EXPECT_TRUE(changedNames.empty());
+
+    // Only the changed histogram is sent
+    EXPECT_TRUE(selector.selectDelta(createHistograms({{"a", 1}, {"b", 3}}), changedNames));
+    EXPECT_EQ(changedNames, std::set<std::string>({"b"}));
+
+    // New histograms are sent as well
+    EXPECT_TRUE(selector.selectDelta(createHistograms({{"a", 1}, {"b", 3}, {"c", 4}}), changedNames));
+    EXPECT_EQ(changedNames, std::set<std::string>({"c"}));
+
+    // The change has been sent already
+    EXPECT_TRUE(selector.selectDelta(createHistograms({{"a", 1}, {"b", 3}, {"c", 4}}), changedNames));
+    EXPECT_TRUE(changedNames.empty());
+  }
+
+  /// Every fullUpdateInterval-th sending includes all histograms, the following deltas are relative to it
+  TEST(HistogramDeltaSelectorTest, FullUpdateInterval)
+  {
+    HistogramDeltaSelector selector(true, 3);
+    std::set<std::string> changedNames;
+
+    for (int update = 0; update < 3; update++) {
+      EXPECT_FALSE(selector.selectDelta(createHistograms({{"a", 1}, {"b", update}}), changedNames));
+      EXPECT_TRUE(selector.selectDelta(createHistograms({{"a", 1}, {"b", update}}), changedNames));
+      EXPECT_TRUE(changedNames.empty());
+      EXPECT_TRUE(selector.selectDelta(createHistograms({{"a", 1}, {"b", update}}), changedNames));
+      EXPECT_TRUE(changedNames.empty());
+    }
+  }
+
+  /// After a reset (at the beginning of a new run) everything is sent again, even if it has not changed
+  TEST(HistogramDeltaSelectorTest, Reset)
+  {
+    HistogramDeltaSelector selector(true, 10);
+    std::set<std::string> changedNames;
+    const auto histograms = createHistograms({{"a", 1}, {"b", 2}});
+
+    EXPECT_FALSE(selector.selectDelta(histograms, changedNames));
+    EXPECT_TRUE(selector.selectDelta(histograms, changedNames));
+    EXPECT_TRUE(changedNames.empty());
+
+    selector.reset();
+    EXPECT_FALSE(selector.selectDelta(histograms, changedNames));
+
+    // The deltas after the reset are relative to the full update after it
+    EXPECT_TRUE(selector.selectDelta(histograms, changedNames));
+    EXPECT_TRUE(changedNames.empty());
+    EXPECT_TRUE(selector.selectDelta(createHistograms({{"a", 5}, {"b", 2}}), changedNames));
+    EXPECT_EQ(changedNames, std::set<std::string>({"a"}));
+  }
+}
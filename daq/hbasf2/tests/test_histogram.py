@@ -330,6 +330,84 @@ class HistogramStopTestCase(HLTZMQTestCase):
         self.assertIsDown("histoserver")
 
 
+class HistogramDeltaTestCase(HLTZMQTestCase):
+    """Test case for the delta (only changed histograms) messages"""
+    #: input_port
+    input_port = HLTZMQTestCase.get_free_port()
+    #: monitoring_port
+    monitoring_port = HLTZMQTestCase.get_free_port()
+
+    #: needed_programs
+    needed_programs = {"histoserver": ["b2hlt_finalhistoserver", "--input", f"tcp://*:{input_port}",
+                                       "--rootFileName", "outputFile.root",
+                                       "--timeout", "0",  # we remove the timeout on purpose
+                                       "--monitor", f"tcp://*:{monitoring_port}"],
+                       }
+
+    #: histogram_data
+    histogram_data = HistogramStopTestCase.histogram_data
+    #: event_data
+    event_data = HistogramStopTestCase.event_data
+
+    def testDeltaMessages(self):
+        """test function"""
+        monitoring_socket = self.create_socket(self.monitoring_port)
+
+        input_socket = self.create_socket(self.input_port)
+        self.send(input_socket, "h")
+        self.assertIsMsgType(input_socket, "c")
+
+        second_input_socket = self.create_socket(self.input_port, identity="other_socket")
+        self.send(second_input_socket, "h")
+        self.assertIsMsgType(second_input_socket, "c")
+
+        # Full messages from both clients
+        self.send(input_socket, "v", self.histogram_data, self.event_data)
+        self.assertIsMsgType(input_socket, "c")
+        self.send(second_input_socket, "v", self.histogram_data, self.event_data)
+        self.assertIsMsgType(second_input_socket, "c")
+
+        # Delta messages only replace the histograms of their sender, so they do not add up
+        for _ in range(3):
+            self.send(input_socket, "p", self.histogram_data, self.event_data)
+            self.assertIsMsgType(input_socket, "c")
+
+        self.assertMonitoring(monitoring_socket, "output.delta_updates", 3)
+
+        self.send(input_socket, "l")
+        self.assertIsMsgType(input_socket, "c")
+        self.send(second_input_socket, "l")
+        self.assertIsMsgType(second_input_socket, "c")
+
+        self.assertMonitoring(monitoring_socket, "input.all_stop_messages", True)
+        self.assertHasOutputFile("outputFile.root", unlink=False)
+        self.assertTrue(check_histogram_output("outputFile.root", 2))
+
+        # After a reset, a delta message without a previous full message is also fine
+        self.send(monitoring_socket, "n")
+        self.assertMonitoring(monitoring_socket, "input.all_stop_messages", False)
+
+        self.send(input_socket, "p", self.histogram_data, self.event_data)
+        self.assertIsMsgType(input_socket, "c")
+        self.send(second_input_socket, "v", self.histogram_data, self.event_data)
+        self.assertIsMsgType(second_input_socket, "c")
+
+        self.send(input_socket, "l")
+        self.assertIsMsgType(input_socket, "c")
+        self.send(second_input_socket, "l")
+        self.assertIsMsgType(second_input_socket, "c")
+
+        self.assertHasOutputFile("outputFile.root", unlink=False)
+        self.assertTrue(check_histogram_output("outputFile.root", 2))
+
+        self.send(input_socket, "x")
+        self.assertIsMsgType(input_socket, "c")
+        self.send(second_input_socket, "x")
+        self.assertIsMsgType(second_input_socket, "c")
+
+        self.assertIsDown("histoserver")
+
+
 if __name__ == '__main__':
     #: Number of failed for loops
     number_of_failures = 0
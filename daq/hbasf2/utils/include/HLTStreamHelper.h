@@ -46,7 +46,10 @@ namespace Belle2 {
     /// Stream the data store into an event message and add SendHeader and SendTrailer around the message. Add ROI as additional message (if valid).
     std::unique_ptr<ZMQNoIdMessage> streamRaw();
 
-    /// Stream all objects derived from TH1 into a message. Only the last subfolder is streamed by prefixing the histogram names with "<subfolder>/".
+    /**
+     * Stream all objects derived from TH1 into a message. Only the last subfolder is streamed by prefixing the histogram names with "<subfolder>/".
+     * If this process holds the export lease of the SharedHistogramStore, the shared histograms are added as well.
+     */
     std::unique_ptr<ZMQNoIdMessage> streamHistograms(bool compressed = true);
 
     /// Read in a ZMQ message and rebuilt the data store from it.
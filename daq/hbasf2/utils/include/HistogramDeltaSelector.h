@@ -0,0 +1,50 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+#pragma once
+
+#include <daq/hbasf2/utils/HistogramMapping.h>
+
+#include <map>
+#include <set>
+#include <string>
+
+namespace Belle2 {
+  /**
+   * Decide which of the merged histograms a histogram server sends out.
+   *
+   * Without delta transport, every sending includes all histograms.
+   * With delta transport, only the histograms whose content changed since they were last sent are included,
+   * except for every fullUpdateInterval-th sending and the first sending after a reset (e.g. at a new run),
+   * which include all histograms, so a restarted receiver is complete again after a while.
+   */
+  class HistogramDeltaSelector {
+  public:
+    /// Create a new selector
+    HistogramDeltaSelector(bool deltaTransport, unsigned int fullUpdateInterval);
+
+    /**
+     * Decide what to send of the given histograms and remember their content as sent.
+     * Returns false if all histograms need to be sent. Otherwise, only the histograms in changedNames
+     * need to be sent, if it is empty the sending can be skipped.
+     */
+    bool selectDelta(const HistogramMapping& histograms, std::set<std::string>& changedNames);
+
+    /// Forget what was sent, so the next sending includes all histograms
+    void reset();
+
+  private:
+    /// Send only changed histograms?
+    bool m_deltaTransport;
+    /// Send all histograms every this many sendings
+    unsigned int m_fullUpdateInterval;
+    /// Number of sendings since the last full update (or 0 if the next sending should be a full update)
+    unsigned int m_sendingsSinceFullUpdate = 0;
+    /// Checksums of the histogram contents at their last sending
+    std::map<std::string, std::size_t> m_sentChecksums;
+  };
+}
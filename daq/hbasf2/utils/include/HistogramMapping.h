@@ -13,6 +13,7 @@
 #include <string>
 #include <memory>
 #include <map>
+#include <set>
 
 namespace Belle2 {
   /**
@@ -22,9 +23,21 @@ namespace Belle2 {
    * server for merging the received histogram messages.
    * Internally, the tree structure is stored as a mapping name -> TH1 (unique) pointer,
    * where folder structure is mapped via "/" in the name.
+   *
+   * For the delta transport, only a subset of the histograms can be serialized
+   * (the ones which changed since the last sending) and the received subset can be used
+   * to update an already existing mapping. The merged result can be rebuilt histogram by histogram,
+   * so only the changed histograms need to be summed up again.
+   *
+   * Histograms exported from a SharedHistogramStore are marked by an additional object
+   * (see c_sharedHistogramMarker) holding the id of the store and the names of the
+   * histograms, so the server can drop the copy of a previous exporter.
    */
   class HistogramMapping {
   public:
+    /// Name of the object marking the shared histograms. Its title holds the store id and the histogram names, one per line.
+    static constexpr const char* c_sharedHistogramMarker = "__SharedHistogramStore__";
+
     /// As this is a heavy object, make sure to not copy
     HistogramMapping& operator=(const HistogramMapping& rhs) = delete;
     /// Moving is allowed
@@ -41,7 +54,24 @@ namespace Belle2 {
     /// Add another histogramm tree instance by merging all histograms with the same name.
     void operator+=(const HistogramMapping& rhs);
 
-    /// Write out all stored histograms in the currently selected ROOT gDirectory
+    /// Replace (or add) all histograms of rhs in this mapping. Returns the names of the replaced/added histograms.
+    std::set<std::string> update(HistogramMapping&& rhs);
+    /// Rebuild the histogram with the given name as the sum of all histograms with this name in the given mappings.
+    void mergeHistogram(const std::string& name, const std::map<std::string, HistogramMapping>& mappings);
+
+    /// Return the names of all stored histograms
+    std::set<std::string> getNames() const;
+    /// Return the id of the SharedHistogramStore the marked histograms come from (empty if there are none)
+    const std::string& getSharedStoreID() const { return m_sharedStoreID; }
+    /// Remove the histograms exported from a SharedHistogramStore and return their names
+    std::set<std::string> removeSharedHistograms();
+    /**
+     * Return the names of all histograms whose content differs from the checksums in lastChecksums
+     * (or which are not in there) and update the checksums to the current state.
+     */
+    std::set<std::string> getChangedNames(std::map<std::string, std::size_t>& lastChecksums) const;
+
+    /// Write out all stored histograms in the currently selected ROOT gDirectory. The histograms are detached from the directory afterwards.
     void write() const;
     /// Clear all histograms in the internal map also deleting the pointers
     void clear();
@@ -49,11 +79,17 @@ namespace Belle2 {
     void printMe() const;
     /// Construct an EvtMessage by serializing the content of the internal histogram storage. Will not invalidate the histograms.
     std::unique_ptr<Belle2::EvtMessage> toMessage() const;
+    /// Same as toMessage, but only serialize the histograms with the given names
+    std::unique_ptr<Belle2::EvtMessage> toMessage(const std::set<std::string>& names) const;
     /// Check if there are no stored histograms
     bool empty() const;
 
   private:
     /// Internal storage of the histograms in the form name -> unique TH1 pointer
     std::map<std::string, std::unique_ptr<TH1>> m_histograms;
+    /// Id of the SharedHistogramStore the shared histograms come from
+    std::string m_sharedStoreID;
+    /// Names of the histograms exported from the SharedHistogramStore
+    std::set<std::string> m_sharedNames;
   };
 }
\ No newline at end of file
@@ -6,12 +6,15 @@
  * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
  **************************************************************************/
 #include <daq/hbasf2/utils/HLTStreamHelper.h>
+#include <daq/hbasf2/utils/HistogramMapping.h>
 #include <framework/pcore/zmq/messages/ZMQMessageFactory.h>
 #include <framework/pcore/MsgHandler.h>
+#include <framework/pcore/SharedHistogramStore.h>
 #include <daq/dataobjects/SendHeader.h>
 #include <daq/dataobjects/SendTrailer.h>
 
 #include <TH1F.h>
+#include <TNamed.h>
 #include <TFile.h>
 #include <TDirectory.h>
 #include <TKey.h>
@@ -157,6 +160,19 @@ std::unique_ptr<ZMQNoIdMessage> HLTStreamHelper::streamHistograms(bool compresse
   Belle2::MsgHandler msgHandler;
   streamHistogramImpl(gDirectory, msgHandler);
 
+  // Histograms in the shared memory are filled by all workers together, so only one of them sends them out
+  auto& sharedHistogramStore = SharedHistogramStore::Instance();
+  if (sharedHistogramStore.acquireExportLease()) {
+    std::string sharedHistograms = std::to_string(sharedHistogramStore.getStoreID());
+    for (TH1* histogram : sharedHistogramStore.snapshot()) {
+      msgHandler.add(histogram, histogram->GetName());
+      sharedHistograms += std::string("\n") + histogram->GetName();
+    }
+    // Lets the histogram server replace the shared histograms of a previous exporter
+    TNamed marker(HistogramMapping::c_sharedHistogramMarker, sharedHistograms.c_str());
+    msgHandler.add(&marker, marker.GetName());
+  }
+
   auto evtMessage = std::unique_ptr<EvtMessage>(msgHandler.encode_msg(Belle2::ERecordType::MSG_EVENT));
 
   EventMetaData& eventMetaData = *m_eventMetaData;
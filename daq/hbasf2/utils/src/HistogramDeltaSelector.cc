@@ -0,0 +1,34 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+#include <daq/hbasf2/utils/HistogramDeltaSelector.h>
+
+using namespace Belle2;
+
+HistogramDeltaSelector::HistogramDeltaSelector(bool deltaTransport, unsigned int fullUpdateInterval) :
+  m_deltaTransport(deltaTransport), m_fullUpdateInterval(fullUpdateInterval)
+{
+}
+
+bool HistogramDeltaSelector::selectDelta(const HistogramMapping& histograms, std::set<std::string>& changedNames)
+{
+  bool sendDelta = m_deltaTransport and m_sendingsSinceFullUpdate > 0 and m_sendingsSinceFullUpdate < m_fullUpdateInterval;
+  if (not sendDelta) {
+    m_sendingsSinceFullUpdate = 0;
+  }
+  m_sendingsSinceFullUpdate++;
+
+  // Always update the checksums, so a delta after a full update only includes the changes since then
+  changedNames = histograms.getChangedNames(m_sentChecksums);
+  return sendDelta;
+}
+
+void HistogramDeltaSelector::reset()
+{
+  m_sentChecksums.clear();
+  m_sendingsSinceFullUpdate = 0;
+}
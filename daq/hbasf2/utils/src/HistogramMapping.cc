@@ -11,8 +11,12 @@
 #include <framework/logging/Logger.h>
 
 #include <boost/range/combine.hpp>
+#include <boost/functional/hash.hpp>
 
 #include <TDirectory.h>
+#include <TNamed.h>
+
+#include <sstream>
 
 using namespace Belle2;
 
@@ -32,6 +36,16 @@ HistogramMapping::HistogramMapping(std::unique_ptr<Belle2::EvtMessage> msg)
     TObject* object;
     boost::tie(key, object) = keyValue;
 
+    if (key == c_sharedHistogramMarker) {
+      std::istringstream lines(object->GetTitle());
+      std::getline(lines, m_sharedStoreID);
+      for (std::string name; std::getline(lines, name);) {
+        m_sharedNames.insert(name);
+      }
+      delete object;
+      continue;
+    }
+
     TH1* histogram = dynamic_cast<TH1*>(object);
     if (histogram == nullptr) {
       B2WARNING("Object " << key << " is not a histogram!");
@@ -60,17 +74,97 @@ void HistogramMapping::operator+=(const HistogramMapping& rhs)
   }
 }
 
+std::set<std::string> HistogramMapping::update(HistogramMapping&& rhs)
+{
+  std::set<std::string> updatedNames;
+  for (auto& [key, histogram] : rhs.m_histograms) {
+    updatedNames.insert(key);
+    m_histograms[key] = std::move(histogram);
+  }
+  rhs.clear();
+  return updatedNames;
+}
+
+void HistogramMapping::mergeHistogram(const std::string& name, const std::map<std::string, HistogramMapping>& mappings)
+{
+  m_histograms.erase(name);
+
+  for (const auto& [_, mapping] : mappings) {
+    auto rhsIterator = mapping.m_histograms.find(name);
+    if (rhsIterator == mapping.m_histograms.end()) {
+      continue;
+    }
+    const auto& histogram = rhsIterator->second;
+
+    auto lhsIterator = m_histograms.find(name);
+    if (lhsIterator == m_histograms.end()) {
+      auto* copiedHistogram = dynamic_cast<TH1*>(histogram->Clone());
+      // The merged histograms are kept between merges, so they must not be owned by any directory
+      copiedHistogram->SetDirectory(nullptr);
+      m_histograms.insert({name, std::unique_ptr<TH1>(copiedHistogram)});
+    } else {
+      lhsIterator->second->Add(histogram.get());
+    }
+  }
+}
+
+std::set<std::string> HistogramMapping::getNames() const
+{
+  std::set<std::string> names;
+  for (const auto& [key, _] : m_histograms) {
+    names.insert(key);
+  }
+  return names;
+}
+
+std::set<std::string> HistogramMapping::removeSharedHistograms()
+{
+  std::set<std::string> removedNames;
+  for (const auto& name : m_sharedNames) {
+    if (m_histograms.erase(name) > 0) {
+      removedNames.insert(name);
+    }
+  }
+  m_sharedNames.clear();
+  m_sharedStoreID.clear();
+  return removedNames;
+}
+
+std::set<std::string> HistogramMapping::getChangedNames(std::map<std::string, std::size_t>& lastChecksums) const
+{
+  std::set<std::string> changedNames;
+  for (const auto& [key, histogram] : m_histograms) {
+    std::size_t checksum = 0;
+    boost::hash_combine(checksum, histogram->GetEntries());
+    const int nCells = histogram->GetNcells();
+    for (int bin = 0; bin < nCells; bin++) {
+      boost::hash_combine(checksum, histogram->GetBinContent(bin));
+    }
+
+    auto lastChecksum = lastChecksums.find(key);
+    if (lastChecksum == lastChecksums.end() or lastChecksum->second != checksum) {
+      changedNames.insert(key);
+      lastChecksums[key] = checksum;
+    }
+  }
+  return changedNames;
+}
+
 void HistogramMapping::write() const
 {
   for (const auto& [_, histogram] : m_histograms) {
     histogram->SetDirectory(gDirectory);
     histogram->Write();
+    // Make sure closing the directory does not delete our histogram
+    histogram->SetDirectory(nullptr);
   }
 }
 
 void HistogramMapping::clear()
 {
   m_histograms.clear();
+  m_sharedNames.clear();
+  m_sharedStoreID.clear();
 }
 
 bool HistogramMapping::empty() const
@@ -86,12 +180,21 @@ void HistogramMapping::printMe() const
 }
 
 std::unique_ptr<Belle2::EvtMessage> HistogramMapping::toMessage() const
+{
+  return toMessage(getNames());
+}
+
+std::unique_ptr<Belle2::EvtMessage> HistogramMapping::toMessage(const std::set<std::string>& names) const
 {
   Belle2::MsgHandler msgHandler;
 
   int objectCounter = 0;
-  for (const auto& [key, histogram] : m_histograms) {
-    msgHandler.add(histogram.get(), key);
+  for (const auto& name : names) {
+    auto iterator = m_histograms.find(name);
+    if (iterator == m_histograms.end()) {
+      continue;
+    }
+    msgHandler.add(iterator->second.get(), name);
     objectCounter++;
   }
 
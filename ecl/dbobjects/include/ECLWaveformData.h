@@ -214,6 +214,25 @@ namespace Belle2 {
       }
     }
 
+    /** sampling n random vectors from the 31-dimensional multivariate normal distribution with covariance matrix C at once.
+     *  The vectors are stored component by component: component i of vector k is z[i * n + k] (x[i * n + k]).
+     *  The result is identical to n calls of generateCorrelatedNoise for single vectors, but the inner
+     *  loop runs over the vectors and can be vectorized by the compiler.
+     */
+    void generateCorrelatedNoise(int n, const float* z, float* x) const
+    {
+      const float* A = m_matrixElement;
+      for (int i = 0; i < 31; i++) {
+        float* xi = x + i * n;
+        for (int k = 0; k < n; k++) xi[k] = 0;
+        for (int j = 0; j <= i; j++) {
+          const float a = *A++;
+          const float* zj = z + j * n;
+          for (int k = 0; k < n; k++) xi[k] += zj[k] * a;
+        }
+      }
+    }
+
     static const size_t c_nElements = 496; /**< number of independent elements */
 
     Float_t m_matrixElement[c_nElements]; /**< electronic noise matrix */
@@ -0,0 +1,272 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#pragma once
+
+/* C++ headers. */
+#include <vector>
+
+namespace Belle2 {
+
+  /**
+   * Struct to keep upper triangle of the covariance matrix. Since the
+   * matrix is already inverted we do not need extra precision, so
+   * keep matrix elements in float type to save space.
+   * sigma is the average noise.
+   */
+  struct CovariancePacked {
+
+    /** Packed matrix. */
+    float m_covMatPacked[31 * (31 + 1) / 2] = {};
+
+    /** Sigma noise. */
+    float sigma{ -1};
+
+    /** Lvalue access by index. */
+    float& operator[](int i) { return m_covMatPacked[i];}
+
+    /** Rvalue access by index. */
+    const float& operator[](int i) const { return m_covMatPacked[i];}
+  };
+
+  /**
+   * Interpolation of signal shape using function values and
+   * the first derivative.
+   */
+  struct SignalInterpolation2 {
+
+    /**
+     * Signal function is sampled in c_nt time steps with c_ndt substeps
+     * and c_ntail steps. c_dt is the time step.
+     */
+    constexpr static int c_nt = 12;
+
+    /** Number of substeps. */
+    constexpr static int c_ndt = 5;
+
+    /** Number of tail steps. */
+    constexpr static int c_ntail = 20;
+
+    /** Time step. */
+    constexpr static double c_dt = 0.5;
+
+    /** Inverted time step */
+    constexpr static double c_idt = 1 / c_dt;
+
+    /** Time substep. */
+    constexpr static double c_dtn = c_dt / c_ndt;
+
+    /** Inverted time substep. */
+    constexpr static double c_idtn = c_ndt / c_dt;
+
+    /** Function values. */
+    double m_FunctionInterpolation[c_nt * c_ndt + c_ntail];
+
+    /** Derivative values. */
+    double m_DerivativeInterpolation[c_nt * c_ndt + c_ntail];
+
+    /**
+     * Assuming exponential drop of the signal function far away from 0,
+     * extrapolate it to +inf.
+     * f(i_last + i) = f(i_last)*m_r0^i
+     * f'(i_last + i) = f'(i_last)*m_r1^i
+     * where i_last is the last point within sampled values in
+     * m_FunctionInterpolation (m_DerivativeInterpolation).
+     */
+    double m_r0;
+
+    /** See above/ */
+    double m_r1;
+
+    /**
+     * Default constructor.
+     */
+    SignalInterpolation2() {};
+
+    /**
+     * Constructor with parameters with the parameter layout as
+     * in ECLDigitWaveformParameters.
+     */
+    explicit SignalInterpolation2(const std::vector<double>&);
+
+    /**
+     * Returns signal shape and derivatives in 31 equidistant time points
+     * starting from t0.
+     * @param[in]  t0          Time.
+     * @param[out] function    Function values.
+     * @param[out] derivatives Derivatives.
+     */
+    void getShape(double t0, double* function, double* derivatives) const;
+
+  };
+
+  namespace ECL {
+
+    /**
+     * Offline fit of ECL waveforms with the template model
+     * pedestal + photon template + hadron (or diode) template [+ background photon template].
+     *
+     * The model is linear in the pedestal and the amplitudes. For given signal times they are
+     * obtained directly from the weighted linear least squares problem, taking into account
+     * their bounds with an active set method. Only the times are iterated, with a damped
+     * Gauss-Newton (Levenberg-Marquardt) step of the times computed from the Jacobian of all
+     * parameters. The start values and the parameter bounds are the same as in the former
+     * MINUIT fits.
+     *
+     * The fitter keeps no global state and does not allocate memory, one object
+     * per thread can be used.
+     */
+    class ECLWaveformTemplateFitter {
+
+    public:
+
+      /** Number of fit points. */
+      static constexpr int c_NFitPoints = 31;
+
+      /** Fit result. */
+      struct Result {
+
+        /** Pedestal. */
+        double pedestal = 0;
+
+        /** Photon amplitude. */
+        double amplitudePhoton = 0;
+
+        /** Signal time. */
+        double signalTime = 0;
+
+        /** Hadron (or diode) amplitude. */
+        double amplitudeHadron = 0;
+
+        /** Background-photon amplitude. */
+        double amplitudeBackgroundPhoton = 0;
+
+        /** Background-photon time. */
+        double timeBackgroundPhoton = 0;
+
+        /** Chi-squared. */
+        double chi2 = -1;
+
+        /** Number of accepted time steps. */
+        int nIterations = 0;
+
+      };
+
+      /**
+       * Sets the inverse covariance matrix of the fit points.
+       * @param[in] packed Inverse covariance matrix in packed form.
+       */
+      void setInverseCovariance(const CovariancePacked& packed);
+
+      /**
+       * Fit with photon and hadron templates.
+       * @param[in]  adc    ADC values of the c_NFitPoints fit points.
+       * @param[in]  photon Photon template.
+       * @param[in]  hadron Hadron (or diode) template.
+       * @param[out] result Fit result.
+       */
+      void fitPhotonHadron(const double* adc, const SignalInterpolation2& photon,
+                           const SignalInterpolation2& hadron, Result& result);
+
+      /**
+       * Fit with photon, hadron, and background photon templates.
+       * @param[in]  adc    ADC values of the c_NFitPoints fit points.
+       * @param[in]  photon Photon template, also used for the background photon.
+       * @param[in]  hadron Hadron template.
+       * @param[out] result Fit result.
+       */
+      void fitPhotonHadronBackgroundPhoton(const double* adc, const SignalInterpolation2& photon,
+                                           const SignalInterpolation2& hadron, Result& result);
+
+    private:
+
+      /** Maximal number of linear parameters (pedestal and amplitudes). */
+      static constexpr int c_MaxLinear = 4;
+
+      /** Maximal number of times. */
+      static constexpr int c_MaxTimes = 2;
+
+      /** Maximal number of accepted and rejected time steps. */
+      static constexpr int c_MaxSteps = 100;
+
+      /**
+       * Fits the model with the current templates and bounds,
+       * the times are started from m_times.
+       * @param[out] nIterations Number of accepted time steps.
+       * @return chi-squared.
+       */
+      double fit(int& nIterations);
+
+      /** Calculates the templates and their derivatives for m_times. */
+      void calculateTemplates();
+
+      /**
+       * Calculates the linear parameters for the current templates within their bounds.
+       * @return chi-squared.
+       */
+      double solveLinear();
+
+      /** Multiplies the vector x by the inverse covariance matrix. */
+      void multiplyInverseCovariance(double* y, const double* x) const;
+
+      /** Inverse covariance matrix. */
+      double m_inverseCovariance[c_NFitPoints][c_NFitPoints] = {};
+
+      /** ADC values. */
+      double m_adc[c_NFitPoints] = {};
+
+      /** Photon template. */
+      const SignalInterpolation2* m_photon = nullptr;
+
+      /** Hadron template. */
+      const SignalInterpolation2* m_hadron = nullptr;
+
+      /** Number of linear parameters: pedestal, photon, hadron and background-photon amplitude. */
+      int m_nLinear = 0;
+
+      /** Number of times: signal and background-photon time. */
+      int m_nTimes = 0;
+
+      /** Linear parameters. */
+      double m_linear[c_MaxLinear] = {};
+
+      /** Lower bounds of the linear parameters. */
+      double m_linearMin[c_MaxLinear] = {};
+
+      /** Upper bounds of the linear parameters. */
+      double m_linearMax[c_MaxLinear] = {};
+
+      /** Times. */
+      double m_times[c_MaxTimes] = {};
+
+      /** Lower bounds of the times. */
+      double m_timesMin[c_MaxTimes] = {};
+
+      /** Upper bounds of the times. */
+      double m_timesMax[c_MaxTimes] = {};
+
+      /** Whether the linear parameter is fixed at one of its bounds. */
+      bool m_fixed[c_MaxLinear] = {};
+
+      /** Templates of the linear parameters (the pedestal template is 1). */
+      double m_templates[c_MaxLinear][c_NFitPoints] = {};
+
+      /** Time derivatives of the templates. */
+      double m_derivatives[c_MaxLinear][c_NFitPoints] = {};
+
+      /** Templates multiplied by the inverse covariance matrix. */
+      double m_weightedTemplates[c_MaxLinear][c_NFitPoints] = {};
+
+      /** Residuals multiplied by the inverse covariance matrix. */
+      double m_weightedResiduals[c_NFitPoints] = {};
+
+    };
+
+  }
+
+}
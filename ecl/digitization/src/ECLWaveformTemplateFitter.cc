@@ -0,0 +1,584 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+/* Own header. */
+#include <ecl/digitization/ECLWaveformTemplateFitter.h>
+
+/* ECL headers. */
+#include <ecl/digitization/shaperdsp.h>
+
+/* C++ headers. */
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace Belle2;
+using namespace ECL;
+
+namespace {
+
+  // Number of fit points.
+  const int c_NFitPoints = ECLWaveformTemplateFitter::c_NFitPoints;
+
+  // Maximal dimension of the linear systems.
+  const int c_MaxDimension = 6;
+
+  // Time (index in the times) of the linear parameters, -1 for the pedestal.
+  const int c_TimeOfLinear[] = { -1, 0, 0, 1};
+
+  // Scalar product of two vectors of fit points.
+  double dot(const double* x, const double* y)
+  {
+    double sum = 0;
+    for (int i = 0; i < c_NFitPoints; ++i)
+      sum += x[i] * y[i];
+    return sum;
+  }
+
+  // Solve the linear system A x = b by Gaussian elimination with partial pivoting,
+  // b is replaced by x. Returns false if the matrix is singular.
+  bool solveSystem(int n, double A[][c_MaxDimension], double* b)
+  {
+    double scale = 0;
+    for (int i = 0; i < n; ++i)
+      scale = std::max(scale, std::fabs(A[i][i]));
+    for (int i = 0; i < n; ++i) {
+      int p = i;
+      for (int k = i + 1; k < n; ++k) {
+        if (std::fabs(A[k][i]) > std::fabs(A[p][i]))
+          p = k;
+      }
+      if (!(std::fabs(A[p][i]) > 1e-14 * scale))
+        return false;
+      if (p != i) {
+        for (int j = 0; j < n; ++j)
+          std::swap(A[p][j], A[i][j]);
+        std::swap(b[p], b[i]);
+      }
+      for (int k = i + 1; k < n; ++k) {
+        const double f = A[k][i] / A[i][i];
+        for (int j = i; j < n; ++j)
+          A[k][j] -= f * A[i][j];
+        b[k] -= f * b[i];
+      }
+    }
+    for (int i = n - 1; i >= 0; --i) {
+      double sum = b[i];
+      for (int j = i + 1; j < n; ++j)
+        sum -= A[i][j] * b[j];
+      b[i] = sum / A[i][i];
+    }
+    return true;
+  }
+
+  // Set the bounds of a parameter, no bounds if they are equal as in MINUIT.
+  void setBounds(double& min, double& max, double a, double b)
+  {
+    if (a == b) {
+      min = -std::numeric_limits<double>::infinity();
+      max = std::numeric_limits<double>::infinity();
+    } else {
+      min = std::min(a, b);
+      max = std::max(a, b);
+    }
+  }
+
+}
+
+void ECLWaveformTemplateFitter::setInverseCovariance(const CovariancePacked& packed)
+{
+  int count = 0;
+  for (int i = 0; i < c_NFitPoints; i++) {
+    for (int j = 0; j < i + 1; j++) {
+      m_inverseCovariance[i][j] = packed[count];
+      m_inverseCovariance[j][i] = packed[count];
+      ++count;
+    }
+  }
+}
+
+void ECLWaveformTemplateFitter::multiplyInverseCovariance(double* y, const double* x) const
+{
+  // The matrix is symmetric, the sum over the columns is vectorized without changing the order of additions.
+  for (int i = 0; i < c_NFitPoints; ++i)
+    y[i] = 0;
+  for (int j = 0; j < c_NFitPoints; ++j) {
+    const double xj = x[j];
+    const double* column = m_inverseCovariance[j];
+    #pragma omp simd
+    for (int i = 0; i < c_NFitPoints; ++i)
+      y[i] += column[i] * xj;
+  }
+}
+
+void ECLWaveformTemplateFitter::calculateTemplates()
+{
+  for (int i = 0; i < c_NFitPoints; ++i) {
+    m_templates[0][i] = 1;
+    m_derivatives[0][i] = 0;
+  }
+  m_photon->getShape(m_times[0], m_templates[1], m_derivatives[1]);
+  m_hadron->getShape(m_times[0], m_templates[2], m_derivatives[2]);
+  if (m_nTimes > 1)
+    m_photon->getShape(m_times[1], m_templates[3], m_derivatives[3]);
+}
+
+double ECLWaveformTemplateFitter::solveLinear()
+{
+  /* Normal equations of the linear parameters. */
+  double normal[c_MaxLinear][c_MaxLinear], rhs[c_MaxLinear];
+  for (int k = 0; k < m_nLinear; ++k) {
+    multiplyInverseCovariance(m_weightedTemplates[k], m_templates[k]);
+    rhs[k] = dot(m_weightedTemplates[k], m_adc);
+    for (int l = 0; l <= k; ++l) {
+      normal[k][l] = dot(m_weightedTemplates[k], m_templates[l]);
+      normal[l][k] = normal[k][l];
+    }
+  }
+
+  /*
+   * Active set method starting from the current parameters moved into their bounds:
+   * move towards the optimum of the free parameters until a bound is reached and fix that
+   * parameter, release fixed parameters if the chi-squared decreases towards the inside.
+   */
+  for (int k = 0; k < m_nLinear; ++k) {
+    m_linear[k] = std::min(std::max(m_linear[k], m_linearMin[k]), m_linearMax[k]);
+    m_fixed[k] = false;
+  }
+  for (int iteration = 0; iteration < 4 * c_MaxLinear; ++iteration) {
+    int free[c_MaxLinear];
+    int nFree = 0;
+    for (int k = 0; k < m_nLinear; ++k) {
+      if (!m_fixed[k])
+        free[nFree++] = k;
+    }
+    double A[c_MaxDimension][c_MaxDimension], x[c_MaxDimension];
+    for (int a = 0; a < nFree; ++a) {
+      x[a] = rhs[free[a]];
+      for (int l = 0; l < m_nLinear; ++l) {
+        if (m_fixed[l])
+          x[a] -= normal[free[a]][l] * m_linear[l];
+      }
+      for (int b = 0; b < nFree; ++b)
+        A[a][b] = normal[free[a]][free[b]];
+    }
+    if (!solveSystem(nFree, A, x))
+      break;
+
+    /* Step towards the optimum of the free parameters. */
+    double alpha = 1;
+    int blocking = -1;
+    double blockingBound = 0;
+    for (int a = 0; a < nFree; ++a) {
+      const int k = free[a];
+      const double step = x[a] - m_linear[k];
+      if (x[a] > m_linearMax[k] && (m_linearMax[k] - m_linear[k]) / step < alpha) {
+        alpha = (m_linearMax[k] - m_linear[k]) / step;
+        blocking = k;
+        blockingBound = m_linearMax[k];
+      } else if (x[a] < m_linearMin[k] && (m_linearMin[k] - m_linear[k]) / step < alpha) {
+        alpha = (m_linearMin[k] - m_linear[k]) / step;
+        blocking = k;
+        blockingBound = m_linearMin[k];
+      }
+    }
+    for (int a = 0; a < nFree; ++a)
+      m_linear[free[a]] += alpha * (x[a] - m_linear[free[a]]);
+    if (blocking >= 0) {
+      m_linear[blocking] = blockingBound;
+      m_fixed[blocking] = true;
+      continue;
+    }
+
+    /* Release the fixed parameter with the largest gradient towards the inside. */
+    int release = -1;
+    double maxGradient = 0;
+    for (int k = 0; k < m_nLinear; ++k) {
+      if (!m_fixed[k])
+        continue;
+      double gradient = -rhs[k];
+      for (int l = 0; l < m_nLinear; ++l)
+        gradient += normal[k][l] * m_linear[l];
+      const double inside = (m_linear[k] == m_linearMin[k]) ? -gradient : gradient;
+      if (inside > maxGradient) {
+        maxGradient = inside;
+        release = k;
+      }
+    }
+    if (release < 0)
+      break;
+    m_fixed[release] = false;
+  }
+
+  /* Chi-squared and weighted residuals. */
+  double residuals[c_NFitPoints];
+  for (int i = 0; i < c_NFitPoints; ++i) {
+    double model = 0;
+    for (int k = 0; k < m_nLinear; ++k)
+      model += m_linear[k] * m_templates[k][i];
+    residuals[i] = m_adc[i] - model;
+  }
+  multiplyInverseCovariance(m_weightedResiduals, residuals);
+  return dot(residuals, m_weightedResiduals);
+}
+
+double ECLWaveformTemplateFitter::fit(int& nIterations)
+{
+  calculateTemplates();
+  double chi2 = solveLinear();
+  double lambda = 1e-3;
+  nIterations = 0;
+  for (int step = 0; step < c_MaxSteps; ++step) {
+    /* Jacobian of the times. */
+    double jacobian[c_MaxTimes][c_NFitPoints], weightedJacobian[c_MaxTimes][c_NFitPoints];
+    for (int t = 0; t < m_nTimes; ++t) {
+      for (int i = 0; i < c_NFitPoints; ++i)
+        jacobian[t][i] = 0;
+      for (int k = 1; k < m_nLinear; ++k) {
+        if (c_TimeOfLinear[k] != t)
+          continue;
+        for (int i = 0; i < c_NFitPoints; ++i)
+          jacobian[t][i] += m_linear[k] * m_derivatives[k][i];
+      }
+      multiplyInverseCovariance(weightedJacobian[t], jacobian[t]);
+    }
+
+    /* Gauss-Newton normal equations of the free linear parameters and the times. */
+    const double* columns[c_MaxDimension];
+    const double* weightedColumns[c_MaxDimension];
+    int n = 0;
+    for (int k = 0; k < m_nLinear; ++k) {
+      if (m_fixed[k])
+        continue;
+      columns[n] = m_templates[k];
+      weightedColumns[n] = m_weightedTemplates[k];
+      ++n;
+    }
+    const int firstTime = n;
+    for (int t = 0; t < m_nTimes; ++t) {
+      columns[n] = jacobian[t];
+      weightedColumns[n] = weightedJacobian[t];
+      ++n;
+    }
+    double A[c_MaxDimension][c_MaxDimension], delta[c_MaxDimension];
+    for (int a = 0; a < n; ++a) {
+      delta[a] = dot(columns[a], m_weightedResiduals);
+      for (int b = 0; b <= a; ++b) {
+        A[a][b] = dot(weightedColumns[a], columns[b]);
+        A[b][a] = A[a][b];
+      }
+    }
+    for (int a = firstTime; a < n; ++a)
+      A[a][a] *= 1 + lambda;
+    if (!solveSystem(n, A, delta))
+      break;
+
+    /* Try the new times, the linear parameters are recalculated. */
+    double oldTimes[c_MaxTimes], oldLinear[c_MaxLinear];
+    std::copy(m_times, m_times + m_nTimes, oldTimes);
+    std::copy(m_linear, m_linear + m_nLinear, oldLinear);
+    double maxStep = 0;
+    for (int t = 0; t < m_nTimes; ++t) {
+      m_times[t] = std::min(std::max(m_times[t] + delta[firstTime + t], m_timesMin[t]), m_timesMax[t]);
+      maxStep = std::max(maxStep, std::fabs(m_times[t] - oldTimes[t]));
+    }
+    if (maxStep == 0)
+      break;
+    calculateTemplates();
+    const double newChi2 = solveLinear();
+    if (newChi2 <= chi2) {
+      const double decrease = chi2 - newChi2;
+      chi2 = newChi2;
+      ++nIterations;
+      lambda = std::max(0.1 * lambda, 1e-9);
+      if (decrease < 1e-7 * (1 + chi2) && maxStep < 1e-3)
+        break;
+    } else {
+      std::copy(oldTimes, oldTimes + m_nTimes, m_times);
+      std::copy(oldLinear, oldLinear + m_nLinear, m_linear);
+      calculateTemplates();
+      chi2 = solveLinear();
+      lambda *= 10;
+      if (lambda > 1e8)
+        break;
+    }
+  }
+  return chi2;
+}
+
+void ECLWaveformTemplateFitter::fitPhotonHadron(
+  const double* adc, const SignalInterpolation2& photon,
+  const SignalInterpolation2& hadron, Result& result)
+{
+  std::copy(adc, adc + c_NFitPoints, m_adc);
+  m_photon = &photon;
+  m_hadron = &hadron;
+  m_nLinear = 3;
+  m_nTimes = 1;
+
+  /* Setting initial fit parameters. */
+  double dt = 0.5;
+  double amax = 0;
+  int jmax = 6;
+  for (int j = 0; j < c_NFitPoints; j++) {
+    if (amax < m_adc[j]) {
+      amax = m_adc[j];
+      jmax = j;
+    }
+  }
+  double sumB0 = 0;
+  int jsum = 0;
+  for (int j = 0; j < c_NFitPoints; j++) {
+    if (j < jmax - 3 || jmax + 4 < j) {
+      sumB0 += m_adc[j];
+      ++jsum;
+    }
+  }
+  double B0 = sumB0 / jsum;
+  amax -= B0;
+  if (amax < 0)
+    amax = 10;
+  double T0 = dt * (4.5 - jmax);
+  double A0 = amax;
+
+  m_linear[0] = B0;
+  setBounds(m_linearMin[0], m_linearMax[0], B0 / 1.5, B0 * 1.5);
+  m_linear[1] = A0;
+  setBounds(m_linearMin[1], m_linearMax[1], 0, 2 * A0);
+  m_linear[2] = 0;
+  setBounds(m_linearMin[2], m_linearMax[2], -A0, 2 * A0);
+  m_times[0] = T0;
+  setBounds(m_timesMin[0], m_timesMax[0], T0 - 2.5, T0 + 2.5);
+
+  result.chi2 = fit(result.nIterations);
+  result.pedestal = m_linear[0];
+  result.amplitudePhoton = m_linear[1];
+  result.signalTime = m_times[0];
+  result.amplitudeHadron = m_linear[2];
+}
+
+void ECLWaveformTemplateFitter::fitPhotonHadronBackgroundPhoton(
+  const double* adc, const SignalInterpolation2& photon,
+  const SignalInterpolation2& hadron, Result& result)
+{
+  std::copy(adc, adc + c_NFitPoints, m_adc);
+  m_photon = &photon;
+  m_hadron = &hadron;
+  m_nLinear = 4;
+  m_nTimes = 2;
+
+  /* Setting initial fit parameters. */
+  double dt = 0.5;
+  double amax = 0; int jmax = 6;
+  for (int j = 0; j < c_NFitPoints; j++) {
+    if (amax < m_adc[j]) {
+      amax = m_adc[j];
+      jmax = j;
+    }
+  }
+
+  double amax1 = 0; int jmax1 = 6;
+  for (int j = 0; j < c_NFitPoints; j++) {
+    if (j < jmax - 3 || jmax + 4 < j) {
+      if (j == 0) {
+        if (amax1 < m_adc[j] && m_adc[j + 1] < m_adc[j]) {
+          amax1 = m_adc[j];
+          jmax1 = j;
+        }
+      } else if (j == 30) {
+        if (amax1 < m_adc[j] && m_adc[j - 1] < m_adc[j]) {
+          amax1 = m_adc[j];
+          jmax1 = j;
+        }
+      } else {
+        if (amax1 < m_adc[j] && m_adc[j + 1] < m_adc[j] && m_adc[j - 1] < m_adc[j]) {
+          amax1 = m_adc[j];
+          jmax1 = j;
+        }
+      }
+    }
+  }
+
+  double sumB0 = 0;
+  int jsum = 0;
+  for (int j = 0; j < c_NFitPoints; j++) {
+    if ((j < jmax - 3 || jmax + 4 < j) && (j < jmax1 - 3 || jmax1 + 4 < j)) {
+      sumB0 += m_adc[j];
+      ++jsum;
+    }
+  }
+  double B0 = sumB0 / jsum;
+  amax -= B0;
+  amax = std::max(10.0, amax);
+  amax1 -= B0;
+  amax1 = std::max(10.0, amax1);
+  double T0 = dt * (4.5 - jmax);
+  double T01 = dt * (4.5 - jmax1);
+  double A0 = amax, A01 = amax1;
+
+  m_linear[0] = B0;
+  setBounds(m_linearMin[0], m_linearMax[0], B0 / 1.5, B0 * 1.5);
+  m_linear[1] = A0;
+  setBounds(m_linearMin[1], m_linearMax[1], 0, 2 * A0);
+  m_linear[2] = 0;
+  setBounds(m_linearMin[2], m_linearMax[2], -A0, 2 * A0);
+  m_linear[3] = A01;
+  setBounds(m_linearMin[3], m_linearMax[3], 0, 2 * A01);
+  m_times[0] = T0;
+  setBounds(m_timesMin[0], m_timesMax[0], T0 - 2.5, T0 + 2.5);
+  m_times[1] = T01;
+  setBounds(m_timesMin[1], m_timesMax[1], T01 - 2.5, T01 + 2.5);
+
+  result.chi2 = fit(result.nIterations);
+  result.pedestal = m_linear[0];
+  result.amplitudePhoton = m_linear[1];
+  result.signalTime = m_times[0];
+  result.amplitudeHadron = m_linear[2];
+  result.amplitudeBackgroundPhoton = m_linear[3];
+  result.timeBackgroundPhoton = m_times[1];
+}
+
+SignalInterpolation2::SignalInterpolation2(const std::vector<double>& s)
+{
+  double T0 = -0.2;
+  std::vector<double> p(s.begin() + 1, s.end());
+  p[1] = std::max(0.0029, p[1]);
+  p[4] = std::max(0.0029, p[4]);
+
+  ShaperDSP_t dsp(p, s[0]);
+  dsp.settimestride(c_dtn);
+  dsp.settimeseed(T0);
+  dd_t t[(c_nt + c_ntail)*c_ndt];
+  dsp.fillarray(sizeof(t) / sizeof(t[0]), t);
+
+  for (int i = 0; i < c_nt * c_ndt; i++) {
+    m_FunctionInterpolation[i] = t[i].first;
+    m_DerivativeInterpolation[i] = t[i].second;
+  }
+  for (int i = 0; i < c_ntail; i++) {
+    int j = c_nt * c_ndt + i;
+    int k = c_nt * c_ndt + i * c_ndt;
+    m_FunctionInterpolation[j] = t[k].first;
+    m_DerivativeInterpolation[j] = t[k].second;
+  }
+  int i1 = c_nt * c_ndt + c_ntail - 2;
+  int i2 = c_nt * c_ndt + c_ntail - 1;
+  m_r0 = m_FunctionInterpolation[i2] / m_FunctionInterpolation[i1];
+  m_r1 = m_DerivativeInterpolation[i2] / m_DerivativeInterpolation[i1];
+}
+
+void SignalInterpolation2::getShape(
+  double t0, double* function, double* derivatives) const
+{
+  /* If before pulse start time (negative times), return 0. */
+  int k = 0;
+  while (t0 < 0) {
+    function[k] = 0;
+    derivatives[k] = 0;
+    t0 += c_dt;
+    ++k;
+    if (k >= c_NFitPoints)
+      return;
+  }
+
+  /* Function and derivative values. */
+  double function0[c_NFitPoints], function1[c_NFitPoints];
+  double derivative0[c_NFitPoints], derivative1[c_NFitPoints];
+
+  /* Interpolate first c_nt points (short time steps). */
+  double x = t0 * c_idtn;
+  double ix = floor(x);
+  double w = x - ix;
+  int j = ix;
+  double w2 = w * w;
+  double hw2 = 0.5 * w2;
+  double tw3 = ((1. / 6) * w) * w2;
+
+  /* Number of interpolation points. */
+  int iMax = k + c_nt;
+  if (iMax > c_NFitPoints)
+    iMax = c_NFitPoints;
+
+  /* Fill interpolation points. */
+  for (int i = k; i < iMax; ++i) {
+    function0[i] = m_FunctionInterpolation[j];
+    function1[i] = m_FunctionInterpolation[j + 1];
+    derivative0[i] = m_DerivativeInterpolation[j];
+    derivative1[i] = m_DerivativeInterpolation[j + 1];
+    j = j + c_ndt;
+  }
+
+  /* Interpolation. */
+  #pragma omp simd
+  for (int i = k; i < iMax; ++i) {
+    double a[4];
+    double dfdt = (function1[i] - function0[i]) * c_idtn;
+    double fp = derivative1[i] + derivative0[i];
+    a[0] = function0[i];
+    a[1] = derivative0[i];
+    a[2] = -((fp + derivative0[i]) - 3 * dfdt);
+    a[3] = fp - 2 * dfdt;
+    double b2 = 2 * a[2];
+    double b3 = 6 * a[3];
+    function[i] = a[0] + c_dtn * (a[1] * w + b2 * hw2 + b3 * tw3);
+    derivatives[i] = a[1] + b2 * w + b3 * hw2;
+  }
+  t0 = t0 + c_dt * c_nt;
+  if (iMax == c_NFitPoints)
+    return;
+  k = iMax;
+
+  /* Interpolate next c_ntail points (long time steps). */
+  x = t0 * c_idt;
+  ix = floor(x);
+  w = x - ix;
+  w2 = w * w;
+  hw2 = 0.5 * w2;
+  tw3 = ((1. / 6) * w) * w2;
+
+  /* Number of interpolation points. */
+  iMax = k + c_ntail - 1;
+  if (iMax > c_NFitPoints)
+    iMax = c_NFitPoints;
+
+  /* Interpolation. */
+  #pragma omp simd
+  for (int i = k; i < iMax; ++i) {
+    j = c_nt * c_ndt + i - k;
+    /*
+     * The interpolation step is the same as the distance between
+     * the fit points. It is possible to load the values in the interpolation
+     * loop while keeping its vectorization.
+     */
+    double f0 = m_FunctionInterpolation[j];
+    double f1 = m_FunctionInterpolation[j + 1];
+    double fp0 = m_DerivativeInterpolation[j];
+    double fp1 = m_DerivativeInterpolation[j + 1];
+    double a[4];
+    double dfdt = (f1 - f0) * c_idt;
+    double fp = fp1 + fp0;
+    a[0] = f0;
+    a[1] = fp0;
+    a[2] = -((fp + fp0) - 3 * dfdt);
+    a[3] = fp - 2 * dfdt;
+    double b2 = 2 * a[2];
+    double b3 = 6 * a[3];
+    function[i] = a[0] + c_dt * (a[1] * w + b2 * hw2 + b3 * tw3);
+    derivatives[i] = a[1] + b2 * w + b3 * hw2;
+  }
+  if (iMax == c_NFitPoints)
+    return;
+  k = iMax;
+
+  /* Exponential tail. */
+  while (k < c_NFitPoints) {
+    function[k] = function[k - 1] * m_r0;
+    derivatives[k] = derivatives[k - 1] * m_r1;
+    ++k;
+  }
+}
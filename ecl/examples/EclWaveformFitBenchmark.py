@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+
+##########################################################################
+# basf2 (Belle II Analysis Software Framework)                           #
+# Author: The Belle II Collaboration                                     #
+#                                                                        #
+# See git log for contributors and copyright holders.                    #
+# This file is licensed under LGPL-3.0, see LICENSE.md.                  #
+##########################################################################
+
+"""Compares the analytic template fit of ECLWaveformFit with the former
+   MINUIT fit (parameter UseMinuit). ECLWaveformFit is run twice on the
+   recorded ECLDsps of the input file, the time per event of both runs and
+   the differences of the fit results are printed.
+
+   Usage: basf2 EclWaveformFitBenchmark.py -i file.root
+   The input file has to contain ECLDigits and ECLDsps (raw data after
+   unpacking or MC with waveforms stored).
+"""
+
+import math
+import basf2 as b2
+from ROOT import Belle2
+
+env = Belle2.Environment.Instance()
+inputFile_list = [str(x) for x in env.getInputFilesOverride()]
+if len(inputFile_list) == 0:
+    b2.B2FATAL('No input file given, use -i file.root')
+
+
+class CollectFitResults(b2.Module):
+    """Collect the offline fit results of all ECLDsps"""
+
+    def __init__(self):
+        """Constructor"""
+        super().__init__()
+        #: list of (cell id, fit type, total amplitude, hadron amplitude, time, chi2) per fitted waveform
+        self.results = []
+
+    def event(self):
+        """Store the fit results of the event"""
+        for dsp in Belle2.PyStoreArray('ECLDsps'):
+            if dsp.getTwoComponentChi2() < 0:
+                continue
+            self.results.append((dsp.getCellId(), int(dsp.getTwoComponentFitType()),
+                                 dsp.getTwoComponentTotalAmp(), dsp.getTwoComponentHadronAmp(),
+                                 dsp.getTwoComponentTime(), dsp.getTwoComponentChi2()))
+
+
+def runWaveformFit(useMinuit):
+    """Run ECLWaveformFit and return the fit results and the time per event in ms"""
+    main = b2.create_path()
+    main.add_module('RootInput', inputFileNames=inputFile_list, branchNames=['EventMetaData', 'ECLDigits', 'ECLDsps'])
+    waveformFit = main.add_module('ECLWaveformFit', UseMinuit=useMinuit)
+    collector = CollectFitResults()
+    main.add_module(collector)
+    b2.process(main, calculateStatistics=True)
+    return collector.results, b2.statistics.get(waveformFit).time_mean(b2.statistics.EVENT) * 1e-6
+
+
+b2.set_log_level(b2.LogLevel.ERROR)
+minuit, minuitTime = runWaveformFit(True)
+analytic, analyticTime = runWaveformFit(False)
+
+if len(minuit) != len(analytic):
+    b2.B2FATAL('Different number of fitted waveforms with and without MINUIT')
+
+nChangedType = 0
+nLargeDifference = 0
+sumSquares = 0.
+for (cellMinuit, typeMinuit, ampMinuit, hadMinuit, timeMinuit, chi2Minuit), \
+        (cellAnalytic, typeAnalytic, ampAnalytic, hadAnalytic, timeAnalytic, chi2Analytic) in zip(minuit, analytic):
+    if cellMinuit != cellAnalytic:
+        b2.B2FATAL('Different order of the fitted waveforms with and without MINUIT')
+    if typeMinuit != typeAnalytic:
+        nChangedType += 1
+        continue
+    relative = (ampAnalytic - ampMinuit) / max(abs(ampMinuit), 1.)
+    sumSquares += relative ** 2
+    if abs(relative) > 1e-3 or abs(hadAnalytic - hadMinuit) > 1e-3 * max(abs(ampMinuit), 1.):
+        nLargeDifference += 1
+
+nFits = max(len(minuit), 1)
+print(f'fitted waveforms:                              {len(minuit)}')
+print(f'time per event MINUIT / analytic [ms]:         {minuitTime:.3f} / {analyticTime:.3f}')
+print(f'waveforms with different fit type:             {nChangedType} ({100. * nChangedType / nFits:.3f}%)')
+print(f'RMS relative difference of the total amplitude: {math.sqrt(sumSquares / nFits):.2e}')
+print(f'waveforms with amplitude differences > 1e-3:    {nLargeDifference} ({100. * nLargeDifference / nFits:.3f}%)')
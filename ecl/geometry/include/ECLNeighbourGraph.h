@@ -0,0 +1,163 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#pragma once
+
+/* ECL headers. */
+#include <ecl/dataobjects/ECLElementNumbers.h>
+
+/* C++ headers. */
+#include <bitset>
+#include <string>
+#include <vector>
+
+namespace Belle2 {
+  namespace ECL {
+
+    class ECLNeighbours;
+
+    /**
+     * Set of cell ids (1-based). Membership is kept in a bitset, the cells
+     * are additionally kept in insertion order, so that iteration and
+     * clearing only cost the number of cells in the set.
+     */
+    class ECLCellSet {
+
+    public:
+
+      /** Check whether the cell is in the set. */
+      bool contains(int cellId) const { return m_bits[cellId]; }
+
+      /**
+       * Add a cell to the set.
+       * @return true if the cell was not in the set before.
+       */
+      bool insert(int cellId)
+      {
+        if (m_bits[cellId])
+          return false;
+        m_bits.set(cellId);
+        m_cells.push_back(cellId);
+        return true;
+      }
+
+      /** Remove all cells. */
+      void clear()
+      {
+        for (int cellId : m_cells)
+          m_bits.reset(cellId);
+        m_cells.clear();
+      }
+
+      /** Number of cells. */
+      int size() const { return m_cells.size(); }
+
+      /** Check whether the set is empty. */
+      bool empty() const { return m_cells.empty(); }
+
+      /** Cells in insertion order. */
+      const std::vector<int>& getCells() const { return m_cells; }
+
+      /** Sorts the cells by increasing cell id. */
+      void sort();
+
+    private:
+
+      /** Membership of the cells. */
+      std::bitset < ECLElementNumbers::c_NCrystals + 1 > m_bits;
+
+      /** Cells. */
+      std::vector<int> m_cells;
+
+    };
+
+    /**
+     * Neighbour lists of all crystals in compressed sparse row form: the
+     * neighbours of all cells are stored in one array, the neighbours of
+     * the cell id c are the entries [m_offsets[c], m_offsets[c + 1]).
+     * The graph is built once from ECLNeighbours and keeps the order of
+     * the neighbours in each list.
+     */
+    class ECLNeighbourGraph {
+
+    public:
+
+      /** Neighbours of one cell. */
+      class Neighbours {
+
+      public:
+
+        /** Constructor. */
+        Neighbours(const short* begin, const short* end) : m_begin(begin), m_end(end) {}
+
+        /** First neighbour. */
+        const short* begin() const { return m_begin; }
+
+        /** Behind the last neighbour. */
+        const short* end() const { return m_end; }
+
+        /** Number of neighbours. */
+        int size() const { return m_end - m_begin; }
+
+      private:
+
+        /** First neighbour. */
+        const short* m_begin;
+
+        /** Behind the last neighbour. */
+        const short* m_end;
+
+      };
+
+      /**
+       * Constructor from neighbour lists.
+       * @param[in] neighbourLists Neighbours for each cell id,
+       *                           c_NCrystals + 1 entries, entry 0 is ignored.
+       */
+      explicit ECLNeighbourGraph(const std::vector<std::vector<short>>& neighbourLists);
+
+      /** Constructor from an ECLNeighbours object. */
+      explicit ECLNeighbourGraph(const ECLNeighbours& neighbours);
+
+      /** Constructor with the neighbour definition of ECLNeighbours. */
+      ECLNeighbourGraph(const std::string& neighbourDef, double par, bool sorted = false);
+
+      /** Return the neighbours for a given cell id. */
+      Neighbours getNeighbours(int cellId) const
+      {
+        const short* neighbours = m_neighbours.data();
+        return Neighbours(neighbours + m_offsets[cellId], neighbours + m_offsets[cellId + 1]);
+      }
+
+      /** Check whether neighbourId is in the neighbour list of cellId. */
+      bool isNeighbour(int cellId, int neighbourId) const;
+
+      /**
+       * Region growing by one step: adds all cells of the set from and all
+       * their neighbours that are contained in the set mask to the set to.
+       * The set to may be the same as from, then only the original cells
+       * of from are grown.
+       */
+      void grow(const ECLCellSet& from, const ECLCellSet& mask, ECLCellSet& to) const;
+
+    private:
+
+      /** Build the graph from a function returning the neighbour list of a cell id. */
+      template <class NeighbourFunction>
+      void build(const NeighbourFunction& neighbourFunction);
+
+      /** Offsets of the neighbour lists, c_NCrystals + 2 entries. */
+      std::vector<unsigned int> m_offsets;
+
+      /** Neighbour cell ids of all cells. */
+      std::vector<short> m_neighbours;
+
+    };
+
+  }
+}
@@ -0,0 +1,79 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+/* Own header. */
+#include <ecl/geometry/ECLNeighbourGraph.h>
+
+/* ECL headers. */
+#include <ecl/geometry/ECLNeighbours.h>
+
+/* Basf2 headers. */
+#include <framework/logging/Logger.h>
+
+/* C++ headers. */
+#include <algorithm>
+
+using namespace Belle2;
+using namespace ECL;
+
+void ECLCellSet::sort()
+{
+  std::sort(m_cells.begin(), m_cells.end());
+}
+
+ECLNeighbourGraph::ECLNeighbourGraph(const std::vector<std::vector<short>>& neighbourLists)
+{
+  if (neighbourLists.size() != ECLElementNumbers::c_NCrystals + 1)
+    B2FATAL("ECLNeighbourGraph: wrong number of neighbour lists " << LogVar("size", neighbourLists.size()));
+  build([&neighbourLists](int cellId) -> const std::vector<short>& { return neighbourLists[cellId]; });
+}
+
+ECLNeighbourGraph::ECLNeighbourGraph(const ECLNeighbours& neighbours)
+{
+  build([&neighbours](int cellId) -> const std::vector<short>& { return neighbours.getNeighbours(cellId); });
+}
+
+ECLNeighbourGraph::ECLNeighbourGraph(const std::string& neighbourDef, double par, bool sorted) :
+  ECLNeighbourGraph(ECLNeighbours(neighbourDef, par, sorted))
+{
+}
+
+template <class NeighbourFunction>
+void ECLNeighbourGraph::build(const NeighbourFunction& neighbourFunction)
+{
+  // Cell id 0 does not exist, it gets an empty list.
+  m_offsets.assign(ECLElementNumbers::c_NCrystals + 2, 0);
+  for (int cellId = 1; cellId <= ECLElementNumbers::c_NCrystals; cellId++)
+    m_offsets[cellId + 1] = m_offsets[cellId] + neighbourFunction(cellId).size();
+  m_neighbours.reserve(m_offsets.back());
+  for (int cellId = 1; cellId <= ECLElementNumbers::c_NCrystals; cellId++) {
+    const std::vector<short>& neighbours = neighbourFunction(cellId);
+    m_neighbours.insert(m_neighbours.end(), neighbours.begin(), neighbours.end());
+  }
+}
+
+bool ECLNeighbourGraph::isNeighbour(int cellId, int neighbourId) const
+{
+  const Neighbours neighbours = getNeighbours(cellId);
+  return std::find(neighbours.begin(), neighbours.end(), neighbourId) != neighbours.end();
+}
+
+void ECLNeighbourGraph::grow(const ECLCellSet& from, const ECLCellSet& mask, ECLCellSet& to) const
+{
+  // Index loop, to may be the same object as from.
+  const std::vector<int>& cells = from.getCells();
+  const int nCells = cells.size();
+  for (int i = 0; i < nCells; i++) {
+    const int cellId = cells[i];
+    to.insert(cellId);
+    for (short neighbourId : getNeighbours(cellId)) {
+      if (mask.contains(neighbourId))
+        to.insert(neighbourId);
+    }
+  }
+}
@@ -16,19 +16,16 @@
 
 // ECL
 #include <ecl/dbobjects/ECLClusteringParameters.h>
+#include <ecl/geometry/ECLNeighbourGraph.h>
 
 // C++
-#include <set>
+#include <memory>
 
 namespace Belle2 {
   class ECLConnectedRegion;
   class ECLCalDigit;
   class EventLevelClusteringInfo;
 
-  namespace ECL {
-    class ECLNeighbours;
-  }
-
   /** Class to find connected regions */
   class ECLCRFinderModule : public Module {
 
@@ -89,37 +86,42 @@ namespace Belle2 {
     /** ECLClusteringParameters payload for parameters */
     DBObjPtr<ECLClusteringParameters> m_eclClusteringParameters;
 
-    /** Digit vectors. */
-    std::vector <int>  m_cellIdToCheckVec; /**< cellid -> check digit. */
-    std::vector <int>  m_cellIdToSeedVec; /**< cellid -> seed digit. */
-    std::vector <int>  m_cellIdToGrowthVec; /**< cellid -> growth digits. */
-    std::vector <int>  m_cellIdToDigitVec; /**< cellid -> above threshold digits. */
+    /** Digit sets. */
+    ECL::ECLCellSet m_seedCells; /**< Seed digits. */
+    ECL::ECLCellSet m_growthCells; /**< Growth digits. */
+    ECL::ECLCellSet m_digitCells; /**< Above threshold digits. */
+    ECL::ECLCellSet m_grownCells; /**< Seed digits grown twice by growth digits. */
+    ECL::ECLCellSet m_regionCells; /**< Grown digits and their neighbouring digits. */
 
     /** vector (ECLElementNumbers::c_NCrystals + 1 entries) with cell id to store array positions */
     std::vector< int > m_calDigitStoreArrPosition;
 
-    /** Connected Region map. */
-    std::vector < int > m_cellIdToTempCRIdVec; /**< cellid -> temporary CR.*/
-    std::map < int, int > m_cellIdToTempCRIdMap; /**< cellid -> temporary CR.*/
+    /** Union-find parent of the cells in m_regionCells. */
+    std::vector<int> m_parent;
 
-    /** Neighbour maps. */
-    std::vector<ECL::ECLNeighbours*> m_neighbourMaps;
+    /** Connected region index of the union-find roots. */
+    std::vector<int> m_rootToRegion;
 
-    /** Vectors for BFS search. */
-    std::vector<std::vector<int>> m_adj; /**< Adjacency list for all crystals. */
-    std::vector<bool> m_visited; /**< Vector to keep track in BFS */
+    /** Cells of the connected regions. */
+    std::vector<std::vector<int>> m_regions;
 
-    /** Convert vector of cell ids to 0/1 vectors from 1-8737. */
-    static std::vector<int> oneHotVector(const std::vector<int>& A, const int n);
+    /** Neighbour graphs. */
+    std::vector<std::unique_ptr<ECL::ECLNeighbourGraph>> m_neighbourGraphs;
 
-    /** Convert vector of vectors to one long vector. */
-    static std::vector<int> flattenVector(const std::vector<std::vector<int>>& A);
+    /** Find the union-find root of a cell. */
+    int findRoot(int cellId);
 
-    /** Find all lists of cell-ids that share at least one cell using Breadth First Search (BFS) graph traversal algorithm. */
-    std::vector<std::set<int>> mergeVectorsUsingBFSTraversal(const std::vector<std::vector<int>>& A);
+    /** Merge the union-find trees of two cells. */
+    void merge(int cellId1, int cellId2);
 
-    /** Get all connected regions. */
-    std::vector<std::vector<int>> getConnectedRegions(const std::vector<int>& A, const std::vector<int>& B, const int maptype);
+    /**
+     * Find the connected regions: the seed digits are grown twice by
+     * neighbouring growth digits, then all neighbouring digits are attached.
+     * Regions that share at least one digit are merged. The regions are
+     * ordered by their lowest grown cell id, the cells in a region by
+     * increasing cell id.
+     */
+    void findConnectedRegions();
 
   };
 
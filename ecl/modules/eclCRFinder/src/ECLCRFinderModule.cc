@@ -12,7 +12,7 @@
 /* ECL headeers. */
 #include <ecl/dataobjects/ECLCalDigit.h>
 #include <ecl/dataobjects/ECLConnectedRegion.h>
-#include <ecl/geometry/ECLNeighbours.h>
+#include <ecl/dataobjects/ECLElementNumbers.h>
 
 /* Basf2 headers. */
 #include <framework/gearbox/Unit.h>
@@ -86,21 +86,15 @@ void ECLCRFinderModule::initialize()
   // Register relations.
   m_eclConnectedRegions.registerRelationTo(m_eclCalDigits);
 
-  // Initialize neighbour maps.
-  m_neighbourMaps.resize(2);
-  m_neighbourMaps[0] = new ECL::ECLNeighbours(m_mapType[0], m_mapPar[0]);
-  m_neighbourMaps[1] = new ECL::ECLNeighbours(m_mapType[1], m_mapPar[1]);
+  // Initialize neighbour graphs.
+  m_neighbourGraphs.clear();
+  m_neighbourGraphs.push_back(std::make_unique<ECL::ECLNeighbourGraph>(m_mapType[0], m_mapPar[0]));
+  m_neighbourGraphs.push_back(std::make_unique<ECL::ECLNeighbourGraph>(m_mapType[1], m_mapPar[1]));
 
   // Resize the vectors
-  m_cellIdToCheckVec.resize(8737); /**< cellid -> check digit: true if digit has been checked for neighbours. */
-  m_cellIdToSeedVec.resize(8737); /**< cellid -> seed digit (type 1). */
-  m_cellIdToGrowthVec.resize(8737); /**< cellid -> growth digits (type 2). */
-  m_cellIdToDigitVec.resize(8737); /**< cellid -> above threshold digits. */
-  m_cellIdToTempCRIdVec.resize(8737); /**< cellid -> CR. */
-  m_calDigitStoreArrPosition.resize(8737);
-
-  m_adj.resize(8737);
-  m_visited.resize(8737);
+  m_calDigitStoreArrPosition.resize(ECLElementNumbers::c_NCrystals + 1);
+  m_parent.resize(ECLElementNumbers::c_NCrystals + 1);
+  m_rootToRegion.resize(ECLElementNumbers::c_NCrystals + 1);
 }
 
 //-----------------------------------------------------------------
@@ -145,12 +139,10 @@ void ECLCRFinderModule::event()
 {
   B2DEBUG(200, "ECLCRFinderModule::event()");
 
-  // Reset the vector(s).
-  std::fill(m_cellIdToCheckVec.begin(), m_cellIdToCheckVec.end(), 0);
-  std::fill(m_cellIdToSeedVec.begin(), m_cellIdToSeedVec.end(), 0);
-  std::fill(m_cellIdToGrowthVec.begin(), m_cellIdToGrowthVec.end(), 0);
-  std::fill(m_cellIdToDigitVec.begin(), m_cellIdToDigitVec.end(), 0);
-  std::fill(m_cellIdToTempCRIdVec.begin(), m_cellIdToTempCRIdVec.end(), 0);
+  // Reset the sets.
+  m_seedCells.clear();
+  m_growthCells.clear();
+  m_digitCells.clear();
 
   // Fill a vector that can be used to map cellid -> store array position
   std::fill(m_calDigitStoreArrPosition.begin(), m_calDigitStoreArrPosition.end(), -1);
@@ -158,11 +150,8 @@ void ECLCRFinderModule::event()
     m_calDigitStoreArrPosition[m_eclCalDigits[i]->getCellId()] = i;
   }
 
-  // Clear the map(s).
-  m_cellIdToTempCRIdMap.clear();
-
   //-------------------------------------------------------
-  // fill digits into maps
+  // fill digits into sets
   for (const auto& eclCalDigit : m_eclCalDigits) {
     const double energy         = eclCalDigit.getEnergy();
     const double time           = eclCalDigit.getTime();
@@ -184,7 +173,7 @@ void ECLCRFinderModule::event()
         if (m_timeCut[2] > 1e-9 and fabs(time) > m_timeCut[2]) continue;
         if (m_timeCut[2] < -1e-9  and fabs(timeresidual) > fabs(m_timeCut[2])) continue;
       }
-      m_cellIdToDigitVec[cellid] = 1;
+      m_digitCells.insert(cellid);
       B2DEBUG(250, "ECLCRFinderModule::event(), adding 'all digit' cellid = " << cellid << " " << energy << " " << time << " " <<
               timeresidual);
 
@@ -195,7 +184,7 @@ void ECLCRFinderModule::event()
           if (m_timeCut[1] > 1e-9 and fabs(time) > m_timeCut[1]) continue;
           if (m_timeCut[1] < -1e-9  and fabs(timeresidual) > fabs(m_timeCut[1])) continue;
         }
-        m_cellIdToGrowthVec[cellid] = 1;
+        m_growthCells.insert(cellid);
         B2DEBUG(250, "ECLCRFinderModule::event(), adding 'growth digit' cellid = " << cellid << " " << energy << " " << time << " " <<
                 timeresidual);
 
@@ -207,33 +196,19 @@ void ECLCRFinderModule::event()
             if (m_timeCut[0] > 1e-9 and fabs(time) > m_timeCut[0]) continue;
             if (m_timeCut[0] < -1e-9  and fabs(timeresidual) > fabs(m_timeCut[0])) continue;
           }
-          m_cellIdToSeedVec[cellid] = 1;
+          m_seedCells.insert(cellid);
           B2DEBUG(250, "ECLCRFinderModule::event(), adding 'seed digit' cellid = " << cellid << " " << energy << " " << time << " " <<
                   timeresidual);
         } // end seed
       } //end growth
     }// end digit
-  }//end filling maps
-
-  // we start with seed crystals A and attach all growth crystals B
-  std::vector<std::vector<int>> connectedRegions_AB = getConnectedRegions(m_cellIdToSeedVec, m_cellIdToGrowthVec, 0);
-  std::vector<int> connectedRegions_AB_flattened = flattenVector(connectedRegions_AB);
-  std::vector<int> AB = oneHotVector(connectedRegions_AB_flattened, m_cellIdToSeedVec.size());
-
-  // Check if any of the growth crystals could grow to other growth crystals
-  std::vector<std::vector<int>> connectedRegions_ABB = getConnectedRegions(AB, m_cellIdToGrowthVec, 0);
-  std::vector<int> connectedRegions_ABB_flattened = flattenVector(connectedRegions_ABB);
-  std::vector<int> ABB = oneHotVector(connectedRegions_ABB_flattened, AB.size());
-
-  // and finally: attach all normal digits
-  std::vector<std::vector<int>> connectedRegions_ABBC = getConnectedRegions(ABB, m_cellIdToDigitVec, 0);
+  }//end filling sets
 
-  //final step: merge all CRs that share at least one crystal
-  std::vector<std::set<int>> connectedRegionsMerged_ABBC_sets = mergeVectorsUsingBFSTraversal(connectedRegions_ABBC);
+  findConnectedRegions();
 
   // Create CRs and add relations to digits.
   unsigned int connectedRegionID = 0;
-  for (const auto& xcr : connectedRegionsMerged_ABBC_sets) {
+  for (const auto& xcr : m_regions) {
 
     // Append to store array
     const auto aCR = m_eclConnectedRegions.appendNew();
@@ -260,128 +235,68 @@ void ECLCRFinderModule::endRun()
 void ECLCRFinderModule::terminate()
 {
   B2DEBUG(200, "ECLCRFinderModule::terminate()");
-  for (unsigned int i = 0; i < m_neighbourMaps.size(); i++) {
-    if (m_neighbourMaps[i]) delete m_neighbourMaps[i];
-  }
-
+  m_neighbourGraphs.clear();
 }
 
-std::vector<int> ECLCRFinderModule::flattenVector(const std::vector<std::vector<int>>& A)
+int ECLCRFinderModule::findRoot(int cellId)
 {
-  std::vector<int> C;
-  for (const auto& B : A) {
-    C.insert(C.end(), B.begin(), B.end());
+  while (m_parent[cellId] != cellId) {
+    // path halving
+    m_parent[cellId] = m_parent[m_parent[cellId]];
+    cellId = m_parent[cellId];
   }
-  std::sort(C.begin(), C.end());
-  C.erase(std::unique(C.begin(), C.end()), C.end());
-  return C;
+  return cellId;
 }
 
-std::vector<int> ECLCRFinderModule::oneHotVector(const std::vector<int>& A, const int n)
+void ECLCRFinderModule::merge(int cellId1, int cellId2)
 {
-  std::vector<int> C(n, 0);
-  for (int x : A) {
-    if (x >= 0 && x < n) {
-      C[x] = 1;
-    }
-  }
-  return C;
+  const int root1 = findRoot(cellId1);
+  const int root2 = findRoot(cellId2);
+  if (root1 < root2)
+    m_parent[root2] = root1;
+  else if (root2 < root1)
+    m_parent[root1] = root2;
 }
 
-std::vector<std::set<int>> ECLCRFinderModule::mergeVectorsUsingBFSTraversal(const std::vector<std::vector<int>>& A)
+void ECLCRFinderModule::findConnectedRegions()
 {
-  std::vector<std::set<int>> output;
-
-  // 1. Data Structures for lookup
-  // We use a fixed-size adjacency list for all crystals (Max ID 8736)
-  std::vector<int> relevantNodes;
-  relevantNodes.reserve(A.size() * 4);
-
-  for (int node = 0; node < 8737; ++node) {
-    m_adj[node].clear();
-    m_visited[node] = false;
-  }
-
-  // 2. Build the Graph
-  // If a vector contains {1, 2, 3}, we mark them as connected neighbors.
-  for (const auto& group : A) {
-    if (group.empty()) continue;
-
-    int root = group[0];
-    relevantNodes.push_back(root);
-
-    for (size_t i = 1; i < group.size(); ++i) {
-      int neighbor = group[i];
-      relevantNodes.push_back(neighbor);
-
-      // Add bi-directional edges
-      m_adj[root].push_back(neighbor);
-      m_adj[neighbor].push_back(root);
-    }
-  }
-
-  // 3. Find Connected Components (BFS)
-  // We only iterate over nodes that actually appeared in the event.
-  for (int startNode : relevantNodes) {
-    if (m_visited[startNode]) continue;
-
-    // Start a new cluster
-    std::set<int> component;
-    std::vector<int> q; // BFS Queue
-
-    m_visited[startNode] = true;
-    q.push_back(startNode);
-    component.insert(startNode);
-
-    int head = 0;
-    while (head < static_cast<int>(q.size())) {
-      int u = q[head++];
-
-      for (int v : m_adj[u]) {
-        if (!m_visited[v]) {
-          m_visited[v] = true;
-          component.insert(v);
-          q.push_back(v);
-        }
-      }
+  // The seed neighbour map is used for all steps.
+  const ECL::ECLNeighbourGraph& graph = *m_neighbourGraphs[0];
+
+  // we start with seed crystals A and attach all growth crystals B,
+  // then check if any of the growth crystals could grow to other growth crystals
+  m_grownCells.clear();
+  graph.grow(m_seedCells, m_growthCells, m_grownCells);
+  graph.grow(m_grownCells, m_growthCells, m_grownCells);
+  m_grownCells.sort();
+
+  // and finally: attach all normal digits; all regions that share at least one crystal are merged
+  m_regionCells.clear();
+  for (int cellId : m_grownCells.getCells()) {
+    if (m_regionCells.insert(cellId))
+      m_parent[cellId] = cellId;
+    for (short neighbourId : graph.getNeighbours(cellId)) {
+      if (!m_digitCells.contains(neighbourId))
+        continue;
+      if (m_regionCells.insert(neighbourId))
+        m_parent[neighbourId] = neighbourId;
+      merge(cellId, neighbourId);
     }
-
-    // Move the finished component to output
-    output.push_back(std::move(component));
   }
 
-  return output;
-}
-
-std::vector<std::vector<int>> ECLCRFinderModule::getConnectedRegions(const std::vector<int>& A, const std::vector<int>& B,
-                           const int maptype)
-{
-  std::vector<std::vector<int>> connectedRegions;
-
-  // We iterate 0..8737 for the seeds (A), as A is a sparse vector mapped to cellID
-  for (unsigned int i = 0; i < A.size(); ++i) {
-    if (A[i] > 0) {
-      std::vector<int> region;
-      // Reserve with neighbor count to prevent reallocations
-      region.reserve(21);
-      region.push_back(i);
-
-      // Instead of looping j = 0 to 8737, we only loop over actual geometric neighbors.
-      const auto& neighbors = m_neighbourMaps[maptype]->getNeighbours(i);
-
-      for (int neighborID : neighbors) {
-        // We only care if this specific neighbor is active in vector B
-        if (neighborID < static_cast<int>(B.size()) && B[neighborID] > 0) {
-          region.push_back(neighborID);
-        }
-      }
-
-      std::sort(region.begin(), region.end());
-      region.erase(std::unique(region.begin(), region.end()), region.end());
-
-      connectedRegions.push_back(region);
+  // Number the regions in the order of their lowest grown cell.
+  for (int cellId : m_regionCells.getCells())
+    m_rootToRegion[cellId] = -1;
+  m_regions.clear();
+  for (int cellId : m_grownCells.getCells()) {
+    const int root = findRoot(cellId);
+    if (m_rootToRegion[root] < 0) {
+      m_rootToRegion[root] = m_regions.size();
+      m_regions.emplace_back();
     }
   }
 
-  return connectedRegions;
+  m_regionCells.sort();
+  for (int cellId : m_regionCells.getCells())
+    m_regions[m_rootToRegion[findRoot(cellId)]].push_back(cellId);
 }
@@ -134,6 +134,25 @@ namespace Belle2 {
     /** Storage for waveform saving thresholds*/
     std::vector<double> m_Awave;
 
+    /** Maximal number of channels of which the correlated noise is calculated at once */
+    static constexpr int c_noiseBatchSize = 64;
+    /** Channels with a waveform in the event */
+    std::vector<int> m_channels;
+    /** Waveforms of m_channels */
+    std::vector<int> m_waveforms;
+    /** Uniform random numbers for the noise generation */
+    std::vector<double> m_uniform;
+    /** Independent standard normal random numbers for the noise of m_channels */
+    std::vector<float> m_normal;
+    /** Start of the channels with each noise matrix in m_noiseGroupMembers */
+    std::vector<int> m_noiseGroupOffsets;
+    /** Indices in m_channels grouped by noise matrix */
+    std::vector<int> m_noiseGroupMembers;
+    /** Standard normal random numbers of a batch of channels, component by component */
+    std::vector<float> m_normalBatch;
+    /** Correlated noise of a batch of channels, component by component */
+    std::vector<float> m_noiseBatch;
+
     /** storage for trigger time in each ECL. The crate trigger time
      *  is an even number from 0 to 142, so here it is stored as
      *  numbers from 0 to 71 inclusive.
@@ -160,8 +179,11 @@ namespace Belle2 {
     void repack(const ECLWFAlgoParams&, algoparams_t&);
     /** load waveform fit parameters for the shapeFitter function */
     void getfitparams(const ECLWaveformData&, const ECLWFAlgoParams&, fitparams_t&);
-    /** fill the waveform array FitA by electronic noise and bias it for channel J [0-8735]*/
-    void makeElectronicNoiseAndPedestal(int j, int* FitA);
+    /** fill the waveform arrays FitA by electronic noise and bias them for the given channels [0-8735],
+     *  the waveform of channels[k] starts at FitA[k * m_nsmp] */
+    void makeElectronicNoiseAndPedestal(const std::vector<int>& channels, int* FitA);
+    /** add the signal of channel j [0-8735] to the waveform FitA and clamp it to the ADC range */
+    void addSignal(int j, int* FitA) const;
 
     /** Hadron signal shapes. */
     DBObjPtr<ECLDigitWaveformParametersForMC> m_waveformParametersMC;
@@ -243,6 +265,7 @@ namespace Belle2 {
     bool m_trigTime; /**< Use trigger time from beam background overlay */
     std::string m_eclWaveformsName;   /**< name of background waveforms storage*/
     bool m_HadronPulseShape; /**< hadron pulse shape flag */
+    bool m_batchedNoise; /**< generate the electronic noise from batches of uniform random numbers */
 
     bool m_dspDataTest; /**< DSP data usage flag */
     /** If true, use m_waveformParameters, m_algoParameters, m_noiseParameters.
@@ -34,6 +34,9 @@
 #include <TRandom.h>
 #include <TTree.h>
 
+/* C++ headers. */
+#include <cmath>
+
 using namespace std;
 using namespace Belle2;
 using namespace ECL;
@@ -67,6 +70,11 @@ ECLDigitizerModule::ECLDigitizerModule() : Module(), m_waveformParametersMC("ECL
   addParam("eclWaveformsName", m_eclWaveformsName, "Name of the output/input collection (digitized waveforms)", string(""));
   addParam("HadronPulseShapes", m_HadronPulseShape, "Flag to include hadron component in pulse shape construction (default: true)",
            true);
+  addParam("BatchedNoise", m_batchedNoise,
+           "Flag to generate the electronic noise of all channels from one batch of uniform random numbers with the "
+           "Box-Muller method. If false, the noise is generated channel by channel with gRandom->Gaus as in previous releases. "
+           "The batched generation changes the random number sequence, so it stays off until the ECL simulation "
+           "has been validated with it (default: false)", false);
   addParam("ADCThreshold", m_ADCThreshold, "ADC threshold for waveform fits (default: 25)", 25);
   addParam("WaveformThresholdOverride", m_WaveformThresholdOverride,
            "If gt 0 value is applied to all crystals for waveform saving threshold. If lt 0 dbobject is used. (GeV)", -1.0);
@@ -348,14 +356,64 @@ void ECLDigitizerModule::shapeSignals()
   }
 }
 
-void ECLDigitizerModule::makeElectronicNoiseAndPedestal(int J, int* FitA)
+void ECLDigitizerModule::makeElectronicNoiseAndPedestal(const std::vector<int>& channels, int* FitA)
+{
+  const EclConfiguration& ec = EclConfiguration::get();
+  const int nChannels = channels.size();
+  const int nNormal = nChannels * ec.m_nsmp;
+
+  // independent standard normal random numbers, ec.m_nsmp per channel
+  if (m_batchedNoise) {
+    // Box-Muller method with one call of the random generator for all channels
+    const int nPairs = (nNormal + 1) / 2;
+    m_uniform.resize(2 * nPairs);
+    m_normal.resize(2 * nPairs);
+    gRandom->RndmArray(2 * nPairs, m_uniform.data());
+    for (int i = 0; i < nPairs; i++) {
+      const double r = sqrt(-2 * log(m_uniform[2 * i]));
+      const double phi = 2 * M_PI * m_uniform[2 * i + 1];
+      m_normal[2 * i] = r * cos(phi);
+      m_normal[2 * i + 1] = r * sin(phi);
+    }
+  } else {
+    m_normal.resize(nNormal);
+    for (int i = 0; i < nNormal; i++) m_normal[i] = gRandom->Gaus(0, 1);
+  }
+
+  // group the channels by noise matrix
+  m_noiseGroupOffsets.assign(m_noise.size() + 1, 0);
+  for (int j : channels) ++m_noiseGroupOffsets[m_tbl[j].inoise + 1];
+  for (size_t i = 1; i < m_noiseGroupOffsets.size(); i++) m_noiseGroupOffsets[i] += m_noiseGroupOffsets[i - 1];
+  m_noiseGroupMembers.resize(nChannels);
+  {
+    std::vector<int> position(m_noiseGroupOffsets.begin(), m_noiseGroupOffsets.end() - 1);
+    for (int k = 0; k < nChannels; k++) m_noiseGroupMembers[position[m_tbl[channels[k]].inoise]++] = k;
+  }
+
+  // correlated noise for batches of channels with the same noise matrix
+  m_normalBatch.resize(c_noiseBatchSize * ec.m_nsmp);
+  m_noiseBatch.resize(c_noiseBatchSize * ec.m_nsmp);
+  for (size_t inoise = 0; inoise < m_noise.size(); inoise++) {
+    for (int first = m_noiseGroupOffsets[inoise]; first < m_noiseGroupOffsets[inoise + 1]; first += c_noiseBatchSize) {
+      const int n = min(c_noiseBatchSize, m_noiseGroupOffsets[inoise + 1] - first);
+      const int* members = &m_noiseGroupMembers[first];
+      for (int b = 0; b < n; b++)
+        for (int i = 0; i < ec.m_nsmp; i++) m_normalBatch[i * n + b] = m_normal[members[b] * ec.m_nsmp + i];
+      m_noise[inoise].generateCorrelatedNoise(n, m_normalBatch.data(), m_noiseBatch.data());
+      for (int b = 0; b < n; b++)
+        for (int i = 0; i < ec.m_nsmp; i++) FitA[members[b] * ec.m_nsmp + i] = 20 * m_noiseBatch[i * n + b] + 3000;
+    }
+  }
+}
+
+void ECLDigitizerModule::addSignal(int j, int* FitA) const
 {
   const EclConfiguration& ec = EclConfiguration::get();
-  std::vector<float> z(ec.m_nsmp), AdcNoise(ec.m_nsmp); // buffers with electronic noise
-  // Noise generation
-  for (int i = 0; i < ec.m_nsmp; i++) z[i] = gRandom->Gaus(0, 1);
-  m_noise[m_tbl[J].inoise].generateCorrelatedNoise(z.data(), AdcNoise.data());
-  for (int i = 0; i < ec.m_nsmp; i++) FitA[i] = 20 * AdcNoise[i] + 3000;
+  const adccounts_t& a = m_adc[j];
+  for (int i = 0; i < ec.m_nsmp; i++) {
+    int A = 20000 * a.c[i] + FitA[i];
+    FitA[i] = max(0, min(A, (1 << 18) - 1));
+  }
 }
 
 void ECLDigitizerModule::makeWaveforms()
@@ -367,16 +425,15 @@ void ECLDigitizerModule::makeWaveforms()
   if (comp == nullptr)
     B2FATAL("Unknown compression algorithm: " << m_compAlgo);
 
-  std::vector<int> FitA(ec.m_nsmp); // buffer for the waveform fitter
-  // loop over entire calorimeter
+  // waveforms of the entire calorimeter
+  m_channels.resize(ec.m_nch);
+  for (int j = 0; j < ec.m_nch; j++) m_channels[j] = j;
+  m_waveforms.resize(ec.m_nch * ec.m_nsmp);
+  makeElectronicNoiseAndPedestal(m_channels, m_waveforms.data());
   for (int j = 0; j < ec.m_nch; j++) {
-    const adccounts_t& a = m_adc[j];
-    makeElectronicNoiseAndPedestal(j, FitA.data());
-    for (int  i = 0; i < ec.m_nsmp; i++) {
-      int A = 20000 * a.c[i] + FitA[i];
-      FitA[i] = max(0, min(A, (1 << 18) - 1));
-    }
-    comp->compress(out, FitA.data());
+    int* FitA = &m_waveforms[j * ec.m_nsmp];
+    addSignal(j, FitA);
+    comp->compress(out, FitA);
   }
   out.resize();
 
@@ -441,12 +498,9 @@ void ECLDigitizerModule::event()
   // dump to a disk, read from the disk to test before real data
   if (m_waveformMaker) { makeWaveforms(); return; }
 
-  std::vector<int> FitA(ec.m_nsmp); // buffer for the waveform fitter
-
-  // loop over entire calorimeter
+  // loop over entire calorimeter and select the channels with waveforms
+  m_channels.clear();
   for (int j = 0; j < ec.m_nch; j++) {
-    const adccounts_t& a = m_adc[j];
-
     //normalize the MC true arrival times
     if (m_adc[j].totalDep > 0) {
       m_adc[j].flighttime /= m_adc[j].totalDep;
@@ -454,20 +508,24 @@ void ECLDigitizerModule::event()
       m_adc[j].timetosensor /= m_adc[j].totalDep;
     }
 
-    // if background waveform is here there is no need to generate
-    // electronic noise since it is already in the waveform
-    if (isBGOverlay) {
-      comp->uncompress(out, FitA.data());
-    } else {
-      // Signal amplitude should be above 100 keV
-      if (a.total < 0.0001) continue;
-      makeElectronicNoiseAndPedestal(j, FitA.data());
-    }
+    // Signal amplitude should be above 100 keV, with background overlay all channels have a waveform
+    if (isBGOverlay || m_adc[j].total >= 0.0001) m_channels.push_back(j);
+  }
 
-    for (int i = 0; i < ec.m_nsmp; i++) {
-      int A = 20000 * a.c[i] + FitA[i];
-      FitA[i] = max(0, min(A, (1 << 18) - 1));
-    }
+  // if background waveform is here there is no need to generate
+  // electronic noise since it is already in the waveform
+  m_waveforms.resize(m_channels.size() * ec.m_nsmp);
+  if (isBGOverlay) {
+    for (size_t k = 0; k < m_channels.size(); k++) comp->uncompress(out, &m_waveforms[k * ec.m_nsmp]);
+  } else {
+    makeElectronicNoiseAndPedestal(m_channels, m_waveforms.data());
+  }
+
+  for (size_t k = 0; k < m_channels.size(); k++) {
+    const int j = m_channels[k];
+    const adccounts_t& a = m_adc[j];
+    int* FitA = &m_waveforms[k * ec.m_nsmp];
+    addSignal(j, FitA);
 
     int  energyFit = 0; // fit output : Amplitude 18 bits
     int       tFit = 0; // fit output : T_ave     12 bits
@@ -477,7 +535,7 @@ void ECLDigitizerModule::event()
     int id = m_eclMapper.getCrateID(j + 1) - 1; // 0 .. 51
     int ttrig = 2 * m_ttime[id];
 
-    shapeFitterWrapper(j, FitA.data(), ttrig, energyFit, tFit, qualityFit, chi);
+    shapeFitterWrapper(j, FitA, ttrig, energyFit, tFit, qualityFit, chi);
 
     if (energyFit > m_ADCThreshold) {
       int CellId = j + 1;
@@ -487,14 +545,14 @@ void ECLDigitizerModule::event()
         //only save waveforms above ADC threshold
         const auto eclDsp = m_eclDsps.appendNew();
         eclDsp->setCellId(CellId);
-        eclDsp->setDspA(FitA.data());
+        eclDsp->setDspA(FitA);
       }
 
       // only store extra MC info if requested and above threshold
       if (m_storeDspWithExtraMCInfo and  a.totalDep >= m_DspWithExtraMCInfoThreshold) {
         const auto eclDspWithExtraMCInfo = m_eclDspsWithExtraMCInfo.appendNew();
         eclDspWithExtraMCInfo->setCellId(CellId);
-        eclDspWithExtraMCInfo->setDspA(FitA.data());
+        eclDspWithExtraMCInfo->setDspA(FitA);
         eclDspWithExtraMCInfo->setEnergyDep(a.totalDep);
         eclDspWithExtraMCInfo->setHadronEnergyDep(a.totalHadronDep);
         eclDspWithExtraMCInfo->setFlightTime(a.flighttime);
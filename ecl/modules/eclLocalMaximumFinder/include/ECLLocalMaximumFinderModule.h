@@ -17,7 +17,10 @@
 #include <framework/geometry/B2Vector3.h>
 #include <mdst/dataobjects/EventLevelClusteringInfo.h>
 #include <ecl/dbobjects/ECLClusteringParameters.h>
+#include <ecl/geometry/ECLNeighbourGraph.h>
 
+/* C++ headers. */
+#include <memory>
 
 class TTree;
 class TFile;
@@ -32,7 +35,6 @@ namespace Belle2 {
   class ECLConnectedRegion;
 
   namespace ECL {
-    class ECLNeighbours;
     class ECLGeometryPar;
   }
 
@@ -146,11 +148,27 @@ namespace Belle2 {
     // Constants
     const double c_minEnergyCut = 5.0 * Belle2::Unit::MeV; /**< Minimum LM energy */
 
-    /** vector (ECLElementNumbers::c_NCrystals + 1 entries) with cell id to store array positions */
-    std::vector< int > m_StoreArrPosition;
+    /** vector (ECLElementNumbers::c_NCrystals + 1 entries) with cell id to energy, 0 without digit */
+    std::vector< double > m_cellEnergy;
 
-    /** Neighbour maps. */
-    ECL::ECLNeighbours* m_neighbourMap{nullptr};
+    /** Digits above the energy cut as (energy, cell id), sorted by decreasing energy. */
+    std::vector< std::pair<double, int> > m_candidates;
+
+    /** Candidates that have been checked already. */
+    ECL::ECLCellSet m_checkedCells;
+
+    /** Candidates without a neighbour of higher energy. */
+    ECL::ECLCellSet m_localMaximumCells;
+
+    /** Neighbour graph. */
+    std::unique_ptr<ECL::ECLNeighbourGraph> m_neighbourGraph;
+
+    /**
+     * Find all digits above the energy cut without a neighbour of higher
+     * energy. The digits are checked in the order of decreasing energy, so
+     * only neighbours that have been checked before can have a higher energy.
+     */
+    void findLocalMaximumCells();
 
     /** Geometry */
     ECL::ECLGeometryPar* m_geom{nullptr};
@@ -17,7 +17,6 @@
 #include <ecl/dataobjects/ECLHit.h>
 #include <ecl/dataobjects/ECLLocalMaximum.h>
 #include <ecl/geometry/ECLGeometryPar.h>
-#include <ecl/geometry/ECLNeighbours.h>
 
 /* ROOT headers. */
 #include <TFile.h>
@@ -28,6 +27,10 @@
 #include <framework/logging/Logger.h>
 #include <mdst/dataobjects/MCParticle.h>
 
+/* C++ headers. */
+#include <algorithm>
+#include <functional>
+
 // NAMESPACE(S)
 using namespace Belle2;
 using namespace ECL;
@@ -100,8 +103,8 @@ void ECLLocalMaximumFinderModule::initialize()
   // Geometry instance.
   m_geom = ECLGeometryPar::Instance();
 
-  // Initialize neighbour map.
-  m_neighbourMap = new ECLNeighbours("N", 1);
+  // Initialize neighbour graph.
+  m_neighbourGraph = std::make_unique<ECLNeighbourGraph>("N", 1);
 
   // Reset all variables.
   resetClassifierVariables();
@@ -148,8 +151,8 @@ void ECLLocalMaximumFinderModule::initialize()
     m_tree->Branch("LMId", &m_LMId, "LMId/F");
   }
 
-  // initialize the vector that gives the relation between cellid and store array position
-  m_StoreArrPosition.resize(ECLElementNumbers::c_NCrystals + 1);
+  // initialize the vector that gives the relation between cellid and energy
+  m_cellEnergy.resize(ECLElementNumbers::c_NCrystals + 1);
 
 }
 
@@ -178,12 +181,15 @@ void ECLLocalMaximumFinderModule::event()
 {
   B2DEBUG(200, "ECLLocalMaximumFinderModule::event()");
 
-  // Fill a vector that can be used to map cellid -> store array position
-  std::fill_n(m_StoreArrPosition.begin(), m_StoreArrPosition.size(), -1);
-  for (int i = 0; i < m_eclCalDigits.getEntries(); i++) {
-    m_StoreArrPosition[m_eclCalDigits[i]->getCellId()] = i;
+  // Fill a vector that can be used to map cellid -> energy
+  std::fill_n(m_cellEnergy.begin(), m_cellEnergy.size(), 0.0);
+  for (const ECLCalDigit& aECLCalDigit : m_eclCalDigits) {
+    m_cellEnergy[aECLCalDigit.getCellId()] = aECLCalDigit.getEnergy();
   }
 
+  // Find the digits without neighbours of higher energy.
+  findLocalMaximumCells();
+
   // Vector with neighbour ids.
   std::vector< double > vNeighourEnergies;
   vNeighourEnergies.resize(c_nMaxNeighbours);
@@ -204,32 +210,19 @@ void ECLLocalMaximumFinderModule::event()
         resetTrainingVariables();
         resetClassifierVariables();
 
-        // Check neighbours: Must be a local energy maximum.
-        bool isLocMax = 1;
-        int neighbourCount = 0;
-        for (const auto& neighbourId : m_neighbourMap->getNeighbours(aECLCalDigit.getCellId())) {
-          if (neighbourId == aECLCalDigit.getCellId()) continue; // Skip the center cell to avoid possible floating point issues.
-
-          const int pos = m_StoreArrPosition[neighbourId]; // Get position in the store array for this digit.
-
-          double energyNeighbour = 0.0;
-          if (pos >= 0) {
-            energyNeighbour = m_eclCalDigits[pos]->getEnergy(); // Get the energy directly from the store array.
-            vNeighourEnergies[neighbourCount] = energyNeighbour;
-          } else {
-            // Digit does not belong to this CR
-            vNeighourEnergies[neighbourCount] = 0.0;
-          }
-          ++neighbourCount;
-
-          if (energyNeighbour > aECLCalDigit.getEnergy()) {
-            isLocMax = 0;
-            break;
-          }
-        }
+        // Must be a local energy maximum.
+        const int cellId = aECLCalDigit.getCellId();
 
         // It is a local maximum. Get all variables needed for classification.
-        if (isLocMax) {
+        if (m_localMaximumCells.contains(cellId)) {
+
+          // Get the neighbour energies, digits that do not exist have zero energy.
+          int neighbourCount = 0;
+          for (short neighbourId : m_neighbourGraph->getNeighbours(cellId)) {
+            if (neighbourId == cellId) continue; // Skip the center cell to avoid possible floating point issues.
+            vNeighourEnergies[neighbourCount] = m_cellEnergy[neighbourId];
+            ++neighbourCount;
+          }
 
           for (unsigned int npos = 0; npos < vNeighourEnergies.size(); ++npos) {
             if (vNeighourEnergies[npos] >= 0) {
@@ -383,10 +376,35 @@ void ECLLocalMaximumFinderModule::terminate()
     delete m_outfile;
   }
 
-  if (m_neighbourMap) delete m_neighbourMap;
+  m_neighbourGraph.reset();
 
 }
 
+void ECLLocalMaximumFinderModule::findLocalMaximumCells()
+{
+  m_candidates.clear();
+  for (const ECLCalDigit& aECLCalDigit : m_eclCalDigits) {
+    if (aECLCalDigit.getEnergy() >= m_energyCut)
+      m_candidates.emplace_back(aECLCalDigit.getEnergy(), aECLCalDigit.getCellId());
+  }
+  std::sort(m_candidates.begin(), m_candidates.end(), std::greater<std::pair<double, int>>());
+
+  // A neighbour of higher energy is above the energy cut as well and has been checked before.
+  m_checkedCells.clear();
+  m_localMaximumCells.clear();
+  for (const auto& [energy, cellId] : m_candidates) {
+    bool isLocMax = true;
+    for (short neighbourId : m_neighbourGraph->getNeighbours(cellId)) {
+      if (neighbourId != cellId and m_checkedCells.contains(neighbourId) and m_cellEnergy[neighbourId] > energy) {
+        isLocMax = false;
+        break;
+      }
+    }
+    m_checkedCells.insert(cellId);
+    if (isLocMax) m_localMaximumCells.insert(cellId);
+  }
+}
+
 void ECLLocalMaximumFinderModule::makeLocalMaximum(const ECLConnectedRegion& aCR, const int cellId, const int lmId)
 {
   // Set the local maximum dataobject.
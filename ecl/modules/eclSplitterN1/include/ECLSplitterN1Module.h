@@ -8,6 +8,9 @@
 
 #pragma once
 
+/* ECL headers. */
+#include <ecl/geometry/ECLNeighbourGraph.h>
+
 /* Basf2 headers. */
 #include <framework/core/Module.h>
 #include <framework/datastore/StoreArray.h>
@@ -30,7 +33,6 @@ namespace Belle2 {
   class ECLnOptimal;
 
   namespace ECL {
-    class ECLNeighbours;
     class ECLGeometryPar;
   }
 
@@ -100,12 +102,12 @@ namespace Belle2 {
     /** vector (ECLElementNumbers::c_NCrystals + 1 entries) with cell id to store array positions for LM*/
     std::vector< int > m_StoreArrPositionLM;
 
-    /** list with all cellid of this connected region */
-    std::vector< int > m_cellIdInCR;
+    /** set with all cellid of this connected region */
+    ECL::ECLCellSet m_cellIdInCR;
 
     /** Neighbour maps */
-    ECL::ECLNeighbours* m_NeighbourMap9{nullptr}; /**< 3x3 = 9 neighbours */
-    ECL::ECLNeighbours* m_NeighbourMap21{nullptr}; /**< 5x5 neighbours excluding corners = 21 */
+    ECL::ECLNeighbourGraph* m_NeighbourMap9{nullptr}; /**< 3x3 = 9 neighbours */
+    ECL::ECLNeighbourGraph* m_NeighbourMap21{nullptr}; /**< 5x5 neighbours excluding corners = 21 */
 
     /** Store array: ECLCalDigit. */
     StoreArray<ECLCalDigit> m_eclCalDigits;
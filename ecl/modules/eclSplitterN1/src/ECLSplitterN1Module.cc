@@ -17,7 +17,6 @@
 #include <ecl/dataobjects/ECLShower.h>
 #include <ecl/dbobjects/ECLnOptimal.h>
 #include <ecl/geometry/ECLGeometryPar.h>
-#include <ecl/geometry/ECLNeighbours.h>
 #include <ecl/utility/Position.h>
 
 /* Basf2 headers. */
@@ -123,8 +122,8 @@ void ECLSplitterN1Module::initialize()
   m_eclConnectedRegions.requireRelationTo(m_eclCalDigits);
 
   // Initialize neighbour maps (we will optimize the endcaps later, there is more than just a certain energy containment to be considered)
-  m_NeighbourMap9 = new ECLNeighbours("N", 1); // N: 3x3 = 9
-  m_NeighbourMap21 = new ECLNeighbours("NC", 2); // NC: 5x5 excluding corners = 21
+  m_NeighbourMap9 = new ECLNeighbourGraph("N", 1); // N: 3x3 = 9
+  m_NeighbourMap21 = new ECLNeighbourGraph("NC", 2); // NC: 5x5 excluding corners = 21
 
   // initialize the vector that gives the relation between cellid and store array position
   m_StoreArrPosition.resize(ECLElementNumbers::c_NCrystals + 1);
@@ -182,18 +181,12 @@ void ECLSplitterN1Module::event()
 
   // Loop over all connected regions
   for (auto& aCR : m_eclConnectedRegions) {
-    // list theat will hold all cellids in this connected region
+    // set that will hold all cellids in this connected region
     m_cellIdInCR.clear();
 
-    const unsigned int entries = (aCR.getRelationsWith<ECLCalDigit>(eclCalDigitArrayName())).size();
-
-    m_cellIdInCR.resize(entries);
-
-    // Fill all calDigits ids in this CR into a vector to make them 'find'-able.
-    int i = 0;
+    // Fill all calDigits ids in this CR into a set to make them 'find'-able.
     for (const auto& caldigit : aCR.getRelationsWith<ECLCalDigit>(eclCalDigitArrayName())) {
-      m_cellIdInCR[i] = caldigit.getCellId();
-      ++i;
+      m_cellIdInCR.insert(caldigit.getCellId());
     }
 
     // Split and reconstruct the showers in this connected regions.
@@ -265,7 +258,7 @@ void ECLSplitterN1Module::splitConnectedRegion(ECLConnectedRegion& aCR)
     const double energyEstimation = estimateEnergy(highestEnergyID);
 
     // Check if 21 would be better in the present background conditions:
-    const ECLNeighbours* neighbourMap; // FIXME pointer needed?
+    const ECLNeighbourGraph* neighbourMap; // FIXME pointer needed?
     int nNeighbours = getNeighbourMap(energyEstimation, backgroundLevel);
     if (nNeighbours == 9 and !m_useOptimalNumberOfDigitsForEnergy) neighbourMap = m_NeighbourMap9;
     else neighbourMap = m_NeighbourMap21;
@@ -274,9 +267,7 @@ void ECLSplitterN1Module::splitConnectedRegion(ECLConnectedRegion& aCR)
     std::vector<ECLCalDigit> digits;
     std::vector<double> weights;
     for (auto& neighbourId : neighbourMap->getNeighbours(highestEnergyID)) {
-      const auto it = std::find(m_cellIdInCR.begin(), m_cellIdInCR.end(),
-                                neighbourId); // check if the neighbour is in the list for this CR
-      if (it == m_cellIdInCR.end()) continue; // not in this CR
+      if (!m_cellIdInCR.contains(neighbourId)) continue; // not in this CR
 
       const int neighbourpos = m_StoreArrPosition[neighbourId];
       digits.push_back(*m_eclCalDigits[neighbourpos]); // list of digits for position reconstruction
@@ -660,14 +651,11 @@ void ECLSplitterN1Module::splitConnectedRegion(ECLConnectedRegion& aCR)
       const double energyEstimation = estimateEnergy(locmaxcellid);
 
       // Get the neighbour list.
-      const ECLNeighbours* neighbourMap; // FIXME need pointer?
+      const ECLNeighbourGraph* neighbourMap; // FIXME need pointer?
       int nNeighbours = getNeighbourMap(energyEstimation, backgroundLevel);
       if (nNeighbours == 9 and !m_useOptimalNumberOfDigitsForEnergy) neighbourMap = m_NeighbourMap9;
       else neighbourMap = m_NeighbourMap21;
 
-      // Get the neighbour list.
-      std::vector<short int> neighbourlist = neighbourMap->getNeighbours(locmaxcellid);
-
       // Get the weight vector.
       std::vector < double > myWeights = (*weightMap.find(locmaxcellid)).second;
 
@@ -692,7 +680,7 @@ void ECLSplitterN1Module::splitConnectedRegion(ECLConnectedRegion& aCR)
 
         // Positive weight and in allowed neighbour list?
         if (weight > 0.0) {
-          if (std::find(neighbourlist.begin(), neighbourlist.end(), cellid) != neighbourlist.end()) {
+          if (neighbourMap->isNeighbour(locmaxcellid, cellid)) {
 
             aECLShower->addRelationTo(m_eclCalDigits[pos], weight);
 
@@ -882,9 +870,7 @@ double ECLSplitterN1Module::estimateEnergy(const int centerid)
   for (auto& neighbourId : m_NeighbourMap9->getNeighbours(centerid)) {
 
     // Check if this neighbour is in this CR
-    const auto it = std::find(m_cellIdInCR.begin(), m_cellIdInCR.end(),
-                              neighbourId); // check if the neighbour is in the list for this CR
-    if (it == m_cellIdInCR.end()) continue; // not in this CR
+    if (!m_cellIdInCR.contains(neighbourId)) continue; // not in this CR
 
     const int pos = m_StoreArrPosition[neighbourId];
     const double energyNeighbour = m_eclCalDigits[pos]->getEnergy();
@@ -15,6 +15,7 @@
 #include <ecl/dbobjects/ECLCrystalCalib.h>
 #include <ecl/dbobjects/ECLDigitWaveformParameters.h>
 #include <ecl/dbobjects/ECLDigitWaveformParametersForMC.h>
+#include <ecl/digitization/ECLWaveformTemplateFitter.h>
 
 /* Basf2 headers. */
 #include <framework/core/Module.h>
@@ -25,100 +26,12 @@ class TMinuit;
 
 namespace Belle2 {
 
-  /**
-   * Struct to keep upper triangle of the covariance matrix. Since the
-   * matrix is already inverted we do not need extra precision, so
-   * keep matrix elements in float type to save space.
-   * sigma is the average noise.
-   */
-  struct CovariancePacked {
-
-    /** Packed matrix. */
-    float m_covMatPacked[31 * (31 + 1) / 2] = {};
-
-    /** Sigma noise. */
-    float sigma{ -1};
-
-    /** Lvalue access by index. */
-    float& operator[](int i) { return m_covMatPacked[i];}
-
-    /** Rvalue access by index. */
-    const float& operator[](int i) const { return m_covMatPacked[i];}
-  };
-
-  /**
-   * Interpolation of signal shape using function values and
-   * the first derivative.
-   */
-  struct SignalInterpolation2 {
-
-    /**
-     * Signal function is sampled in c_nt time steps with c_ndt substeps
-     * and c_ntail steps. c_dt is the time step.
-     */
-    constexpr static int c_nt = 12;
-
-    /** Number of substeps. */
-    constexpr static int c_ndt = 5;
-
-    /** Number of tail steps. */
-    constexpr static int c_ntail = 20;
-
-    /** Time step. */
-    constexpr static double c_dt = 0.5;
-
-    /** Inverted time step */
-    constexpr static double c_idt = 1 / c_dt;
-
-    /** Time substep. */
-    constexpr static double c_dtn = c_dt / c_ndt;
-
-    /** Inverted time substep. */
-    constexpr static double c_idtn = c_ndt / c_dt;
-
-    /** Function values. */
-    double m_FunctionInterpolation[c_nt * c_ndt + c_ntail];
-
-    /** Derivative values. */
-    double m_DerivativeInterpolation[c_nt * c_ndt + c_ntail];
-
-    /**
-     * Assuming exponential drop of the signal function far away from 0,
-     * extrapolate it to +inf.
-     * f(i_last + i) = f(i_last)*m_r0^i
-     * f'(i_last + i) = f'(i_last)*m_r1^i
-     * where i_last is the last point within sampled values in
-     * m_FunctionInterpolation (m_DerivativeInterpolation).
-     */
-    double m_r0;
-
-    /** See above/ */
-    double m_r1;
-
-    /**
-     * Default constructor.
-     */
-    SignalInterpolation2() {};
-
-    /**
-     * Constructor with parameters with the parameter layout as
-     * in ECLDigitWaveformParameters.
-     */
-    explicit SignalInterpolation2(const std::vector<double>&);
-
-    /**
-     * Returns signal shape and derivatives in 31 equidistant time points
-     * starting from t0.
-     * @param[in]  t0          Time.
-     * @param[out] function    Function values.
-     * @param[out] derivatives Derivatives.
-     */
-    void getShape(double t0, double* function, double* derivatives) const;
-
-  };
-
   /**
    * Module performs offline fit for saved ECL waveforms.
+   *
+   * The waveforms to fit are selected first, then they are fitted one after the
+   * other with ECL::ECLWaveformTemplateFitter. The former MINUIT fits are still
+   * available for validation (parameter UseMinuit).
    */
   class ECLWaveformFitModule : public Module {
 
@@ -158,32 +71,47 @@ namespace Belle2 {
      */
     void loadTemplateParameterArray();
 
+    /**
+     * Fits the waveform and stores the results.
+     * @param[in,out] aECLDsp Waveform.
+     */
+    void fitWaveform(ECLDsp& aECLDsp);
+
     /**
      * Fit with photon and hadron.
-     * @param[out] pedestal        Pedestal.
-     * @param[out] amplitudePhoton Photon amplitude.
-     * @param[out] signalTime      Signal time.
-     * @param[out] amplitudeHadron Hadron amplitude.
-     * @param[out] chi2            Chi-squared.
+     * @param[in]  adc    ADC values.
+     * @param[in]  photon Photon template.
+     * @param[in]  hadron Hadron (or diode) template.
+     * @param[out] result Fit result.
      */
-    void fitPhotonHadron(
-      double& pedestal, double& amplitudePhoton, double& signalTime,
-      double& amplitudeHadron, double& chi2);
+    void fitPhotonHadron(const double* adc, const SignalInterpolation2& photon,
+                         const SignalInterpolation2& hadron,
+                         ECL::ECLWaveformTemplateFitter::Result& result);
 
     /**
      * Fit with photon, hadron, and background photon.
-     * @param[out] pedestal                  Pedestal.
-     * @param[out] amplitudePhoton           Photon amplitude.
-     * @param[out] signalTime                Signal time.
-     * @param[out] amplitudeHadron           Hadron amplitude.
-     * @param[out] amplitudeBackgroundPhoton Background-photon amplitude.
-     * @param[out] timeBackgroundPhoton      Background-photon time.
-     * @param[out] chi2                      Chi-squared.
+     * @param[in]  adc    ADC values.
+     * @param[in]  photon Photon template.
+     * @param[in]  hadron Hadron template.
+     * @param[out] result Fit result.
+     */
+    void fitPhotonHadronBackgroundPhoton(const double* adc, const SignalInterpolation2& photon,
+                                         const SignalInterpolation2& hadron,
+                                         ECL::ECLWaveformTemplateFitter::Result& result);
+
+    /**
+     * MINUIT fit with photon and hadron, the ADC values and
+     * templates are passed in global variables.
+     * @param[out] result Fit result.
+     */
+    void fitPhotonHadronMinuit(ECL::ECLWaveformTemplateFitter::Result& result);
+
+    /**
+     * MINUIT fit with photon, hadron, and background photon, the ADC values
+     * and templates are passed in global variables.
+     * @param[out] result Fit result.
      */
-    void fitPhotonHadronBackgroundPhoton(
-      double& pedestal, double& amplitudePhoton, double& signalTime,
-      double& amplitudeHadron, double& amplitudeBackgroundPhoton,
-      double& timeBackgroundPhoton, double& chi2);
+    void fitPhotonHadronBackgroundPhotonMinuit(ECL::ECLWaveformTemplateFitter::Result& result);
 
     /** Energy threshold to fit pulse offline. */
     double m_EnergyThreshold{0.03};
@@ -197,12 +125,24 @@ namespace Belle2 {
     /** Option to use crystal dependent covariance matrices. */
     bool m_CovarianceMatrix{true};
 
+    /** Use the former MINUIT fits instead of ECL::ECLWaveformTemplateFitter. */
+    bool m_UseMinuit{false};
+
     /** Flag to indicate if waveform templates are loaded from database. */
     bool m_TemplatesLoaded{false};
 
     /** Calibration vector from ADC to energy. */
     std::vector<double> m_ADCtoEnergy;
 
+    /** Template fitter. */
+    ECL::ECLWaveformTemplateFitter m_Fitter;
+
+    /** Index of the first ECLDigit of each crystal in the event, -1 if there is none. */
+    std::vector<int> m_DigitIndex;
+
+    /** Indices of the ECLDsps to fit in the event. */
+    std::vector<int> m_FitIndices;
+
     /** Minuit minimizer for fit with photon and hadron. */
     TMinuit* m_MinuitPhotonHadron = nullptr;
 
@@ -11,7 +11,6 @@
 
 /* ECL headers. */
 #include <ecl/digitization/EclConfiguration.h>
-#include <ecl/digitization/shaperdsp.h>
 
 /* Basf2 headers. */
 #include <framework/core/Environment.h>
@@ -22,6 +21,9 @@
 #include <TMatrixDSym.h>
 #include <TDecompChol.h>
 
+/* C++ headers. */
+#include <algorithm>
+
 using namespace Belle2;
 using namespace ECL;
 
@@ -205,6 +207,9 @@ ECLWaveformFitModule::ECLWaveformFitModule()
            "Option to use crystal-dependent covariance matrices (false uses identity matrix).",
            true);
   addParam("RegParam1", m_u1, "u1 parameter for regularization function).", 1.0);
+  addParam("UseMinuit", m_UseMinuit,
+           "Use the former MINUIT fits instead of the template fitter with analytic amplitudes (for validation only).",
+           false);
 }
 
 ECLWaveformFitModule::~ECLWaveformFitModule()
@@ -312,6 +317,7 @@ void ECLWaveformFitModule::beginRun()
     }
     ecl_waveform_fit_load_inverse_covariance(
       packedDefaultCovariance.m_covMatPacked);
+    m_Fitter.setInverseCovariance(packedDefaultCovariance);
   }
 
 }
@@ -363,15 +369,21 @@ void ECLWaveformFitModule::initialize()
 
 void ECLWaveformFitModule::event()
 {
-  const EclConfiguration& ec = EclConfiguration::get();
-
   if (!m_TemplatesLoaded) {
     /* Load templates once per run in first event that has saved waveforms. */
     if (m_eclDSPs.getEntries() > 0)
       loadTemplateParameterArray();
   }
 
-  for (ECLDsp& aECLDsp : m_eclDSPs) {
+  /* First ECLDigit of each crystal. */
+  m_DigitIndex.assign(ECLElementNumbers::c_NCrystals, -1);
+  for (int i = m_eclDigits.getEntries() - 1; i >= 0; --i)
+    m_DigitIndex[m_eclDigits[i]->getCellId() - 1] = i;
+
+  /* Reset the fit results and select the waveforms to fit. */
+  m_FitIndices.clear();
+  for (int i = 0; i < m_eclDSPs.getEntries(); ++i) {
+    ECLDsp& aECLDsp = *m_eclDSPs[i];
 
     aECLDsp.setTwoComponentTotalAmp(-1);
     aECLDsp.setTwoComponentHadronAmp(-1);
@@ -386,104 +398,137 @@ void ECLWaveformFitModule::event()
 
     const int id = aECLDsp.getCellId() - 1;
 
-    // Filling array with ADC values.
-    for (int j = 0; j < ec.m_nsmp; j++)
-      fitA[j] = aECLDsp.getDspA()[j];
-
     //setting relation of eclDSP to aECLDigit
-    const ECLDigit* d = nullptr;
-    for (const ECLDigit& aECLDigit : m_eclDigits) {
-      if (aECLDigit.getCellId() - 1 == id) {
-        d = &aECLDigit;
-        aECLDsp.addRelationTo(&aECLDigit);
-        break;
-      }
-    }
-    if (d == nullptr)
+    if (m_DigitIndex[id] < 0)
       continue;
+    const ECLDigit* d = m_eclDigits[m_DigitIndex[id]];
+    aECLDsp.addRelationTo(d);
 
     //Skipping low amplitude waveforms
     if (d->getAmp() * m_ADCtoEnergy[id] < m_EnergyThreshold)
       continue;
 
-    //loading template for waveform
-    if (m_IsMCFlag == 0) {
-      //data cell id dependent
-      g_PhotonSignal = &m_SignalInterpolation[id][0];
-      g_HadronSignal = &m_SignalInterpolation[id][1];
-    } else {
-      // mc uses same waveform
-      g_PhotonSignal = &m_SignalInterpolation[0][0];
-      g_HadronSignal = &m_SignalInterpolation[0][1];
-    }
+    m_FitIndices.push_back(i);
+  }
+
+  /* Fit the selected waveforms. */
+  for (int i : m_FitIndices)
+    fitWaveform(*m_eclDSPs[i]);
+}
+
+void ECLWaveformFitModule::fitWaveform(ECLDsp& aECLDsp)
+{
+  const EclConfiguration& ec = EclConfiguration::get();
+  const int id = aECLDsp.getCellId() - 1;
+
+  // Filling array with ADC values.
+  double adc[c_NFitPoints];
+  for (int j = 0; j < ec.m_nsmp; j++)
+    adc[j] = aECLDsp.getDspA()[j];
 
-    //get covariance matrix for cell id
-    if (m_CovarianceMatrix) {
+  //loading template for waveform
+  const SignalInterpolation2* photonSignal;
+  const SignalInterpolation2* hadronSignal;
+  if (m_IsMCFlag == 0) {
+    //data cell id dependent
+    photonSignal = &m_SignalInterpolation[id][0];
+    hadronSignal = &m_SignalInterpolation[id][1];
+  } else {
+    // mc uses same waveform
+    photonSignal = &m_SignalInterpolation[0][0];
+    hadronSignal = &m_SignalInterpolation[0][1];
+  }
+
+  //get covariance matrix for cell id
+  if (m_CovarianceMatrix) {
+    if (m_UseMinuit) {
       ecl_waveform_fit_load_inverse_covariance(
         m_PackedCovariance[id].m_covMatPacked);
       aNoise = m_PackedCovariance[id].sigma;
+    } else {
+      m_Fitter.setInverseCovariance(m_PackedCovariance[id]);
     }
+  }
 
-    /* Fit with photon and hadron templates (fit type = 0). */
-    double pedestal, amplitudePhoton, signalTime, amplitudeHadron,
-           amplitudeBackgroundPhoton, timeBackgroundPhoton, chi2;
-    ECLDsp::TwoComponentFitType fitType = ECLDsp::photonHadron;
-    chi2 = -1;
-    fitPhotonHadron(pedestal, amplitudePhoton, signalTime, amplitudeHadron,
-                    chi2);
-    aECLDsp.setTwoComponentSavedChi2(ECLDsp::photonHadron, chi2);
-
-    /* If failed, try photon, hadron, and background photon (fit type = 1). */
-    if (chi2 >= m_Chi2Threshold27dof) {
-
-      fitType = ECLDsp::photonHadronBackgroundPhoton;
-      chi2 = -1;
-      fitPhotonHadronBackgroundPhoton(
-        pedestal, amplitudePhoton, signalTime, amplitudeHadron,
-        amplitudeBackgroundPhoton, timeBackgroundPhoton, chi2);
-      aECLDsp.setTwoComponentSavedChi2(ECLDsp::photonHadronBackgroundPhoton,
-                                       chi2);
-
-      /* If failed, try diode fit (fit type = 2). */
-      if (chi2 >= m_Chi2Threshold25dof) {
-        /* Set second component to diode. */
-        g_HadronSignal = &m_SignalInterpolation[0][2];
-        fitType = ECLDsp::photonDiodeCrossing;
-        chi2 = -1;
-        fitPhotonHadron(pedestal, amplitudePhoton, signalTime, amplitudeHadron,
-                        chi2);
-        aECLDsp.setTwoComponentSavedChi2(ECLDsp::photonDiodeCrossing, chi2);
-
-        /* Indicates that all fits tried had bad chi^2. */
-        if (chi2 >= m_Chi2Threshold27dof)
-          fitType = ECLDsp::poorChi2;
-      }
-
+  /* Fit with photon and hadron templates (fit type = 0). */
+  ECL::ECLWaveformTemplateFitter::Result result;
+  ECLDsp::TwoComponentFitType fitType = ECLDsp::photonHadron;
+  fitPhotonHadron(adc, *photonSignal, *hadronSignal, result);
+  aECLDsp.setTwoComponentSavedChi2(ECLDsp::photonHadron, result.chi2);
+
+  /* If failed, try photon, hadron, and background photon (fit type = 1). */
+  if (result.chi2 >= m_Chi2Threshold27dof) {
+
+    fitType = ECLDsp::photonHadronBackgroundPhoton;
+    fitPhotonHadronBackgroundPhoton(adc, *photonSignal, *hadronSignal, result);
+    aECLDsp.setTwoComponentSavedChi2(ECLDsp::photonHadronBackgroundPhoton,
+                                     result.chi2);
+
+    /* If failed, try diode fit (fit type = 2). */
+    if (result.chi2 >= m_Chi2Threshold25dof) {
+      /* Set second component to diode. */
+      fitType = ECLDsp::photonDiodeCrossing;
+      fitPhotonHadron(adc, *photonSignal, m_SignalInterpolation[0][2], result);
+      aECLDsp.setTwoComponentSavedChi2(ECLDsp::photonDiodeCrossing, result.chi2);
+
+      /* Indicates that all fits tried had bad chi^2. */
+      if (result.chi2 >= m_Chi2Threshold27dof)
+        fitType = ECLDsp::poorChi2;
     }
 
-    /* Storing fit results. */
-    aECLDsp.setTwoComponentTotalAmp(amplitudePhoton + amplitudeHadron);
-    if (fitType == ECLDsp::photonDiodeCrossing) {
-      aECLDsp.setTwoComponentHadronAmp(0.0);
-      aECLDsp.setTwoComponentDiodeAmp(amplitudeHadron);
-    } else {
-      aECLDsp.setTwoComponentHadronAmp(amplitudeHadron);
-      aECLDsp.setTwoComponentDiodeAmp(0.0);
-    }
-    aECLDsp.setTwoComponentChi2(chi2);
-    aECLDsp.setTwoComponentTime(signalTime);
-    aECLDsp.setTwoComponentBaseline(pedestal);
-    aECLDsp.setTwoComponentFitType(fitType);
-    if (fitType == ECLDsp::photonHadronBackgroundPhoton) {
-      aECLDsp.setBackgroundPhotonEnergy(amplitudeBackgroundPhoton);
-      aECLDsp.setBackgroundPhotonTime(timeBackgroundPhoton);
-    }
+  }
+
+  /* Storing fit results. */
+  aECLDsp.setTwoComponentTotalAmp(result.amplitudePhoton + result.amplitudeHadron);
+  if (fitType == ECLDsp::photonDiodeCrossing) {
+    aECLDsp.setTwoComponentHadronAmp(0.0);
+    aECLDsp.setTwoComponentDiodeAmp(result.amplitudeHadron);
+  } else {
+    aECLDsp.setTwoComponentHadronAmp(result.amplitudeHadron);
+    aECLDsp.setTwoComponentDiodeAmp(0.0);
+  }
+  aECLDsp.setTwoComponentChi2(result.chi2);
+  aECLDsp.setTwoComponentTime(result.signalTime);
+  aECLDsp.setTwoComponentBaseline(result.pedestal);
+  aECLDsp.setTwoComponentFitType(fitType);
+  if (fitType == ECLDsp::photonHadronBackgroundPhoton) {
+    aECLDsp.setBackgroundPhotonEnergy(result.amplitudeBackgroundPhoton);
+    aECLDsp.setBackgroundPhotonTime(result.timeBackgroundPhoton);
   }
 }
 
 void ECLWaveformFitModule::fitPhotonHadron(
-  double& pedestal, double& amplitudePhoton, double& signalTime,
-  double& amplitudeHadron, double& chi2)
+  const double* adc, const SignalInterpolation2& photon,
+  const SignalInterpolation2& hadron,
+  ECL::ECLWaveformTemplateFitter::Result& result)
+{
+  if (!m_UseMinuit) {
+    m_Fitter.fitPhotonHadron(adc, photon, hadron, result);
+    return;
+  }
+  std::copy(adc, adc + c_NFitPoints, fitA);
+  g_PhotonSignal = &photon;
+  g_HadronSignal = &hadron;
+  fitPhotonHadronMinuit(result);
+}
+
+void ECLWaveformFitModule::fitPhotonHadronBackgroundPhoton(
+  const double* adc, const SignalInterpolation2& photon,
+  const SignalInterpolation2& hadron,
+  ECL::ECLWaveformTemplateFitter::Result& result)
+{
+  if (!m_UseMinuit) {
+    m_Fitter.fitPhotonHadronBackgroundPhoton(adc, photon, hadron, result);
+    return;
+  }
+  std::copy(adc, adc + c_NFitPoints, fitA);
+  g_PhotonSignal = &photon;
+  g_HadronSignal = &hadron;
+  fitPhotonHadronBackgroundPhotonMinuit(result);
+}
+
+void ECLWaveformFitModule::fitPhotonHadronMinuit(
+  ECL::ECLWaveformTemplateFitter::Result& result)
 {
   //minuit parameters
   double arglist[10] = {0};
@@ -527,20 +572,18 @@ void ECLWaveformFitModule::fitPhotonHadron(
 
   double edm, errdef;
   int nvpar, nparx, icstat;
-  m_MinuitPhotonHadron->mnstat(chi2, edm, errdef, nvpar, nparx, icstat);
+  m_MinuitPhotonHadron->mnstat(result.chi2, edm, errdef, nvpar, nparx, icstat);
 
   //get fit results
   double error;
-  m_MinuitPhotonHadron->GetParameter(0, pedestal, error);
-  m_MinuitPhotonHadron->GetParameter(1, amplitudePhoton, error);
-  m_MinuitPhotonHadron->GetParameter(2, signalTime, error);
-  m_MinuitPhotonHadron->GetParameter(3, amplitudeHadron, error);
+  m_MinuitPhotonHadron->GetParameter(0, result.pedestal, error);
+  m_MinuitPhotonHadron->GetParameter(1, result.amplitudePhoton, error);
+  m_MinuitPhotonHadron->GetParameter(2, result.signalTime, error);
+  m_MinuitPhotonHadron->GetParameter(3, result.amplitudeHadron, error);
 }
 
-void ECLWaveformFitModule::fitPhotonHadronBackgroundPhoton(
-  double& pedestal, double& amplitudePhoton, double& signalTime,
-  double& amplitudeHadron, double& amplitudeBackgroundPhoton,
-  double& timeBackgroundPhoton, double& chi2)
+void ECLWaveformFitModule::fitPhotonHadronBackgroundPhotonMinuit(
+  ECL::ECLWaveformTemplateFitter::Result& result)
 {
   double arglist[10] = {0};
   int ierflg = 0;
@@ -612,154 +655,14 @@ void ECLWaveformFitModule::fitPhotonHadronBackgroundPhoton(
 
   double edm, errdef;
   int nvpar, nparx, icstat;
-  m_MinuitPhotonHadronBackgroundPhoton->mnstat(chi2, edm, errdef, nvpar, nparx, icstat);
+  m_MinuitPhotonHadronBackgroundPhoton->mnstat(result.chi2, edm, errdef, nvpar, nparx, icstat);
   double error;
-  m_MinuitPhotonHadronBackgroundPhoton->GetParameter(0, pedestal, error);
-  m_MinuitPhotonHadronBackgroundPhoton->GetParameter(1, amplitudePhoton, error);
-  m_MinuitPhotonHadronBackgroundPhoton->GetParameter(2, signalTime, error);
-  m_MinuitPhotonHadronBackgroundPhoton->GetParameter(3, amplitudeHadron, error);
+  m_MinuitPhotonHadronBackgroundPhoton->GetParameter(0, result.pedestal, error);
+  m_MinuitPhotonHadronBackgroundPhoton->GetParameter(1, result.amplitudePhoton, error);
+  m_MinuitPhotonHadronBackgroundPhoton->GetParameter(2, result.signalTime, error);
+  m_MinuitPhotonHadronBackgroundPhoton->GetParameter(3, result.amplitudeHadron, error);
   m_MinuitPhotonHadronBackgroundPhoton->GetParameter(
-    4, amplitudeBackgroundPhoton, error);
+    4, result.amplitudeBackgroundPhoton, error);
   m_MinuitPhotonHadronBackgroundPhoton->GetParameter(
-    5, timeBackgroundPhoton, error);
-}
-
-SignalInterpolation2::SignalInterpolation2(const std::vector<double>& s)
-{
-  double T0 = -0.2;
-  std::vector<double> p(s.begin() + 1, s.end());
-  p[1] = std::max(0.0029, p[1]);
-  p[4] = std::max(0.0029, p[4]);
-
-  ShaperDSP_t dsp(p, s[0]);
-  dsp.settimestride(c_dtn);
-  dsp.settimeseed(T0);
-  dd_t t[(c_nt + c_ntail)*c_ndt];
-  dsp.fillarray(sizeof(t) / sizeof(t[0]), t);
-
-  for (int i = 0; i < c_nt * c_ndt; i++) {
-    m_FunctionInterpolation[i] = t[i].first;
-    m_DerivativeInterpolation[i] = t[i].second;
-  }
-  for (int i = 0; i < c_ntail; i++) {
-    int j = c_nt * c_ndt + i;
-    int k = c_nt * c_ndt + i * c_ndt;
-    m_FunctionInterpolation[j] = t[k].first;
-    m_DerivativeInterpolation[j] = t[k].second;
-  }
-  int i1 = c_nt * c_ndt + c_ntail - 2;
-  int i2 = c_nt * c_ndt + c_ntail - 1;
-  m_r0 = m_FunctionInterpolation[i2] / m_FunctionInterpolation[i1];
-  m_r1 = m_DerivativeInterpolation[i2] / m_DerivativeInterpolation[i1];
-}
-
-void SignalInterpolation2::getShape(
-  double t0, double* function, double* derivatives) const
-{
-  /* If before pulse start time (negative times), return 0. */
-  int k = 0;
-  while (t0 < 0) {
-    function[k] = 0;
-    derivatives[k] = 0;
-    t0 += c_dt;
-    ++k;
-    if (k >= c_NFitPoints)
-      return;
-  }
-
-  /* Function and derivative values. */
-  double function0[c_NFitPoints], function1[c_NFitPoints];
-  double derivative0[c_NFitPoints], derivative1[c_NFitPoints];
-
-  /* Interpolate first c_nt points (short time steps). */
-  double x = t0 * c_idtn;
-  double ix = floor(x);
-  double w = x - ix;
-  int j = ix;
-  double w2 = w * w;
-  double hw2 = 0.5 * w2;
-  double tw3 = ((1. / 6) * w) * w2;
-
-  /* Number of interpolation points. */
-  int iMax = k + c_nt;
-  if (iMax > c_NFitPoints)
-    iMax = c_NFitPoints;
-
-  /* Fill interpolation points. */
-  for (int i = k; i < iMax; ++i) {
-    function0[i] = m_FunctionInterpolation[j];
-    function1[i] = m_FunctionInterpolation[j + 1];
-    derivative0[i] = m_DerivativeInterpolation[j];
-    derivative1[i] = m_DerivativeInterpolation[j + 1];
-    j = j + c_ndt;
-  }
-
-  /* Interpolation. */
-  #pragma omp simd
-  for (int i = k; i < iMax; ++i) {
-    double a[4];
-    double dfdt = (function1[i] - function0[i]) * c_idtn;
-    double fp = derivative1[i] + derivative0[i];
-    a[0] = function0[i];
-    a[1] = derivative0[i];
-    a[2] = -((fp + derivative0[i]) - 3 * dfdt);
-    a[3] = fp - 2 * dfdt;
-    double b2 = 2 * a[2];
-    double b3 = 6 * a[3];
-    function[i] = a[0] + c_dtn * (a[1] * w + b2 * hw2 + b3 * tw3);
-    derivatives[i] = a[1] + b2 * w + b3 * hw2;
-  }
-  t0 = t0 + c_dt * c_nt;
-  if (iMax == c_NFitPoints)
-    return;
-  k = iMax;
-
-  /* Interpolate next c_ntail points (long time steps). */
-  x = t0 * c_idt;
-  ix = floor(x);
-  w = x - ix;
-  w2 = w * w;
-  hw2 = 0.5 * w2;
-  tw3 = ((1. / 6) * w) * w2;
-
-  /* Number of interpolation points. */
-  iMax = k + c_ntail - 1;
-  if (iMax > c_NFitPoints)
-    iMax = c_NFitPoints;
-
-  /* Interpolation. */
-  #pragma omp simd
-  for (int i = k; i < iMax; ++i) {
-    j = c_nt * c_ndt + i - k;
-    /*
-     * The interpolation step is the same as the distance between
-     * the fit points. It is possible to load the values in the interpolation
-     * loop while keeping its vectorization.
-     */
-    double f0 = m_FunctionInterpolation[j];
-    double f1 = m_FunctionInterpolation[j + 1];
-    double fp0 = m_DerivativeInterpolation[j];
-    double fp1 = m_DerivativeInterpolation[j + 1];
-    double a[4];
-    double dfdt = (f1 - f0) * c_idt;
-    double fp = fp1 + fp0;
-    a[0] = f0;
-    a[1] = fp0;
-    a[2] = -((fp + fp0) - 3 * dfdt);
-    a[3] = fp - 2 * dfdt;
-    double b2 = 2 * a[2];
-    double b3 = 6 * a[3];
-    function[i] = a[0] + c_dt * (a[1] * w + b2 * hw2 + b3 * tw3);
-    derivatives[i] = a[1] + b2 * w + b3 * hw2;
-  }
-  if (iMax == c_NFitPoints)
-    return;
-  k = iMax;
-
-  /* Exponential tail. */
-  while (k < c_NFitPoints) {
-    function[k] = function[k - 1] * m_r0;
-    derivatives[k] = derivatives[k - 1] * m_r1;
-    ++k;
-  }
+    5, result.timeBackgroundPhoton, error);
 }
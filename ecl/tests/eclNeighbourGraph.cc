@@ -0,0 +1,91 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#include <ecl/geometry/ECLNeighbourGraph.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace std;
+
+namespace Belle2 {
+  namespace ECL {
+
+    /** Graph with the neighbours i - 1, i, i + 1 for each cell i */
+    class ECLNeighbourGraphTest : public ::testing::Test {
+    protected:
+      /** Set up the neighbour lists */
+      void SetUp() override
+      {
+        m_lists.resize(ECLElementNumbers::c_NCrystals + 1);
+        for (short cellId = 1; cellId <= ECLElementNumbers::c_NCrystals; cellId++) {
+          if (cellId > 1) m_lists[cellId].push_back(cellId - 1);
+          m_lists[cellId].push_back(cellId);
+          if (cellId < ECLElementNumbers::c_NCrystals) m_lists[cellId].push_back(cellId + 1);
+        }
+      }
+
+      /** Neighbour lists */
+      vector<vector<short>> m_lists;
+    };
+
+    /** The graph reproduces the neighbour lists */
+    TEST_F(ECLNeighbourGraphTest, Neighbours)
+    {
+      m_lists[100] = {100, 7, 8000};
+      const ECLNeighbourGraph graph(m_lists);
+      for (int cellId = 1; cellId <= ECLElementNumbers::c_NCrystals; cellId++) {
+        const ECLNeighbourGraph::Neighbours neighbours = graph.getNeighbours(cellId);
+        ASSERT_EQ(neighbours.size(), static_cast<int>(m_lists[cellId].size()));
+        EXPECT_TRUE(std::equal(neighbours.begin(), neighbours.end(), m_lists[cellId].begin()));
+      }
+      EXPECT_TRUE(graph.isNeighbour(100, 8000));
+      EXPECT_FALSE(graph.isNeighbour(100, 101));
+      EXPECT_FALSE(graph.isNeighbour(8000, 100));
+    }
+
+    /** Cell sets keep the insertion order and are cleared completely */
+    TEST_F(ECLNeighbourGraphTest, CellSet)
+    {
+      ECLCellSet cells;
+      EXPECT_TRUE(cells.empty());
+      EXPECT_TRUE(cells.insert(5));
+      EXPECT_TRUE(cells.insert(ECLElementNumbers::c_NCrystals));
+      EXPECT_TRUE(cells.insert(1));
+      EXPECT_FALSE(cells.insert(5));
+      EXPECT_EQ(cells.size(), 3);
+      EXPECT_EQ(cells.getCells(), vector<int>({5, ECLElementNumbers::c_NCrystals, 1}));
+      cells.sort();
+      EXPECT_EQ(cells.getCells(), vector<int>({1, 5, ECLElementNumbers::c_NCrystals}));
+      EXPECT_TRUE(cells.contains(ECLElementNumbers::c_NCrystals));
+      cells.clear();
+      EXPECT_TRUE(cells.empty());
+      for (int cellId = 0; cellId <= ECLElementNumbers::c_NCrystals; cellId++)
+        EXPECT_FALSE(cells.contains(cellId));
+    }
+
+    /** Region growing adds the neighbours in the mask by one step only */
+    TEST_F(ECLNeighbourGraphTest, Grow)
+    {
+      const ECLNeighbourGraph graph(m_lists);
+      ECLCellSet seeds, mask, grown;
+      seeds.insert(10);
+      for (int cellId = 5; cellId <= 20; cellId++)
+        if (cellId != 12) mask.insert(cellId);
+      graph.grow(seeds, mask, grown);
+      grown.sort();
+      EXPECT_EQ(grown.getCells(), vector<int>({9, 10, 11}));
+      // growing in place uses the cells of the previous step only
+      graph.grow(grown, mask, grown);
+      grown.sort();
+      EXPECT_EQ(grown.getCells(), vector<int>({8, 9, 10, 11}));
+    }
+
+  }
+}
@@ -0,0 +1,44 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#include <ecl/dbobjects/ECLWaveformData.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+using namespace std;
+
+namespace Belle2 {
+
+  /** Declare ECLNoiseData test */
+  class ECLNoiseDataTest : public ::testing::Test {};
+
+  /** The correlated noise of a batch of vectors is identical to the one of single vectors */
+  TEST_F(ECLNoiseDataTest, BatchedCorrelatedNoise)
+  {
+    mt19937 generator(42);
+    normal_distribution<float> normal;
+
+    ECLNoiseData noise;
+    for (size_t i = 0; i < ECLNoiseData::c_nElements; i++) noise.setMatrixElement(i, normal(generator));
+
+    const int n = 13;
+    vector<float> z(31 * n), x(31 * n);
+    for (float& value : z) value = normal(generator);
+    noise.generateCorrelatedNoise(n, z.data(), x.data());
+
+    for (int k = 0; k < n; k++) {
+      float zSingle[31], xSingle[31];
+      for (int i = 0; i < 31; i++) zSingle[i] = z[i * n + k];
+      noise.generateCorrelatedNoise(zSingle, xSingle);
+      for (int i = 0; i < 31; i++) EXPECT_EQ(x[i * n + k], xSingle[i]);
+    }
+  }
+}
@@ -0,0 +1,153 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#include <ecl/digitization/ECLWaveformTemplateFitter.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+using namespace std;
+
+namespace Belle2 {
+  namespace ECL {
+
+    /** Fixture with the MC templates and an uncorrelated noise of 7.5 ADC counts */
+    class ECLWaveformTemplateFitterTest : public ::testing::Test {
+    protected:
+      /** Set up the templates and the inverse covariance matrix */
+      void SetUp() override
+      {
+        m_photon = SignalInterpolation2({27.7221, 0.5, 0.648324, 0.401711, 0.374167, 0.849417,
+                                         0.00144548, 4.70722, 0.815639, 0.555605, 0.2752});
+        m_hadron = SignalInterpolation2({29.5092, 0.542623, 0.929354, 0.556139, 0.446967, 0.140175,
+                                         0.0312971, 3.12842, 0.791012, 0.619416, 0.385621});
+        CovariancePacked inverseCovariance;
+        int k = 0;
+        for (int i = 0; i < c_NFitPoints; i++)
+          for (int j = 0; j < i + 1; j++)
+            inverseCovariance[k++] = (i == j) / (c_sigma * c_sigma);
+        m_fitter.setInverseCovariance(inverseCovariance);
+      }
+
+      /** Waveform with the given parameters and Gaussian noise */
+      void makeWaveform(double pedestal, double amplitudePhoton, double time, double amplitudeHadron,
+                        double amplitudeBackgroundPhoton, double timeBackgroundPhoton, double sigma)
+      {
+        double f[c_NFitPoints], df[c_NFitPoints];
+        for (int i = 0; i < c_NFitPoints; i++) m_adc[i] = pedestal + sigma * m_normal(m_generator);
+        m_photon.getShape(time, f, df);
+        for (int i = 0; i < c_NFitPoints; i++) m_adc[i] += amplitudePhoton * f[i];
+        m_hadron.getShape(time, f, df);
+        for (int i = 0; i < c_NFitPoints; i++) m_adc[i] += amplitudeHadron * f[i];
+        m_photon.getShape(timeBackgroundPhoton, f, df);
+        for (int i = 0; i < c_NFitPoints; i++) m_adc[i] += amplitudeBackgroundPhoton * f[i];
+      }
+
+      /** Chi-squared of the waveform for the given parameters */
+      double chi2(double pedestal, double amplitudePhoton, double time, double amplitudeHadron) const
+      {
+        double f[c_NFitPoints], df[c_NFitPoints], h[c_NFitPoints], dh[c_NFitPoints];
+        m_photon.getShape(time, f, df);
+        m_hadron.getShape(time, h, dh);
+        double sum = 0;
+        for (int i = 0; i < c_NFitPoints; i++) {
+          const double r = m_adc[i] - pedestal - amplitudePhoton * f[i] - amplitudeHadron * h[i];
+          sum += r * r / (c_sigma * c_sigma);
+        }
+        return sum;
+      }
+
+      /** Number of fit points */
+      static constexpr int c_NFitPoints = ECLWaveformTemplateFitter::c_NFitPoints;
+      /** Noise level */
+      static constexpr double c_sigma = 7.5;
+      /** Photon template */
+      SignalInterpolation2 m_photon;
+      /** Hadron template */
+      SignalInterpolation2 m_hadron;
+      /** The fitter */
+      ECLWaveformTemplateFitter m_fitter;
+      /** ADC values */
+      double m_adc[c_NFitPoints] = {};
+      /** Random generator */
+      mt19937 m_generator{42};
+      /** Standard normal distribution */
+      normal_distribution<double> m_normal;
+    };
+
+    /** Waveforms without noise are reproduced exactly */
+    TEST_F(ECLWaveformTemplateFitterTest, PhotonHadronWithoutNoise)
+    {
+      makeWaveform(3000, 5000, -3.7, 800, 0, 0, 0);
+      ECLWaveformTemplateFitter::Result result;
+      m_fitter.fitPhotonHadron(m_adc, m_photon, m_hadron, result);
+      EXPECT_NEAR(result.pedestal, 3000, 1e-3);
+      EXPECT_NEAR(result.amplitudePhoton, 5000, 1e-2);
+      EXPECT_NEAR(result.signalTime, -3.7, 1e-6);
+      EXPECT_NEAR(result.amplitudeHadron, 800, 1e-2);
+      EXPECT_LT(result.chi2, 1e-6);
+      EXPECT_GT(result.nIterations, 0);
+    }
+
+    /** The fit result is a minimum of the chi-squared for noisy waveforms */
+    TEST_F(ECLWaveformTemplateFitterTest, PhotonHadronMinimum)
+    {
+      double sumChi2 = 0;
+      const int nWaveforms = 200;
+      for (int iWaveform = 0; iWaveform < nWaveforms; iWaveform++) {
+        makeWaveform(3000, 2000, -3.5, 200, 0, 0, c_sigma);
+        ECLWaveformTemplateFitter::Result result;
+        m_fitter.fitPhotonHadron(m_adc, m_photon, m_hadron, result);
+        const double chi2Fit = chi2(result.pedestal, result.amplitudePhoton, result.signalTime, result.amplitudeHadron);
+        EXPECT_NEAR(result.chi2, chi2Fit, 1e-6 * chi2Fit);
+        EXPECT_LE(result.chi2, chi2(3000, 2000, -3.5, 200) + 1e-9);
+        for (double dt : { -1e-3, 1e-3}) {
+          for (double da : { -1., 1.}) {
+            EXPECT_LE(result.chi2, chi2(result.pedestal, result.amplitudePhoton + da, result.signalTime + dt,
+                                        result.amplitudeHadron - da) + 1e-9);
+          }
+        }
+        EXPECT_NEAR(result.signalTime, -3.5, 0.05);
+        sumChi2 += result.chi2;
+      }
+      // 31 points and 4 parameters
+      EXPECT_NEAR(sumChi2 / nWaveforms, 27, 2);
+    }
+
+    /** The photon amplitude stays within its bounds */
+    TEST_F(ECLWaveformTemplateFitterTest, AmplitudeBounds)
+    {
+      makeWaveform(3000, -500, -3.5, 1500, 0, 0, 0);
+      ECLWaveformTemplateFitter::Result result;
+      m_fitter.fitPhotonHadron(m_adc, m_photon, m_hadron, result);
+      EXPECT_GE(result.amplitudePhoton, 0);
+      EXPECT_LE(result.chi2, chi2(result.pedestal, result.amplitudePhoton + 1, result.signalTime, result.amplitudeHadron));
+    }
+
+    /** A waveform with a background photon is described by the fit with background photon */
+    TEST_F(ECLWaveformTemplateFitterTest, PhotonHadronBackgroundPhoton)
+    {
+      // background photon 1.9 time units before the signal
+      makeWaveform(3000, 5000, -4.5, 500, 2000, -0.7, 0);
+      ECLWaveformTemplateFitter::Result result;
+      m_fitter.fitPhotonHadron(m_adc, m_photon, m_hadron, result);
+      EXPECT_GT(result.chi2, 1000);
+      m_fitter.fitPhotonHadronBackgroundPhoton(m_adc, m_photon, m_hadron, result);
+      EXPECT_LT(result.chi2, 1e-6);
+      EXPECT_NEAR(result.pedestal, 3000, 1e-3);
+      EXPECT_NEAR(result.amplitudePhoton, 5000, 1e-2);
+      EXPECT_NEAR(result.signalTime, -4.5, 1e-6);
+      EXPECT_NEAR(result.amplitudeHadron, 500, 1e-2);
+      EXPECT_NEAR(result.amplitudeBackgroundPhoton, 2000, 1e-2);
+      EXPECT_NEAR(result.timeBackgroundPhoton, -0.7, 1e-6);
+    }
+
+  }
+}
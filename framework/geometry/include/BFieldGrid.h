@@ -0,0 +1,94 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#pragma once
+
+#include <Math/Vector3D.h>
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace Belle2 {
+  /** Precomputed magnetic field on a regular Cartesian grid.
+   *
+   * The field is evaluated once at all grid nodes (usually from the full
+   * MagneticField with all its components) and afterwards obtained by trilinear
+   * interpolation. This is much faster than going through all components with
+   * their own interpolation for every single point, at the price of the
+   * interpolation error of the grid (see BFieldManager::setGrid()).
+   *
+   * The field components are stored as separate float arrays to keep the
+   * memory footprint small.
+   */
+  class BFieldGrid {
+  public:
+    /** Region and spacing of the grid, all in framework units */
+    struct Binning {
+      double xyMax{0}; /**< the grid covers -xyMax to xyMax in x and y */
+      double zMin{0}; /**< lower edge of the grid in z */
+      double zMax{0}; /**< upper edge of the grid in z */
+      double spacing{0}; /**< distance between neighbouring grid nodes */
+    };
+
+    /** Fill the grid by evaluating the given field at all grid nodes
+     * @param binning region and spacing of the grid
+     * @param field function returning the field at a given position
+     */
+    BFieldGrid(const Binning& binning, const std::function<ROOT::Math::XYZVector(const ROOT::Math::XYZVector&)>& field);
+
+    /** Return the binning of the grid */
+    const Binning& getBinning() const { return m_binning; }
+    /** Return the number of grid nodes */
+    std::size_t getNumberOfNodes() const { return m_nX * m_nY * m_nZ; }
+
+    /** Check whether the point is covered by the grid */
+    bool inside(double x, double y, double z) const
+    {
+      return x >= m_xMin and x <= m_xMax and y >= m_xMin and y <= m_xMax and z >= m_zMin and z <= m_zMax;
+    }
+
+    /** Interpolate the field at the given position
+     * @param x x coordinate of the position
+     * @param y y coordinate of the position
+     * @param z z coordinate of the position
+     * @param[out] field interpolated field, needs to be of at least size 3
+     * @returns false (and does not touch field) if the position is outside of the grid
+     */
+    bool getField(double x, double y, double z, double* field) const;
+
+  private:
+    /** Index of the grid node with the given indices along the axes */
+    std::size_t getNode(std::size_t iX, std::size_t iY, std::size_t iZ) const { return (iZ * m_nY + iY) * m_nX + iX; }
+
+    /** Binning of the grid */
+    Binning m_binning;
+    /** Lower edge in x and y */
+    double m_xMin;
+    /** Upper edge in x and y */
+    double m_xMax;
+    /** Lower edge in z */
+    double m_zMin;
+    /** Upper edge in z */
+    double m_zMax;
+    /** Inverse of the spacing */
+    double m_inverseSpacing;
+    /** Number of nodes in x */
+    std::size_t m_nX;
+    /** Number of nodes in y */
+    std::size_t m_nY;
+    /** Number of nodes in z */
+    std::size_t m_nZ;
+    /** x component of the field at all nodes. The nodes are ordered with x running fastest. */
+    std::vector<float> m_bx;
+    /** y component of the field at all nodes */
+    std::vector<float> m_by;
+    /** z component of the field at all nodes */
+    std::vector<float> m_bz;
+  };
+}
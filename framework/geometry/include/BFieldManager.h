@@ -13,6 +13,10 @@
 #include <framework/gearbox/Unit.h>
 #include <framework/database/DBObjPtr.h>
 #include <framework/dbobjects/MagneticField.h>
+#include <framework/geometry/BFieldGrid.h>
+
+#include <memory>
+#include <optional>
 
 namespace Belle2 {
   /** Bfield manager to obtain the magnetic field at any point.
@@ -57,11 +61,27 @@ namespace Belle2 {
     {
       return getField(pos) / Unit::T;
     }
+    /** return the magnetic field at a given position, using the precomputed grid if one was set with setGrid()
+     * and the position is covered by it. Otherwise this is the same as getField().
+     * @param[in] pos position in framework units, needs to be of at least size 3
+     * @param[out] field magnetic field field value at position pos in framework units
+     */
+    static void getGridField(const double* pos, double* field);
+    /** Use a precomputed grid with the given binning for getGridField().
+     * The grid is filled immediately if the field is already available and otherwise when it is loaded
+     * from the database. It is filled again whenever the field changes. This happens only in the calling
+     * thread or in the database update at the beginning of a run, so that threads which call getGridField()
+     * during the event processing only read a grid which does not change.
+     * The trilinear interpolation error scales with the square of the grid spacing.
+     */
+    static void setGrid(const BFieldGrid::Binning& binning);
+    /** Do not use a grid anymore, getGridField() then returns the full field */
+    static void resetGrid();
     /** Return the instance of the magnetic field manager */
     static BFieldManager& getInstance();
   private:
     /** Singleton: private constructor */
-    BFieldManager() = default;
+    BFieldManager() { m_magfield.addCallback(this, &BFieldManager::fillGrid); }
     /** Singleton: no copy constructor */
     BFieldManager(BFieldManager&) = delete;
     /** Singleton: no assignment operator */
@@ -73,8 +93,16 @@ namespace Belle2 {
      * @returns magnetic field value at position pos
      */
     ROOT::Math::XYZVector calculate(const ROOT::Math::XYZVector& pos) const;
+    /** Return the filled grid or nullptr if no grid should be used or the field is not available yet */
+    const BFieldGrid* getGrid() const { return m_grid.get(); }
+    /** Fill the grid with the current field, or remove it if no grid should be used or there is no field */
+    void fillGrid();
     /** Pointer to the actual magnetic field in the database */
     DBObjPtr<MagneticField> m_magfield;
+    /** Binning of the precomputed grid, if one should be used */
+    std::optional<BFieldGrid::Binning> m_gridBinning;
+    /** Precomputed grid of the current field */
+    std::unique_ptr<BFieldGrid> m_grid;
   };
 
   inline ROOT::Math::XYZVector BFieldManager::calculate(const ROOT::Math::XYZVector& pos) const
@@ -83,6 +111,14 @@ namespace Belle2 {
     return m_magfield->getField(pos);
   };
 
+  inline void BFieldManager::getGridField(const double* pos, double* field)
+  {
+    const BFieldGrid* grid = getInstance().getGrid();
+    if (!grid or !grid->getField(pos[0], pos[1], pos[2], field)) {
+      getField(pos, field);
+    }
+  }
+
   inline void BFieldManager::getField(const double* pos, double* field)
   {
     ROOT::Math::XYZVector fieldvec = getField(ROOT::Math::XYZVector(pos[0], pos[1], pos[2]));
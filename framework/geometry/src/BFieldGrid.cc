@@ -0,0 +1,102 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#include <framework/geometry/BFieldGrid.h>
+#include <framework/logging/Logger.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace Belle2;
+
+namespace {
+  /** Position of one point in the grid: the lower corner node and the relative position in the cell */
+  struct GridPosition {
+    std::size_t node; /**< index of the lower corner node of the cell */
+    double tx; /**< relative position in x inside the cell (0 to 1) */
+    double ty; /**< relative position in y inside the cell (0 to 1) */
+    double tz; /**< relative position in z inside the cell (0 to 1) */
+  };
+
+  /** Trilinear interpolation of one field component inside the cell */
+  inline double interpolate(const float* values, const GridPosition& position, std::size_t strideY, std::size_t strideZ)
+  {
+    const float* corner = values + position.node;
+    const double c00 = corner[0] + position.tx * (corner[1] - corner[0]);
+    const double c10 = corner[strideY] + position.tx * (corner[strideY + 1] - corner[strideY]);
+    const double c01 = corner[strideZ] + position.tx * (corner[strideZ + 1] - corner[strideZ]);
+    const double c11 = corner[strideZ + strideY] + position.tx * (corner[strideZ + strideY + 1] - corner[strideZ + strideY]);
+    const double c0 = c00 + position.ty * (c10 - c00);
+    const double c1 = c01 + position.ty * (c11 - c01);
+    return c0 + position.tz * (c1 - c0);
+  }
+
+  /** Cell index and relative position along one axis. Points on the upper edge belong to the last cell. */
+  inline std::size_t getCell(double coordinate, double lowerEdge, double inverseSpacing, std::size_t nNodes, double& relative)
+  {
+    const double position = (coordinate - lowerEdge) * inverseSpacing;
+    const std::size_t cell = std::min(static_cast<std::size_t>(position), nNodes - 2);
+    relative = position - cell;
+    return cell;
+  }
+}
+
+BFieldGrid::BFieldGrid(const Binning& binning,
+                       const std::function<ROOT::Math::XYZVector(const ROOT::Math::XYZVector&)>& field):
+  m_binning(binning)
+{
+  if (binning.spacing <= 0 or binning.xyMax <= 0 or binning.zMax <= binning.zMin) {
+    B2FATAL("Invalid magnetic field grid" << LogVar("xyMax", binning.xyMax) << LogVar("zMin", binning.zMin)
+            << LogVar("zMax", binning.zMax) << LogVar("spacing", binning.spacing));
+  }
+  // the grid covers at least the requested region
+  m_nX = m_nY = static_cast<std::size_t>(std::ceil(2 * binning.xyMax / binning.spacing)) + 1;
+  m_nZ = static_cast<std::size_t>(std::ceil((binning.zMax - binning.zMin) / binning.spacing)) + 1;
+  m_xMin = -binning.xyMax;
+  m_xMax = m_xMin + (m_nX - 1) * binning.spacing;
+  m_zMin = binning.zMin;
+  m_zMax = m_zMin + (m_nZ - 1) * binning.spacing;
+  m_inverseSpacing = 1. / binning.spacing;
+
+  const std::size_t nNodes = getNumberOfNodes();
+  m_bx.assign(nNodes, 0);
+  m_by.assign(nNodes, 0);
+  m_bz.assign(nNodes, 0);
+
+  for (std::size_t iZ = 0; iZ < m_nZ; ++iZ) {
+    const double z = m_zMin + iZ * binning.spacing;
+    for (std::size_t iY = 0; iY < m_nY; ++iY) {
+      const double y = m_xMin + iY * binning.spacing;
+      for (std::size_t iX = 0; iX < m_nX; ++iX) {
+        const double x = m_xMin + iX * binning.spacing;
+        const ROOT::Math::XYZVector value = field(ROOT::Math::XYZVector(x, y, z));
+        const std::size_t node = getNode(iX, iY, iZ);
+        m_bx[node] = value.X();
+        m_by[node] = value.Y();
+        m_bz[node] = value.Z();
+      }
+    }
+  }
+}
+
+bool BFieldGrid::getField(double x, double y, double z, double* field) const
+{
+  if (not inside(x, y, z)) return false;
+
+  GridPosition position;
+  const std::size_t iX = getCell(x, m_xMin, m_inverseSpacing, m_nX, position.tx);
+  const std::size_t iY = getCell(y, m_xMin, m_inverseSpacing, m_nY, position.ty);
+  const std::size_t iZ = getCell(z, m_zMin, m_inverseSpacing, m_nZ, position.tz);
+  position.node = getNode(iX, iY, iZ);
+
+  const std::size_t strideZ = m_nX * m_nY;
+  field[0] = interpolate(m_bx.data(), position, m_nX, strideZ);
+  field[1] = interpolate(m_by.data(), position, m_nX, strideZ);
+  field[2] = interpolate(m_bz.data(), position, m_nX, strideZ);
+  return true;
+}
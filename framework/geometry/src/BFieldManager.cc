@@ -15,3 +15,27 @@ BFieldManager& BFieldManager::getInstance()
   static BFieldManager instance;
   return instance;
 }
+
+void BFieldManager::setGrid(const BFieldGrid::Binning& binning)
+{
+  BFieldManager& instance = getInstance();
+  instance.m_gridBinning = binning;
+  instance.fillGrid();
+}
+
+void BFieldManager::resetGrid()
+{
+  BFieldManager& instance = getInstance();
+  instance.m_gridBinning.reset();
+  instance.fillGrid();
+}
+
+void BFieldManager::fillGrid()
+{
+  m_grid.reset();
+  if (!m_gridBinning or !m_magfield) return;
+  const MagneticField& magfield = *m_magfield;
+  m_grid = std::make_unique<BFieldGrid>(*m_gridBinning, [&magfield](const ROOT::Math::XYZVector & pos) {
+    return magfield.getField(pos);
+  });
+}
@@ -14,6 +14,8 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <mutex>
+#include <atomic>
 #include <unordered_map>
 
 
@@ -195,6 +197,18 @@ namespace Belle2 {
      */
     void updateModule(const LogConfig* moduleLogConfig = nullptr, const std::string& moduleName = "") { m_moduleLogConfig = moduleLogConfig; m_moduleName = moduleName; }
 
+    /**
+     * Start a section in which other threads may send messages as well: until the matching
+     * endThreadedSection() sendMessage() is serialized. Sections can be nested. Has to be called in the
+     * main thread before the other threads are started, e.g. by ParallelJobs.
+     */
+    void beginThreadedSection() { ++m_threadedSections; }
+
+    /**
+     * End a section started with beginThreadedSection(), after all other threads stopped sending messages.
+     */
+    void endThreadedSection() { --m_threadedSections; }
+
     /**
      * Enable debug output.
      */
@@ -228,6 +242,10 @@ namespace Belle2 {
     unsigned int m_suppressedMessages{0};
     /** Counts the number of messages sent per message level. */
     int m_messageCounter[LogConfig::c_Default];
+    /** Serializes sendMessage() while several threads may log */
+    std::recursive_mutex m_messageMutex;
+    /** Number of open sections in which several threads may log, see beginThreadedSection() */
+    std::atomic<int> m_threadedSections{0};
     /** Global flag for fast checking if debug output is enabled */
     static bool s_debugEnabled;
 
@@ -65,6 +65,9 @@ void LogSystem::showText(LogConfig::ELogLevel level, const std::string& txt, int
 
 bool LogSystem::sendMessage(LogMessage&& message)
 {
+  // only serialize the messages if other threads may log as well
+  std::unique_lock<std::recursive_mutex> lock(m_messageMutex, std::defer_lock);
+  if (m_threadedSections > 0) lock.lock();
   LogConfig::ELogLevel logLevel = message.getLogLevel();
   auto packageLogConfig = m_packageLogConfigs.find(message.getPackage());
   if ((packageLogConfig != m_packageLogConfigs.end()) && packageLogConfig->second.getLogInfo(logLevel)) {
@@ -35,6 +35,9 @@ namespace Belle2 {
     virtual void terminate() override;
 
   private:
+    //! Position the current file at the first event of this reader (after the StreamerInfo was read)
+    void selectEventRange();
+
     //! File name
     std::string m_inputFileName{""};
     //! List of all file names to read
@@ -46,6 +49,17 @@ namespace Belle2 {
     //! Is the input real data?
     bool m_realData{false};
 
+    //! Index of the first event to read in each file
+    int m_firstEvent{0};
+    //! Number of readers the events of each file are split between
+    int m_numberOfReaders{1};
+    //! Which of the readers are we?
+    int m_readerIndex{0};
+    //! Number of events still to read from the current file (-1 = read until the end)
+    int64_t m_eventsLeftInFile{ -1};
+    //! The event read in initialize() is not one of this reader's events and must not be processed
+    bool m_skipFirstEvent{false};
+
     //! Blocked file handler
     SeqFile* m_file{nullptr};
 
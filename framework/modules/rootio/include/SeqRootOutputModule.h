@@ -60,6 +60,9 @@ namespace Belle2 {
     //! Compression level
     int m_compressionLevel;
 
+    //! If true write the event offset index next to the file
+    bool m_writeIndex{false};
+
     //! Blocked file handler
     SeqFile* m_file;
 
@@ -14,6 +14,7 @@
 #include <framework/dataobjects/FileMetaData.h>
 #include <framework/database/Configuration.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdio>
 
@@ -47,6 +48,12 @@ SeqRootInputModule::SeqRootInputModule() : Module()
            "subsequent files are named .sroot-N. For example 'myfile-f%08d.sroot'",
            false);
   addParam("declareRealData", m_realData, "Declare the input to be real, not generated data", false);
+  addParam("firstEvent", m_firstEvent, "Index of the first event to read in each file (0 = first event). "
+           "Needs the index written by SeqRootOutput with writeIndex=True.", m_firstEvent);
+  addParam("numberOfReaders", m_numberOfReaders, "Split the events of each file into this number of consecutive blocks and "
+           "only read the block given by readerIndex. This allows several jobs to read the same file in parallel. "
+           "Needs the index written by SeqRootOutput with writeIndex=True.", m_numberOfReaders);
+  addParam("readerIndex", m_readerIndex, "Which of the blocks (0 to numberOfReaders - 1) to read", m_readerIndex);
 }
 
 SeqRootInputModule::~SeqRootInputModule() = default;
@@ -71,6 +78,11 @@ void SeqRootInputModule::initialize()
     m_nfile = 1;
   }
 
+  if (m_numberOfReaders < 1 or m_readerIndex < 0 or m_readerIndex >= m_numberOfReaders or m_firstEvent < 0) {
+    B2FATAL("SeqRootInput : invalid event selection: firstEvent=" << m_firstEvent << ", numberOfReaders=" << m_numberOfReaders
+            << ", readerIndex=" << m_readerIndex);
+  }
+
   // Initialize DataStoreStreamer
   m_streamer = new DataStoreStreamer();
 
@@ -99,8 +111,18 @@ void SeqRootInputModule::initialize()
         B2INFO("Reading StreamerInfo");
         if (info_cnt != 0) B2FATAL("SeqRootInput : Reading StreamerInfos twice");
         info_cnt++;
+        // Only now (after the StreamerInfo) we can jump to the events of this reader
+        selectEventRange();
+        if (m_eventsLeftInFile == 0) {
+          // Nothing to read for this reader (e.g. more readers than events). We still restore the first event of the
+          // file (selectEventRange() did not move the file) to know the content of the DataStore, but it is thrown
+          // away in the first call of event()
+          B2INFO("SeqRootInput : No events to read in " << m_inputFileName << " for this reader");
+          m_skipFirstEvent = true;
+        }
       } else {
         // first event was read
+        if (m_eventsLeftInFile > 0) m_eventsLeftInFile--;
         delete[] evtbuf;
         delete evtmsg;
         break;
@@ -141,12 +163,20 @@ void SeqRootInputModule::event()
   // on first call: first event is already loaded. This is actually called once
   // before the first beginRun() since we are the module setting the EventInfo
   // so don't get confused by the m_nevt=0 in beginRun()
-  if (++m_nevt == 0) return;
+  if (++m_nevt == 0) {
+    if (!m_skipFirstEvent) return;
+    // the first event was only read to set up the DataStore and does not belong to this reader
+    m_skipFirstEvent = false;
+    DataStore::Instance().invalidateData(DataStore::c_Event);
+  }
 
-  // Get a SeqRoot record from the file
+  // Get a SeqRoot record from the file (if we have not read all events of this reader already)
   auto* evtbuf = new char[EvtMessage::c_MaxEventSize];
   EvtMessage* evtmsg = nullptr;
-  int size = m_file->read(evtbuf, EvtMessage::c_MaxEventSize);
+  int size = 0;
+  if (m_eventsLeftInFile != 0) {
+    size = m_file->read(evtbuf, EvtMessage::c_MaxEventSize);
+  }
   if (size < 0) {
     B2ERROR("SeqRootInput : file read error");
     delete m_file;
@@ -156,32 +186,40 @@ void SeqRootInputModule::event()
     return;
   } else if (size == 0) {
     B2INFO("SeqRootInput : EOF detected");
-    delete m_file;
-    m_file = nullptr;
-    m_fileptr++;
-    if (m_fileptr >= m_nfile) {
-      delete[] evtbuf;
-      evtbuf = nullptr;
-      return;
+    // Go on with the next file which has events for this reader
+    while (size == 0) {
+      delete m_file;
+      m_file = nullptr;
+      m_fileptr++;
+      if (m_fileptr >= m_nfile) {
+        delete[] evtbuf;
+        evtbuf = nullptr;
+        return;
+      }
+      printf("fileptr = %d ( of %d )\n", m_fileptr, m_nfile);
+      fflush(stdout);
+      m_inputFileName = m_filelist[m_fileptr];
+      m_file = new SeqFile(m_inputFileName, "r");
+      if (m_file->status() <= 0)
+        B2FATAL("SeqRootInput : Error in opening input file : " << m_inputFileName);
+      B2INFO("SeqRootInput : Open " << m_inputFileName);
+      // Skip the first record (StreamerInfo)
+      int is = m_file->read(evtbuf, EvtMessage::c_MaxEventSize);
+      if (is <= 0) {
+        B2FATAL("SeqRootInput : Error in reading file. error code = " << is);
+      }
+      selectEventRange();
+      if (m_eventsLeftInFile == 0) {
+        B2INFO("SeqRootInput : No events to read in " << m_inputFileName << " for this reader");
+        continue;
+      }
+      // Read next record
+      size = m_file->read(evtbuf, EvtMessage::c_MaxEventSize);
+      if (size <= 0) {
+        B2FATAL("SeqRootInput : Error in reading file. error code = " << size);
+      }
     }
-    printf("fileptr = %d ( of %d )\n", m_fileptr, m_nfile);
-    fflush(stdout);
-    m_inputFileName = m_filelist[m_fileptr];
-    m_file = new SeqFile(m_inputFileName, "r");
-    if (m_file->status() <= 0)
-      B2FATAL("SeqRootInput : Error in opening input file : " << m_inputFileName);
-    B2INFO("SeqRootInput : Open " << m_inputFileName);
     evtmsg = new EvtMessage(evtbuf);
-    // Skip the first record (StreamerInfo)
-    int is = m_file->read(evtbuf, EvtMessage::c_MaxEventSize);
-    if (is <= 0) {
-      B2FATAL("SeqRootInput : Error in reading file. error code = " << is);
-    }
-    // Read next record
-    is = m_file->read(evtbuf, EvtMessage::c_MaxEventSize);
-    if (is <= 0) {
-      B2FATAL("SeqRootInput : Error in reading file. error code = " << is);
-    }
   } else {
     //    printf("SeqRootInput : read = %d\n", size);
     evtmsg = new EvtMessage(evtbuf);
@@ -201,6 +239,8 @@ void SeqRootInputModule::event()
     evtmsg = new EvtMessage(evtbuf);
   }
 
+  if (m_eventsLeftInFile > 0) m_eventsLeftInFile--;
+
   // Restore objects in DataStore
   m_streamer->restoreDataStore(evtmsg);
 
@@ -211,6 +251,29 @@ void SeqRootInputModule::event()
   evtmsg = nullptr;
 }
 
+void SeqRootInputModule::selectEventRange()
+{
+  m_eventsLeftInFile = -1;
+  if (m_numberOfReaders == 1 and m_firstEvent == 0) {
+    // read everything sequentially, no index needed
+    return;
+  }
+  if (!m_file->hasIndex()) {
+    B2FATAL("SeqRootInput : Reading only a part of " << m_inputFileName
+            << " needs an index file (written by SeqRootOutput with writeIndex=True)");
+  }
+
+  const int64_t nEvents = m_file->getNumberOfEvents();
+  const int64_t first = std::min<int64_t>(m_firstEvent, nEvents);
+  const int64_t begin = first + (nEvents - first) * m_readerIndex / m_numberOfReaders;
+  const int64_t end = first + (nEvents - first) * (m_readerIndex + 1) / m_numberOfReaders;
+  m_eventsLeftInFile = end - begin;
+  if (m_eventsLeftInFile > 0 and !m_file->seekToEvent(begin)) {
+    B2FATAL("SeqRootInput : Cannot jump to event " << begin << " in " << m_inputFileName);
+  }
+  B2INFO("SeqRootInput : Reading events " << begin << " to " << end - 1 << " of " << nEvents << " in " << m_inputFileName);
+}
+
 void SeqRootInputModule::endRun()
 {
   // End time
@@ -48,6 +48,9 @@ SeqRootOutputModule::SeqRootOutputModule() : Module(), m_nevt(0), m_streamer(nul
   addParam("saveObjs", m_saveObjs, "List of objects/arrays to be saved", emptyvector);
   addParam("fileNameIsPattern", m_fileNameIsPattern, "If true interpret the output filename as a boost::format pattern "
            "instead of the standard where subsequent files are named .sroot-N. For example 'myfile-f%08d.sroot'", false);
+  addParam("writeIndex", m_writeIndex, "Write an index with the event offsets next to each (uncompressed) file (same name with "
+           "suffix .idx). This allows SeqRootInput to start at any event and several readers to share a file. "
+           "The file itself is unchanged. For fast per-event compression, choose LZ4 via the compressionLevel (e.g. 404).", false);
 }
 
 
@@ -75,7 +78,7 @@ void SeqRootOutputModule::initialize()
   //Write StreamerInfo at the beginning of a file
   getStreamerInfos();
 
-  m_file = new SeqFile(m_outputFileName.c_str(), "w", m_streamerinfo, m_streamerinfo_size, m_fileNameIsPattern);
+  m_file = new SeqFile(m_outputFileName.c_str(), "w", m_streamerinfo, m_streamerinfo_size, m_fileNameIsPattern, m_writeIndex);
 
   B2INFO("SeqRootOutput: initialized.");
 }
@@ -8,13 +8,24 @@
 
 #pragma once
 
+#include <cstdint>
+#include <fstream>
 #include <iosfwd>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace Belle2 {
 
-  /** A class to manage I/O for a chain of blocked files */
+  /** A class to manage I/O for a chain of blocked files
+   *
+   * When writing uncompressed files, optionally an index is written next to each file part
+   * (same name with an additional ".idx" suffix). It contains a magic string followed by the
+   * byte offsets (64 bit) of all records after the StreamerInfo. The .sroot files themselves are
+   * unchanged, so they can still be read without the index. If all index files are present when
+   * reading, seekToEvent() allows to start reading at any event, e.g. to split a file between
+   * several readers.
+   */
   class SeqFile {
   public:
     /** Constructor.
@@ -26,10 +37,12 @@ namespace Belle2 {
      * @param filenameIsPattern if true interpret the filename as a
      *     boost::format pattern which takes the sequence number as argument
      *     instead of producing .sroot-N files
+     * @param writeIndex if true (and writing an uncompressed file) write the
+     *     offset index next to each file
      */
     SeqFile(const std::string& filename, const std::string& rwflag,
             const char* streamerinfo = nullptr, int streamerinfo_size = 0,
-            bool filenameIsPattern = false);
+            bool filenameIsPattern = false, bool writeIndex = false);
     /** Destructor */
     ~SeqFile();
     /** No copying */
@@ -44,9 +57,24 @@ namespace Belle2 {
     /** Read a record from a file. The record length is returned. */
     int read(char* buf, int max);
 
+    /** Was an index found for all parts of the file when opening it for reading? */
+    bool hasIndex() const { return not m_eventsBeforePart.empty(); }
+    /** Number of events in all parts of the file according to the index (-1 if there is no index). */
+    int64_t getNumberOfEvents() const;
+    /** Position the file so the next read() returns the event with the given index (0 is the first event after the StreamerInfo).
+     * Needs an index, returns false if the file can not be positioned. */
+    bool seekToEvent(int64_t event);
+
+    /** Magic string at the beginning of the index files */
+    static constexpr char c_indexMagic[8] = {'S', 'R', 'O', 'O', 'T', 'I', 'D', 'X'};
+
   private:
     /** actually open the file */
     void openFile(std::string filename, bool readonly);
+    /** Return the name of the file part with the given sequence number */
+    std::string getPartFilename(int nfile) const;
+    /** Read the index files of all file parts. Leaves the index empty if any of them is missing. */
+    void readIndex();
 
   private:
     /** maximal size of one file (in Bytes). */
@@ -66,6 +94,15 @@ namespace Belle2 {
     /** size(bytes) of StreamerInfo */
     int m_streamerinfo_size;
 
+    /** Write the index files? */
+    bool m_writeIndex{false};
+    /** Stream of the index file of the current part, when writing */
+    std::ofstream m_indexStream;
+    /** Offsets of the events in the file parts according to the index, when reading */
+    std::vector<std::vector<uint64_t>> m_eventOffsets;
+    /** Number of events in all previous file parts, when reading */
+    std::vector<int64_t> m_eventsBeforePart;
+
   };
 
 }
@@ -0,0 +1,235 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class TH1;
+
+namespace Belle2 {
+
+  /** Fixed size description of a single histogram in the shared memory segment. */
+  struct SharedHistogramInfo {
+    /// Maximal length of the histogram name (including the terminating 0).
+    static constexpr int c_maxNameLength = 128;
+    /// Maximal length of the histogram title (including the terminating 0).
+    static constexpr int c_maxTitleLength = 128;
+
+    char name[c_maxNameLength]; /**< name of the histogram, may contain a "<folder>/" prefix. */
+    char title[c_maxTitleLength]; /**< title of the histogram. */
+    int nBinsX; /**< number of x bins (without under- and overflow). */
+    int nBinsY; /**< number of y bins (without under- and overflow), 0 for 1D histograms. */
+    double xLow; /**< lower edge of the x axis. */
+    double xUp; /**< upper edge of the x axis. */
+    double yLow; /**< lower edge of the y axis. */
+    double yUp; /**< upper edge of the y axis. */
+    std::uint64_t binOffset; /**< offset of the first bin in the shared bin array. */
+    std::uint64_t nCells; /**< number of bins including under- and overflow. */
+    std::atomic<std::uint64_t> entries; /**< number of fill calls. */
+  };
+
+  /** Metadata placed on top of the shared memory segment of the SharedHistogramStore. */
+  struct SharedHistogramStoreHeader {
+    std::uint32_t maxHistograms; /**< number of SharedHistogramInfo slots. */
+    std::uint64_t maxCells; /**< number of available bins for all histograms together. */
+    std::atomic<std::uint32_t> nHistograms; /**< number of registered (and fully initialized) histograms. */
+    std::atomic<std::uint64_t> usedCells; /**< number of bins already handed out. */
+    std::atomic<int> registrationLock; /**< spin lock only used while registering new histograms and at run boundaries. */
+    std::uint64_t storeID; /**< random id of the store, identifies the exported histograms at the histogram server. */
+    std::atomic<std::uint64_t> runKey; /**< (exp, run) the bins belong to, shifted by one bit. Lowest bit set while resetting. */
+    std::atomic<std::uint32_t> nProcesses; /**< number of processes filling the histograms. */
+    std::atomic<std::uint32_t> processesAtRunBoundary; /**< number of processes which stopped filling for the run in runKey. */
+  };
+
+  /**
+   * Lightweight handle to a histogram in the SharedHistogramStore.
+   *
+   * Filling is lock-free: every bin is a 64 bit atomic holding the bit pattern of a double,
+   * which is updated with a compare-and-swap loop. Therefore all processes forked from
+   * the process which created the store can fill the same histogram concurrently without
+   * any merging step afterwards. Only equidistant binning is supported.
+   */
+  class SharedHistogram {
+  public:
+    /// Create an invalid handle (all fill calls are ignored)
+    SharedHistogram() = default;
+    /// Create a handle for the given histogram info and bin arrays
+    SharedHistogram(SharedHistogramInfo* info, std::atomic<std::uint64_t>* sumw, std::atomic<std::uint64_t>* sumw2) :
+      m_info(info), m_sumw(sumw), m_sumw2(sumw2) {}
+
+    /// Fill a 1D histogram
+    void fill(double x, double weight = 1.0);
+    /// Fill a 2D histogram
+    void fill(double x, double y, double weight);
+
+    /// Return the content of the given global bin (same numbering as in TH1::GetBin)
+    double getBinContent(int bin) const;
+    /// Return the number of fill calls
+    std::uint64_t getEntries() const;
+    /// Is this handle pointing to a histogram?
+    bool isValid() const { return m_info != nullptr; }
+
+  private:
+    /// Atomically add the value to the double stored in the given atomic
+    static void atomicAdd(std::atomic<std::uint64_t>& target, double value);
+    /// Find the bin (including under- and overflow) for the given axis definition
+    static int findBin(double value, int nBins, double low, double up);
+    /// Add weight to the given global bin
+    void addToBin(int bin, double weight);
+
+    /// Description of the histogram in the shared memory
+    SharedHistogramInfo* m_info = nullptr;
+    /// First bin of the sum of weights
+    std::atomic<std::uint64_t>* m_sumw = nullptr;
+    /// First bin of the sum of squared weights
+    std::atomic<std::uint64_t>* m_sumw2 = nullptr;
+  };
+
+  /**
+   * Store for DQM histograms with all bins placed in an anonymous shared memory segment.
+   *
+   * The store needs to be created (via create) before the worker processes are forked,
+   * e.g. in the initialize of a module. Each worker then registers its histograms
+   * (typically in HistoModule::defineHisto). Registration is idempotent: if a histogram
+   * with the same name was already registered by another process, a handle to the
+   * already existing bins is returned. All workers fill the same bins, so the usual
+   * per-process clone-and-add merging of the histograms is not needed.
+   *
+   * Exactly one process at a time holds the export lease (see acquireExportLease) and
+   * converts the shared bins into ROOT histograms for sending them out. These ROOT histograms
+   * are created once and afterwards only their bin arrays are overwritten.
+   * The lease is a POSIX record lock on the memory file of the segment, so the kernel
+   * releases it when the holding process dies.
+   */
+  class SharedHistogramStore {
+  public:
+    /// Default number of histograms
+    static constexpr std::uint32_t c_defaultMaxHistograms = 4096;
+    /// Default number of seconds to wait for the other processes at a run boundary
+    static constexpr double c_defaultRunBoundaryTimeout = 10;
+
+    /// Access to the singleton
+    static SharedHistogramStore& Instance();
+
+    /// Create the shared memory segment with the given total size in bytes. Needs to be called before forking.
+    void create(std::size_t sizeInBytes, std::uint32_t maxHistograms = c_defaultMaxHistograms);
+    /// Unmap the shared memory segment. All handles get invalid.
+    void destroy();
+    /// Was the shared memory segment created?
+    bool isEnabled() const { return m_header != nullptr; }
+    /// Return the random id of the store (0 if not created)
+    std::uint64_t getStoreID() const { return m_header ? m_header->storeID : 0; }
+
+    /// Register (or look up) a 1D histogram with equidistant binning
+    SharedHistogram registerHistogram(const std::string& name, const std::string& title, int nBinsX, double xLow, double xUp);
+    /// Register (or look up) a 2D histogram with equidistant binning
+    SharedHistogram registerHistogram(const std::string& name, const std::string& title, int nBinsX, double xLow, double xUp,
+                                      int nBinsY, double yLow, double yUp);
+    /// Return the number of registered histograms
+    unsigned int getNumberOfHistograms() const;
+
+    /**
+     * Set the number of processes filling the histograms (1 by default). Needs to be called before forking.
+     * The bins are only reset for a new run after all of them have reached the run boundary,
+     * but at most runBoundaryTimeout seconds after the first one (e.g. if a worker died).
+     */
+    void setNumberOfProcesses(std::uint32_t nProcesses, double runBoundaryTimeout = c_defaultRunBoundaryTimeout);
+
+    /**
+     * Announce the start of a new run. The process has reached the run boundary (if it did not call endRun before)
+     * and waits until all other processes have reached it as well. Then the first of them resets all bins,
+     * all other processes wait until this reset is done.
+     */
+    void beginRun(int experiment, int run);
+    /// Announce that this process does not fill the histograms of the given run anymore
+    void endRun(int experiment, int run);
+    /// Reset all bins and entries
+    void reset();
+
+    /// Try to become the exporting process. Succeeds if no other living process holds the lease.
+    bool acquireExportLease();
+    /// Give back the export lease (if held by this process)
+    void releaseExportLease();
+
+    /// Copy the shared bins into ROOT histograms (owned by the store) and return them. Only call this when holding the export lease.
+    const std::vector<TH1*>& snapshot();
+
+  private:
+    /// Singletons are not created by others
+    SharedHistogramStore() = default;
+    /// Unmap on destruction
+    ~SharedHistogramStore();
+    /// No copies
+    SharedHistogramStore(const SharedHistogramStore&) = delete;
+    /// No assignment
+    SharedHistogramStore& operator=(const SharedHistogramStore&) = delete;
+
+    /// Common implementation of the registration
+    SharedHistogram registerHistogramImpl(const std::string& name, const std::string& title, int nBinsX, double xLow, double xUp,
+                                          int nBinsY, double yLow, double yUp);
+    /// Return a handle for the histogram with the given index
+    SharedHistogram getHandle(std::uint32_t index) const;
+    /// Count this process as done with the run of the given key (once per run). Needs the registration lock.
+    void reachRunBoundary(std::uint64_t key);
+
+    /// Memory file backing the segment, also used for the export lease
+    int m_fd = -1;
+    /// Start of the mapped segment
+    void* m_segment = nullptr;
+    /// Size of the mapped segment
+    std::size_t m_segmentSize = 0;
+    /// Header at the start of the segment
+    SharedHistogramStoreHeader* m_header = nullptr;
+    /// Histogram descriptions following the header
+    SharedHistogramInfo* m_infos = nullptr;
+    /// Sum of weights for all bins
+    std::atomic<std::uint64_t>* m_sumw = nullptr;
+    /// Sum of squared weights for all bins
+    std::atomic<std::uint64_t>* m_sumw2 = nullptr;
+
+    /// Seconds to wait for the other processes at a run boundary before resetting anyway
+    double m_runBoundaryTimeout = c_defaultRunBoundaryTimeout;
+    /// Was this process already counted as done with the run in m_runBoundaryKey?
+    bool m_atRunBoundary = false;
+    /// Key of the run this process was counted as done with last
+    std::uint64_t m_runBoundaryKey = 0;
+
+    /// ROOT histograms used for exporting, created lazily in the exporting process
+    std::vector<std::unique_ptr<TH1>> m_exportHistograms;
+    /// Raw pointers to the export histograms (returned by snapshot)
+    std::vector<TH1*> m_exportHistogramPointers;
+  };
+
+  /**
+   * 1D histogram of a HistoModule, which is registered in the SharedHistogramStore if the store was created
+   * (see the sharedHistogramMemorySize parameter of HLTDQM2ZMQ) and is a normal TH1F in the current ROOT directory
+   * otherwise (e.g. when running with the HistoManager). Create it in defineHisto: the name of the current
+   * directory is used as prefix of the shared histogram, in the same way HLTDQM2ZMQ names the histograms of a directory.
+   */
+  class SharedOrLocalHistogram {
+  public:
+    /// Create an invalid handle (all fill calls are ignored)
+    SharedOrLocalHistogram() = default;
+    /// Register or create the histogram. As for TH1, the title may contain the axis titles separated by ";".
+    SharedOrLocalHistogram(const std::string& name, const std::string& title, int nBinsX, double xLow, double xUp);
+
+    /// Fill the histogram
+    void fill(double x, double weight = 1.0);
+
+  private:
+    /// The histogram in the shared store (if used)
+    SharedHistogram m_shared;
+    /// The histogram in the current directory otherwise (owned by the directory)
+    TH1* m_local = nullptr;
+  };
+}
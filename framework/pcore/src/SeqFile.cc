@@ -11,7 +11,11 @@
 
 #include <ios>
 #include <fcntl.h>
+#include <unistd.h>
 #include <cerrno>
+#include <algorithm>
+#include <filesystem>
+#include <iterator>
 
 #include <boost/iostreams/device/file_descriptor.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
@@ -23,7 +27,7 @@ using namespace std;
 namespace io = boost::iostreams;
 
 SeqFile::SeqFile(const std::string& filename, const std::string& rwflag, const char* streamerinfo, int streamerinfo_size,
-                 bool filenameIsPattern):
+                 bool filenameIsPattern, bool writeIndex):
   m_filename(filename)
 {
   if (m_filename.empty()) {
@@ -51,6 +55,13 @@ SeqFile::SeqFile(const std::string& filename, const std::string& rwflag, const c
     }
   }
 
+  // The index contains offsets in the uncompressed files, so we can only seek in those
+  m_writeIndex = writeIndex and not readonly;
+  if (m_writeIndex and (m_compressed or m_filename == "/dev/null")) {
+    B2WARNING("SeqFile: no index is written for compressed files or /dev/null");
+    m_writeIndex = false;
+  }
+
   // Store StreamerInfo 2017.5.8
   m_streamerinfo = nullptr;
   m_streamerinfo_size = 0;
@@ -74,6 +85,9 @@ SeqFile::SeqFile(const std::string& filename, const std::string& rwflag, const c
     B2ERROR("SeqFile: error opening '" << m_filename << "': " << strerror(errno));
   } else {
     B2INFO("SeqFile: " << m_filename << " opened (fd=" << m_fd << ")");
+    if (readonly and not m_compressed) {
+      readIndex();
+    }
   }
 
 }
@@ -92,6 +106,12 @@ void SeqFile::openFile(std::string filename, bool readonly)
     filter->exceptions(ios_base::badbit | ios_base::failbit);
     m_stream.reset(filter);
 
+    // Every file part gets its own index
+    if (m_writeIndex) {
+      m_indexStream = std::ofstream(filename + ".idx", std::ios::binary | std::ios::trunc);
+      m_indexStream.write(c_indexMagic, sizeof(c_indexMagic));
+    }
+
     //
     // Write StreamerInfo  (2017.5.8)
     //
@@ -148,10 +168,7 @@ int SeqFile::write(const char* buf)
   if (insize + m_nb >= c_MaxFileSize && m_filename != "/dev/null") {
     B2INFO("SeqFile: previous file closed (size=" << m_nb << " bytes)");
     m_nfile++;
-    auto file = m_filename + '-' + std::to_string(m_nfile);
-    if (!m_filenamePattern.empty()) {
-      file = (boost::format(m_filenamePattern) % m_nfile).str();
-    }
+    auto file = getPartFilename(m_nfile);
     openFile(file, false);
     if (m_fd < 0) {
       B2FATAL("SeqFile::write() error opening file '" << file << "': " << strerror(errno));
@@ -162,6 +179,11 @@ int SeqFile::write(const char* buf)
     out = dynamic_cast<std::ostream*>(m_stream.get());
   }
   try {
+    if (m_writeIndex) {
+      // The record starts after the StreamerInfo and all records written so far to this part
+      const uint64_t offset = m_streamerinfo_size + static_cast<uint64_t>(m_nb);
+      m_indexStream.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+    }
     out->write(buf, insize);
     m_nb += insize;
     return insize;
@@ -189,10 +211,7 @@ int SeqFile::read(char* buf, int size)
   if (in->eof()) {
     // EOF of current file, search for next file
     m_nfile++;
-    auto nextfile = m_filename + '-' + std::to_string(m_nfile);
-    if (!m_filenamePattern.empty()) {
-      nextfile = (boost::format(m_filenamePattern) % m_nfile).str();
-    }
+    auto nextfile = getPartFilename(m_nfile);
     openFile(nextfile, true);
     if (m_fd < 0) return 0;   // End of all files
     // update the stream pointer
@@ -220,3 +239,90 @@ int SeqFile::read(char* buf, int size)
   }
   return recsize;
 }
+
+std::string SeqFile::getPartFilename(int nfile) const
+{
+  if (!m_filenamePattern.empty()) {
+    return (boost::format(m_filenamePattern) % nfile).str();
+  }
+  if (nfile == 0) {
+    return m_filename;
+  }
+  return m_filename + '-' + std::to_string(nfile);
+}
+
+void SeqFile::readIndex()
+{
+  m_eventOffsets.clear();
+  m_eventsBeforePart.clear();
+
+  std::vector<std::vector<uint64_t>> eventOffsets;
+  for (int nfile = 0; ; nfile++) {
+    const std::string partFilename = getPartFilename(nfile);
+    std::error_code error;
+    const auto partSize = std::filesystem::file_size(partFilename, error);
+    if (error) {
+      // no more parts
+      break;
+    }
+
+    std::ifstream indexStream(partFilename + ".idx", std::ios::binary);
+    char magic[sizeof(c_indexMagic)];
+    if (!indexStream.read(magic, sizeof(magic)) or !std::equal(std::begin(magic), std::end(magic), std::begin(c_indexMagic))) {
+      B2DEBUG(20, "SeqFile: no (valid) index for " << partFilename << ", can only read sequentially");
+      return;
+    }
+
+    std::vector<uint64_t> offsets;
+    uint64_t offset = 0;
+    while (indexStream.read(reinterpret_cast<char*>(&offset), sizeof(offset))) {
+      offsets.push_back(offset);
+    }
+    if (!offsets.empty() and offsets.back() >= partSize) {
+      B2WARNING("SeqFile: the index of " << partFilename << " does not match the file, can only read sequentially");
+      return;
+    }
+    eventOffsets.push_back(std::move(offsets));
+  }
+
+  int64_t numberOfEvents = 0;
+  for (const auto& offsets : eventOffsets) {
+    m_eventsBeforePart.push_back(numberOfEvents);
+    numberOfEvents += offsets.size();
+  }
+  m_eventOffsets = std::move(eventOffsets);
+  B2DEBUG(20, "SeqFile: found index with " << numberOfEvents << " events in " << m_eventOffsets.size() << " file(s)");
+}
+
+int64_t SeqFile::getNumberOfEvents() const
+{
+  if (!hasIndex()) {
+    return -1;
+  }
+  return m_eventsBeforePart.back() + m_eventOffsets.back().size();
+}
+
+bool SeqFile::seekToEvent(int64_t event)
+{
+  if (!hasIndex()) {
+    B2ERROR("SeqFile::seekToEvent() needs an index, but there is none for " << m_filename);
+    return false;
+  }
+  if (event < 0 or event >= getNumberOfEvents()) {
+    B2ERROR("SeqFile::seekToEvent() event " << event << " is not in the file (" << getNumberOfEvents() << " events)");
+    return false;
+  }
+
+  // find the part containing the event
+  const auto part = std::upper_bound(m_eventsBeforePart.begin(), m_eventsBeforePart.end(), event) - m_eventsBeforePart.begin() - 1;
+  const uint64_t offset = m_eventOffsets[part][event - m_eventsBeforePart[part]];
+
+  // Reopen the part: the new stream has not buffered anything yet, so positioning the file descriptor is enough
+  m_nfile = part;
+  openFile(getPartFilename(m_nfile), true);
+  if (m_fd < 0 or lseek(m_fd, offset, SEEK_SET) < 0) {
+    B2ERROR("SeqFile::seekToEvent() could not position " << getPartFilename(m_nfile) << ": " << strerror(errno));
+    return false;
+  }
+  return true;
+}
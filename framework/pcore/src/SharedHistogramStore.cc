@@ -0,0 +1,522 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#include <framework/pcore/SharedHistogramStore.h>
+
+#include <framework/logging/Logger.h>
+
+#include <TH1D.h>
+#include <TH1F.h>
+#include <TH2D.h>
+#include <TArrayD.h>
+#include <TDirectory.h>
+#include <TROOT.h>
+
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <new>
+#include <random>
+#include <thread>
+
+using namespace Belle2;
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "The shared histogram bins need lock-free 64 bit atomics to work across processes");
+static_assert(std::atomic<int>::is_always_lock_free,
+              "The shared histogram locks need lock-free atomics to work across processes");
+
+namespace {
+  /// Bit pattern of a double
+  std::uint64_t toBits(double value)
+  {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+
+  /// Double from a bit pattern
+  double fromBits(std::uint64_t bits)
+  {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  /// Round up to a multiple of the cache line size, so the bin arrays do not share lines with the header
+  std::size_t alignToCacheLine(std::size_t size)
+  {
+    constexpr std::size_t cacheLineSize = 64;
+    return (size + cacheLineSize - 1) / cacheLineSize * cacheLineSize;
+  }
+
+  /// Lowest bit of the run key, set while the bins are reset
+  constexpr std::uint64_t c_resetBit = 1;
+
+  /// Key of the given run in SharedHistogramStoreHeader::runKey
+  std::uint64_t getRunKey(int experiment, int run)
+  {
+    return ((static_cast<std::uint64_t>(static_cast<std::uint32_t>(experiment)) << 31) | static_cast<std::uint32_t>(run)) << 1;
+  }
+
+  /// Scoped spin lock on an atomic int in the shared memory
+  class SpinLock {
+  public:
+    /// Lock
+    explicit SpinLock(std::atomic<int>& lock) : m_lock(lock)
+    {
+      int expected = 0;
+      while (not m_lock.compare_exchange_weak(expected, 1, std::memory_order_acquire)) {
+        expected = 0;
+        std::this_thread::yield();
+      }
+    }
+    /// Unlock
+    ~SpinLock() { m_lock.store(0, std::memory_order_release); }
+  private:
+    /// The lock variable
+    std::atomic<int>& m_lock;
+  };
+}
+
+void SharedHistogram::atomicAdd(std::atomic<std::uint64_t>& target, double value)
+{
+  std::uint64_t expected = target.load(std::memory_order_relaxed);
+  while (not target.compare_exchange_weak(expected, toBits(fromBits(expected) + value), std::memory_order_relaxed)) {
+    // expected is updated by compare_exchange_weak, just retry
+  }
+}
+
+int SharedHistogram::findBin(double value, int nBins, double low, double up)
+{
+  // Same convention as TAxis::FindFixBin
+  if (value < low) return 0;
+  if (not(value < up)) return nBins + 1;
+  return 1 + static_cast<int>(nBins * (value - low) / (up - low));
+}
+
+void SharedHistogram::addToBin(int bin, double weight)
+{
+  atomicAdd(m_sumw[bin], weight);
+  atomicAdd(m_sumw2[bin], weight * weight);
+  m_info->entries.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SharedHistogram::fill(double x, double weight)
+{
+  if (not m_info or std::isnan(x)) return;
+  addToBin(findBin(x, m_info->nBinsX, m_info->xLow, m_info->xUp), weight);
+}
+
+void SharedHistogram::fill(double x, double y, double weight)
+{
+  if (not m_info or std::isnan(x) or std::isnan(y)) return;
+  const int binX = findBin(x, m_info->nBinsX, m_info->xLow, m_info->xUp);
+  const int binY = findBin(y, m_info->nBinsY, m_info->yLow, m_info->yUp);
+  addToBin(binX + (m_info->nBinsX + 2) * binY, weight);
+}
+
+double SharedHistogram::getBinContent(int bin) const
+{
+  if (not m_info or bin < 0 or static_cast<std::uint64_t>(bin) >= m_info->nCells) return 0;
+  return fromBits(m_sumw[bin].load(std::memory_order_relaxed));
+}
+
+std::uint64_t SharedHistogram::getEntries() const
+{
+  return m_info ? m_info->entries.load(std::memory_order_relaxed) : 0;
+}
+
+SharedHistogramStore& SharedHistogramStore::Instance()
+{
+  static SharedHistogramStore instance;
+  return instance;
+}
+
+SharedHistogramStore::~SharedHistogramStore()
+{
+  destroy();
+}
+
+void SharedHistogramStore::create(std::size_t sizeInBytes, std::uint32_t maxHistograms)
+{
+  if (isEnabled()) {
+    B2WARNING("The shared histogram store was already created, will not create it again.");
+    return;
+  }
+
+  const std::size_t headerSize = alignToCacheLine(sizeof(SharedHistogramStoreHeader));
+  const std::size_t infoSize = alignToCacheLine(maxHistograms * sizeof(SharedHistogramInfo));
+  if (sizeInBytes <= headerSize + infoSize) {
+    B2FATAL("The shared histogram store needs more than " << headerSize + infoSize << " bytes for "
+            << maxHistograms << " histograms.");
+  }
+  // two doubles (sum of weights and sum of squared weights) per bin
+  const std::size_t maxCells = (sizeInBytes - headerSize - infoSize) / (2 * sizeof(std::atomic<std::uint64_t>));
+
+  // The memory file has no name in the file system, so it is cleaned up automatically.
+  // Shared mappings of it are inherited by forked children.
+  int fd = memfd_create("SharedHistogramStore", MFD_CLOEXEC);
+  if (fd < 0 or ftruncate(fd, sizeInBytes) != 0) {
+    B2FATAL("Could not create the shared histogram memory of " << sizeInBytes << " bytes: " << strerror(errno));
+  }
+  void* segment = mmap(nullptr, sizeInBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (segment == MAP_FAILED) {
+    B2FATAL("Could not map the shared histogram memory of " << sizeInBytes << " bytes: " << strerror(errno));
+  }
+
+  m_fd = fd;
+  m_segment = segment;
+  m_segmentSize = sizeInBytes;
+
+  char* position = static_cast<char*>(segment);
+  m_header = new (position) SharedHistogramStoreHeader;
+  position += headerSize;
+  m_infos = reinterpret_cast<SharedHistogramInfo*>(position);
+  position += infoSize;
+  m_sumw = reinterpret_cast<std::atomic<std::uint64_t>*>(position);
+  m_sumw2 = m_sumw + maxCells;
+
+  // The mapping is zero-initialized, which is the bit pattern of 0.0 for all bins
+  m_header->maxHistograms = maxHistograms;
+  m_header->maxCells = maxCells;
+  m_header->nHistograms.store(0);
+  m_header->usedCells.store(0);
+  m_header->registrationLock.store(0);
+  m_header->runKey.store(0);
+  m_header->nProcesses.store(1);
+  m_header->processesAtRunBoundary.store(0);
+  m_runBoundaryTimeout = c_defaultRunBoundaryTimeout;
+  m_atRunBoundary = false;
+  m_runBoundaryKey = 0;
+  std::random_device randomDevice;
+  m_header->storeID = (static_cast<std::uint64_t>(randomDevice()) << 32 | randomDevice()) | 1;
+
+  B2DEBUG(10, "Created shared histogram store with space for " << maxHistograms << " histograms and " << maxCells << " bins.");
+}
+
+void SharedHistogramStore::destroy()
+{
+  m_exportHistogramPointers.clear();
+  m_exportHistograms.clear();
+
+  if (not m_segment) {
+    return;
+  }
+  munmap(m_segment, m_segmentSize);
+  // Closing the file also releases the export lease
+  close(m_fd);
+  m_fd = -1;
+  m_segment = nullptr;
+  m_segmentSize = 0;
+  m_header = nullptr;
+  m_infos = nullptr;
+  m_sumw = nullptr;
+  m_sumw2 = nullptr;
+}
+
+SharedHistogram SharedHistogramStore::getHandle(std::uint32_t index) const
+{
+  SharedHistogramInfo* info = &m_infos[index];
+  return SharedHistogram(info, m_sumw + info->binOffset, m_sumw2 + info->binOffset);
+}
+
+SharedHistogram SharedHistogramStore::registerHistogram(const std::string& name, const std::string& title, int nBinsX,
+                                                        double xLow, double xUp)
+{
+  return registerHistogramImpl(name, title, nBinsX, xLow, xUp, 0, 0, 0);
+}
+
+SharedHistogram SharedHistogramStore::registerHistogram(const std::string& name, const std::string& title, int nBinsX,
+                                                        double xLow, double xUp, int nBinsY, double yLow, double yUp)
+{
+  B2ASSERT("A 2D shared histogram needs at least one y bin", nBinsY > 0);
+  return registerHistogramImpl(name, title, nBinsX, xLow, xUp, nBinsY, yLow, yUp);
+}
+
+SharedHistogram SharedHistogramStore::registerHistogramImpl(const std::string& name, const std::string& title, int nBinsX,
+                                                            double xLow, double xUp, int nBinsY, double yLow, double yUp)
+{
+  if (not isEnabled()) {
+    B2ERROR("The shared histogram store was not created, can not register " << name);
+    return SharedHistogram();
+  }
+  B2ASSERT("A shared histogram needs at least one x bin", nBinsX > 0);
+  if (name.size() >= SharedHistogramInfo::c_maxNameLength) {
+    B2ERROR("The name of the shared histogram " << name << " is too long.");
+    return SharedHistogram();
+  }
+
+  // Registration happens only in defineHisto, so a simple lock is fine here. Filling never locks.
+  SpinLock lock(m_header->registrationLock);
+
+  const std::uint32_t nHistograms = m_header->nHistograms.load(std::memory_order_acquire);
+  for (std::uint32_t index = 0; index < nHistograms; index++) {
+    const SharedHistogramInfo& info = m_infos[index];
+    if (name != info.name) {
+      continue;
+    }
+    if (info.nBinsX != nBinsX or info.nBinsY != nBinsY or info.xLow != xLow or info.xUp != xUp
+        or info.yLow != yLow or info.yUp != yUp) {
+      B2ERROR("The shared histogram " << name << " was already registered with a different binning.");
+      return SharedHistogram();
+    }
+    return getHandle(index);
+  }
+
+  if (nHistograms >= m_header->maxHistograms) {
+    B2ERROR("No space left for the shared histogram " << name << ". Increase the number of histograms.");
+    return SharedHistogram();
+  }
+
+  const std::uint64_t nCells = static_cast<std::uint64_t>(nBinsX + 2) * (nBinsY > 0 ? nBinsY + 2 : 1);
+  const std::uint64_t binOffset = m_header->usedCells.load(std::memory_order_relaxed);
+  if (binOffset + nCells > m_header->maxCells) {
+    B2ERROR("No space left for the " << nCells << " bins of the shared histogram " << name << ". Increase the shared memory size.");
+    return SharedHistogram();
+  }
+
+  SharedHistogramInfo& info = m_infos[nHistograms];
+  std::strncpy(info.name, name.c_str(), SharedHistogramInfo::c_maxNameLength - 1);
+  std::strncpy(info.title, title.c_str(), SharedHistogramInfo::c_maxTitleLength - 1);
+  info.nBinsX = nBinsX;
+  info.nBinsY = nBinsY;
+  info.xLow = xLow;
+  info.xUp = xUp;
+  info.yLow = yLow;
+  info.yUp = yUp;
+  info.binOffset = binOffset;
+  info.nCells = nCells;
+  info.entries.store(0, std::memory_order_relaxed);
+
+  m_header->usedCells.store(binOffset + nCells, std::memory_order_relaxed);
+  // Publish the histogram only after its info is complete
+  m_header->nHistograms.store(nHistograms + 1, std::memory_order_release);
+
+  return getHandle(nHistograms);
+}
+
+unsigned int SharedHistogramStore::getNumberOfHistograms() const
+{
+  return isEnabled() ? m_header->nHistograms.load(std::memory_order_acquire) : 0;
+}
+
+void SharedHistogramStore::reset()
+{
+  if (not isEnabled()) {
+    return;
+  }
+
+  const std::uint64_t usedCells = m_header->usedCells.load(std::memory_order_acquire);
+  for (std::uint64_t cell = 0; cell < usedCells; cell++) {
+    m_sumw[cell].store(0, std::memory_order_relaxed);
+    m_sumw2[cell].store(0, std::memory_order_relaxed);
+  }
+  const std::uint32_t nHistograms = m_header->nHistograms.load(std::memory_order_acquire);
+  for (std::uint32_t index = 0; index < nHistograms; index++) {
+    m_infos[index].entries.store(0, std::memory_order_relaxed);
+  }
+}
+
+void SharedHistogramStore::setNumberOfProcesses(std::uint32_t nProcesses, double runBoundaryTimeout)
+{
+  if (not isEnabled()) {
+    return;
+  }
+  m_header->nProcesses.store(std::max(nProcesses, 1u));
+  m_runBoundaryTimeout = runBoundaryTimeout;
+}
+
+void SharedHistogramStore::reachRunBoundary(std::uint64_t key)
+{
+  if (m_atRunBoundary and m_runBoundaryKey == key) {
+    return;
+  }
+  m_atRunBoundary = true;
+  m_runBoundaryKey = key;
+  m_header->processesAtRunBoundary.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void SharedHistogramStore::endRun(int experiment, int run)
+{
+  if (not isEnabled()) {
+    return;
+  }
+
+  SpinLock lock(m_header->registrationLock);
+  const std::uint64_t key = getRunKey(experiment, run);
+  // A late end of a run whose bins were already reset does not count for the current run
+  if ((m_header->runKey.load(std::memory_order_acquire) & ~c_resetBit) == key) {
+    reachRunBoundary(key);
+  }
+}
+
+void SharedHistogramStore::beginRun(int experiment, int run)
+{
+  if (not isEnabled()) {
+    return;
+  }
+
+  const std::uint64_t key = getRunKey(experiment, run);
+
+  std::uint64_t previous = 0;
+  {
+    SpinLock lock(m_header->registrationLock);
+    previous = m_header->runKey.load(std::memory_order_acquire) & ~c_resetBit;
+    if (previous != key) {
+      reachRunBoundary(previous);
+    }
+  }
+
+  // Other processes may still fill the previous run, so only reset after all of them are done with it.
+  // Before the first run nobody has filled anything yet.
+  if (previous != key and previous != 0) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(m_runBoundaryTimeout);
+    while (m_header->runKey.load(std::memory_order_acquire) == previous
+           and m_header->processesAtRunBoundary.load(std::memory_order_acquire) < m_header->nProcesses.load()) {
+      if (std::chrono::steady_clock::now() > deadline) {
+        B2WARNING("Not all processes reached the end of the previous run in time, will reset the shared histograms anyway."
+                  << LogVar("experiment", experiment) << LogVar("run", run)
+                  << LogVar("processes at the run boundary", m_header->processesAtRunBoundary.load())
+                  << LogVar("processes", m_header->nProcesses.load()));
+        break;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+  bool resetting = false;
+  {
+    SpinLock lock(m_header->registrationLock);
+    if ((m_header->runKey.load(std::memory_order_acquire) & ~c_resetBit) != key) {
+      m_header->runKey.store(key | c_resetBit, std::memory_order_release);
+      m_header->processesAtRunBoundary.store(0, std::memory_order_release);
+      resetting = true;
+    }
+  }
+
+  if (not resetting) {
+    // Someone else is resetting the bins for this run (or has done so already): wait for it
+    while (m_header->runKey.load(std::memory_order_acquire) == (key | c_resetBit)) {
+      std::this_thread::yield();
+    }
+    return;
+  }
+
+  B2DEBUG(10, "Resetting the shared histograms for experiment " << experiment << " run " << run);
+  reset();
+  m_header->runKey.store(key, std::memory_order_release);
+}
+
+bool SharedHistogramStore::acquireExportLease()
+{
+  if (not isEnabled()) {
+    return false;
+  }
+
+  // Record locks belong to a process: they are not inherited by forked children, locking again
+  // in the holding process succeeds, and the kernel releases them when the process dies
+  // (e.g. a crashed worker), so a living process can take over without any PID checks.
+  struct flock lock = {};
+  lock.l_type = F_WRLCK;
+  lock.l_whence = SEEK_SET;
+  lock.l_start = 0;
+  lock.l_len = 1;
+  if (fcntl(m_fd, F_SETLK, &lock) != 0) {
+    if (errno != EACCES and errno != EAGAIN) {
+      B2ERROR("Could not lock the shared histogram memory: " << strerror(errno));
+    }
+    return false;
+  }
+  return true;
+}
+
+void SharedHistogramStore::releaseExportLease()
+{
+  if (not isEnabled()) {
+    return;
+  }
+  struct flock lock = {};
+  lock.l_type = F_UNLCK;
+  lock.l_whence = SEEK_SET;
+  lock.l_start = 0;
+  lock.l_len = 1;
+  fcntl(m_fd, F_SETLK, &lock);
+}
+
+const std::vector<TH1*>& SharedHistogramStore::snapshot()
+{
+  if (not isEnabled()) {
+    return m_exportHistogramPointers;
+  }
+
+  const std::uint32_t nHistograms = m_header->nHistograms.load(std::memory_order_acquire);
+  // Histograms are never removed, so we only need to create the newly registered ones
+  for (std::uint32_t index = m_exportHistograms.size(); index < nHistograms; index++) {
+    const SharedHistogramInfo& info = m_infos[index];
+    std::unique_ptr<TH1> histogram;
+    if (info.nBinsY > 0) {
+      histogram.reset(new TH2D(info.name, info.title, info.nBinsX, info.xLow, info.xUp, info.nBinsY, info.yLow, info.yUp));
+    } else {
+      histogram.reset(new TH1D(info.name, info.title, info.nBinsX, info.xLow, info.xUp));
+    }
+    histogram->SetDirectory(nullptr);
+    histogram->Sumw2();
+    m_exportHistogramPointers.push_back(histogram.get());
+    m_exportHistograms.push_back(std::move(histogram));
+  }
+
+  for (std::uint32_t index = 0; index < nHistograms; index++) {
+    const SharedHistogramInfo& info = m_infos[index];
+    TH1* histogram = m_exportHistograms[index].get();
+
+    // TH1D and TH2D store their bins in the TArrayD base class with the same global bin numbering as we do
+    double* contents = dynamic_cast<TArrayD*>(histogram)->GetArray();
+    double* squaredWeights = histogram->GetSumw2()->GetArray();
+    const std::atomic<std::uint64_t>* sumw = m_sumw + info.binOffset;
+    const std::atomic<std::uint64_t>* sumw2 = m_sumw2 + info.binOffset;
+    for (std::uint64_t cell = 0; cell < info.nCells; cell++) {
+      contents[cell] = fromBits(sumw[cell].load(std::memory_order_relaxed));
+      squaredWeights[cell] = fromBits(sumw2[cell].load(std::memory_order_relaxed));
+    }
+    // Force the statistics to be recomputed from the bin contents
+    histogram->ResetStats();
+    histogram->SetEntries(info.entries.load(std::memory_order_relaxed));
+  }
+
+  return m_exportHistogramPointers;
+}
+
+SharedOrLocalHistogram::SharedOrLocalHistogram(const std::string& name, const std::string& title, int nBinsX, double xLow,
+                                               double xUp)
+{
+  auto& store = SharedHistogramStore::Instance();
+  if (store.isEnabled()) {
+    const std::string prefix = gDirectory != gROOT ? std::string(gDirectory->GetName()) + "/" : "";
+    m_shared = store.registerHistogram(prefix + name, title, nBinsX, xLow, xUp);
+  }
+  // Without the store (or if it is full), the histogram is merged as usual
+  if (not m_shared.isValid()) {
+    m_local = new TH1F(name.c_str(), title.c_str(), nBinsX, xLow, xUp);
+  }
+}
+
+void SharedOrLocalHistogram::fill(double x, double weight)
+{
+  if (m_shared.isValid()) {
+    m_shared.fill(x, weight);
+  } else if (m_local) {
+    m_local->Fill(x, weight);
+  }
+}
@@ -9,11 +9,16 @@
 
 #include <framework/pcore/zmq/utils/ZMQLogger.h>
 #include <framework/pcore/zmq/utils/ZMQParent.h>
+#include <framework/pcore/zmq/utils/SharedMemoryMessagePool.h>
+#include <framework/pcore/zmq/messages/ZMQDefinitions.h>
+#include <framework/logging/Logger.h>
 
 #include <zmq.hpp>
 
 #include <memory>
 #include <functional>
+#include <cstring>
+#include <chrono>
 
 namespace Belle2 {
   /**
@@ -55,6 +60,17 @@ namespace Belle2 {
   /**
    * Specialized connection over a ZMQ socket. Keeps track of a shared instance of a ZMQParent and the zmq socket.
    * Will not initialize the socket, you need to do this in a derived class.
+   *
+   * For local (ipc) connections, the event data can be passed via a SharedMemoryMessagePool:
+   * the sending side copies the data into a free slot and only sends a SharedMemoryMessageReference
+   * (as c_sharedMemoryDataMessage) over the socket, the receiving side turns this back into the original
+   * message, with the data part pointing directly into the slot. The slot is released once this
+   * message is destroyed. Polling, ready and confirmation messages work as before, as they still go over the socket.
+   * If the data does not fit into a slot or no slot is free, the message is sent normally.
+   *
+   * If the binding side is restarted, it creates a new pool under the same name and retires the old one.
+   * The sending side notices this before the next message and attaches to the new pool, the receiving
+   * side attaches to a new pool when the first message referencing it arrives.
    */
   class ZMQConnectionOverSocket : public ZMQConnection {
   public:
@@ -66,10 +82,135 @@ namespace Belle2 {
 
     /// Return the connection string for this socket
     std::string getEndPoint() const;
+
+    /**
+     * Create the shared memory pool for the given address (the one this connection binds to), so
+     * event data is sent via shared memory. Does nothing for non-ipc addresses.
+     */
+    void createSharedMemoryPool(const std::string& address, std::uint32_t numberOfSlots, std::uint64_t slotSize);
+    /**
+     * Attach to the shared memory pool of the given address (the one this connection connects to) if it exists.
+     * If it does not exist (yet), event data is sent normally, but received shared memory messages
+     * will trigger another attempt to attach.
+     */
+    void attachSharedMemoryPool(const std::string& address);
+
   protected:
+    /// If a pool is present, put the data of an event message into a shared memory slot and replace the message by a reference.
+    template <class AMessage>
+    void toSharedMemory(AMessage& message);
+    /**
+     * If the message is a shared memory message, replace it by the original message with the data in the shared memory slot.
+     * Returns false if the message references a pool which can not be reached anymore (e.g. a message sent to
+     * this side before it was restarted). The data of such a message is lost.
+     */
+    template <class AMessage>
+    bool fromSharedMemory(AMessage& message);
+
     /// The shared ZMQParent instance
     std::shared_ptr<ZMQParent> m_parent;
     /// The memory of the socket. Needs to be initialized in a derived class.
     std::unique_ptr<zmq::socket_t> m_socket;
+    /// The shared memory pool for the event data (if used)
+    std::shared_ptr<SharedMemoryMessagePool> m_sharedMemoryPool;
+    /// The address to use when attaching to the pool later
+    std::string m_sharedMemoryAddress;
+    /// The pool we were attached to has been retired, so try to attach to its replacement
+    bool m_waitingForSharedMemoryPool = false;
+    /// Do not try to attach to a replaced pool more often than this
+    std::chrono::steady_clock::time_point m_nextSharedMemoryAttachAttempt;
+
+  private:
+    /// Called by ZMQ when a message pointing into a shared memory slot is not needed anymore: release the slot.
+    static void releaseSharedMemorySlot(void* data, void* hint);
   };
+
+  template <class AMessage>
+  void ZMQConnectionOverSocket::toSharedMemory(AMessage& message)
+  {
+    if (m_sharedMemoryPool and not m_sharedMemoryPool->isOwner() and m_sharedMemoryPool->isRetired()) {
+      // The other side has been restarted (or is gone), its old pool must not be used anymore.
+      // Slots of messages still on their way keep the old pool alive until they are released.
+      m_sharedMemoryPool.reset();
+      m_waitingForSharedMemoryPool = true;
+      increment("shared_memory_pool_changes");
+    }
+    if (not m_sharedMemoryPool and m_waitingForSharedMemoryPool) {
+      // Until the new pool is there, the data is sent over the socket
+      const auto now = std::chrono::steady_clock::now();
+      if (now >= m_nextSharedMemoryAttachAttempt) {
+        m_nextSharedMemoryAttachAttempt = now + std::chrono::seconds(1);
+        attachSharedMemoryPool(m_sharedMemoryAddress);
+        m_waitingForSharedMemoryPool = not m_sharedMemoryPool;
+      }
+    }
+    if (not m_sharedMemoryPool) {
+      return;
+    }
+    if (not(message.isMessage(EMessageTypes::c_eventMessage) or message.isMessage(EMessageTypes::c_rawDataMessage))) {
+      return;
+    }
+
+    auto& data = message.template getMessagePart<AMessage::c_data>();
+    if (data.size() > m_sharedMemoryPool->getSlotSize()) {
+      increment("shared_memory_fallbacks");
+      return;
+    }
+    const auto slot = m_sharedMemoryPool->allocate();
+    if (not slot) {
+      increment("shared_memory_fallbacks");
+      return;
+    }
+
+    std::memcpy(m_sharedMemoryPool->getSlot(*slot), data.data(), data.size());
+
+    SharedMemoryMessageReference reference;
+    reference.poolIdentifier = m_sharedMemoryPool->getIdentifier();
+    reference.size = data.size();
+    reference.slot = *slot;
+    reference.type = message.template getMessagePartAsCharArray<AMessage::c_type>()[0];
+
+    const char type = static_cast<char>(EMessageTypes::c_sharedMemoryDataMessage);
+    message.template getMessagePart<AMessage::c_type>() = zmq::message_t(&type, 1);
+    data = zmq::message_t(&reference, sizeof(reference));
+    increment("shared_memory_messages");
+  }
+
+  template <class AMessage>
+  bool ZMQConnectionOverSocket::fromSharedMemory(AMessage& message)
+  {
+    if (not message.isMessage(EMessageTypes::c_sharedMemoryDataMessage)) {
+      return true;
+    }
+
+    auto& data = message.template getMessagePart<AMessage::c_data>();
+    B2ASSERT("Invalid shared memory message", data.size() == sizeof(SharedMemoryMessageReference));
+    SharedMemoryMessageReference reference;
+    std::memcpy(&reference, data.data(), sizeof(reference));
+
+    // We may not be attached yet or the other side has created a new pool in the meantime (e.g. after a restart)
+    if (not m_sharedMemoryPool or (not m_sharedMemoryPool->isOwner()
+                                   and m_sharedMemoryPool->getIdentifier() != reference.poolIdentifier)) {
+      attachSharedMemoryPool(m_sharedMemoryAddress);
+    }
+    if (not m_sharedMemoryPool or m_sharedMemoryPool->getIdentifier() != reference.poolIdentifier) {
+      B2ERROR("Received a shared memory message for an unknown shared memory pool for " << m_sharedMemoryAddress
+              << ", its data is lost.");
+      increment("lost_shared_memory_messages");
+      return false;
+    }
+    // Never trust the reference: a corrupt one must not make us read (or release) memory outside of the pool
+    if (reference.slot >= m_sharedMemoryPool->getNumberOfSlots() or reference.size > m_sharedMemoryPool->getSlotSize()) {
+      B2ERROR("Received a shared memory message with an invalid slot or size for " << m_sharedMemoryAddress
+              << ", its data is lost." << LogVar("slot", reference.slot) << LogVar("size", reference.size));
+      increment("lost_shared_memory_messages");
+      return false;
+    }
+
+    // The slot is given back when the message pointing into it is destroyed
+    auto* hint = new std::pair<std::shared_ptr<SharedMemoryMessagePool>, std::uint32_t>(m_sharedMemoryPool, reference.slot);
+    data = zmq::message_t(m_sharedMemoryPool->getSlot(reference.slot), reference.size, &releaseSharedMemorySlot, hint);
+    message.template getMessagePart<AMessage::c_type>() = zmq::message_t(&reference.type, 1);
+    return true;
+  }
 }
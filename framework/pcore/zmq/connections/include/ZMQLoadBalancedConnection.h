@@ -19,6 +19,9 @@
 #include <memory>
 #include <set>
 #include <deque>
+#include <map>
+#include <chrono>
+#include <optional>
 
 namespace Belle2 {
   /**
@@ -32,6 +35,12 @@ namespace Belle2 {
    *
    * Please note that only event messages (and raw event messages) are answered
    * with a ready message.
+   *
+   * The initial ready messages are empty, the ready messages answering an event
+   * carry the time in microseconds since the previous event was received (or -1 for the first event).
+   * As the input is typically polled directly after the previous event is processed, this is
+   * (for a busy input) the processing time of the previous event. The output uses these to
+   * calculate in-flight events and latencies.
    */
   class ZMQLoadBalancedInput : public ZMQConnectionOverSocket {
   public:
@@ -41,6 +50,10 @@ namespace Belle2 {
 
     /// Answer event messages with a ready message and pass on every received message.
     std::unique_ptr<ZMQNoIdMessage> handleIncomingData();
+
+  private:
+    /// When was the last event received?
+    std::optional<std::chrono::steady_clock::time_point> m_lastEventReceived;
   };
 
   /**
@@ -62,12 +75,21 @@ namespace Belle2 {
    * polled for new ready messages. However, there is also a "lax" mode which
    * makes the events being silently discarded if no input is ready.
    *
+   * Ready messages answering an event (see ZMQLoadBalancedInput) mark the oldest event sent to
+   * this input as started. The time between sending an event and its start is recorded in the
+   * "dispatch_latency" histograms and the reported processing time of the previous event in the
+   * "worker_event_interval" histograms (see ZMQLogger::histogram), both overall and per input.
+   * If maximalInFlightEvents is larger than 0, an input only gets new events as long as less than
+   * this number of its events are not started yet, even if it has sent more ready messages.
+   * This limits how many events can pile up in front of a slow input.
+   *
    * Internally a ZMQ_ROUTER in bind mode is used.
    */
   class ZMQLoadBalancedOutput : public ZMQConnectionOverSocket {
   public:
     /// Create a new load-balanced output and bind to the given address.
-    ZMQLoadBalancedOutput(const std::string& outputAddress, bool lax, const std::shared_ptr<ZMQParent>& parent);
+    ZMQLoadBalancedOutput(const std::string& outputAddress, bool lax, const std::shared_ptr<ZMQParent>& parent,
+                          unsigned int maximalInFlightEvents = 0);
 
     /**
      * Send the given message (without identity) to the next input
@@ -87,10 +109,13 @@ namespace Belle2 {
     void handleIncomingData();
     /// Clear the counter for sent stop and terminate messages. Should be called on run start.
     void clear();
-    /// If lax mode is disabled, the output is ready if at least a single input is ready. Else always.
+    /// If lax mode is disabled, the output is ready if at least a single input is ready (and below its in-flight limit). Else always.
     bool isReady() const final;
 
   protected:
+    /// Return the first input in the ready queue which is below its in-flight limit (or end of queue if there is none)
+    std::deque<std::string>::const_iterator findNextWorker() const;
+
     /// List of identities of ready inputs in LIFO order
     std::deque<std::string> m_readyWorkers;
     /// All ever registered inputs
@@ -101,5 +126,9 @@ namespace Belle2 {
     bool m_sentTerminateMessages = false;
     /// Parameter to enable lax mode
     bool m_lax = false;
+    /// Parameter: maximal number of not yet started events per input (0 means no limit)
+    unsigned int m_maximalInFlightEvents = 0;
+    /// Send times of the not yet started events per input
+    std::map<std::string, std::deque<std::chrono::steady_clock::time_point>> m_inFlightEvents;
   };
 }
\ No newline at end of file
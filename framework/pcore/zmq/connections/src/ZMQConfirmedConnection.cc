@@ -47,6 +47,7 @@ ZMQConfirmedInput::ZMQConfirmedInput(const std::string& inputAddress, const std:
 std::unique_ptr<ZMQIdMessage> ZMQConfirmedInput::handleIncomingData()
 {
   auto message = ZMQMessageFactory::fromSocket<ZMQIdMessage>(m_socket);
+  const bool hasData = fromSharedMemory(*message);
   const auto fromIdentity = message->getIdentity();
 
   logTime("last_received_message");
@@ -56,6 +57,11 @@ std::unique_ptr<ZMQIdMessage> ZMQConfirmedInput::handleIncomingData()
   auto confirmMessage = ZMQMessageFactory::createMessage(fromIdentity, EMessageTypes::c_confirmMessage);
   ZMQParent::send(m_socket, std::move(confirmMessage));
 
+  if (not hasData) {
+    // The sender has put the data into the pool of our predecessor (we have been restarted), nothing to pass on
+    return {};
+  }
+
   if (message->isMessage(EMessageTypes::c_helloMessage)) {
     // a hello message makes us register the worker identity - which is the identity of the sender of the message
     m_registeredWorkersInput.emplace(fromIdentity);
@@ -226,6 +232,8 @@ ZMQConfirmedOutput::ZMQConfirmedOutput(const std::string& outputAddress, const s
 
   // Register a non-binding DEALER socket
   m_socket = m_parent->createSocket<ZMQ_DEALER>(outputAddress, false);
+  // Send the event data via shared memory if the input offers it (only for local connections)
+  attachSharedMemoryPool(outputAddress);
 
   logTime("last_hello_sent");
 
@@ -265,6 +273,7 @@ void ZMQConfirmedOutput::handleEvent(std::unique_ptr<ZMQNoIdMessage> message, bo
 
   logTime("last_sent_event_message");
 
+  toSharedMemory(*message);
   ZMQParent::send(m_socket, std::move(message));
   m_waitingForConfirmation++;
 }
@@ -92,3 +92,38 @@ std::string ZMQConnectionOverSocket::getEndPoint() const
   }
   return endpoint;
 }
+
+void ZMQConnectionOverSocket::createSharedMemoryPool(const std::string& address, std::uint32_t numberOfSlots,
+                                                     std::uint64_t slotSize)
+{
+  const std::string poolName = SharedMemoryMessagePool::getPoolName(address);
+  if (poolName.empty()) {
+    B2WARNING("Shared memory can only be used for ipc connections, will send all data over " << address);
+    return;
+  }
+  m_sharedMemoryAddress = address;
+  m_sharedMemoryPool = SharedMemoryMessagePool::create(poolName, numberOfSlots, slotSize);
+  log("shared_memory_messages", 0l);
+  log("shared_memory_fallbacks", 0l);
+}
+
+void ZMQConnectionOverSocket::attachSharedMemoryPool(const std::string& address)
+{
+  const std::string poolName = SharedMemoryMessagePool::getPoolName(address);
+  if (poolName.empty()) {
+    return;
+  }
+  m_sharedMemoryAddress = address;
+  m_sharedMemoryPool = SharedMemoryMessagePool::attach(poolName);
+  if (m_sharedMemoryPool) {
+    log("shared_memory_messages", 0l);
+    log("shared_memory_fallbacks", 0l);
+  }
+}
+
+void ZMQConnectionOverSocket::releaseSharedMemorySlot(void*, void* hint)
+{
+  auto* poolAndSlot = static_cast<std::pair<std::shared_ptr<SharedMemoryMessagePool>, std::uint32_t>*>(hint);
+  poolAndSlot->first->release(poolAndSlot->second);
+  delete poolAndSlot;
+}
@@ -10,6 +10,9 @@
 #include <framework/pcore/zmq/messages/ZMQMessageFactory.h>
 #include <framework/logging/Logger.h>
 
+#include <algorithm>
+#include <charconv>
+
 using namespace Belle2;
 
 ZMQLoadBalancedInput::ZMQLoadBalancedInput(const std::string& inputAddress, unsigned int bufferSize,
@@ -23,6 +26,8 @@ ZMQLoadBalancedInput::ZMQLoadBalancedInput(const std::string& inputAddress, unsi
 
   // Create a non-binding DEALER socket
   m_socket = m_parent->createSocket<ZMQ_DEALER>(inputAddress, false);
+  // Receive the event data via shared memory if the output offers it (only for local connections)
+  attachSharedMemoryPool(inputAddress);
 
   // Send as many ready message as our buffer size is. This means we will get that many events, which will then be "in flight"
   for (unsigned int i = 0; i < bufferSize; i++) {
@@ -35,10 +40,22 @@ ZMQLoadBalancedInput::ZMQLoadBalancedInput(const std::string& inputAddress, unsi
 std::unique_ptr<ZMQNoIdMessage> ZMQLoadBalancedInput::handleIncomingData()
 {
   auto message = ZMQMessageFactory::fromSocket<ZMQNoIdMessage>(m_socket);
+  if (not fromSharedMemory(*message)) {
+    // We only attach to the pool of the distributor, so it is gone together with the event
+    B2FATAL("The shared memory pool of the distributor is gone, can not read the event data");
+  }
 
   if (message->isMessage(EMessageTypes::c_rawDataMessage) or message->isMessage(EMessageTypes::c_eventMessage)) {
     // if it is an event message, return a ready message back. If not, no need for that.
-    auto readyMessage = ZMQMessageFactory::createMessage(EMessageTypes::c_readyMessage);
+    // The ready message includes the time since the last event, which the output uses for latency monitoring
+    const auto now = std::chrono::steady_clock::now();
+    long eventInterval = -1;
+    if (m_lastEventReceived) {
+      eventInterval = std::chrono::duration_cast<std::chrono::microseconds>(now - *m_lastEventReceived).count();
+    }
+    m_lastEventReceived = now;
+
+    auto readyMessage = ZMQMessageFactory::createMessage(EMessageTypes::c_readyMessage, std::to_string(eventInterval));
     ZMQParent::send(m_socket, std::move(readyMessage));
     increment("sent_ready");
 
@@ -54,8 +71,9 @@ std::unique_ptr<ZMQNoIdMessage> ZMQLoadBalancedInput::handleIncomingData()
 }
 
 ZMQLoadBalancedOutput::ZMQLoadBalancedOutput(const std::string& outputAddress, bool lax,
-                                             const std::shared_ptr<ZMQParent>& parent) : ZMQConnectionOverSocket(
-                                                 parent), m_lax(lax)
+                                             const std::shared_ptr<ZMQParent>& parent,
+                                             unsigned int maximalInFlightEvents) : ZMQConnectionOverSocket(
+                                                 parent), m_lax(lax), m_maximalInFlightEvents(maximalInFlightEvents)
 {
   // We clear all our internal state and counters
   log("ready_queue_size", static_cast<long>(m_readyWorkers.size()));
@@ -104,7 +122,8 @@ void ZMQLoadBalancedOutput::handleEvent(std::unique_ptr<ZMQNoIdMessage> message)
     return;
   }
 
-  if (m_lax and m_readyWorkers.empty()) {
+  auto nextWorkerIterator = findNextWorker();
+  if (m_lax and nextWorkerIterator == m_readyWorkers.end()) {
     // There is no one that can handle the event in the moment, dismiss it (if lax is true)
     increment("dismissed_events");
     return;
@@ -117,13 +136,19 @@ void ZMQLoadBalancedOutput::handleEvent(std::unique_ptr<ZMQNoIdMessage> message)
 
   const auto dataSize = message->getDataMessage().size();
 
-  B2ASSERT("Must be > 0", not m_readyWorkers.empty());
-  auto nextWorker = m_readyWorkers.front();
-  m_readyWorkers.pop_front();
+  B2ASSERT("Must be > 0", nextWorkerIterator != m_readyWorkers.end());
+  auto nextWorker = *nextWorkerIterator;
+  m_readyWorkers.erase(nextWorkerIterator);
+
+  auto& inFlightEvents = m_inFlightEvents[nextWorker];
+  inFlightEvents.push_back(std::chrono::steady_clock::now());
+  log("in_flight_events[" + nextWorker + "]", static_cast<long>(inFlightEvents.size()));
 
   average("data_size", dataSize);
   average("data_size_to[" + nextWorker + "]", dataSize);
 
+  toSharedMemory(*message);
+
   increment("sent_events");
   increment("sent_events[" + nextWorker + "]");
 
@@ -146,6 +171,34 @@ void ZMQLoadBalancedOutput::handleIncomingData()
   const auto toIdentity = readyMessage->getIdentity();
   m_readyWorkers.push_back(toIdentity);
 
+  const auto& readyData = readyMessage->getDataMessage();
+  auto& inFlightEvents = m_inFlightEvents[toIdentity];
+  if (readyData.size() == 0) {
+    // An empty ready message is sent when the input (re)starts, e.g. a restarted worker with the same identity.
+    // Events sent to a previous instance will never be answered, so they must not count against the in-flight limit.
+    inFlightEvents.clear();
+  } else if (not inFlightEvents.empty()) {
+    // A non-empty ready message answers an event: the oldest event in flight is started now
+    const auto dispatchLatency = std::chrono::duration_cast<std::chrono::microseconds>(
+                                   std::chrono::steady_clock::now() - inFlightEvents.front()).count();
+    inFlightEvents.pop_front();
+    histogram("dispatch_latency", dispatchLatency);
+    histogram("dispatch_latency[" + toIdentity + "]", dispatchLatency);
+
+    // The content comes from the other side of the connection, so do not trust it
+    long eventInterval = -1;
+    const char* first = readyData.data<char>();
+    const char* last = first + readyData.size();
+    const auto result = std::from_chars(first, last, eventInterval);
+    if (result.ec != std::errc() or result.ptr != last) {
+      increment("malformed_ready_messages");
+    } else if (eventInterval >= 0) {
+      histogram("worker_event_interval", eventInterval);
+      histogram("worker_event_interval[" + toIdentity + "]", eventInterval);
+    }
+  }
+  log("in_flight_events[" + toIdentity + "]", static_cast<long>(inFlightEvents.size()));
+
   if (m_allWorkers.emplace(toIdentity).second) {
     // Aha, we did never see this worker so far, so add it to our list.
     if (m_sentStopMessages) {
@@ -175,8 +228,21 @@ void ZMQLoadBalancedOutput::clear()
   log("all_terminate_messages", static_cast<long>(m_sentTerminateMessages));
 }
 
+std::deque<std::string>::const_iterator ZMQLoadBalancedOutput::findNextWorker() const
+{
+  if (m_maximalInFlightEvents == 0) {
+    return m_readyWorkers.begin();
+  }
+
+  return std::find_if(m_readyWorkers.begin(), m_readyWorkers.end(), [this](const std::string & worker) {
+    const auto inFlightEvents = m_inFlightEvents.find(worker);
+    return inFlightEvents == m_inFlightEvents.end() or inFlightEvents->second.size() < m_maximalInFlightEvents;
+  });
+}
+
 bool ZMQLoadBalancedOutput::isReady() const
 {
   // if we are lax, we are always ready. If not, we need to have at least a single ready worker. This prevents the B2ASSERT to fail.
-  return m_lax or not m_readyWorkers.empty();
+  // With an in-flight limit, ready workers with too many not started events do not count.
+  return m_lax or findNextWorker() != m_readyWorkers.end();
 }
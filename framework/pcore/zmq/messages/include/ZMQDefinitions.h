@@ -22,6 +22,7 @@ namespace Belle2 {
     c_rawDataMessage = 'u',        // a normal message with event data but in raw format
     c_compressedDataMessage = 'v', // a normal message with event data but in compressed format
     c_eventMessage = 'w',          // a normal message with event data
+    c_sharedMemoryDataMessage = 'o', // event data placed in a shared memory slot, only the slot reference is sent
 
     // Only needed by framework
     c_goodbyeMessage = 'g',      // un-registration
@@ -31,5 +32,6 @@ namespace Belle2 {
     // Only needed by DAQ
     c_monitoringMessage = 'm',   // sent in DAQ package to monitor from remote
     c_newRunMessage = 'n',              // sent in DAQ package on starting
+    c_compressedDeltaDataMessage = 'p', // compressed histograms, only the ones changed since the last message
   };
 }
\ No newline at end of file
@@ -0,0 +1,68 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Belle2 {
+  /**
+   * Fixed-memory histogram of (latency) values with a constant relative precision,
+   * in the spirit of the HDR histograms.
+   *
+   * Values below c_subBuckets are counted exactly. Larger values are sorted
+   * into buckets whose width doubles with every power of two, each power of two being split
+   * into c_subBuckets / 2 linear sub buckets. This gives a relative precision of
+   * better than 2 / c_subBuckets over the whole range up to 2^c_maxExponent
+   * (larger values are counted in the last bucket) with a few kB of memory and
+   * a constant time for recording a value.
+   *
+   * Typically used with latencies in microseconds.
+   */
+  class LatencyHistogram {
+  public:
+    /// Number of exact buckets at the beginning (and twice the number of sub buckets per power of two)
+    static constexpr std::uint64_t c_subBuckets = 128;
+    /// Largest power of two which can still be resolved
+    static constexpr unsigned int c_maxExponent = 40;
+
+    /// Create an empty histogram
+    LatencyHistogram();
+
+    /// Count the given value
+    void record(std::uint64_t value);
+    /// Remove all counts
+    void reset();
+
+    /// Number of recorded values
+    std::uint64_t getCount() const { return m_count; }
+    /// Largest recorded value (exact)
+    std::uint64_t getMax() const { return m_max; }
+    /// Mean of the recorded values (exact)
+    double getMean() const { return m_count > 0 ? static_cast<double>(m_sum) / m_count : 0; }
+    /// Return the value below which the given percentage (0-100) of the recorded values lie (up to the bucket precision)
+    std::uint64_t getValueAtPercentile(double percentile) const;
+
+    /// Return the bucket index of the given value
+    static unsigned int getBucketIndex(std::uint64_t value);
+    /// Return the smallest value counted in the bucket with the given index
+    static std::uint64_t getBucketLowerEdge(unsigned int index);
+    /// Return the largest value counted in the bucket with the given index
+    static std::uint64_t getBucketUpperEdge(unsigned int index);
+
+  private:
+    /// Counts per bucket
+    std::vector<std::uint64_t> m_counts;
+    /// Total number of counts
+    std::uint64_t m_count = 0;
+    /// Sum of all recorded values
+    std::uint64_t m_sum = 0;
+    /// Largest recorded value
+    std::uint64_t m_max = 0;
+  };
+}
@@ -0,0 +1,124 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace Belle2 {
+  /// Header at the start of the shared memory segment of a SharedMemoryMessagePool.
+  struct SharedMemoryMessagePoolHeader {
+    std::uint64_t magic; /**< marker to check that we attached to a valid pool. */
+    std::uint64_t identifier; /**< random number distinguishing pools created under the same name. */
+    std::uint64_t segmentSize; /**< total size of the segment in bytes. */
+    std::uint32_t numberOfSlots; /**< number of slots (a power of two). */
+    std::uint64_t slotSize; /**< size of a single slot in bytes. */
+    std::atomic<std::uint32_t> retired; /**< set when the creator is gone or a new pool with the same name has replaced this one. */
+    alignas(64) std::atomic<std::uint64_t> releasePosition; /**< position of the next free list cell to write a released slot into. */
+    alignas(64) std::atomic<std::uint64_t> allocatePosition; /**< position of the next free list cell to read a free slot from. */
+  };
+
+  /// A single cell of the free list of a SharedMemoryMessagePool.
+  struct SharedMemoryMessagePoolCell {
+    std::atomic<std::uint64_t> sequence; /**< sequence number telling if the cell can be read or written. */
+    std::uint32_t slot; /**< index of the free slot stored in this cell. */
+  };
+
+  /// Reference to a message stored in a slot of a SharedMemoryMessagePool. Sent instead of the message data.
+  struct SharedMemoryMessageReference {
+    std::uint64_t poolIdentifier; /**< identifier of the pool the slot belongs to. */
+    std::uint64_t size; /**< size of the message data in the slot. */
+    std::uint32_t slot; /**< index of the slot. */
+    char type; /**< original message type. */
+  };
+
+  /**
+   * Pool of fixed-size message slots in a named POSIX shared memory segment,
+   * used to pass event payloads between local processes without copying them
+   * through the kernel socket buffers.
+   *
+   * The free slots are kept in a lock-free bounded queue (D. Vyukov's MPMC algorithm), so any
+   * number of processes can allocate (write a message) and release (after reading a message)
+   * slots at the same time. This covers the single producer - many consumer case
+   * (distributor to workers) as well as the many producer - single consumer case (workers to collector).
+   *
+   * The pool does not do any notification: the slot index is sent over the normal ZMQ
+   * connection, see ZMQConnectionOverSocket::toSharedMemory.
+   * If the owning process of a slot dies before releasing it, the slot is lost. If no
+   * slot is free anymore, the connections fall back to sending the payload over ZMQ.
+   *
+   * The process creating the pool removes the segment name again on destruction,
+   * already attached processes can still use their mapping.
+   * The pool is then marked as retired, the same happens if a new pool is created under the same name
+   * (e.g. when a crashed collector is restarted). Attached processes check this before each use
+   * and attach to the new pool, see ZMQConnectionOverSocket::toSharedMemory.
+   */
+  class SharedMemoryMessagePool {
+  public:
+    /// Create a new pool with the given name (any existing segment with this name is removed before).
+    static std::shared_ptr<SharedMemoryMessagePool> create(const std::string& name, std::uint32_t numberOfSlots,
+                                                           std::uint64_t slotSize);
+    /// Attach to an already existing pool with the given name. Returns a nullptr if there is none.
+    static std::shared_ptr<SharedMemoryMessagePool> attach(const std::string& name);
+    /// Return the pool name used for the ZMQ address (only ipc addresses have one, all other return an empty string).
+    static std::string getPoolName(const std::string& address);
+
+    /// Unmap the segment and remove its name if we have created it (in this process)
+    ~SharedMemoryMessagePool();
+    /// No copies
+    SharedMemoryMessagePool(const SharedMemoryMessagePool&) = delete;
+    /// No assignment
+    SharedMemoryMessagePool& operator=(const SharedMemoryMessagePool&) = delete;
+
+    /// Take a free slot. Returns nothing if all slots are in use.
+    std::optional<std::uint32_t> allocate();
+    /// Give the slot back to the free list.
+    void release(std::uint32_t slot);
+
+    /// Return the start of the slot with the given index
+    char* getSlot(std::uint32_t slot) const;
+    /// Return the size of a single slot
+    std::uint64_t getSlotSize() const { return m_header->slotSize; }
+    /// Return the number of slots
+    std::uint32_t getNumberOfSlots() const { return m_header->numberOfSlots; }
+    /// Has this pool object created the segment?
+    bool isOwner() const { return m_owner; }
+    /// Return the random identifier of this pool
+    std::uint64_t getIdentifier() const { return m_header->identifier; }
+    /// Has the creator given up this pool (or replaced it by a new one)? Attached processes should not put new data into it.
+    bool isRetired() const { return m_header->retired.load(std::memory_order_acquire) != 0; }
+    /// Mark the pool as retired
+    void retire() { m_header->retired.store(1, std::memory_order_release); }
+    /// Return the (approximate) number of free slots
+    std::uint32_t getNumberOfFreeSlots() const;
+
+  private:
+    /// Use the static functions for creating a pool
+    SharedMemoryMessagePool(const std::string& name, void* segment, std::uint64_t segmentSize, bool owner);
+
+    /// Name of the shared memory segment
+    std::string m_name;
+    /// Start of the mapped segment
+    void* m_segment = nullptr;
+    /// Size of the mapped segment
+    std::uint64_t m_segmentSize = 0;
+    /// Did we create the segment?
+    bool m_owner = false;
+    /// Process which has created (or attached) the pool. Forked children do not remove the segment name.
+    int m_processID = 0;
+    /// Header at the start of the segment
+    SharedMemoryMessagePoolHeader* m_header = nullptr;
+    /// Free list, following the header
+    SharedMemoryMessagePoolCell* m_cells = nullptr;
+    /// Start of the slots, following the free list
+    char* m_slots = nullptr;
+  };
+}
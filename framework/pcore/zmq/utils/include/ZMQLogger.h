@@ -7,6 +7,8 @@
  **************************************************************************/
 #pragma once
 
+#include <framework/pcore/zmq/utils/LatencyHistogram.h>
+
 #include <variant>
 #include <chrono>
 #include <vector>
@@ -48,6 +50,16 @@ namespace Belle2 {
     void timeit(const std::string& key);
     /// Store the current time as a string under the given key
     void logTime(const std::string& key);
+    /**
+     * Record the value (e.g. a latency in microseconds) in a LatencyHistogram stored under the given key.
+     * Its 50%, 90% and 99% percentiles, the maximum and the number of entries are reported as
+     * \<key\>_p50, \<key\>_p90, \<key\>_p99, \<key\>_max and \<key\>_count (calculated only when
+     * the monitoring JSON is requested). A key of the form \<name\>[\<identity\>] is reported as
+     * \<name\>_p50[\<identity\>] etc.
+     * After RESET_SIZE values, the histogram starts from scratch, so it always describes the recent values.
+     */
+    template<size_t RESET_SIZE = 10000>
+    void histogram(const std::string& key, std::uint64_t value);
 
   private:
     /// Internal storage of all stored values
@@ -56,6 +68,12 @@ namespace Belle2 {
     std::unordered_map<std::string, std::tuple<std::vector<double>, size_t>> m_averages;
     /// Internal storage how often the timeit function for a given key was called and when it has last reached MAX_SIZE
     std::unordered_map<std::string, std::tuple<unsigned long, std::chrono::system_clock::time_point>> m_timeCounters;
+    /// Internal storage of the histograms
+    std::unordered_map<std::string, LatencyHistogram> m_histograms;
+
+    /// Add the summary values of the given histogram to the monitoring values
+    static void addHistogramSummary(const std::string& key, const LatencyHistogram& latencyHistogram,
+                                    std::map<std::string, std::variant<long, double, std::string>>& monitoring);
 
     /// Visitor Helper for converting a variant value into a JSON string
     struct toJSON {
@@ -128,4 +146,14 @@ namespace Belle2 {
     }
     calls++;
   }
+
+  template<size_t RESET_SIZE>
+  void ZMQLogger::histogram(const std::string& key, std::uint64_t value)
+  {
+    auto& latencyHistogram = m_histograms[key];
+    if (latencyHistogram.getCount() == RESET_SIZE) {
+      latencyHistogram.reset();
+    }
+    latencyHistogram.record(value);
+  }
 }
@@ -0,0 +1,107 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+#include <framework/pcore/zmq/utils/LatencyHistogram.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace Belle2;
+
+namespace {
+  /// Half of the sub buckets: the number of linear buckets per power of two above c_subBuckets
+  constexpr std::uint64_t c_halfSubBuckets = LatencyHistogram::c_subBuckets / 2;
+  /// log2(c_halfSubBuckets)
+  constexpr unsigned int c_halfSubBucketsBits = 6;
+  static_assert((1u << c_halfSubBucketsBits) == c_halfSubBuckets, "Sub buckets need to be a power of two");
+
+  /// Total number of buckets
+  constexpr unsigned int c_numberOfBuckets = LatencyHistogram::c_subBuckets
+                                             + (LatencyHistogram::c_maxExponent - c_halfSubBucketsBits) * c_halfSubBuckets;
+}
+
+LatencyHistogram::LatencyHistogram() : m_counts(c_numberOfBuckets, 0)
+{
+}
+
+unsigned int LatencyHistogram::getBucketIndex(std::uint64_t value)
+{
+  if (value < c_subBuckets) {
+    return value;
+  }
+
+  const unsigned int mostSignificantBit = 63 - __builtin_clzll(value);
+  if (mostSignificantBit > c_maxExponent) {
+    return c_numberOfBuckets - 1;
+  }
+
+  // keep the c_halfSubBucketsBits + 1 most significant bits of the value
+  const unsigned int shift = mostSignificantBit - c_halfSubBucketsBits;
+  const std::uint64_t mantissa = value >> shift;
+  return c_subBuckets + (shift - 1) * c_halfSubBuckets + (mantissa - c_halfSubBuckets);
+}
+
+std::uint64_t LatencyHistogram::getBucketLowerEdge(unsigned int index)
+{
+  if (index < c_subBuckets) {
+    return index;
+  }
+
+  const unsigned int offset = index - c_subBuckets;
+  const unsigned int shift = offset / c_halfSubBuckets + 1;
+  const std::uint64_t mantissa = offset % c_halfSubBuckets + c_halfSubBuckets;
+  return mantissa << shift;
+}
+
+std::uint64_t LatencyHistogram::getBucketUpperEdge(unsigned int index)
+{
+  if (index < c_subBuckets) {
+    return index;
+  }
+
+  const unsigned int shift = (index - c_subBuckets) / c_halfSubBuckets + 1;
+  return getBucketLowerEdge(index) + (std::uint64_t(1) << shift) - 1;
+}
+
+void LatencyHistogram::record(std::uint64_t value)
+{
+  m_counts[getBucketIndex(value)]++;
+  m_count++;
+  m_sum += value;
+  m_max = std::max(m_max, value);
+}
+
+void LatencyHistogram::reset()
+{
+  std::fill(m_counts.begin(), m_counts.end(), 0);
+  m_count = 0;
+  m_sum = 0;
+  m_max = 0;
+}
+
+std::uint64_t LatencyHistogram::getValueAtPercentile(double percentile) const
+{
+  if (m_count == 0) {
+    return 0;
+  }
+
+  const double fraction = std::clamp(percentile, 0.0, 100.0) / 100.0;
+  const std::uint64_t neededCounts = std::max<std::uint64_t>(1, std::ceil(fraction * m_count));
+
+  std::uint64_t cumulativeCounts = 0;
+  for (unsigned int index = 0; index < m_counts.size(); index++) {
+    cumulativeCounts += m_counts[index];
+    if (cumulativeCounts >= neededCounts) {
+      // The bucket edge can be larger than anything we have seen (and the last bucket also holds all larger values)
+      if (index == m_counts.size() - 1) {
+        return m_max;
+      }
+      return std::min(getBucketUpperEdge(index), m_max);
+    }
+  }
+  return m_max;
+}
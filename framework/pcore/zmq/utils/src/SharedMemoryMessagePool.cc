@@ -0,0 +1,236 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+#include <framework/pcore/zmq/utils/SharedMemoryMessagePool.h>
+#include <framework/logging/Logger.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <random>
+#include <sstream>
+
+using namespace Belle2;
+
+namespace {
+  /// Marker written into the header
+  constexpr std::uint64_t c_magic = 0x62326d73676d706cull;
+  /// Alignment of the free list and the slots (one cache line)
+  constexpr std::uint64_t c_alignment = 64;
+
+  static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "The pool needs lock-free 64 bit atomics");
+
+  /// Round the value up to a multiple of c_alignment
+  std::uint64_t align(std::uint64_t value)
+  {
+    return (value + c_alignment - 1) / c_alignment * c_alignment;
+  }
+
+  /// Offset of the free list in the segment
+  std::uint64_t getCellsOffset()
+  {
+    return align(sizeof(SharedMemoryMessagePoolHeader));
+  }
+
+  /// Offset of the slots in the segment
+  std::uint64_t getSlotsOffset(std::uint32_t numberOfSlots)
+  {
+    return getCellsOffset() + align(numberOfSlots * sizeof(SharedMemoryMessagePoolCell));
+  }
+}
+
+std::shared_ptr<SharedMemoryMessagePool> SharedMemoryMessagePool::create(const std::string& name, std::uint32_t numberOfSlots,
+    std::uint64_t slotSize)
+{
+  B2ASSERT("The number of slots must be a power of two", numberOfSlots > 0 and (numberOfSlots & (numberOfSlots - 1)) == 0);
+  slotSize = align(slotSize);
+  const std::uint64_t segmentSize = getSlotsOffset(numberOfSlots) + numberOfSlots * slotSize;
+
+  // A left over from a crashed process would have the wrong state. Processes still attached to it
+  // need to know that they should switch to the new pool.
+  if (auto previousPool = attach(name)) {
+    previousPool->retire();
+  }
+  shm_unlink(name.c_str());
+  const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) {
+    B2FATAL("Could not create the shared memory segment " << name << ": " << std::strerror(errno));
+  }
+  if (ftruncate(fd, segmentSize) != 0) {
+    close(fd);
+    shm_unlink(name.c_str());
+    B2FATAL("Could not resize the shared memory segment " << name << " to " << segmentSize << " bytes: " << std::strerror(errno));
+  }
+  void* segment = mmap(nullptr, segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (segment == MAP_FAILED) {
+    shm_unlink(name.c_str());
+    B2FATAL("Could not map the shared memory segment " << name << ": " << std::strerror(errno));
+  }
+
+  auto* header = new (segment) SharedMemoryMessagePoolHeader;
+  header->identifier = std::random_device()() ^ (static_cast<std::uint64_t>(getpid()) << 32);
+  header->segmentSize = segmentSize;
+  header->numberOfSlots = numberOfSlots;
+  header->slotSize = slotSize;
+  header->retired = 0;
+  header->releasePosition = 0;
+  header->allocatePosition = 0;
+
+  // In the beginning all slots are free: cell i holds slot i and is ready to be read
+  auto* cells = reinterpret_cast<SharedMemoryMessagePoolCell*>(static_cast<char*>(segment) + getCellsOffset());
+  for (std::uint32_t cell = 0; cell < numberOfSlots; cell++) {
+    new (&cells[cell]) SharedMemoryMessagePoolCell;
+    cells[cell].slot = cell;
+    cells[cell].sequence.store(cell + 1, std::memory_order_relaxed);
+  }
+  header->releasePosition.store(numberOfSlots, std::memory_order_relaxed);
+
+  // Only now the pool can be used by others
+  std::atomic_thread_fence(std::memory_order_release);
+  header->magic = c_magic;
+
+  return std::shared_ptr<SharedMemoryMessagePool>(new SharedMemoryMessagePool(name, segment, segmentSize, true));
+}
+
+std::shared_ptr<SharedMemoryMessagePool> SharedMemoryMessagePool::attach(const std::string& name)
+{
+  const int fd = shm_open(name.c_str(), O_RDWR, 0600);
+  if (fd < 0) {
+    return nullptr;
+  }
+
+  // First only map the header to find out the full size
+  void* headerSegment = mmap(nullptr, sizeof(SharedMemoryMessagePoolHeader), PROT_READ, MAP_SHARED, fd, 0);
+  if (headerSegment == MAP_FAILED) {
+    close(fd);
+    return nullptr;
+  }
+  const auto* header = static_cast<const SharedMemoryMessagePoolHeader*>(headerSegment);
+  const std::uint64_t magic = header->magic;
+  const std::uint64_t segmentSize = header->segmentSize;
+  munmap(headerSegment, sizeof(SharedMemoryMessagePoolHeader));
+
+  if (magic != c_magic) {
+    close(fd);
+    B2WARNING("The shared memory segment " << name << " is not (yet) a valid message pool. Will not use it.");
+    return nullptr;
+  }
+
+  void* segment = mmap(nullptr, segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (segment == MAP_FAILED) {
+    B2WARNING("Could not map the shared memory segment " << name << ": " << std::strerror(errno));
+    return nullptr;
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+
+  return std::shared_ptr<SharedMemoryMessagePool>(new SharedMemoryMessagePool(name, segment, segmentSize, false));
+}
+
+std::string SharedMemoryMessagePool::getPoolName(const std::string& address)
+{
+  // Only local (ipc) connections can share memory. tcp connections may go to another host.
+  const std::string ipcPrefix = "ipc://";
+  if (address.compare(0, ipcPrefix.size(), ipcPrefix) != 0) {
+    return "";
+  }
+
+  // Every process needs to come up with the same name, so use a fixed hash function (FNV-1a)
+  std::uint64_t hash = 0xcbf29ce484222325ull;
+  for (const char character : address) {
+    hash = (hash ^ static_cast<unsigned char>(character)) * 0x100000001b3ull;
+  }
+
+  std::stringstream name;
+  name << "/basf2_zmq_" << std::hex << hash;
+  return name.str();
+}
+
+SharedMemoryMessagePool::SharedMemoryMessagePool(const std::string& name, void* segment, std::uint64_t segmentSize,
+                                                 bool owner) :
+  m_name(name), m_segment(segment), m_segmentSize(segmentSize), m_owner(owner), m_processID(getpid())
+{
+  m_header = static_cast<SharedMemoryMessagePoolHeader*>(segment);
+  m_cells = reinterpret_cast<SharedMemoryMessagePoolCell*>(static_cast<char*>(segment) + getCellsOffset());
+  m_slots = static_cast<char*>(segment) + getSlotsOffset(m_header->numberOfSlots);
+}
+
+SharedMemoryMessagePool::~SharedMemoryMessagePool()
+{
+  if (m_owner and m_processID == getpid()) {
+    retire();
+    shm_unlink(m_name.c_str());
+  }
+  munmap(m_segment, m_segmentSize);
+}
+
+std::optional<std::uint32_t> SharedMemoryMessagePool::allocate()
+{
+  const std::uint64_t mask = m_header->numberOfSlots - 1;
+  std::uint64_t position = m_header->allocatePosition.load(std::memory_order_relaxed);
+  while (true) {
+    auto& cell = m_cells[position & mask];
+    const std::uint64_t sequence = cell.sequence.load(std::memory_order_acquire);
+    const auto difference = static_cast<std::int64_t>(sequence) - static_cast<std::int64_t>(position + 1);
+    if (difference == 0) {
+      // The cell holds a free slot, try to claim it
+      if (m_header->allocatePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+        const std::uint32_t slot = cell.slot;
+        // Mark the cell as writable for the release one round later
+        cell.sequence.store(position + mask + 1, std::memory_order_release);
+        return slot;
+      }
+    } else if (difference < 0) {
+      // No free slot
+      return {};
+    } else {
+      // Someone else was faster
+      position = m_header->allocatePosition.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+void SharedMemoryMessagePool::release(std::uint32_t slot)
+{
+  B2ASSERT("Invalid slot index", slot < m_header->numberOfSlots);
+
+  const std::uint64_t mask = m_header->numberOfSlots - 1;
+  std::uint64_t position = m_header->releasePosition.load(std::memory_order_relaxed);
+  while (true) {
+    auto& cell = m_cells[position & mask];
+    const std::uint64_t sequence = cell.sequence.load(std::memory_order_acquire);
+    const auto difference = static_cast<std::int64_t>(sequence) - static_cast<std::int64_t>(position);
+    if (difference == 0) {
+      if (m_header->releasePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+        cell.slot = slot;
+        cell.sequence.store(position + 1, std::memory_order_release);
+        return;
+      }
+    } else {
+      // Either someone else was faster or (difference < 0) the allocation which emptied this cell one round
+      // before is not finished yet. As there are never more released slots than cells, the free list can
+      // not be full, so just try again.
+      position = m_header->releasePosition.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+char* SharedMemoryMessagePool::getSlot(std::uint32_t slot) const
+{
+  return m_slots + slot * m_header->slotSize;
+}
+
+std::uint32_t SharedMemoryMessagePool::getNumberOfFreeSlots() const
+{
+  const std::uint64_t released = m_header->releasePosition.load(std::memory_order_relaxed);
+  const std::uint64_t allocated = m_header->allocatePosition.load(std::memory_order_relaxed);
+  return released > allocated ? released - allocated : 0;
+}
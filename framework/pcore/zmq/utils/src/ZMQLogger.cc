@@ -14,10 +14,16 @@ using namespace Belle2;
 
 std::string ZMQLogger::getMonitoringJSON() const
 {
+  // The histogram summaries are only calculated on request, as this is much more expensive than filling
+  auto monitoring = m_monitoring;
+  for (const auto& [key, latencyHistogram] : m_histograms) {
+    addHistogramSummary(key, latencyHistogram, monitoring);
+  }
+
   std::stringstream buffer;
   buffer << "{";
   bool first = true;
-  for (const auto& keyValue : m_monitoring) {
+  for (const auto& keyValue : monitoring) {
     if (not first) {
       buffer << ", ";
     }
@@ -46,6 +52,21 @@ void ZMQLogger::logTime(const std::string& key)
   log(key, std::ctime(&displayTime));
 }
 
+void ZMQLogger::addHistogramSummary(const std::string& key, const LatencyHistogram& latencyHistogram,
+                                    std::map<std::string, std::variant<long, double, std::string>>& monitoring)
+{
+  // Keep an identity in brackets at the end, so e.g. the monitoring can still hide it
+  const auto bracketPosition = key.find('[');
+  const std::string name = key.substr(0, bracketPosition);
+  const std::string identity = bracketPosition == std::string::npos ? "" : key.substr(bracketPosition);
+
+  monitoring[name + "_p50" + identity] = static_cast<long>(latencyHistogram.getValueAtPercentile(50));
+  monitoring[name + "_p90" + identity] = static_cast<long>(latencyHistogram.getValueAtPercentile(90));
+  monitoring[name + "_p99" + identity] = static_cast<long>(latencyHistogram.getValueAtPercentile(99));
+  monitoring[name + "_max" + identity] = static_cast<long>(latencyHistogram.getMax());
+  monitoring[name + "_count" + identity] = static_cast<long>(latencyHistogram.getCount());
+}
+
 std::string ZMQLogger::toJSON::operator()(long value)
 {
   return std::to_string(value);
@@ -0,0 +1,131 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#include <framework/geometry/BFieldGrid.h>
+#include <framework/geometry/BFieldManager.h>
+#include <framework/database/DBStore.h>
+#include <framework/dbobjects/MagneticField.h>
+#include <framework/dbobjects/MagneticFieldComponentConstant.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+using namespace Belle2;
+
+namespace {
+  /** Binning used in the tests */
+  BFieldGrid::Binning getTestBinning()
+  {
+    BFieldGrid::Binning binning;
+    binning.xyMax = 50;
+    binning.zMin = -40;
+    binning.zMax = 60;
+    binning.spacing = 2;
+    return binning;
+  }
+
+  /** A linear field is reproduced exactly by the trilinear interpolation (up to the float precision) */
+  TEST(BFieldGrid, LinearField)
+  {
+    const auto linear = [](const ROOT::Math::XYZVector & pos) {
+      return ROOT::Math::XYZVector(0.01 * pos.X(), -0.02 * pos.Y() + 0.001 * pos.Z(), 1.5 + 0.003 * pos.Z());
+    };
+    const BFieldGrid grid(getTestBinning(), linear);
+    EXPECT_EQ(grid.getNumberOfNodes(), 51u * 51u * 51u);
+
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> xy(-50, 50), z(-40, 60);
+    for (int i = 0; i < 1000; ++i) {
+      const ROOT::Math::XYZVector pos(xy(generator), xy(generator), z(generator));
+      double field[3];
+      ASSERT_TRUE(grid.getField(pos.X(), pos.Y(), pos.Z(), field));
+      const ROOT::Math::XYZVector expected = linear(pos);
+      EXPECT_NEAR(field[0], expected.X(), 1e-6);
+      EXPECT_NEAR(field[1], expected.Y(), 1e-6);
+      EXPECT_NEAR(field[2], expected.Z(), 1e-6);
+    }
+
+    // the edges still belong to the grid, everything beyond not
+    double field[3] = {0, 0, 0};
+    EXPECT_TRUE(grid.getField(50, 50, 60, field));
+    EXPECT_NEAR(field[2], 1.5 + 0.003 * 60, 1e-6);
+    EXPECT_FALSE(grid.getField(50.1, 0, 0, field));
+    EXPECT_FALSE(grid.getField(0, 0, -40.1, field));
+  }
+
+  /** The interpolation error of a smooth field is small compared to the grid spacing */
+  TEST(BFieldGrid, CurvedField)
+  {
+    const auto curved = [](const ROOT::Math::XYZVector & pos) {
+      return ROOT::Math::XYZVector(std::sin(0.05 * pos.X()), std::cos(0.03 * pos.Y()), 1.5 - 1e-4 * pos.Z() * pos.Z());
+    };
+    const BFieldGrid grid(getTestBinning(), curved);
+
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> xy(-50, 50), z(-40, 60);
+    for (int i = 0; i < 1000; ++i) {
+      const ROOT::Math::XYZVector pos(xy(generator), xy(generator), z(generator));
+      double field[3];
+      ASSERT_TRUE(grid.getField(pos.X(), pos.Y(), pos.Z(), field));
+      const ROOT::Math::XYZVector expected = curved(pos);
+      EXPECT_NEAR(field[0], expected.X(), 2e-3);
+      EXPECT_NEAR(field[1], expected.Y(), 2e-3);
+      EXPECT_NEAR(field[2], expected.Z(), 2e-3);
+    }
+  }
+
+  /** Compare with the full component chain of a MagneticField */
+  TEST(BFieldGrid, MagneticFieldComponents)
+  {
+    MagneticField magneticField;
+    magneticField.addComponent(new MagneticFieldComponentConstant(ROOT::Math::XYZVector(0, 0, 1.5)));
+    magneticField.addComponent(new MagneticFieldComponentConstant(ROOT::Math::XYZVector(0.1, 0, 0), 0, 20, -10, 30));
+    const BFieldGrid grid(getTestBinning(), [&magneticField](const ROOT::Math::XYZVector & pos) {
+      return magneticField.getField(pos);
+    });
+
+    // away from the edge of the second component the grid agrees with the full field
+    for (const ROOT::Math::XYZVector pos : {ROOT::Math::XYZVector(1, 2, 3), ROOT::Math::XYZVector(-10, 5, 20),
+                                            ROOT::Math::XYZVector(30, -30, 50), ROOT::Math::XYZVector(0, 40, -30)
+                                           }) {
+      double field[3];
+      ASSERT_TRUE(grid.getField(pos.X(), pos.Y(), pos.Z(), field));
+      const ROOT::Math::XYZVector expected = magneticField.getField(pos);
+      EXPECT_NEAR(field[0], expected.X(), 1e-6);
+      EXPECT_NEAR(field[1], expected.Y(), 1e-6);
+      EXPECT_NEAR(field[2], expected.Z(), 1e-6);
+    }
+  }
+
+  /** The grid of the BFieldManager is filled when it is set and again when the field changes */
+  TEST(BFieldGrid, BFieldManager)
+  {
+    BFieldManager::setGrid(getTestBinning());
+    const double pos[3] = {1, 2, 3};
+    double field[3];
+    BFieldManager::getGridField(pos, field);
+    EXPECT_NEAR(field[2], 1.5 * Unit::T, 1e-6);
+
+    auto* newField = new MagneticField();
+    newField->addComponent(new MagneticFieldComponentConstant(ROOT::Math::XYZVector(0, 0, 2 * Unit::T)));
+    DBStore::Instance().addConstantOverride("MagneticField", newField, false);
+    BFieldManager::getGridField(pos, field);
+    EXPECT_NEAR(field[2], 2 * Unit::T, 1e-6);
+
+    // outside of the grid the full field is used
+    const double outside[3] = {0, 0, 100};
+    BFieldManager::getGridField(outside, field);
+    EXPECT_NEAR(field[2], 2 * Unit::T, 1e-6);
+
+    BFieldManager::resetGrid();
+    BFieldManager::getGridField(pos, field);
+    EXPECT_NEAR(field[2], 2 * Unit::T, 1e-6);
+  }
+}
@@ -0,0 +1,69 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#include <framework/pcore/zmq/utils/LatencyHistogram.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+using namespace Belle2;
+
+namespace {
+  /** Every value lies inside its bucket and the buckets are contiguous */
+  TEST(LatencyHistogramTest, BucketEdges)
+  {
+    for (std::uint64_t value = 0; value < 1'000'000; value += 7) {
+      const unsigned int index = LatencyHistogram::getBucketIndex(value);
+      EXPECT_LE(LatencyHistogram::getBucketLowerEdge(index), value);
+      EXPECT_GE(LatencyHistogram::getBucketUpperEdge(index), value);
+    }
+
+    for (unsigned int index = 1; index < 2000; index++) {
+      EXPECT_EQ(LatencyHistogram::getBucketLowerEdge(index), LatencyHistogram::getBucketUpperEdge(index - 1) + 1);
+    }
+
+    // small values are exact
+    EXPECT_EQ(LatencyHistogram::getBucketIndex(127), 127u);
+    EXPECT_EQ(LatencyHistogram::getBucketUpperEdge(LatencyHistogram::getBucketIndex(128)), 129u);
+  }
+
+  /** Percentiles are correct up to the relative bucket precision */
+  TEST(LatencyHistogramTest, Percentiles)
+  {
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.getValueAtPercentile(50), 0u);
+
+    for (std::uint64_t value = 1; value <= 100'000; value++) {
+      histogram.record(value);
+    }
+
+    EXPECT_EQ(histogram.getCount(), 100'000u);
+    EXPECT_EQ(histogram.getMax(), 100'000u);
+    EXPECT_DOUBLE_EQ(histogram.getMean(), 50'000.5);
+
+    EXPECT_NEAR(histogram.getValueAtPercentile(50), 50'000, 50'000 * 2.0 / LatencyHistogram::c_subBuckets);
+    EXPECT_NEAR(histogram.getValueAtPercentile(99), 99'000, 99'000 * 2.0 / LatencyHistogram::c_subBuckets);
+    EXPECT_EQ(histogram.getValueAtPercentile(100), 100'000u);
+    EXPECT_EQ(histogram.getValueAtPercentile(0), 1u);
+  }
+
+  /** Huge values end up in the last bucket, reset removes everything */
+  TEST(LatencyHistogramTest, OverflowAndReset)
+  {
+    LatencyHistogram histogram;
+    histogram.record(std::uint64_t(1) << 50);
+    histogram.record(3);
+    EXPECT_EQ(histogram.getValueAtPercentile(100), std::uint64_t(1) << 50);
+
+    histogram.reset();
+    EXPECT_EQ(histogram.getCount(), 0u);
+    EXPECT_EQ(histogram.getMax(), 0u);
+    EXPECT_EQ(histogram.getValueAtPercentile(99), 0u);
+  }
+}
@@ -0,0 +1,69 @@
+#!/usr/bin/env python3
+
+##########################################################################
+# basf2 (Belle II Analysis Software Framework)                           #
+# Author: The Belle II Collaboration                                     #
+#                                                                        #
+# See git log for contributors and copyright holders.                    #
+# This file is licensed under LGPL-3.0, see LICENSE.md.                  #
+##########################################################################
+
+# Test that SeqRootOutput can write an event index and that SeqRootInput can use it
+# to start at a given event and to split a file between several readers
+
+import os
+import multiprocessing
+import basf2
+from ROOT import Belle2
+from b2test_utils import clean_working_directory
+
+basf2.conditions.disable_globaltag_replay()
+
+
+class EventNumbers(basf2.Module):
+    """Collect the event numbers of all processed events"""
+
+    def __init__(self, numbers):
+        """Remember the list to fill"""
+        super().__init__()
+        #: list of event numbers
+        self.numbers = numbers
+
+    def event(self):
+        """Add the number of the current event"""
+        self.numbers.append(Belle2.PyStoreObj("EventMetaData").obj().getEvent())
+
+
+def read(**parameters):
+    """Read the test file with the given SeqRootInput parameters and return the event numbers"""
+    numbers = []
+    path = basf2.create_path()
+    path.add_module("SeqRootInput", inputFileName="index_test.sroot", **parameters)
+    path.add_module(EventNumbers(numbers))
+    basf2.process(path)
+    return numbers
+
+
+with clean_working_directory():
+    main = basf2.create_path()
+    main.add_module("EventInfoSetter", evtNumList=[10])
+    main.add_module("SeqRootOutput", outputFileName="index_test.sroot", writeIndex=True)
+    # Run in sub process to avoid side effects
+    sub = multiprocessing.Process(target=basf2.process, args=(main,))
+    sub.start()
+    sub.join()
+
+    assert os.path.exists("index_test.sroot.idx")
+
+    assert read() == list(range(1, 11))
+    assert read(firstEvent=7) == [8, 9, 10]
+    first = read(numberOfReaders=2, readerIndex=0)
+    second = read(numberOfReaders=2, readerIndex=1)
+    assert first == [1, 2, 3, 4, 5]
+    assert second == [6, 7, 8, 9, 10]
+
+    # more readers than events: the readers without events just end
+    readers = [read(numberOfReaders=12, readerIndex=i) for i in range(12)]
+    assert sum(readers, []) == list(range(1, 11))
+    assert readers[0] == [] and readers[11] == [10]
+    assert read(firstEvent=10) == []
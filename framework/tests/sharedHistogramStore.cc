@@ -0,0 +1,276 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#include <framework/pcore/SharedHistogramStore.h>
+
+#include <TH1.h>
+#include <TDirectory.h>
+
+#include <gtest/gtest.h>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace Belle2;
+
+namespace {
+  /** Test fixture creating and destroying the shared histogram store */
+  class SharedHistogramStoreTest : public ::testing::Test {
+  protected:
+    /** Create a small store */
+    void SetUp() override
+    {
+      SharedHistogramStore::Instance().create(1024 * 1024, 16);
+    }
+
+    /** Unmap the store again */
+    void TearDown() override
+    {
+      SharedHistogramStore::Instance().destroy();
+    }
+  };
+
+  /** Registering the same name twice gives the same bins */
+  TEST_F(SharedHistogramStoreTest, Registration)
+  {
+    auto& store = SharedHistogramStore::Instance();
+    auto first = store.registerHistogram("folder/h1", "title", 10, 0, 10);
+    auto second = store.registerHistogram("folder/h1", "title", 10, 0, 10);
+    auto other = store.registerHistogram("folder/h2", "title", 5, 0, 5, 5, 0, 5);
+    EXPECT_TRUE(first.isValid());
+    EXPECT_TRUE(other.isValid());
+    EXPECT_EQ(store.getNumberOfHistograms(), 2u);
+
+    first.fill(2.5);
+    second.fill(2.5, 2.0);
+    EXPECT_DOUBLE_EQ(first.getBinContent(3), 3.0);
+    EXPECT_EQ(second.getEntries(), 2u);
+
+    // A different binning for the same name is refused
+    auto wrong = store.registerHistogram("folder/h1", "title", 20, 0, 10);
+    EXPECT_FALSE(wrong.isValid());
+  }
+
+  /** Under- and overflow handling and the 2D bin numbering are the same as in ROOT */
+  TEST_F(SharedHistogramStoreTest, Snapshot)
+  {
+    auto& store = SharedHistogramStore::Instance();
+    auto h1 = store.registerHistogram("h1", "title", 10, 0, 10);
+    auto h2 = store.registerHistogram("h2", "title", 4, 0, 4, 3, 0, 3);
+
+    h1.fill(-1);
+    h1.fill(5.5, 0.5);
+    h1.fill(10);
+    h2.fill(1.5, 2.5, 3.0);
+
+    ASSERT_TRUE(store.acquireExportLease());
+    const auto& histograms = store.snapshot();
+    ASSERT_EQ(histograms.size(), 2u);
+
+    EXPECT_DOUBLE_EQ(histograms[0]->GetBinContent(0), 1.0);
+    EXPECT_DOUBLE_EQ(histograms[0]->GetBinContent(6), 0.5);
+    EXPECT_DOUBLE_EQ(histograms[0]->GetBinContent(11), 1.0);
+    EXPECT_DOUBLE_EQ(histograms[0]->GetBinError(6), 0.5);
+    EXPECT_DOUBLE_EQ(histograms[0]->GetEntries(), 3);
+
+    EXPECT_DOUBLE_EQ(histograms[1]->GetBinContent(2, 3), 3.0);
+    EXPECT_DOUBLE_EQ(histograms[1]->GetSumOfWeights(), 3.0);
+    store.releaseExportLease();
+  }
+
+  /** Filling from several threads at the same time does not lose any entries */
+  TEST_F(SharedHistogramStoreTest, ConcurrentThreads)
+  {
+    auto histogram = SharedHistogramStore::Instance().registerHistogram("h", "title", 4, 0, 4);
+
+    const int nThreads = 8;
+    const int nFills = 10000;
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < nThreads; thread++) {
+      threads.emplace_back([&histogram, thread]() {
+        for (int fill = 0; fill < nFills; fill++) {
+          histogram.fill(thread % 4 + 0.5);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    for (int bin = 1; bin <= 4; bin++) {
+      EXPECT_DOUBLE_EQ(histogram.getBinContent(bin), 2 * nFills);
+    }
+    EXPECT_EQ(histogram.getEntries(), static_cast<std::uint64_t>(nThreads * nFills));
+  }
+
+  /** Forked processes fill the same bins and see each other's histograms */
+  TEST_F(SharedHistogramStoreTest, ConcurrentProcesses)
+  {
+    auto& store = SharedHistogramStore::Instance();
+    const int nProcesses = 4;
+    const int nFills = 1000;
+
+    std::vector<pid_t> children;
+    for (int process = 0; process < nProcesses; process++) {
+      pid_t pid = fork();
+      ASSERT_GE(pid, 0);
+      if (pid == 0) {
+        // Every child registers the histogram itself as done in defineHisto
+        auto histogram = store.registerHistogram("h", "title", 2, 0, 2);
+        for (int fill = 0; fill < nFills; fill++) {
+          histogram.fill(0.5);
+        }
+        _exit(0);
+      }
+      children.push_back(pid);
+    }
+    for (pid_t child : children) {
+      int status = 0;
+      waitpid(child, &status, 0);
+      EXPECT_EQ(WEXITSTATUS(status), 0);
+    }
+
+    EXPECT_EQ(store.getNumberOfHistograms(), 1u);
+    auto histogram = store.registerHistogram("h", "title", 2, 0, 2);
+    EXPECT_DOUBLE_EQ(histogram.getBinContent(1), nProcesses * nFills);
+  }
+
+  /** A new run resets the bins exactly once */
+  TEST_F(SharedHistogramStoreTest, BeginRun)
+  {
+    auto& store = SharedHistogramStore::Instance();
+    auto histogram = store.registerHistogram("h", "title", 2, 0, 2);
+
+    store.beginRun(1, 1);
+    histogram.fill(0.5);
+    // Another process announcing the same run must not remove the entry
+    store.beginRun(1, 1);
+    EXPECT_DOUBLE_EQ(histogram.getBinContent(1), 1.0);
+
+    store.beginRun(1, 2);
+    EXPECT_DOUBLE_EQ(histogram.getBinContent(1), 0.0);
+    EXPECT_EQ(histogram.getEntries(), 0u);
+  }
+
+  /** The bins are only reset for a new run after all processes are done with the previous one */
+  TEST_F(SharedHistogramStoreTest, RunBoundary)
+  {
+    auto& store = SharedHistogramStore::Instance();
+    store.setNumberOfProcesses(2, 60);
+    auto histogram = store.registerHistogram("h", "title", 2, 0, 2);
+
+    store.beginRun(1, 1);
+    histogram.fill(0.5);
+
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+      // Waits for the parent to finish run 1
+      store.beginRun(1, 2);
+      const bool reset = histogram.getBinContent(1) == 0;
+      histogram.fill(0.5);
+      _exit(reset ? 0 : 1);
+    }
+
+    // The child has started the new run, but we are still filling the old one
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    histogram.fill(0.5);
+    EXPECT_DOUBLE_EQ(histogram.getBinContent(1), 2.0);
+
+    store.endRun(1, 1);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+
+    // The child already reset the bins for run 2 and filled them
+    store.beginRun(1, 2);
+    EXPECT_DOUBLE_EQ(histogram.getBinContent(1), 1.0);
+  }
+
+  /** A process which never reaches the run boundary (e.g. a dead worker) only delays the reset */
+  TEST_F(SharedHistogramStoreTest, RunBoundaryTimeout)
+  {
+    auto& store = SharedHistogramStore::Instance();
+    store.setNumberOfProcesses(2, 0.05);
+    auto histogram = store.registerHistogram("h", "title", 2, 0, 2);
+
+    store.beginRun(1, 1);
+    histogram.fill(0.5);
+    store.beginRun(1, 2);
+    EXPECT_DOUBLE_EQ(histogram.getBinContent(1), 0.0);
+  }
+
+  /** Histograms of a HistoModule are registered in the store if it exists, and created in the current directory otherwise */
+  TEST_F(SharedHistogramStoreTest, SharedOrLocalHistogram)
+  {
+    auto& store = SharedHistogramStore::Instance();
+    SharedOrLocalHistogram shared("shared", "title;x", 10, 0, 10);
+    shared.fill(2.5);
+    EXPECT_EQ(store.getNumberOfHistograms(), 1u);
+    EXPECT_DOUBLE_EQ(store.registerHistogram("shared", "title;x", 10, 0, 10).getBinContent(3), 1.0);
+    EXPECT_EQ(gDirectory->Get("shared"), nullptr);
+
+    store.destroy();
+    SharedOrLocalHistogram local("local", "title;x", 10, 0, 10);
+    local.fill(2.5);
+    auto* histogram = dynamic_cast<TH1*>(gDirectory->Get("local"));
+    ASSERT_NE(histogram, nullptr);
+    EXPECT_DOUBLE_EQ(histogram->GetBinContent(3), 1.0);
+    EXPECT_STREQ(histogram->GetXaxis()->GetTitle(), "x");
+    delete histogram;
+  }
+
+  /** The export lease is held by one living process only and is freed when it dies */
+  TEST_F(SharedHistogramStoreTest, ExportLease)
+  {
+    auto& store = SharedHistogramStore::Instance();
+    EXPECT_NE(store.getStoreID(), 0u);
+
+    int toParent[2], toChild[2];
+    ASSERT_EQ(pipe(toParent), 0);
+    ASSERT_EQ(pipe(toChild), 0);
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+      // Take the lease, tell the parent and keep it until the parent allows us to die
+      char answer = store.acquireExportLease() ? 1 : 0;
+      if (write(toParent[1], &answer, 1) != 1) _exit(1);
+      if (read(toChild[0], &answer, 1) != 1) _exit(1);
+      _exit(0);
+    }
+
+    char answer = 0;
+    ASSERT_EQ(read(toParent[0], &answer, 1), 1);
+    EXPECT_EQ(answer, 1);
+    EXPECT_FALSE(store.acquireExportLease());
+
+    // The child dies without releasing the lease
+    ASSERT_EQ(write(toChild[1], &answer, 1), 1);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+    EXPECT_TRUE(store.acquireExportLease());
+    EXPECT_TRUE(store.acquireExportLease());
+
+    // A child forked while we hold the lease does not inherit it
+    pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+      _exit(store.acquireExportLease() ? 1 : 0);
+    }
+    waitpid(pid, &status, 0);
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+    store.releaseExportLease();
+
+    for (int fd : {toParent[0], toParent[1], toChild[0], toChild[1]}) close(fd);
+  }
+}
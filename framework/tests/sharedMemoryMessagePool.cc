@@ -0,0 +1,190 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#include <framework/pcore/zmq/utils/SharedMemoryMessagePool.h>
+
+#include <gtest/gtest.h>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace Belle2;
+
+namespace {
+  /// Unique segment name for this test process
+  std::string getTestPoolName()
+  {
+    return "/basf2_test_pool_" + std::to_string(getpid());
+  }
+
+  /** Only ipc addresses get a pool name, which is the same for the same address */
+  TEST(SharedMemoryMessagePoolTest, PoolName)
+  {
+    EXPECT_EQ(SharedMemoryMessagePool::getPoolName("tcp://localhost:1234"), "");
+    EXPECT_NE(SharedMemoryMessagePool::getPoolName("ipc:///tmp/a"), "");
+    EXPECT_EQ(SharedMemoryMessagePool::getPoolName("ipc:///tmp/a"), SharedMemoryMessagePool::getPoolName("ipc:///tmp/a"));
+    EXPECT_NE(SharedMemoryMessagePool::getPoolName("ipc:///tmp/a"), SharedMemoryMessagePool::getPoolName("ipc:///tmp/b"));
+  }
+
+  /** All slots can be allocated exactly once and are reusable after releasing */
+  TEST(SharedMemoryMessagePoolTest, AllocateAndRelease)
+  {
+    auto pool = SharedMemoryMessagePool::create(getTestPoolName(), 8, 100);
+    EXPECT_EQ(pool->getNumberOfSlots(), 8u);
+    EXPECT_GE(pool->getSlotSize(), 100u);
+    EXPECT_EQ(pool->getNumberOfFreeSlots(), 8u);
+
+    std::set<std::uint32_t> slots;
+    for (int i = 0; i < 8; i++) {
+      auto slot = pool->allocate();
+      ASSERT_TRUE(slot);
+      slots.insert(*slot);
+    }
+    EXPECT_EQ(slots.size(), 8u);
+    EXPECT_FALSE(pool->allocate());
+
+    pool->release(3);
+    auto slot = pool->allocate();
+    ASSERT_TRUE(slot);
+    EXPECT_EQ(*slot, 3u);
+  }
+
+  /** Data written by one process is visible in another attached one */
+  TEST(SharedMemoryMessagePoolTest, Attach)
+  {
+    // The child has another PID, so fix the name before forking
+    const std::string name = getTestPoolName();
+    EXPECT_FALSE(SharedMemoryMessagePool::attach(name));
+
+    auto pool = SharedMemoryMessagePool::create(name, 4, 64);
+    auto slot = pool->allocate();
+    ASSERT_TRUE(slot);
+    std::strcpy(pool->getSlot(*slot), "event");
+
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+      auto attachedPool = SharedMemoryMessagePool::attach(name);
+      const bool correct = attachedPool and std::strcmp(attachedPool->getSlot(*slot), "event") == 0;
+      if (attachedPool) {
+        attachedPool->release(*slot);
+      }
+      _exit(correct ? 0 : 1);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+    EXPECT_EQ(pool->getNumberOfFreeSlots(), 4u);
+
+    // The name is gone after the creator is done
+    pool.reset();
+    EXPECT_FALSE(SharedMemoryMessagePool::attach(name));
+  }
+
+  /** Many processes allocating and releasing at the same time never get the same slot */
+  TEST(SharedMemoryMessagePoolTest, ConcurrentProcesses)
+  {
+    auto pool = SharedMemoryMessagePool::create(getTestPoolName(), 16, 64);
+    const int nProcesses = 4;
+    const int nIterations = 20000;
+
+    std::vector<pid_t> children;
+    for (int process = 0; process < nProcesses; process++) {
+      pid_t pid = fork();
+      ASSERT_GE(pid, 0);
+      if (pid == 0) {
+        bool correct = true;
+        for (int iteration = 0; iteration < nIterations; iteration++) {
+          auto slot = pool->allocate();
+          if (not slot) {
+            continue;
+          }
+          // Nobody else may write into our slot while we hold it
+          auto* data = reinterpret_cast<volatile int*>(pool->getSlot(*slot));
+          *data = process;
+          for (int check = 0; check < 10; check++) {
+            correct = correct and *data == process;
+          }
+          pool->release(*slot);
+        }
+        _exit(correct ? 0 : 1);
+      }
+      children.push_back(pid);
+    }
+    for (pid_t child : children) {
+      int status = 0;
+      waitpid(child, &status, 0);
+      EXPECT_EQ(WEXITSTATUS(status), 0);
+    }
+    EXPECT_EQ(pool->getNumberOfFreeSlots(), 16u);
+  }
+
+  /** A new pool under the same name (restarted collector) retires the old one, attached processes can switch to the new one */
+  TEST(SharedMemoryMessagePoolTest, RestartedCreator)
+  {
+    const std::string name = getTestPoolName();
+
+    auto collectorPool = SharedMemoryMessagePool::create(name, 4, 64);
+    auto senderPool = SharedMemoryMessagePool::attach(name);
+    ASSERT_TRUE(senderPool);
+    EXPECT_FALSE(senderPool->isRetired());
+    const auto oldIdentifier = senderPool->getIdentifier();
+
+    // Clean restart: the old collector is gone before the new one comes up
+    collectorPool.reset();
+    EXPECT_TRUE(senderPool->isRetired());
+    collectorPool = SharedMemoryMessagePool::create(name, 4, 64);
+    EXPECT_FALSE(collectorPool->isRetired());
+
+    senderPool = SharedMemoryMessagePool::attach(name);
+    ASSERT_TRUE(senderPool);
+    EXPECT_FALSE(senderPool->isRetired());
+    EXPECT_NE(senderPool->getIdentifier(), oldIdentifier);
+    EXPECT_EQ(senderPool->getIdentifier(), collectorPool->getIdentifier());
+    collectorPool.reset();
+  }
+
+  /** A collector which crashed can not retire its pool, this is done by its successor */
+  TEST(SharedMemoryMessagePoolTest, CrashedCreator)
+  {
+    const std::string name = getTestPoolName();
+
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+      auto pool = SharedMemoryMessagePool::create(name, 4, 64);
+      // No destructor call, as in a crash
+      _exit(pool ? 0 : 1);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+
+    auto senderPool = SharedMemoryMessagePool::attach(name);
+    ASSERT_TRUE(senderPool);
+    EXPECT_FALSE(senderPool->isRetired());
+    auto slot = senderPool->allocate();
+    ASSERT_TRUE(slot);
+
+    auto collectorPool = SharedMemoryMessagePool::create(name, 4, 64);
+    EXPECT_TRUE(senderPool->isRetired());
+    EXPECT_EQ(collectorPool->getNumberOfFreeSlots(), 4u);
+    // Slots of the old pool can still be released without harm
+    senderPool->release(*slot);
+
+    auto newSenderPool = SharedMemoryMessagePool::attach(name);
+    ASSERT_TRUE(newSenderPool);
+    EXPECT_EQ(newSenderPool->getIdentifier(), collectorPool->getIdentifier());
+    EXPECT_NE(newSenderPool->getIdentifier(), senderPool->getIdentifier());
+  }
+}
@@ -0,0 +1,165 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+/*
+ * Measure the throughput of the load-balanced ZMQ connection between a local distributor and
+ * local workers, once with all event data sent over the (ipc) socket and once with the
+ * event data passed via shared memory (see SharedMemoryMessagePool).
+ * The results are written as CSV to stdout (one line per transport and try).
+ */
+
+#include <framework/pcore/zmq/connections/ZMQLoadBalancedConnection.h>
+#include <framework/pcore/zmq/messages/ZMQMessageFactory.h>
+#include <framework/pcore/zmq/utils/ZMQAddressUtils.h>
+#include <framework/pcore/zmq/utils/ZMQParent.h>
+#include <framework/logging/Logger.h>
+
+#include <boost/program_options.hpp>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Belle2;
+namespace po = boost::program_options;
+
+namespace {
+  /// Worker process: receive events (touching every page of the data) until a terminate message comes in
+  void runWorker(const std::string& address, unsigned int bufferSize)
+  {
+    auto parent = std::make_shared<ZMQParent>();
+    ZMQLoadBalancedInput input(address, bufferSize, parent);
+
+    bool terminate = false;
+    while (not terminate) {
+      ZMQConnection::poll({{&input, [&]() {
+          auto message = input.handleIncomingData();
+          if (message->isMessage(EMessageTypes::c_terminateMessage)) {
+            terminate = true;
+            return;
+          }
+          // Make sure the data is really read, as the deserialization would do
+          const auto& data = message->getDataMessage();
+          volatile char sum = 0;
+          for (size_t i = 0; i < data.size(); i += 4096) {
+            sum += static_cast<const char*>(data.data())[i];
+          }
+        }
+      }
+      }, -1);
+    }
+  }
+
+  /// Distributor process: send the events to the workers and return the time until all workers are done
+  double runBenchmark(bool sharedMemory, unsigned int numberOfEvents, unsigned int eventSize, unsigned int numberOfWorkers,
+                      unsigned int bufferSize, unsigned int numberOfSlots)
+  {
+    const std::string address = ZMQAddressUtils::randomSocketName();
+
+    std::vector<pid_t> workers;
+    for (unsigned int worker = 0; worker < numberOfWorkers; worker++) {
+      pid_t pid = fork();
+      if (pid < 0) {
+        B2FATAL("Could not fork a worker");
+      } else if (pid == 0) {
+        runWorker(address, bufferSize);
+        _exit(0);
+      }
+      workers.push_back(pid);
+    }
+
+    auto parent = std::make_shared<ZMQParent>();
+    ZMQLoadBalancedOutput output(address, false, parent);
+    if (sharedMemory) {
+      output.createSharedMemoryPool(address, numberOfSlots, eventSize);
+    }
+
+    const std::string eventData(eventSize, 'x');
+    // Every worker sends bufferSize ready messages on startup and one for each received event
+    unsigned int receivedReadyMessages = 0;
+    const auto pollOutput = [&output, &receivedReadyMessages]() {
+      ZMQConnection::poll({{&output, [&output, &receivedReadyMessages]() {
+          output.handleIncomingData();
+          receivedReadyMessages++;
+        }
+      }
+      }, -1);
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned int event = 0; event < numberOfEvents; event++) {
+      while (not output.isReady()) {
+        pollOutput();
+      }
+      output.handleEvent(ZMQMessageFactory::createMessage(EMessageTypes::c_rawDataMessage, eventData));
+    }
+    // Wait until all events are received and every worker is registered before sending the terminate messages
+    while (receivedReadyMessages < numberOfWorkers * bufferSize + numberOfEvents) {
+      pollOutput();
+    }
+    output.handleEvent(ZMQMessageFactory::createMessage(EMessageTypes::c_terminateMessage));
+
+    for (pid_t worker : workers) {
+      int status = 0;
+      waitpid(worker, &status, 0);
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double>(end - start).count();
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  unsigned int numberOfEvents = 10000;
+  unsigned int eventSize = 300'000;
+  unsigned int numberOfWorkers = 4;
+  unsigned int bufferSize = 2;
+  unsigned int numberOfSlots = 64;
+  unsigned int tries = 3;
+
+  po::options_description options("Options");
+  options.add_options()
+  ("help,h", "print all available options")
+  ("events", po::value<unsigned int>(&numberOfEvents)->default_value(numberOfEvents), "number of events to send")
+  ("size", po::value<unsigned int>(&eventSize)->default_value(eventSize), "size of a single event in bytes")
+  ("workers", po::value<unsigned int>(&numberOfWorkers)->default_value(numberOfWorkers), "number of worker processes")
+  ("bufferSize", po::value<unsigned int>(&bufferSize)->default_value(bufferSize), "number of events in flight per worker")
+  ("slots", po::value<unsigned int>(&numberOfSlots)->default_value(numberOfSlots),
+   "number of shared memory slots (power of two)")
+  ("tries", po::value<unsigned int>(&tries)->default_value(tries), "how often to repeat each measurement");
+
+  po::variables_map variables;
+  try {
+    po::store(po::parse_command_line(argc, argv, options), variables);
+    po::notify(variables);
+  } catch (po::error& error) {
+    std::cerr << "ERROR: " << error.what() << std::endl << std::endl << options << std::endl;
+    return 1;
+  }
+  if (variables.count("help")) {
+    std::cout << "Usage: " << argv[0] << " [options]" << std::endl << options << std::endl;
+    return 0;
+  }
+
+  std::cout << "transport,n_events,event_size,workers,buffer_size,try,total_time,events_per_second,megabytes_per_second" << std::endl;
+  for (unsigned int currentTry = 0; currentTry < tries; currentTry++) {
+    for (bool sharedMemory : {false, true}) {
+      const double totalTime = runBenchmark(sharedMemory, numberOfEvents, eventSize, numberOfWorkers, bufferSize, numberOfSlots);
+      std::cout << (sharedMemory ? "shared_memory" : "zmq") << "," << numberOfEvents << "," << eventSize << ","
+                << numberOfWorkers << "," << bufferSize << "," << currentTry << "," << totalTime << ","
+                << numberOfEvents / totalTime << "," << numberOfEvents * double(eventSize) / totalTime / 1e6 << std::endl;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,110 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Belle2 {
+
+  /**
+   * Runs independent jobs of a module in several threads.
+   *
+   * The jobs are numbered and each job is done exactly once by one of the threads;
+   * the calling thread does its share of the jobs as well.
+   * Results must be stored per job number, then they do not depend on the number of threads.
+   * The worker threads are started at the first call of run(), to be compatible with the
+   * forking of multiprocessing.
+   *
+   * Jobs must not use the DataStore. Each thread has a fixed index (0 for the calling thread),
+   * which can be used to give every thread its own scratch objects:
+   *
+   *   ParallelJobs jobs(4);
+   *   std::vector<Fitter> fitters(jobs.getNumThreads());
+   *   jobs.run(tracks.size(), [&](size_t job, unsigned thread) { fitters[thread].fit(tracks[job]); });
+   */
+  class ParallelJobs {
+
+  public:
+
+    /**
+     * Constructor
+     * @param numThreads number of threads including the calling thread
+     */
+    explicit ParallelJobs(unsigned numThreads);
+
+    /**
+     * Destructor: stops the worker threads
+     */
+    ~ParallelJobs();
+
+    /** No copies of the threads */
+    ParallelJobs(const ParallelJobs&) = delete;
+
+    /** No copies of the threads */
+    ParallelJobs& operator=(const ParallelJobs&) = delete;
+
+    /**
+     * Returns number of threads including the calling thread
+     * @return number of threads
+     */
+    unsigned getNumThreads() const {return m_numThreads;}
+
+    /**
+     * Runs the jobs and returns when all of them are done.
+     * If a job throws, the jobs not yet started are skipped and the first exception
+     * is rethrown here, in the calling thread.
+     * @param numJobs number of jobs
+     * @param job function doing the job of a given number (0-based) in the thread with the given index
+     */
+    void run(size_t numJobs, const std::function<void(size_t, unsigned)>& job);
+
+    /**
+     * Same as above for jobs which do not need the index of the thread
+     * @param numJobs number of jobs
+     * @param job function doing the job of a given number (0-based)
+     */
+    void run(size_t numJobs, const std::function<void(size_t)>& job)
+    {
+      run(numJobs, [&job](size_t i, unsigned) { job(i); });
+    }
+
+  private:
+
+    /**
+     * Loop of a worker thread: waits for jobs and does them
+     * @param thread index of the thread
+     */
+    void work(unsigned thread);
+
+    /**
+     * Does the jobs until none is left; an exception is stored for run()
+     * @param thread index of the thread
+     */
+    void doJobs(unsigned thread);
+
+    unsigned m_numThreads = 1; /**< number of threads including the calling thread */
+    std::vector<std::thread> m_threads; /**< worker threads */
+    std::mutex m_mutex; /**< protects the state shared with the worker threads */
+    std::condition_variable m_startCondition; /**< signals the worker threads that there are new jobs */
+    std::condition_variable m_doneCondition; /**< signals the calling thread that a worker thread is done */
+    unsigned long m_generation = 0; /**< incremented for every new set of jobs */
+    unsigned m_busyThreads = 0; /**< number of worker threads not yet done with the current jobs */
+    bool m_stop = false; /**< set to stop the worker threads */
+    size_t m_numJobs = 0; /**< number of current jobs */
+    const std::function<void(size_t, unsigned)>* m_job = nullptr; /**< current job function */
+    std::atomic<size_t> m_nextJob{0}; /**< number of the next job */
+    std::exception_ptr m_exception; /**< first exception thrown by a job of the current set */
+  };
+
+} // namespace Belle2
@@ -0,0 +1,95 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#include <framework/utilities/ParallelJobs.h>
+#include <framework/logging/LogSystem.h>
+
+#include <algorithm>
+#include <utility>
+
+using namespace Belle2;
+
+ParallelJobs::ParallelJobs(unsigned numThreads):
+  m_numThreads(std::max(numThreads, 1u))
+{}
+
+ParallelJobs::~ParallelJobs()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_startCondition.notify_all();
+  for (auto& thread : m_threads) thread.join();
+}
+
+void ParallelJobs::run(size_t numJobs, const std::function<void(size_t, unsigned)>& job)
+{
+  if (numJobs == 0) return;
+
+  if (m_numThreads == 1 or numJobs == 1) {
+    for (size_t i = 0; i < numJobs; i++) job(i, 0);
+    return;
+  }
+
+  if (m_threads.empty()) {
+    for (unsigned i = 1; i < m_numThreads; i++) m_threads.emplace_back(&ParallelJobs::work, this, i);
+  }
+
+  // the jobs of the worker threads may send log messages
+  LogSystem::Instance().beginThreadedSection();
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_numJobs = numJobs;
+    m_job = &job;
+    m_nextJob = 0;
+    m_busyThreads = m_threads.size();
+    m_generation++;
+  }
+  m_startCondition.notify_all();
+  doJobs(0);
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_doneCondition.wait(lock, [this]() { return m_busyThreads == 0; });
+  m_job = nullptr;
+  LogSystem::Instance().endThreadedSection();
+  if (m_exception) std::rethrow_exception(std::exchange(m_exception, nullptr));
+}
+
+void ParallelJobs::doJobs(unsigned thread)
+{
+  try {
+    for (size_t i = m_nextJob++; i < m_numJobs; i = m_nextJob++) (*m_job)(i, thread);
+  } catch (...) {
+    // an exception must not leave a worker thread; skip the remaining jobs instead
+    m_nextJob = m_numJobs;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (not m_exception) m_exception = std::current_exception();
+  }
+}
+
+void ParallelJobs::work(unsigned thread)
+{
+  unsigned long generation = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_startCondition.wait(lock, [this, generation]() { return m_stop or m_generation != generation; });
+      if (m_stop) break;
+      generation = m_generation;
+    }
+
+    doJobs(thread);
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_busyThreads--;
+    }
+    m_doneCondition.notify_one();
+  }
+}
@@ -0,0 +1,75 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#include <framework/utilities/ParallelJobs.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+namespace Belle2 {
+
+  /** Every job is done exactly once, also for repeated calls and any number of threads */
+  TEST(ParallelJobsTest, AllJobsDoneOnce)
+  {
+    for (unsigned numThreads : {1u, 2u, 4u, 8u}) {
+      ParallelJobs jobs(numThreads);
+      EXPECT_EQ(jobs.getNumThreads(), numThreads);
+      for (size_t numJobs : {0u, 1u, 3u, 1000u}) {
+        vector<atomic<int>> calls(numJobs);
+        for (auto& count : calls) count = 0;
+        vector<size_t> results(numJobs, 0);
+        jobs.run(numJobs, [&](size_t i) {
+          calls[i]++;
+          results[i] = i * i;
+        });
+        for (size_t i = 0; i < numJobs; i++) {
+          EXPECT_EQ(calls[i], 1) << "job " << i << " with " << numThreads << " threads";
+          EXPECT_EQ(results[i], i * i);
+        }
+      }
+    }
+  }
+
+  /** Every thread has a fixed index below the number of threads, so it can use its own scratch objects */
+  TEST(ParallelJobsTest, ThreadIndex)
+  {
+    for (unsigned numThreads : {1u, 3u}) {
+      ParallelJobs jobs(numThreads);
+      vector<vector<size_t>> jobsPerThread(numThreads);
+      for (int repetition = 0; repetition < 3; repetition++) {
+        jobs.run(500, [&](size_t i, unsigned thread) {
+          ASSERT_LT(thread, numThreads);
+          jobsPerThread[thread].push_back(i);
+        });
+      }
+      size_t numDone = 0;
+      for (const auto& done : jobsPerThread) numDone += done.size();
+      EXPECT_EQ(numDone, 1500u);
+    }
+  }
+
+  /** An exception of a job is rethrown in the calling thread and the jobs can be run again afterwards */
+  TEST(ParallelJobsTest, Exception)
+  {
+    for (unsigned numThreads : {1u, 4u}) {
+      ParallelJobs jobs(numThreads);
+      EXPECT_THROW(jobs.run(100, [](size_t i) {
+        if (i == 37) throw runtime_error("job failed");
+      }), runtime_error);
+
+      atomic<size_t> numDone{0};
+      EXPECT_NO_THROW(jobs.run(100, [&numDone](size_t) { numDone++; }));
+      EXPECT_EQ(numDone, 100u);
+    }
+  }
+} // namespace Belle2
@@ -108,6 +108,7 @@ class FieldManager {
 
 #ifdef CACHE
   //! Cache last lookup positions, and use stored field values if a lookup at (almost) the same position is done.
+  //! Every thread has its own cache.
   void useCache(bool opt = true, unsigned int nBuckets = 8);
 #else
   void useCache(bool opt = true, unsigned int nBuckets = 8) {
@@ -127,18 +128,14 @@ class FieldManager {
  private:
 
   FieldManager() {}
-#ifdef CACHE
-  ~FieldManager() { delete cache_; }
-#else
   ~FieldManager() { }
-#endif
   static FieldManager* instance_;
   static AbsBField* field_;
 
 #ifdef CACHE
   static bool useCache_;
   static unsigned int n_buckets_;
-  static fieldCache* cache_;
+  // the cache itself is kept per thread in FieldManager.cc, so that several threads can use the field at the same time
 #endif
 
 };
@@ -24,18 +24,26 @@
  */
 
 #include <ostream>
+#include <streambuf>
 
 namespace genfit {
 
 /** Default stream for debug output.  Defaults to std::cout.
-   Override destination with debugOut.rdbuf(newStream.rdbuf()).  */
-extern std::ostream debugOut;
+   Every thread has its own stream, so that fits in several threads can write at the same time.
+   Override destination with setStreamBuffers() for all threads or with
+   debugOut.rdbuf(newStream.rdbuf()) for the calling thread only.  */
+extern thread_local std::ostream debugOut;
 /** Default stream for error output.  Defaults to std::cerr.
-    Override destination with errorOut.rdbuf(newStream.rdbuf()).  */
-extern std::ostream errorOut;
+    Every thread has its own stream, override destination as for debugOut.  */
+extern thread_local std::ostream errorOut;
 /** Default stream for output of Print calls.  Defaults to std::cout.
-   Override destination with printOut.rdbuf(newStream.rdbuf()).  */
-extern std::ostream printOut;
+   Every thread has its own stream, override destination as for debugOut.  */
+extern thread_local std::ostream printOut;
+
+/** Set the destinations of debugOut, errorOut and printOut of the calling thread
+    and of all threads using them for the first time afterwards.
+    The buffers are shared by these threads, so they must allow writing from several threads at once.  */
+void setStreamBuffers(std::streambuf* debug, std::streambuf* error, std::streambuf* print);
 
 }
 
@@ -20,6 +20,8 @@
 #include "IO.h"
 
 #include <math.h>
+#include <atomic>
+#include <vector>
 
 namespace genfit {
 
@@ -29,7 +31,19 @@ AbsBField* FieldManager::field_ = nullptr;
 #ifdef CACHE
 bool FieldManager::useCache_ = false;
 unsigned int FieldManager::n_buckets_ = 8;
-fieldCache* FieldManager::cache_ = nullptr;
+
+namespace {
+  //! Field cache of one thread
+  struct ThreadFieldCache {
+    std::vector<fieldCache> buckets;
+    int last_read_i = 0;
+    int last_written_i = 0;
+    unsigned int generation = 0;
+  };
+  thread_local ThreadFieldCache threadCache;
+  //! Incremented by useCache(), so that the caches of all threads are reinitialized
+  std::atomic<unsigned int> cacheGeneration(1);
+}
 #endif
 
 //#define DEBUG
@@ -41,8 +55,19 @@ void FieldManager::getFieldVal(const double& posX, const double& posY, const dou
   if (useCache_) {
 
     // cache code copied from http://en.wikibooks.org/wiki/Optimizing_C%2B%2B/General_optimization_techniques/Memoization
-    static int last_read_i = 0;
-    static int last_written_i = 0;
+    if (threadCache.generation != cacheGeneration) {
+      threadCache.generation = cacheGeneration;
+      threadCache.buckets.resize(n_buckets_);
+      for (fieldCache& bucket : threadCache.buckets) {
+        // Should be safe to initialize with values in Andromeda
+        bucket.posX = bucket.posY = bucket.posZ = 2.4e24 / sqrt(3);
+        bucket.Bx = bucket.By = bucket.Bz = 1e30;
+      }
+      threadCache.last_read_i = threadCache.last_written_i = 0;
+    }
+    fieldCache* cache_ = threadCache.buckets.data();
+    int& last_read_i = threadCache.last_read_i;
+    int& last_written_i = threadCache.last_written_i;
     int i = last_read_i;
 
     static const double epsilon = 0.001;
@@ -95,15 +120,8 @@ void FieldManager::getFieldVal(const double& posX, const double& posY, const dou
 void FieldManager::useCache(bool opt, unsigned int nBuckets) {
   useCache_ = opt;
   n_buckets_ = nBuckets;
-
-  if (useCache_) {
-    cache_ = new fieldCache[n_buckets_];
-    for (size_t i = 0; i < n_buckets_; ++i) {
-      // Should be safe to initialize with values in Andromeda
-      cache_[i].posX = cache_[i].posY = cache_[i].posZ = 2.4e24 / sqrt(3);
-      cache_[i].Bx = cache_[i].By = cache_[i].Bz = 1e30;      
-    }      
-  }
+  // the cache of each thread is (re)initialized at its next use
+  ++cacheGeneration;
 }
 #endif
 
@@ -21,8 +21,26 @@
 
 #include "IO.h"
 
+#include <atomic>
 #include <iostream>
 
-std::ostream genfit::debugOut(std::cout.rdbuf());
-std::ostream genfit::errorOut(std::cerr.rdbuf());
-std::ostream genfit::printOut(std::cout.rdbuf());
+namespace {
+  //! Destinations used by the streams of threads starting output
+  std::atomic<std::streambuf*> debugBuffer(std::cout.rdbuf());
+  std::atomic<std::streambuf*> errorBuffer(std::cerr.rdbuf());
+  std::atomic<std::streambuf*> printBuffer(std::cout.rdbuf());
+}
+
+thread_local std::ostream genfit::debugOut(debugBuffer.load());
+thread_local std::ostream genfit::errorOut(errorBuffer.load());
+thread_local std::ostream genfit::printOut(printBuffer.load());
+
+void genfit::setStreamBuffers(std::streambuf* debug, std::streambuf* error, std::streambuf* print)
+{
+  debugBuffer = debug;
+  errorBuffer = error;
+  printBuffer = print;
+  debugOut.rdbuf(debug);
+  errorOut.rdbuf(error);
+  printOut.rdbuf(print);
+}
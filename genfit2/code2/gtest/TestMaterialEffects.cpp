@@ -3,6 +3,8 @@
 #include <AbsMaterialInterface.h>
 #include <MaterialEffects.h>
 
+#include <thread>
+
 namespace genfit {
 
     class MaterialEffectsTests : public ::testing::Test {
@@ -17,6 +19,43 @@ namespace genfit {
     };
 
 
+    namespace {
+        //! Material interface with the same material everywhere, which can be cloned
+        class ConstMaterialInterface : public AbsMaterialInterface {
+        public:
+            bool initTrack(double, double, double, double, double, double) override { return false; }
+            Material getMaterialParameters() override { return Material(2.33, 14, 28.0855, 9.37, 173); }
+            double findNextBoundary(const RKTrackRep*, const M1x7&, double sMax, bool) override { return sMax; }
+            AbsMaterialInterface* clone() const override { return new ConstMaterialInterface(); }
+        };
+    }
+
+    TEST_F (MaterialEffectsTests, ThreadInstance) {
+        // without a material interface there is nothing to clone
+        EXPECT_EQ(nullptr, genfit::MaterialEffects::createThreadInstance());
+        genfit::MaterialEffects::destruct();
+
+        genfit::MaterialEffects* global = genfit::MaterialEffects::getInstance();
+        global->init(new ConstMaterialInterface());
+        global->setNoiseBrems(false);
+        genfit::MaterialEffects* threadInstance = genfit::MaterialEffects::createThreadInstance();
+        ASSERT_NE(nullptr, threadInstance);
+        EXPECT_NE(global, threadInstance);
+        EXPECT_TRUE(threadInstance->isInitialized());
+
+        genfit::MaterialEffects* seenInThread = nullptr;
+        std::thread thread([&]() {
+            genfit::MaterialEffects::setThreadInstance(threadInstance);
+            seenInThread = genfit::MaterialEffects::getInstance();
+            genfit::MaterialEffects::setThreadInstance(nullptr);
+        });
+        thread.join();
+        EXPECT_EQ(threadInstance, seenInThread);
+        EXPECT_EQ(global, genfit::MaterialEffects::getInstance());
+
+        genfit::MaterialEffects::deleteThreadInstance(threadInstance);
+    }
+
     // TODO: Write a ConstMaterialInterface similar to the ConstMagneticField for testing purposes.
     // TODO: We can easily check the formulas then! Yeah...
 }
\ No newline at end of file
@@ -65,6 +65,10 @@ class AbsMaterialInterface : public TObject {
                                   double sMax,
                                   bool varField = true) = 0;
 
+  /** @brief Return a new, independent instance for the use in another thread, or nullptr if this is not supported.
+   */
+  virtual AbsMaterialInterface* clone() const { return nullptr; }
+
   virtual void setDebugLvl(unsigned int lvl = 1) {debugLvl_ = lvl;}
 
  protected:
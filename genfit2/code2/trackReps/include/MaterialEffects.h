@@ -59,9 +59,22 @@ class MaterialEffects {
 
 public:
 
+  //! Returns the instance of the current thread if one was set with setThreadInstance(), otherwise the global instance.
   static MaterialEffects* getInstance();
   static void destruct();
 
+  //! Create a copy of the global instance with the same settings and its own clone of the material interface.
+  /** Such a copy can be used by another thread (see setThreadInstance()), so that several threads can
+   *  extrapolate at the same time. Returns nullptr if the material interface does not support cloning.
+   */
+  static MaterialEffects* createThreadInstance();
+  //! Use the given instance (from createThreadInstance()) in the calling thread instead of the global one.
+  /** The caller keeps the ownership. Call with nullptr to use the global instance again.
+   */
+  static void setThreadInstance(MaterialEffects* instance);
+  //! Delete an instance created with createThreadInstance().
+  static void deleteThreadInstance(MaterialEffects* instance) { delete instance; }
+
   //! set the material interface here. Material interface classes must be derived from AbsMaterialInterface.
   void init(AbsMaterialInterface* matIfc);
   bool isInitialized() { return materialInterface_ != nullptr; }
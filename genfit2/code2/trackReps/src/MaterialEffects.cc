@@ -39,6 +39,11 @@ namespace genfit {
 
 MaterialEffects* MaterialEffects::instance_ = nullptr;
 
+namespace {
+  //! Instance used by the current thread instead of the global one, see MaterialEffects::setThreadInstance()
+  thread_local MaterialEffects* threadInstance = nullptr;
+}
+
 
 MaterialEffects::MaterialEffects():
   noEffects_(false),
@@ -72,10 +77,29 @@ MaterialEffects::~MaterialEffects()
 
 MaterialEffects* MaterialEffects::getInstance()
 {
+  if (threadInstance != nullptr) return threadInstance;
   if (instance_ == nullptr) instance_ = new MaterialEffects();
   return instance_;
 }
 
+MaterialEffects* MaterialEffects::createThreadInstance()
+{
+  MaterialEffects* global = instance_;
+  if (global == nullptr or global->materialInterface_ == nullptr) return nullptr;
+  AbsMaterialInterface* materialInterface = global->materialInterface_->clone();
+  if (materialInterface == nullptr) return nullptr;
+
+  // copy all settings, the cached values are overwritten in each step anyway
+  MaterialEffects* instance = new MaterialEffects(*global);
+  instance->materialInterface_ = materialInterface;
+  return instance;
+}
+
+void MaterialEffects::setThreadInstance(MaterialEffects* instance)
+{
+  threadInstance = instance;
+}
+
 void MaterialEffects::destruct()
 {
   if (instance_ != nullptr) {
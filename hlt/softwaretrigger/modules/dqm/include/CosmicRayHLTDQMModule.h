@@ -14,9 +14,8 @@
 
 #include <string>
 
-#include <TH1F.h>
-
 #include <framework/core/HistoModule.h>
+#include <framework/pcore/SharedHistogramStore.h>
 
 namespace Belle2 {
   namespace SoftwareTrigger {
@@ -48,56 +47,56 @@ namespace Belle2 {
 
       //CDC
       /**Signed distance to the POCA in the r-phi plane*/
-      TH1F* h_d0 = nullptr;
+      SharedOrLocalHistogram h_d0;
       /**z coordinate of the POCA*/
-      TH1F* h_z0 = nullptr;
+      SharedOrLocalHistogram h_z0;
       /**number of traks*/
-      TH1F* h_ntrk = nullptr;
+      SharedOrLocalHistogram h_ntrk;
       /**momentum information of track*/
-      TH1F* h_p[5] = {nullptr, nullptr, nullptr, nullptr, nullptr};
+      SharedOrLocalHistogram h_p[5];
       /**chi2 probalility of the track fit*/
-      TH1F* h_pValue = nullptr;
+      SharedOrLocalHistogram h_pValue;
       /**Number of CDC hits associated to CDC track*/
-      TH1F* h_ncdchits = nullptr;
+      SharedOrLocalHistogram h_ncdchits;
       /**Angle of the transverse momentum in the r-phi plane*/
-      TH1F* h_phi0 = nullptr;
+      SharedOrLocalHistogram h_phi0;
       /**charge of track*/
-      TH1F* h_charge = nullptr;
+      SharedOrLocalHistogram h_charge;
 
       //ECL
       /**number of ecl clusters*/
-      TH1F* h_ncluster = nullptr;
+      SharedOrLocalHistogram h_ncluster;
       /**phi angle of ECLCluster position*/
-      TH1F* h_phi_eclcluster = nullptr;
+      SharedOrLocalHistogram h_phi_eclcluster;
       /**theta angle of ECLCluster position*/
-      TH1F* h_theta_eclcluster = nullptr;
+      SharedOrLocalHistogram h_theta_eclcluster;
       /**the ecl cluster time*/
-      TH1F* h_Time_eclcluster = nullptr;
+      SharedOrLocalHistogram h_Time_eclcluster;
       /**the E1/E9 energy ratio*/
-      TH1F* h_E1oE9_eclcluster = nullptr;
+      SharedOrLocalHistogram h_E1oE9_eclcluster;
       /**energy of ECL cluster*/
-      TH1F* h_e_eclcluster = nullptr;
+      SharedOrLocalHistogram h_e_eclcluster;
 
       /**number of ECL showers*/
-      TH1F* h_nshower = nullptr;
+      SharedOrLocalHistogram h_nshower;
       /**time of  ECL shower*/
-      TH1F* h_time_eclshower = nullptr;
+      SharedOrLocalHistogram h_time_eclshower;
       /**energy of ECL shower*/
-      TH1F* h_e_eclshower = nullptr;
+      SharedOrLocalHistogram h_e_eclshower;
 
       //KLM
       /**number of bKLM Hit*/
-      TH1F* h_nbklmhit = nullptr;
+      SharedOrLocalHistogram h_nbklmhit;
       /**layer ID of hits in bKLM*/
-      TH1F* h_layerId_bklmhit = nullptr;
+      SharedOrLocalHistogram h_layerId_bklmhit;
       /**sector ID of hits in bKLM*/
-      TH1F* h_sectorId_bklmhit = nullptr;
+      SharedOrLocalHistogram h_sectorId_bklmhit;
       /**number of eKLM Hit*/
-      TH1F* h_neklmhit = nullptr;
+      SharedOrLocalHistogram h_neklmhit;
       /**layer ID of hits in eKLM*/
-      TH1F* h_layerId_eklmhit = nullptr;
+      SharedOrLocalHistogram h_layerId_eklmhit;
       /**sector ID of hits in eKLM*/
-      TH1F* h_sectorId_eklmhit = nullptr;
+      SharedOrLocalHistogram h_sectorId_eklmhit;
 
 
     };
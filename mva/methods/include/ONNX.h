@@ -207,6 +207,37 @@ namespace Belle2 {
           return at(flat_index);
         }
 
+        /**
+         * @brief Changes the shape of the tensor, e.g. to reuse it for a different batch size.
+         *
+         * The values are kept in row-major order up to the new size, additional values are zero.
+         * The allocated memory is only ever increased, so resizing an existing tensor every event
+         * avoids allocations once the largest size has been seen.
+         *
+         * @param shape New shape of the tensor.
+         *
+         * @throws std::invalid_argument if any shape dimension is negative
+         */
+        void reshape(std::vector<int64_t> shape)
+        {
+          m_shape = std::move(shape);
+          checkShapePositive();
+          m_values.resize(sizeFromShape(m_shape));
+        }
+
+        /**
+         * @brief Pointer to the flat buffer of values in row-major order.
+         *
+         * Unlike `at`, no bounds checking is done, so this is meant for
+         * filling or reading large tensors in tight loops.
+         */
+        T* data() { return m_values.data(); }
+
+        /**
+         * @brief Pointer to the flat buffer of values in row-major order.
+         */
+        const T* data() const { return m_values.data(); }
+
         /**
          * @brief Replaces the internal values with a new vector.
          *
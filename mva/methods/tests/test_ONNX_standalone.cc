@@ -32,6 +32,18 @@ namespace {
   {
     EXPECT_THROW(Tensor<int>({1, 2, 3}, {2, 2}), std::length_error);
   }
+  TEST(ONNXStandaloneTest, Reshape)
+  {
+    auto t = Tensor<int>::make_shared({1, 2, 3, 4, 5, 6}, {2, 3});
+    t->reshape({1, 3});
+    EXPECT_EQ(t->at({0, 2}), 3);
+    EXPECT_THROW(t->at({1, 0}), std::out_of_range);
+    t->reshape({3, 3});
+    EXPECT_EQ(t->at({0, 1}), 2);
+    EXPECT_EQ(t->at({2, 2}), 0);
+    EXPECT_EQ(t->data()[8], 0);
+    EXPECT_THROW(t->reshape({-1, 3}), std::invalid_argument);
+  }
   TEST(ONNXStandaloneTest, RunStandaloneModel)
   {
     // Testfile created with mva/examples/onnx/write_test_files.py
@@ -44,14 +44,15 @@ namespace Belle2 {
     {}
 
     /**
-     * Use basf2 units when returning geometry parameters
+     * Use basf2 units when returning geometry parameters.
+     * Units are written only if they change, since reconstruction threads call this concurrently.
      */
-    static void useBasf2Units() {s_unit = Unit::cm; s_unitName = "cm";}
+    static void useBasf2Units() {if (s_unit != Unit::cm) {s_unit = Unit::cm; s_unitName = "cm";}}
 
     /**
      * Use Geant units when returning geometry parameters
      */
-    static void useGeantUnits() {s_unit = Unit::mm; s_unitName = "mm";}
+    static void useGeantUnits() {if (s_unit != Unit::mm) {s_unit = Unit::mm; s_unitName = "mm";}}
 
     /**
      * Appends module (if its ID differs from already appended modules)
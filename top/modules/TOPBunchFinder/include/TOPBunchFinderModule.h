@@ -10,6 +10,7 @@
 
 #include <framework/core/Module.h>
 #include <map>
+#include <memory>
 #include <framework/datastore/StoreArray.h>
 #include <framework/datastore/StoreObjPtr.h>
 #include <top/dataobjects/TOPDigit.h>
@@ -27,6 +28,7 @@
 #include <top/dbobjects/TOPCalFillPatternOffset.h>
 
 #include <top/reconstruction_cpp/PDFConstructor.h>
+#include <framework/utilities/ParallelJobs.h>
 #include <top/utilities/Chi2MinimumFinder1D.h>
 #include <framework/gearbox/Const.h>
 
@@ -135,6 +137,7 @@ namespace Belle2 {
     unsigned m_nTrackLimit; /**< maximum number of tracks (inclusive) to use three particle hypotheses in fine search */
     bool m_useTimeSeed; /**< use CDC or SVD event T0 as seed */
     bool m_useFillPattern; /**< use know fill pattern to enhance efficiency */
+    unsigned m_numberOfThreads; /**< number of threads for the T0 scans */
 
     // internal variables shared between events
     double m_bunchTimeSep = 0; /**< time between two bunches */
@@ -147,6 +150,7 @@ namespace Belle2 {
     int m_nodEdxCount = 0; /**< counter of tracks with no dEdx, reset at each event */
     unsigned short m_revo9Counter = 0xFFFF; /**< number of system clocks since last revo9 marker */
     bool m_isMC = false; /**< is Monte Carlo */
+    std::unique_ptr<ParallelJobs> m_parallelJobs; /**< runs the T0 scans in several threads */
 
     // collections
     StoreArray<TOPDigit> m_topDigits; /**< collection of TOP digits */
@@ -30,6 +30,7 @@
 // framework aux
 #include <framework/logging/Logger.h>
 #include <set>
+#include <algorithm>
 
 using namespace std;
 
@@ -101,6 +102,9 @@ namespace Belle2 {
              "(only when running in data processing mode and autoRange turned off).", true);
     addParam("useFillPattern", m_useFillPattern, "use known accelerator fill pattern to enhance efficiency "
              "(only when running in data processing mode).", true);
+    addParam("numberOfThreads", m_numberOfThreads,
+             "number of threads for the T0 scans (coarse search: tracks, fine search: bins). "
+             "The results do not depend on the number of threads.", unsigned(1));
   }
 
 
@@ -139,6 +143,10 @@ namespace Belle2 {
     m_timeZeros.registerRelationTo(extHits);
     m_eventT0.registerInDataStore(); // usually it is already registered in tracking
 
+    // threads are started at the first event, as they would not survive the fork of parallel processing
+
+    m_parallelJobs = std::make_unique<ParallelJobs>(m_numberOfThreads);
+
     // bunch separation in time
 
     const auto* geo = TOPGeometryPar::Instance()->getGeometry();
@@ -362,17 +370,18 @@ namespace Belle2 {
       int numBins = (maxT0 - minT0) / binSize;
       maxT0 = minT0 + binSize * numBins;
 
-      // find coarse T0
+      // find coarse T0 (tracks are independent)
 
-      for (const auto& pdf : top1Dpdfs) {
-        finders.push_back(Chi2MinimumFinder1D(numBins, minT0, maxT0));
-        auto& finder = finders.back();
+      finders.resize(top1Dpdfs.size(), Chi2MinimumFinder1D(numBins, minT0, maxT0));
+      m_parallelJobs->run(top1Dpdfs.size(), [&top1Dpdfs, &finders](size_t itrk) {
+        const auto& pdf = top1Dpdfs[itrk];
+        auto& finder = finders[itrk];
         const auto& bins = finder.getBinCenters();
         for (unsigned i = 0; i < bins.size(); i++) {
           double t0 = bins[i];
           finder.add(i, -2 * pdf.getLogL(t0));
         }
-      }
+      });
       auto coarseFinder = finders[0];
       for (size_t i = 1; i < finders.size(); i++) {
         coarseFinder.add(finders[i]);
@@ -622,9 +631,22 @@ namespace Belle2 {
     const auto& binCenters = finder.getBinCenters();
     int numPhotons = 0;
     double logL_bkg = reco.getBackgroundLogL(timeMin, timeMax).logL;
+
+    // bins are independent: each job scans every numJobs-th bin with its own PDF,
+    // since PDFConstructor keeps temporary values in the log likelihood calculation
+
+    size_t numJobs = std::min<size_t>(m_parallelJobs->getNumThreads(), binCenters.size());
+    std::vector<PDFConstructor> copies(numJobs > 0 ? numJobs - 1 : 0, reco);
+    std::vector<PDFConstructor::LogL> logLs(binCenters.size(), PDFConstructor::LogL(0));
+    m_parallelJobs->run(numJobs, [this, &reco, &copies, &binCenters, &logLs, numJobs, timeMin, timeMax](size_t job) {
+      const auto& pdf = (job == 0) ? reco : copies[job - 1];
+      for (size_t i = job; i < binCenters.size(); i += numJobs) {
+        logLs[i] = pdf.getLogL(binCenters[i], timeMin, timeMax, m_sigmaSmear);
+      }
+    });
+
     for (unsigned i = 0; i < binCenters.size(); i++) {
-      double t0 = binCenters[i];
-      auto LL = reco.getLogL(t0, timeMin, timeMax, m_sigmaSmear);
+      const auto& LL = logLs[i];
       finder.add(i, -2 * (LL.logL - logL_bkg));
       if (i == 0) numPhotons = LL.numPhotons;
       nfotSet.insert(LL.numPhotons);
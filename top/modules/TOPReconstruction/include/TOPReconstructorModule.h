@@ -20,9 +20,11 @@
 #include <top/dataobjects/TOPPull.h>
 #include <top/reconstruction_cpp/PDFConstructor.h>
 #include <top/reconstruction_cpp/TOPTrack.h>
+#include <framework/utilities/ParallelJobs.h>
 #include <top/dbobjects/TOPCalTOFCorrection.h>
 #include <framework/gearbox/Const.h>
 #include <vector>
+#include <memory>
 #include <string>
 #include <limits>
 
@@ -133,6 +135,14 @@ namespace Belle2 {
 
     };
 
+    /**
+     * Constructs the PDF's of the tracks in one module and sets the PDF's of other tracks.
+     * Modules are independent of each other, this method can run in parallel for different modules.
+     * @param tracks tracks in the module
+     * @return PDF collections of the tracks with valid PDF's
+     */
+    std::vector<PDFCollection> reconstructModule(const std::vector<const TOP::TOPTrack*>& tracks) const;
+
     // Module steering parameters
 
     double m_minTime = 0;      /**< optional lower time limit for photons */
@@ -143,6 +153,9 @@ namespace Belle2 {
     std::string m_topDigitCollectionName; /**< name of the collection of TOPDigits */
     std::string m_topLikelihoodCollectionName; /**< name of the collection of created TOPLikelihoods */
     std::string m_topPullCollectionName; /**< name of the collection of created TOPPulls */
+    unsigned m_numberOfThreads = 1; /**< number of threads for the reconstruction of the modules */
+
+    std::unique_ptr<ParallelJobs> m_parallelJobs; /**< runs the reconstruction of modules in several threads */
 
     // datastore objects
 
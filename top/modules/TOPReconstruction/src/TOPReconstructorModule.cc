@@ -60,6 +60,9 @@ namespace Belle2 {
     addParam("TOPLikelihoodCollectionName", m_topLikelihoodCollectionName,
              "Name of the produced collection of TOPLikelihoods", string(""));
     addParam("TOPPullCollectionName", m_topPullCollectionName, "Name of the collection of produced TOPPulls", string(""));
+    addParam("numberOfThreads", m_numberOfThreads,
+             "Number of threads for reconstructing the modules (slots) of one event. "
+             "The results do not depend on the number of threads.", m_numberOfThreads);
   }
 
 
@@ -82,6 +85,10 @@ namespace Belle2 {
 
     m_topPulls.registerInDataStore(m_topPullCollectionName, DataStore::c_DontWriteOut);
     m_tracks.registerRelationTo(m_topPulls, DataStore::c_Event, DataStore::c_DontWriteOut);
+
+    // threads are started at the first event, as they would not survive the fork of parallel processing
+
+    m_parallelJobs = std::make_unique<ParallelJobs>(m_numberOfThreads);
   }
 
 
@@ -121,44 +128,29 @@ namespace Belle2 {
       }
     }
 
-    // reconstruct module-by-module
+    // collect tracks module-by-module
 
+    std::vector<std::vector<const TOPTrack*>> moduleTracks;
     const auto* geo = TOPGeometryPar::Instance()->getGeometry();
     for (unsigned moduleID = 1; moduleID <= geo->getNumModules(); moduleID++) {
+      std::vector<const TOPTrack*> tracks;
+      const auto& range = topTracks.equal_range(moduleID);
+      for (auto it = range.first; it != range.second; ++it) tracks.push_back(it->second);
+      if (not tracks.empty()) moduleTracks.push_back(tracks);
+    }
 
-      // make a vector of PDF collections for a given TOP module
+    // reconstruct modules, in parallel if requested;
+    // reconstruction objects must be set up before the threads use them
 
-      std::vector<PDFCollection> pdfCollections;
-      const auto& range = topTracks.equal_range(moduleID);
-      for (auto it = range.first; it != range.second; ++it) {
-        const auto* trk = it->second;
-        PDFCollection collection(*trk, m_deltaRayModeling);
-        if (collection.isValid) pdfCollections.push_back(collection);
-      }
-      if (pdfCollections.empty()) continue;
+    TOPRecoManager::getBackgroundPDFs();
+    std::vector<std::vector<PDFCollection>> modulePDFCollections(moduleTracks.size());
+    m_parallelJobs->run(moduleTracks.size(), [this, &moduleTracks, &modulePDFCollections](size_t i) {
+      modulePDFCollections[i] = reconstructModule(moduleTracks[i]);
+    });
 
-      // add most probable PDF's of other tracks if present
+    // store the results in the order of modules
 
-      if (pdfCollections.size() > 1) {
-        std::vector<int> lastMostProbables;
-        for (int iter = 0; iter < 10; iter++) {
-          std::vector<int> mostProbables;
-          for (auto& collection : pdfCollections) { // set most probable PDF
-            collection.setMostProbable();
-            mostProbables.push_back(collection.mostProbable->getHypothesis().getPDGCode());
-          }
-          if (mostProbables == lastMostProbables) break;
-          else lastMostProbables = mostProbables;
-
-          for (auto& collection : pdfCollections) collection.clearPDFOther(); // reset
-          for (auto& collection : pdfCollections) { // append
-            for (const auto& other : pdfCollections) {
-              if (&other == &collection) continue;
-              collection.appendPDFOther(other.mostProbable);
-            }
-          }
-        } // loop: iter
-      }
+    for (auto& pdfCollections : modulePDFCollections) {
 
       // determine and save log likelihoods
 
@@ -201,11 +193,49 @@ namespace Belle2 {
 
       for (auto& collection : pdfCollections) collection.deletePDFs();
 
-    } // loop: moduleID
+    } // loop: modules
 
     for (const auto& x : topTracks) delete x.second;
 
   }
 
+
+  std::vector<TOPReconstructorModule::PDFCollection>
+  TOPReconstructorModule::reconstructModule(const std::vector<const TOPTrack*>& tracks) const
+  {
+    // make a vector of PDF collections for a given TOP module
+
+    std::vector<PDFCollection> pdfCollections;
+    for (const auto* trk : tracks) {
+      PDFCollection collection(*trk, m_deltaRayModeling);
+      if (collection.isValid) pdfCollections.push_back(collection);
+    }
+
+    // add most probable PDF's of other tracks if present
+
+    if (pdfCollections.size() > 1) {
+      std::vector<int> lastMostProbables;
+      for (int iter = 0; iter < 10; iter++) {
+        std::vector<int> mostProbables;
+        for (auto& collection : pdfCollections) { // set most probable PDF
+          collection.setMostProbable();
+          mostProbables.push_back(collection.mostProbable->getHypothesis().getPDGCode());
+        }
+        if (mostProbables == lastMostProbables) break;
+        else lastMostProbables = mostProbables;
+
+        for (auto& collection : pdfCollections) collection.clearPDFOther(); // reset
+        for (auto& collection : pdfCollections) { // append
+          for (const auto& other : pdfCollections) {
+            if (&other == &collection) continue;
+            collection.appendPDFOther(other.mostProbable);
+          }
+        }
+      } // loop: iter
+    }
+
+    return pdfCollections;
+  }
+
 } // end Belle2 namespace
 
@@ -177,6 +177,7 @@ namespace Belle2 {
       double m_fraction = 0; /**< fraction of delta-ray photons within time window */
       double m_numPhotons = 0; /**< number of photons */
       std::vector<double> m_pixelAcceptances; /**< pixel angular acceptances for direct peak (index = pixelID - 1) */
+      std::vector<double> m_pixelTimeShifts; /**< direct peak positions relative to m_dirT0 (index = pixelID - 1) */
 
     };
 
@@ -12,6 +12,7 @@
 #include <top/reconstruction_cpp/FastRaytracer.h>
 #include <top/reconstruction_cpp/YScanner.h>
 #include <top/reconstruction_cpp/BackgroundPDF.h>
+#include <top/reconstruction_cpp/DeltaRayPDF.h>
 #include <top/dbobjects/TOPCalChannelMask.h>
 #include <top/dbobjects/TOPCalChannelT0.h>
 #include <top/dbobjects/TOPCalTimebase.h>
@@ -71,6 +72,14 @@ namespace Belle2 {
        */
       static const std::vector<BackgroundPDF>& getBackgroundPDFs() {return getInstance().backgroundPDFs();}
 
+      /**
+       * Returns delta-ray PDF of a given module, constructed but not prepared.
+       * The PDF constructors copy it instead of constructing it for each track and hypothesis.
+       * @param moduleID slot ID (1-based)
+       * @return pointer to delta-ray PDF or null pointer if moduleID is not valid
+       */
+      static const DeltaRayPDF* getDeltaRayPDF(int moduleID);
+
       /**
        * Returns time window lower edge
        * @return time window lower edge
@@ -196,10 +205,18 @@ namespace Belle2 {
        */
       std::vector<BackgroundPDF>& backgroundPDFs();
 
+      /**
+       * Interface to delta-ray PDF's of all modules.
+       * Any accesses to underlying collection must be made with this method.
+       * @return collection of delta-ray PDF's (index = moduleID - 1)
+       */
+      std::vector<DeltaRayPDF>& deltaRayPDFs();
+
       std::vector<InverseRaytracer> m_inverseRaytracers; /**< collection of inverse raytracers */
       std::vector<FastRaytracer> m_fastRaytracers; /**< collection of fast raytracers */
       std::vector<YScanner> m_yScanners; /**< collection of y-scanners */
       std::vector<BackgroundPDF> m_backgroundPDFs; /**< collection of background PDF's */
+      std::vector<DeltaRayPDF> m_deltaRayPDFs; /**< collection of delta-ray PDF's */
       double m_minTime = 0; /**< time window lower edge */
       double m_maxTime = 0; /**< time window upper edge */
       bool m_redoBkg = false; /**< flag to signal whether backgroundPDF has to be redone */
@@ -236,6 +253,12 @@ namespace Belle2 {
       return m_backgroundPDFs;
     }
 
+    inline std::vector<DeltaRayPDF>& TOPRecoManager::deltaRayPDFs()
+    {
+      if (m_deltaRayPDFs.empty()) set();
+      return m_deltaRayPDFs;
+    }
+
   } // namespace TOP
 } // namespace Belle2
 
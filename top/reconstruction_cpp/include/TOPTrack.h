@@ -93,6 +93,16 @@ namespace Belle2 {
         {}
       };
 
+      /**
+       * Hypothesis independent quantities of PDF construction for the average emission point,
+       * computed by the first PDF constructed for this track and reused for the other hypotheses
+       */
+      struct PDFCache {
+        std::map<int, double> reflectionExtremes; /**< positions of reflection extremes (key = reflections before mirror) */
+        std::vector<double> deltaRayAcceptances; /**< delta-ray pixel acceptances for direct peak (index = pixelID - 1) */
+        std::vector<double> deltaRayTimeShifts; /**< delta-ray direct peak positions rel. to minimal (index = pixelID - 1) */
+      };
+
       /**
        * Default constructor
        */
@@ -261,6 +271,12 @@ namespace Belle2 {
        */
       bool isScanRequired(unsigned col, double time, double wid) const;
 
+      /**
+       * Returns the cache of hypothesis independent quantities of PDF construction
+       * @return PDF cache (can be modified, it is filled by the PDF constructors)
+       */
+      PDFCache& getPDFCache() const {return m_pdfCache;}
+
     private:
 
       /**
@@ -314,6 +330,9 @@ namespace Belle2 {
       /** assumed emission points in module local frame */
       mutable std::map<double, TOPTrack::AssumedEmission> m_emissionPoints;
 
+      /** hypothesis independent quantities of PDF construction */
+      mutable PDFCache m_pdfCache;
+
     };
 
 
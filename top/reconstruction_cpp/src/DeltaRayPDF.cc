@@ -94,16 +94,25 @@ namespace Belle2 {
       m_fraction = totalFraction(tmin, tmax);
       m_numPhotons = photonYield(beta, PDGCode) * tlen * m_fraction * relEffi;
 
-      for (const auto& pixel : m_pixelPositions->getPixels()) {
-        double dfi_dx = std::abs(m_zD - m_zE) / (pow(pixel.xc - m_xE, 2) + pow(pixel.yc - m_yE, 2) + pow(m_zD - m_zE, 2));
-        m_pixelAcceptances.push_back(dfi_dx * pixel.Dx);
+      // pixel acceptances and direct peak positions depend only on the emission point
+
+      auto& cache = track.getPDFCache();
+      if (cache.deltaRayAcceptances.empty()) {
+        for (const auto& pixel : m_pixelPositions->getPixels()) {
+          double distSq = pow(pixel.xc - m_xE, 2) + pow(pixel.yc - m_yE, 2) + pow(m_zD - m_zE, 2);
+          double dfi_dx = std::abs(m_zD - m_zE) / distSq;
+          cache.deltaRayAcceptances.push_back(dfi_dx * pixel.Dx);
+          cache.deltaRayTimeShifts.push_back(sqrt(distSq) * m_groupIndex / Const::speedOfLight - m_dirT0);
+        }
+        double sum = 0;
+        const auto& pixelPDF = m_background->getPDF();
+        for (size_t k = 0; k < cache.deltaRayAcceptances.size(); k++) {
+          sum += cache.deltaRayAcceptances[k] * pixelPDF[k];
+        }
+        for (auto& x : cache.deltaRayAcceptances) x /= sum;
       }
-      double sum = 0;
-      const auto& pixelPDF = m_background->getPDF();
-      for (size_t k = 0; k < m_pixelAcceptances.size(); k++) {
-        sum += m_pixelAcceptances[k] * pixelPDF[k];
-      }
-      for (auto& x : m_pixelAcceptances) x /= sum;
+      m_pixelAcceptances = cache.deltaRayAcceptances;
+      m_pixelTimeShifts = cache.deltaRayTimeShifts;
     }
 
     double DeltaRayPDF::getPDFValue(int pixelID, double time) const
@@ -111,10 +120,7 @@ namespace Belle2 {
       const auto& pixelPDF = m_background->getPDF();
       unsigned k = pixelID - 1;
       if (k < pixelPDF.size()) {
-        const auto& pixel = m_pixelPositions->get(pixelID);
-        double t0 = sqrt(pow(pixel.xc - m_xE, 2) + pow(pixel.yc - m_yE, 2) + pow(m_zD - m_zE, 2))
-                    * m_groupIndex / Const::speedOfLight;
-        return getPDFValue(time, t0 - m_dirT0, m_pixelAcceptances[k]) * pixelPDF[k];
+        return getPDFValue(time, m_pixelTimeShifts[k], m_pixelAcceptances[k]) * pixelPDF[k];
       }
       return 0;
     }
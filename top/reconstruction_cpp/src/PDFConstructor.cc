@@ -27,7 +27,8 @@ namespace Belle2 {
       m_fastRaytracer(TOPRecoManager::getFastRaytracer(m_moduleID)),
       m_yScanner(TOPRecoManager::getYScanner(m_moduleID)),
       m_backgroundPDF(TOPRecoManager::getBackgroundPDF(m_moduleID)),
-      m_deltaRayPDF(m_moduleID),
+      m_deltaRayPDF(TOPRecoManager::getDeltaRayPDF(m_moduleID) ?
+                    *TOPRecoManager::getDeltaRayPDF(m_moduleID) : DeltaRayPDF(m_moduleID)),
       m_PDFOption(PDFOption), m_storeOption(storeOption)
     {
       if (not track.isValid()) {
@@ -58,6 +59,7 @@ namespace Belle2 {
       const auto& pixelPositions = m_yScanner->getPixelPositions();
       int numPixels = pixelPositions.getNumPixels();
       const auto* geo = TOPGeometryPar::Instance()->getGeometry();
+      m_signalPDFs.reserve(numPixels);
       for (int pixelID = 1; pixelID <= numPixels; pixelID++) {
         auto pmtType = pixelPositions.get(pixelID).pmtType;
         const auto& tts = geo->getTTS(pmtType);
@@ -158,9 +160,13 @@ namespace Belle2 {
       double xE = emiPoint.X();
       double zE = emiPoint.Z();
       double Ah = bar.A / 2;
+      auto& reflectionExtremes = m_track.getPDFCache().reflectionExtremes; // hypothesis independent
       for (int k = kmi; k <= kma; k++) {
-        double x0 = findReflectionExtreme(xE, zE, prism.zD, k, bar.A, mirror);
-        x0 = func::clip(x0, k, bar.A, xmi, xma);
+        auto extreme = reflectionExtremes.find(k);
+        if (extreme == reflectionExtremes.end()) {
+          extreme = reflectionExtremes.emplace(k, findReflectionExtreme(xE, zE, prism.zD, k, bar.A, mirror)).first;
+        }
+        double x0 = func::clip(extreme->second, k, bar.A, xmi, xma);
         double xL = func::clip(-Ah, k, bar.A, xmi, xma);
         double xR = func::clip(Ah, k, bar.A, xmi, xma);
         if (x0 > xL) setSignalPDF_reflected(k, xL, x0);
@@ -27,6 +27,10 @@ namespace Belle2 {
         m_fastRaytracers.push_back(FastRaytracer(moduleID));
         m_backgroundPDFs.push_back(BackgroundPDF(moduleID));
       }
+      // delta-ray PDF's need the collections above
+      for (unsigned moduleID = 1; moduleID <= geo->getNumModules(); moduleID++) {
+        m_deltaRayPDFs.push_back(DeltaRayPDF(moduleID));
+      }
     }
 
     const InverseRaytracer* TOPRecoManager::getInverseRaytracer(int moduleID)
@@ -81,6 +85,18 @@ namespace Belle2 {
       return 0;
     }
 
+    const DeltaRayPDF* TOPRecoManager::getDeltaRayPDF(int moduleID)
+    {
+      const auto& collection = getInstance().deltaRayPDFs();
+      unsigned k = moduleID - 1;
+      if (k < collection.size()) {
+        return &collection[k];
+      }
+
+      B2ERROR("TOPRecoManager::getDeltaRayPDF: invalid moduleID" << LogVar("moduleID", moduleID));
+      return 0;
+    }
+
     void TOPRecoManager::setChannelMask(const DBObjPtr<TOPCalChannelMask>& mask,
                                         const TOPAsicMask& asicMask)
     {
@@ -166,6 +166,7 @@ namespace Belle2 {
     bool TOPTrack::setHelix(const Transform3D& transform)
     {
       m_emissionPoints.clear();
+      m_pdfCache = PDFCache();
 
       // helix in module nominal frame (z-axis still parallel to magnetic field)
 
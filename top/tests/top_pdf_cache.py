@@ -0,0 +1,102 @@
+#!/usr/bin/env python
+
+##########################################################################
+# basf2 (Belle II Analysis Software Framework)                           #
+# Author: The Belle II Collaboration                                     #
+#                                                                        #
+# See git log for contributors and copyright holders.                    #
+# This file is licensed under LGPL-3.0, see LICENSE.md.                  #
+##########################################################################
+
+# Checks that the PDFs constructed with the hypothesis independent quantities cached in TOPTrack
+# (delta-ray acceptances and peak positions, reflection extremes) are identical to the ones
+# constructed with an empty cache, for all hypotheses
+
+import basf2 as b2
+from ROOT import Belle2
+from simulation import add_simulation
+from reconstruction import add_reconstruction
+
+
+b2.set_random_seed(12345)
+
+#: all charged stable hypotheses
+hypotheses = [Belle2.Const.electron, Belle2.Const.muon, Belle2.Const.pion,
+              Belle2.Const.kaon, Belle2.Const.proton, Belle2.Const.deuteron]
+
+
+class CheckPDFCache(b2.Module):
+
+    """
+    module which compares the PDFs constructed with and without a filled cache
+    """
+
+    def __init__(self):
+        """
+        constructor
+        """
+
+        super().__init__()
+        #: number of compared PDFs
+        self.numCompared = 0
+
+    def summary(self, pdf):
+        """
+        returns the quantities to compare: expected photons, log likelihood and PDF values of the selected hits
+        """
+
+        logL = pdf.getLogL()
+        values = [pdf.getExpectedSignalPhotons(), pdf.getExpectedDeltaPhotons(), pdf.getExpectedBkgPhotons(),
+                  logL.logL, logL.expPhotons, logL.numPhotons]
+        for hit in pdf.getSelectedHits():
+            values.append(pdf.getPDFValue(hit.pixelID, hit.time, hit.timeErr))
+        return values
+
+    def event(self):
+        """
+        construct the PDFs of all tracks and hypotheses with and without the cache and compare them
+        """
+
+        for track in Belle2.PyStoreArray('Tracks'):
+            cachedTrack = Belle2.TOP.TOPTrack(track)
+            if not cachedTrack.isValid():
+                continue
+
+            # fill the cache with a hypothesis which is not the first one
+            Belle2.TOP.PDFConstructor(cachedTrack, Belle2.Const.proton)
+            if cachedTrack.getPDFCache().deltaRayAcceptances.size() == 0:
+                b2.B2FATAL("The PDF cache of the track is not filled")
+
+            for hypothesis in hypotheses:
+                cachedPDF = Belle2.TOP.PDFConstructor(cachedTrack, hypothesis)
+                # a new track object has an empty cache
+                emptyCacheTrack = Belle2.TOP.TOPTrack(track)
+                emptyCachePDF = Belle2.TOP.PDFConstructor(emptyCacheTrack, hypothesis)
+                if cachedPDF.isValid() != emptyCachePDF.isValid():
+                    b2.B2FATAL("PDF valid with and without cache differs")
+                if not cachedPDF.isValid():
+                    continue
+                if self.summary(cachedPDF) != self.summary(emptyCachePDF):
+                    b2.B2FATAL(f"PDFs with and without cache differ for PDG code {hypothesis.getPDGCode()}")
+                self.numCompared += 1
+
+    def terminate(self):
+        """
+        make sure that the test has compared something
+        """
+
+        if self.numCompared == 0:
+            b2.B2FATAL("No PDFs were compared")
+
+
+components = ['PXD', 'SVD', 'CDC', 'TOP']
+
+main = b2.create_path()
+main.add_module('EventInfoSetter', evtNumList=[10])
+main.add_module('ParticleGun', pdgCodes=[211, -211, 321, -321], nTracks=5)
+add_simulation(main, components=components)
+b2.set_module_parameters(main, type="Geometry", useDB=False, components=components)
+add_reconstruction(main, components=components)
+main.add_module(CheckPDFCache())
+
+b2.process(main)
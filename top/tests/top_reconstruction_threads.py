@@ -0,0 +1,86 @@
+#!/usr/bin/env python
+
+##########################################################################
+# basf2 (Belle II Analysis Software Framework)                           #
+# Author: The Belle II Collaboration                                     #
+#                                                                        #
+# See git log for contributors and copyright holders.                    #
+# This file is licensed under LGPL-3.0, see LICENSE.md.                  #
+##########################################################################
+
+# Checks that TOPBunchFinder and TOPReconstructor give the same results with one and with several threads
+
+import basf2 as b2
+from ROOT import Belle2
+from simulation import add_simulation
+from reconstruction import add_reconstruction
+
+
+class CollectResults(b2.Module):
+
+    """
+    module which collects the reconstructed bunch and the TOP likelihoods of all events
+    """
+
+    def __init__(self):
+        """
+        constructor
+        """
+
+        super().__init__()
+        #: list of the results per event
+        self.results = []
+
+    def event(self):
+        """
+        store the bunch finder result and the log likelihoods of all hypotheses
+        """
+
+        recBunch = Belle2.PyStoreObj('TOPRecBunch')
+        bunch = (recBunch.isReconstructed(), recBunch.getBunchNo(), recBunch.getTime(),
+                 recBunch.getCurrentOffset(), recBunch.getUsedTracks())
+        likelihoods = []
+        for likelihood in Belle2.PyStoreArray('TOPLikelihoods'):
+            likelihoods.append((likelihood.getFlag(), likelihood.getModuleID(), likelihood.getNphot(),
+                                likelihood.getLogL_e(), likelihood.getLogL_mu(), likelihood.getLogL_pi(),
+                                likelihood.getLogL_K(), likelihood.getLogL_p(),
+                                likelihood.getNphot_e(), likelihood.getNphot_mu(), likelihood.getNphot_pi(),
+                                likelihood.getNphot_K(), likelihood.getNphot_p()))
+        self.results.append((bunch, likelihoods))
+
+
+def reconstruct(numberOfThreads):
+    """
+    simulate and reconstruct the same events with the given number of threads for the TOP modules
+    """
+
+    b2.set_random_seed(12345)
+    components = ['PXD', 'SVD', 'CDC', 'TOP']
+
+    main = b2.create_path()
+    main.add_module('EventInfoSetter', evtNumList=[10])
+    main.add_module('ParticleGun', pdgCodes=[211, -211, 321, -321], nTracks=5)
+    add_simulation(main, components=components)
+    b2.set_module_parameters(main, type="Geometry", useDB=False, components=components)
+    add_reconstruction(main, components=components)
+    b2.set_module_parameters(main, type='TOPBunchFinder', numberOfThreads=numberOfThreads)
+    b2.set_module_parameters(main, type='TOPReconstructor', numberOfThreads=numberOfThreads)
+    collector = CollectResults()
+    main.add_module(collector)
+
+    b2.process(main)
+    return collector.results
+
+
+singleThread = reconstruct(1)
+multiThread = reconstruct(4)
+
+if len(singleThread) != len(multiThread):
+    b2.B2FATAL("Different number of events with one and with several threads")
+for event, (single, multi) in enumerate(zip(singleThread, multiThread)):
+    if single[0] != multi[0]:
+        b2.B2FATAL(f"TOPBunchFinder: different results with one and with several threads in event {event}")
+    if single[1] != multi[1]:
+        b2.B2FATAL(f"TOPReconstructor: different likelihoods with one and with several threads in event {event}")
+if not any(likelihoods for bunch, likelihoods in singleThread):
+    b2.B2FATAL("No TOPLikelihoods were produced, the test is meaningless")
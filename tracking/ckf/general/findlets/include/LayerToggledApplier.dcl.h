@@ -33,7 +33,14 @@ namespace Belle2 {
     void apply(const std::vector<TrackingUtilities::WithWeight<const AState*>>& currentPath,
                std::vector<TrackingUtilities::WithWeight<AState*>>& childStates) override;
 
+    /// Hand the paths to the subfilter of the geometrical layer of their last state, each subfilter getting all of its paths at once.
+    void applyBatch(const std::vector<std::vector<TrackingUtilities::WithWeight<const AState*>>>& paths,
+                    std::vector<std::vector<TrackingUtilities::WithWeight<AState*>>>& childStates) override;
+
   private:
+    /// The subfilter for the geometrical layer of the given state
+    AFindlet& getFindlet(const AState& previousState);
+
     /// Findlet used for layers > N
     AFindlet m_highLayerFindlet;
     /// Findlet used for layers == N
@@ -11,6 +11,8 @@
 #include <tracking/ckf/general/findlets/OnStateApplier.icc.h>
 #include <tracking/trackingUtilities/utilities/StringManipulation.h>
 
+#include <utility>
+
 namespace Belle2 {
 
   /// Add the subfilters as listeners.
@@ -42,14 +44,62 @@ namespace Belle2 {
                                                     std::vector<TrackingUtilities::WithWeight<AState*>>& childStates)
   {
     const AState* previousState = currentPath.back();
-    const int layer = previousState->getGeometricalLayer();
+    getFindlet(*previousState).apply(currentPath, childStates);
+  }
+
+  /// Hand the paths to the subfilter of the geometrical layer of their last state, each subfilter getting all of its paths at once.
+  template <class AState, class AFindlet>
+  void LayerToggledApplier<AState, AFindlet>::applyBatch(const
+                                                         std::vector<std::vector<TrackingUtilities::WithWeight<const AState*>>>& paths,
+                                                         std::vector<std::vector<TrackingUtilities::WithWeight<AState*>>>& childStates)
+  {
+    std::vector<AFindlet*> findlets;
+    findlets.reserve(paths.size());
+    for (const std::vector<TrackingUtilities::WithWeight<const AState*>>& path : paths) {
+      const AState* previousState = path.back();
+      findlets.push_back(&getFindlet(*previousState));
+    }
+
+    for (AFindlet* findlet : {&m_highLayerFindlet, &m_equalLayerFindlet, &m_lowLayerFindlet}) {
+      std::vector<unsigned int> findletPathIndices;
+      for (unsigned int iPath = 0; iPath < paths.size(); ++iPath) {
+        if (findlets[iPath] == findlet) {
+          findletPathIndices.push_back(iPath);
+        }
+      }
+
+      if (findletPathIndices.empty()) {
+        continue;
+      } else if (findletPathIndices.size() == paths.size()) {
+        findlet->applyBatch(paths, childStates);
+        return;
+      }
+
+      std::vector<std::vector<TrackingUtilities::WithWeight<const AState*>>> findletPaths;
+      std::vector<std::vector<TrackingUtilities::WithWeight<AState*>>> findletChildStates;
+      for (unsigned int iPath : findletPathIndices) {
+        findletPaths.push_back(paths[iPath]);
+        findletChildStates.push_back(std::move(childStates[iPath]));
+      }
+      findlet->applyBatch(findletPaths, findletChildStates);
+      for (unsigned int iFindletPath = 0; iFindletPath < findletPathIndices.size(); ++iFindletPath) {
+        childStates[findletPathIndices[iFindletPath]] = std::move(findletChildStates[iFindletPath]);
+      }
+    }
+  }
+
+  /// The subfilter for the geometrical layer of the given state
+  template <class AState, class AFindlet>
+  AFindlet& LayerToggledApplier<AState, AFindlet>::getFindlet(const AState& previousState)
+  {
+    const int layer = previousState.getGeometricalLayer();
 
     if (layer > m_param_toggleOnLayer) {
-      m_highLayerFindlet.apply(currentPath, childStates);
+      return m_highLayerFindlet;
     } else if (layer == m_param_toggleOnLayer) {
-      m_equalLayerFindlet.apply(currentPath, childStates);
+      return m_equalLayerFindlet;
     } else {
-      m_lowLayerFindlet.apply(currentPath, childStates);
+      return m_lowLayerFindlet;
     }
   }
 }
@@ -41,13 +41,24 @@ namespace Belle2 {
     void apply(const std::vector<TrackingUtilities::WithWeight<const AState*>>& currentPath,
                std::vector<TrackingUtilities::WithWeight<AState*>>& childStates) override;
 
+    /// Apply the filter to all pairs of states and paths at once and let only pass the best N states of each path.
+    void applyBatch(const std::vector<std::vector<TrackingUtilities::WithWeight<const AState*>>>& paths,
+                    std::vector<std::vector<TrackingUtilities::WithWeight<AState*>>>& childStates) override;
+
     /// Copy the filter operator to this method
     TrackingUtilities::Weight operator()(const Object& object) override;
 
     /// Expose the parameters of the subfindlet
     void exposeParameters(ModuleParamList* moduleParamList, const std::string& prefix) override ;
 
+  protected:
+    /// Hand all objects to the filter at once
+    std::vector<float> getWeights(const std::vector<Object*>& objects) override;
+
   private:
+    /// Delete all but the best N states
+    void keepBestStates(std::vector<TrackingUtilities::WithWeight<AState*>>& childStates) const;
+
     /// Parameter how many objects should pass maximal
     int m_param_useNStates = 0;
 
@@ -27,7 +27,23 @@ namespace Belle2 {
                                                      std::vector<TrackingUtilities::WithWeight<AState*>>& childStates)
   {
     Super::apply(currentPath, childStates);
+    keepBestStates(childStates);
+  };
+
+  template <class AState, class AFilter>
+  void LimitedOnStateApplier<AState, AFilter>::applyBatch(const std::vector<std::vector<TrackingUtilities::WithWeight<const AState*>>>&
+                                                          paths,
+                                                          std::vector<std::vector<TrackingUtilities::WithWeight<AState*>>>& childStates)
+  {
+    Super::applyBatch(paths, childStates);
+    for (std::vector<TrackingUtilities::WithWeight<AState*>>& states : childStates) {
+      keepBestStates(states);
+    }
+  };
 
+  template <class AState, class AFilter>
+  void LimitedOnStateApplier<AState, AFilter>::keepBestStates(std::vector<TrackingUtilities::WithWeight<AState*>>& childStates) const
+  {
     if (m_param_useNStates > 0 and childStates.size() > static_cast<unsigned int>(m_param_useNStates)) {
       std::sort(childStates.begin(), childStates.end(), TrackingUtilities::LessOf<TrackingUtilities::GetWeight>());
       childStates.erase(childStates.begin() + m_param_useNStates, childStates.end());
@@ -40,6 +56,12 @@ namespace Belle2 {
     return m_filter(object);
   };
 
+  template <class AState, class AFilter>
+  std::vector<float> LimitedOnStateApplier<AState, AFilter>::getWeights(const std::vector<Object*>& objects)
+  {
+    return m_filter(objects);
+  };
+
   template <class AState, class AFilter>
   void LimitedOnStateApplier<AState, AFilter>::exposeParameters(ModuleParamList* moduleParamList, const std::string& prefix)
   {
@@ -20,6 +20,10 @@ namespace Belle2 {
    * Helper findlet which applies its () operator to all pairs of path and state with all states in the given
    * child state list. It deletes all states in the list, where the operator () return NAN.
    * Should probably be overloaded in derived classes.
+   *
+   * With applyBatch, the child states of several paths are handled at once. All pairs of path and
+   * state are then given to getWeights together, which derived classes can overload to e.g. evaluate an MVA
+   * on all of them in one go.
    */
   template <class AState>
   class OnStateApplier : public
@@ -37,7 +41,15 @@ namespace Belle2 {
     void apply(const std::vector<TrackingUtilities::WithWeight<const AState*>>& currentPath,
                std::vector<TrackingUtilities::WithWeight<AState*>>& childStates) override;
 
+    /// Apply the () operator to all pairs of path and state for all paths at once, childStates[i] being the children of paths[i].
+    virtual void applyBatch(const std::vector<std::vector<TrackingUtilities::WithWeight<const AState*>>>& paths,
+                            std::vector<std::vector<TrackingUtilities::WithWeight<AState*>>>& childStates);
+
     /// The filter operator for this class
     virtual TrackingUtilities::Weight operator()(const Object& object);
+
+  protected:
+    /// The weights of all given objects, by default the () operator applied to each of them.
+    virtual std::vector<float> getWeights(const std::vector<Object*>& objects);
   };
 }
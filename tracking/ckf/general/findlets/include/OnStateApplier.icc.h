@@ -29,9 +29,57 @@ namespace Belle2 {
     TrackingUtilities::erase_remove_if(childStates, TrackingUtilities::HasNaNWeight());
   };
 
+  template <class AState>
+  void OnStateApplier<AState>::applyBatch(const std::vector<std::vector<TrackingUtilities::WithWeight<const AState*>>>& paths,
+                                          std::vector<std::vector<TrackingUtilities::WithWeight<AState*>>>& childStates)
+  {
+    unsigned int numberOfObjects = 0;
+    for (const std::vector<TrackingUtilities::WithWeight<AState*>>& states : childStates) {
+      numberOfObjects += states.size();
+    }
+    if (numberOfObjects == 0) {
+      return;
+    }
+
+    // The objects hold a copy of their path, so they must not be moved around after creation
+    std::vector<Object> objects;
+    objects.reserve(numberOfObjects);
+    std::vector<Object*> objectPointers;
+    objectPointers.reserve(numberOfObjects);
+    for (unsigned int iPath = 0; iPath < paths.size(); ++iPath) {
+      for (TrackingUtilities::WithWeight<AState*>& stateWithWeight : childStates[iPath]) {
+        AState& state = *stateWithWeight;
+        objects.emplace_back(paths[iPath], &state);
+        objectPointers.push_back(&objects.back());
+      }
+    }
+
+    const std::vector<float> weights = getWeights(objectPointers);
+
+    unsigned int iObject = 0;
+    for (std::vector<TrackingUtilities::WithWeight<AState*>>& states : childStates) {
+      for (TrackingUtilities::WithWeight<AState*>& stateWithWeight : states) {
+        stateWithWeight.setWeight(weights[iObject]);
+        ++iObject;
+      }
+      TrackingUtilities::erase_remove_if(states, TrackingUtilities::HasNaNWeight());
+    }
+  };
+
   template <class AState>
   TrackingUtilities::Weight OnStateApplier<AState>::operator()(const Object& object __attribute__((unused)))
   {
     return NAN;
   };
+
+  template <class AState>
+  std::vector<float> OnStateApplier<AState>::getWeights(const std::vector<Object*>& objects)
+  {
+    std::vector<float> weights;
+    weights.reserve(objects.size());
+    for (const Object* object : objects) {
+      weights.push_back(this->operator()(*object));
+    }
+    return weights;
+  };
 }
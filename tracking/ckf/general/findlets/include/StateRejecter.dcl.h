@@ -29,6 +29,9 @@ namespace Belle2 {
    * All filters get as input the current path and the full list of child states, so it
    * is possible to look for the best N states etc. The filters themselves are responsible
    * for deleting the not-wanted states.
+   *
+   * With applyBatch, the child states of several paths are handed to each filter together, so e.g. an MVA
+   * filter is evaluated once for all of them.
    */
   template <class AState, class AFilter>
   class StateRejecter : public
@@ -49,6 +52,10 @@ namespace Belle2 {
     void apply(const std::vector<TrackingUtilities::WithWeight<const AState*>>& currentPath,
                std::vector<TrackingUtilities::WithWeight<AState*>>& childStates) final;
 
+    /// Apply all five filters to the child states of all paths, childStates[i] being the child states of paths[i].
+    void applyBatch(const std::vector<std::vector<TrackingUtilities::WithWeight<const AState*>>>& paths,
+                    std::vector<std::vector<TrackingUtilities::WithWeight<AState*>>>& childStates);
+
   private:
     /// State filter to decide which available continuations should be traversed next.
     AFilter m_firstFilter;
@@ -11,6 +11,7 @@
 #include <tracking/trackingUtilities/utilities/StringManipulation.h>
 #include <framework/logging/Logger.h>
 
+#include <algorithm>
 
 namespace Belle2 {
   template <class AState, class AFindlet>
@@ -66,4 +67,20 @@ namespace Belle2 {
     m_thirdFilter.apply(currentPath, childStates);
     B2DEBUG(29, "After third filter " << childStates.size() << " states.");
   };
+  template <class AState, class AFindlet>
+  void StateRejecter<AState, AFindlet>::applyBatch(const std::vector<std::vector<TrackingUtilities::WithWeight<const AState*>>>& paths,
+                                                   std::vector<std::vector<TrackingUtilities::WithWeight<AState*>>>& childStates)
+  {
+    const auto noStates = [](const std::vector<TrackingUtilities::WithWeight<AState*>>& states) {
+      return states.empty();
+    };
+
+    for (AFindlet* filter : {&m_firstFilter, &m_advanceFilter, &m_secondFilter, &m_updateFilter, &m_thirdFilter}) {
+      // Nothing to do anymore
+      if (std::all_of(childStates.begin(), childStates.end(), noStates)) {
+        return;
+      }
+      filter->applyBatch(paths, childStates);
+    }
+  };
 }
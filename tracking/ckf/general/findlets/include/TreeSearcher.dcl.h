@@ -11,6 +11,7 @@
 
 #include <tracking/trackingUtilities/utilities/WeightedRelation.h>
 #include <tracking/trackingUtilities/numerics/WithWeight.h>
+#include <tracking/trackingUtilities/numerics/Weight.h>
 
 #include <tracking/trackingUtilities/ca/CellularAutomaton.h>
 
@@ -28,6 +29,12 @@ namespace Belle2 {
    * This rejector is allowed to alter the states, so using a cellular automaton it is assured,
    * that the states are traversed in the correct order without overriding each other.
    * It is however crucial, that the relations do not create cycles in the graph!
+   *
+   * By default the full tree is traversed depth first. If beamWidth is set, the tree of each seed is traversed
+   * breadth first instead: all paths of the same length are extended at once and only the beamWidth paths with the
+   * largest sum of state weights are extended further. The state rejecter gets the children of all paths of one length
+   * at once. As one state can be part of several of these paths, each path extends a copy of it, and the paths share
+   * the copies of their common first states.
    */
   template <class AState, class AStateRejecter, class AResult>
   class TreeSearcher : public
@@ -60,6 +67,48 @@ namespace Belle2 {
                       const std::vector<TrackingUtilities::WeightedRelation<AState>>& relations,
                       std::vector<AResult>& results);
 
+    /// Traverse the tree of one seed breadth first, keeping only the best beamWidth paths of each length
+    void traverseTreeWithBeam(const AState& seedState,
+                              const std::vector<TrackingUtilities::WeightedRelation<AState>>& relations,
+                              std::vector<AResult>& results);
+
+    /**
+     * The states of the beam search of one seed, which are the same number of steps away from the seed.
+     * A path is given by its last state, the previous states are found following the parent indices.
+     */
+    struct BeamLayer {
+      /// Copies of the states, as their fit results depend on the path leading to them
+      std::vector<AState> states;
+      /// The states these are copies of, which are used in the relations
+      std::vector<const AState*> originalStates;
+      /// Index of the previous state of the path in the previous layer (not used in the first layer, which follows the seed)
+      std::vector<unsigned int> parentIndices;
+      /// Weights of the states
+      std::vector<TrackingUtilities::Weight> weights;
+      /// Sum of the weights of the states of the path up to the state
+      std::vector<TrackingUtilities::Weight> weightSums;
+      /// Indices of the states, whose paths are extended further
+      std::vector<unsigned int> beam;
+
+      /// Remove all states
+      void clear()
+      {
+        states.clear();
+        originalStates.clear();
+        parentIndices.clear();
+        weights.clear();
+        weightSums.clear();
+        beam.clear();
+      }
+    };
+
+    /// Write the path ending with the given state of the last of the given number of beam layers into path
+    void collectPath(const AState& seedState, unsigned int numberOfLayers, unsigned int index,
+                     std::vector<TrackingUtilities::WithWeight<const AState*>>& path) const;
+
+    /// Check whether the state is on the path ending with the given state of the last of the given number of beam layers
+    bool isOnPath(const AState* state, const AState& seedState, unsigned int numberOfLayers, unsigned int index) const;
+
   private:
     /// State rejecter to decide which available continuations should be traversed next.
     AStateRejecter m_stateRejecter;
@@ -69,5 +118,17 @@ namespace Belle2 {
 
     /// Parameter: Make it possible to have all subresults in the end results vector.
     bool m_param_endEarly = true;
+
+    /// Parameter: Number of paths per seed kept in the breadth first beam search, 0 for the depth first search of all paths.
+    int m_param_beamWidth = 0;
+
+    /// States of the beam search of the current seed
+    std::vector<BeamLayer> m_beamLayers;
+
+    /// Paths of the current length in the beam search
+    std::vector<std::vector<TrackingUtilities::WithWeight<const AState*>>> m_beamPaths;
+
+    /// Child states of the paths of the current length in the beam search
+    std::vector<std::vector<TrackingUtilities::WithWeight<AState*>>> m_beamChildStates;
   };
 }
@@ -17,6 +17,8 @@
 
 #include <framework/core/ModuleParamList.templateDetails.h>
 
+#include <algorithm>
+
 namespace Belle2 {
   template <class AState, class AStateRejecter, class AResult>
   TreeSearcher<AState, AStateRejecter, AResult>::TreeSearcher() : Super()
@@ -32,6 +34,12 @@ namespace Belle2 {
     moduleParamList->addParameter(TrackingUtilities::prefixed(prefix, "endEarly"), m_param_endEarly,
                                   "Make it possible to have all subresults in the end result vector.",
                                   m_param_endEarly);
+
+    moduleParamList->addParameter(TrackingUtilities::prefixed(prefix, "beamWidth"), m_param_beamWidth,
+                                  "If larger than 0, search the paths of each seed breadth first and only extend the "
+                                  "beamWidth paths with the largest sum of state weights of each length, "
+                                  "which bounds the number of extrapolations per seed. With 0 all paths are searched depth first.",
+                                  m_param_beamWidth);
   }
 
   template <class AState, class AStateRejecter, class AResult>
@@ -43,6 +51,15 @@ namespace Belle2 {
     B2ASSERT("Expected relation to be sorted",
              std::is_sorted(relations.begin(), relations.end()));
 
+    if (m_param_beamWidth > 0) {
+      for (const AState& state : seededStates) {
+        B2DEBUG(29, "Starting beam search with new seed...");
+        traverseTreeWithBeam(state, relations, results);
+        B2DEBUG(29, "... finished with seed");
+      }
+      return;
+    }
+
     // TODO: May be better to just do this for each seed separately
     const std::vector<AState*>& statePointers = TrackingUtilities::as_pointers<AState>(hitStates);
     m_automaton.applyTo(statePointers, relations);
@@ -126,4 +143,131 @@ namespace Belle2 {
       path.pop_back();
     }
   }
+
+  template <class AState, class AStateRejecter, class AResult>
+  void TreeSearcher<AState, AStateRejecter, AResult>::traverseTreeWithBeam(const AState& seedState,
+      const std::vector<TrackingUtilities::WeightedRelation<AState>>& relations,
+      std::vector<AResult>& results)
+  {
+    // The paths of the beam end with the states in beam of the last of these layers
+    unsigned int numberOfLayers = 0;
+
+    m_beamPaths.resize(1);
+    m_beamPaths.front().clear();
+    m_beamPaths.front().emplace_back(&seedState, 0);
+
+    std::vector<unsigned int> firstChildIndices;
+    while (not m_beamPaths.empty()) {
+      if (m_beamLayers.size() == numberOfLayers) {
+        m_beamLayers.emplace_back();
+      }
+      BeamLayer& nextLayer = m_beamLayers[numberOfLayers];
+      const BeamLayer* currentLayer = numberOfLayers > 0 ? &m_beamLayers[numberOfLayers - 1] : nullptr;
+      nextLayer.clear();
+
+      // Copy all continuations first, as the copies must not move anymore once the paths point to them
+      firstChildIndices.clear();
+      for (unsigned int iPath = 0; iPath < m_beamPaths.size(); ++iPath) {
+        if (m_param_endEarly) {
+          // Make it possible to end earlier (with less hits)
+          results.emplace_back(m_beamPaths[iPath]);
+        }
+
+        const unsigned int currentIndex = currentLayer ? currentLayer->beam[iPath] : 0;
+        const AState* currentState = currentLayer ? currentLayer->originalStates[currentIndex] : &seedState;
+        auto continuations =
+          TrackingUtilities::asRange(std::equal_range(relations.begin(), relations.end(), currentState));
+
+        firstChildIndices.push_back(nextLayer.states.size());
+        for (const TrackingUtilities::WeightedRelation<AState>& continuation : continuations) {
+          const AState* childState = continuation.getTo();
+          if (isOnPath(childState, seedState, numberOfLayers, currentIndex)) {
+            B2FATAL("Cycle detected!");
+          }
+          // the state may still include information from an other round of processing, so lets set it back
+          nextLayer.states.push_back(*childState);
+          nextLayer.states.back().reset();
+          nextLayer.originalStates.push_back(childState);
+          nextLayer.parentIndices.push_back(currentIndex);
+          nextLayer.weights.push_back(continuation.getWeight());
+        }
+      }
+      firstChildIndices.push_back(nextLayer.states.size());
+
+      m_beamChildStates.resize(m_beamPaths.size());
+      for (unsigned int iPath = 0; iPath < m_beamPaths.size(); ++iPath) {
+        std::vector<TrackingUtilities::WithWeight<AState*>>& childStates = m_beamChildStates[iPath];
+        childStates.clear();
+        for (unsigned int iState = firstChildIndices[iPath]; iState < firstChildIndices[iPath + 1]; ++iState) {
+          childStates.emplace_back(&nextLayer.states[iState], nextLayer.weights[iState]);
+        }
+      }
+
+      // Extrapolate, filter and score the children of all paths together
+      m_stateRejecter.applyBatch(m_beamPaths, m_beamChildStates);
+
+      nextLayer.weightSums.resize(nextLayer.states.size(), 0);
+      for (unsigned int iPath = 0; iPath < m_beamPaths.size(); ++iPath) {
+        const std::vector<TrackingUtilities::WithWeight<AState*>>& childStates = m_beamChildStates[iPath];
+        if (childStates.empty()) {
+          B2DEBUG(29, "Terminating this route, as there are no possible child states.");
+          if (not m_param_endEarly) {
+            results.emplace_back(m_beamPaths[iPath]);
+          }
+          continue;
+        }
+
+        const TrackingUtilities::Weight weightSum = currentLayer ? currentLayer->weightSums[currentLayer->beam[iPath]] : 0;
+        for (const TrackingUtilities::WithWeight<AState*>& childState : childStates) {
+          const AState* state = childState;
+          const unsigned int index = state - nextLayer.states.data();
+          nextLayer.weights[index] = childState.getWeight();
+          nextLayer.weightSums[index] = weightSum + childState.getWeight();
+          nextLayer.beam.push_back(index);
+        }
+      }
+
+      std::vector<unsigned int>& beam = nextLayer.beam;
+      if (beam.size() > static_cast<unsigned int>(m_param_beamWidth)) {
+        std::stable_sort(beam.begin(), beam.end(), [&nextLayer](unsigned int lhs, unsigned int rhs) {
+          return nextLayer.weightSums[lhs] > nextLayer.weightSums[rhs];
+        });
+        beam.erase(beam.begin() + m_param_beamWidth, beam.end());
+      }
+      B2DEBUG(29, "Extending " << beam.size() << " paths.");
+
+      ++numberOfLayers;
+      m_beamPaths.resize(beam.size());
+      for (unsigned int iPath = 0; iPath < beam.size(); ++iPath) {
+        collectPath(seedState, numberOfLayers, beam[iPath], m_beamPaths[iPath]);
+      }
+    }
+  }
+
+  template <class AState, class AStateRejecter, class AResult>
+  void TreeSearcher<AState, AStateRejecter, AResult>::collectPath(const AState& seedState, unsigned int numberOfLayers,
+      unsigned int index,
+      std::vector<TrackingUtilities::WithWeight<const AState*>>& path) const
+  {
+    path.assign(numberOfLayers + 1, TrackingUtilities::WithWeight<const AState*>(&seedState, 0));
+    for (unsigned int iLayer = numberOfLayers; iLayer > 0; --iLayer) {
+      const BeamLayer& layer = m_beamLayers[iLayer - 1];
+      path[iLayer] = TrackingUtilities::WithWeight<const AState*>(&layer.states[index], layer.weights[index]);
+      index = layer.parentIndices[index];
+    }
+  }
+
+  template <class AState, class AStateRejecter, class AResult>
+  bool TreeSearcher<AState, AStateRejecter, AResult>::isOnPath(const AState* state, const AState& seedState,
+      unsigned int numberOfLayers, unsigned int index) const
+  {
+    for (unsigned int iLayer = numberOfLayers; iLayer > 0; --iLayer) {
+      const BeamLayer& layer = m_beamLayers[iLayer - 1];
+      if (layer.originalStates[index] == state) {
+        return true;
+      }
+      index = layer.parentIndices[index];
+    }
+    return state == &seedState;
+  }
 }
@@ -0,0 +1,228 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+#include <gtest/gtest.h>
+
+#include <tracking/ckf/general/findlets/TreeSearcher.icc.h>
+
+#include <tracking/trackingUtilities/findlets/base/Findlet.h>
+#include <tracking/trackingUtilities/ca/AutomatonCell.h>
+#include <tracking/trackingUtilities/utilities/WeightedRelation.h>
+#include <tracking/trackingUtilities/numerics/WithWeight.h>
+#include <tracking/trackingUtilities/numerics/Weight.h>
+#include <tracking/trackingUtilities/numerics/WeightComperator.h>
+#include <tracking/trackingUtilities/utilities/Algorithms.h>
+
+#include <framework/core/ModuleParamList.h>
+
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+using namespace Belle2;
+using namespace TrackingUtilities;
+
+namespace {
+  /// State with a value, which is calculated from the path leading to it
+  class TestState {
+  public:
+    /// Create a state with the given id
+    explicit TestState(int id) : m_id(id) {}
+
+    /// The id of the state
+    int getId() const
+    {
+      return m_id;
+    }
+
+    /// The value calculated by the rejecter
+    int getValue() const
+    {
+      return m_value;
+    }
+
+    /// Set the value
+    void setValue(int value)
+    {
+      m_value = value;
+    }
+
+    /// The cell for the cellular automaton
+    AutomatonCell& getAutomatonCell()
+    {
+      return m_automatonCell;
+    }
+
+    /// Forget the value of the last path
+    void reset()
+    {
+      m_value = -1;
+    }
+
+  private:
+    /// The id of the state
+    int m_id;
+    /// The value of the state on the current path
+    int m_value = -1;
+    /// The cell for the cellular automaton
+    AutomatonCell m_automatonCell;
+  };
+
+  /// Path of states with their values and weights
+  class TestResult {
+  public:
+    /// Store the states of the path
+    explicit TestResult(const std::vector<WithWeight<const TestState*>>& path)
+    {
+      for (const WithWeight<const TestState*>& state : path) {
+        m_states.emplace_back(state->getId(), state->getValue(), state.getWeight());
+      }
+    }
+
+    /// Order by the states
+    bool operator<(const TestResult& other) const
+    {
+      return m_states < other.m_states;
+    }
+
+    /// Compare the states
+    bool operator==(const TestResult& other) const
+    {
+      return m_states == other.m_states;
+    }
+
+    /// Id, value and weight of each state of the path
+    std::vector<std::tuple<int, int, Weight>> m_states;
+  };
+
+  /// Rejecter giving the states a value depending on their path and dropping some of them
+  class TestStateRejecter : public Findlet<const WithWeight<const TestState*>, WithWeight<TestState*>> {
+  public:
+    /// Set the value and the weight of the child states and drop some of them
+    void apply(const std::vector<WithWeight<const TestState*>>& currentPath,
+               std::vector<WithWeight<TestState*>>& childStates) override
+    {
+      const int parentValue = currentPath.back()->getValue();
+      for (WithWeight<TestState*>& childState : childStates) {
+        const int value = parentValue + childState->getId() * static_cast<int>(currentPath.size());
+        childState->setValue(value);
+        childState.setWeight(value % 7 == 0 ? NAN : childState.getWeight() + value % 4);
+      }
+      erase_remove_if(childStates, HasNaNWeight());
+    }
+
+    /// Apply to the child states of all paths
+    void applyBatch(const std::vector<std::vector<WithWeight<const TestState*>>>& paths,
+                    std::vector<std::vector<WithWeight<TestState*>>>& childStates)
+    {
+      for (unsigned int iPath = 0; iPath < paths.size(); ++iPath) {
+        apply(paths[iPath], childStates[iPath]);
+      }
+    }
+  };
+
+  /// Acyclic graph of states, in which several paths lead to the same state
+  class TreeSearcherTest : public ::testing::Test {
+  protected:
+    /// Create the states and relations
+    void SetUp() override
+    {
+      m_seedStates.emplace_back(0);
+      m_seedStates.back().setValue(1);
+      for (int id = 1; id <= 8; ++id) {
+        m_hitStates.emplace_back(id);
+      }
+
+      const std::vector<std::tuple<int, int, Weight>> connections = {
+        {0, 1, 1}, {0, 2, 3}, {0, 3, 2},
+        {1, 4, 1}, {1, 5, 2}, {2, 4, 2}, {2, 5, 1}, {3, 5, 3},
+        {4, 6, 2}, {4, 7, 1}, {5, 6, 1}, {5, 7, 3}, {5, 8, 1},
+        {6, 8, 2}, {7, 8, 1}
+      };
+      for (const auto& connection : connections) {
+        m_relations.emplace_back(getState(std::get<0>(connection)), std::get<2>(connection), getState(std::get<1>(connection)));
+      }
+      std::sort(m_relations.begin(), m_relations.end());
+    }
+
+    /// The state with the given id
+    TestState* getState(int id)
+    {
+      return id == 0 ? &m_seedStates.front() : &m_hitStates[id - 1];
+    }
+
+    /// Search the paths with the given parameters and return them sorted
+    std::vector<TestResult> search(int beamWidth, bool endEarly)
+    {
+      TreeSearcher<TestState, TestStateRejecter, TestResult> treeSearcher;
+      ModuleParamList moduleParamList;
+      treeSearcher.exposeParameters(&moduleParamList, "");
+      moduleParamList.setParameter("beamWidth", beamWidth);
+      moduleParamList.setParameter("endEarly", endEarly);
+
+      std::vector<TestResult> results;
+      treeSearcher.apply(m_seedStates, m_hitStates, m_relations, results);
+      std::sort(results.begin(), results.end());
+      return results;
+    }
+
+    /// The seed state
+    std::vector<TestState> m_seedStates;
+    /// The other states
+    std::vector<TestState> m_hitStates;
+    /// The relations between the states
+    std::vector<WeightedRelation<TestState>> m_relations;
+  };
+}
+
+/// A beam wider than the number of paths finds the same paths as the depth first search
+TEST_F(TreeSearcherTest, wideBeamFindsAllPaths)
+{
+  for (bool endEarly : {true, false}) {
+    const std::vector<TestResult> depthFirstResults = search(0, endEarly);
+    const std::vector<TestResult> beamResults = search(100, endEarly);
+
+    ASSERT_FALSE(depthFirstResults.empty());
+    EXPECT_EQ(depthFirstResults, beamResults);
+  }
+}
+
+/// A beam of width one follows the path with the largest weight sum of each length
+TEST_F(TreeSearcherTest, narrowBeamKeepsBestPath)
+{
+  const std::vector<TestResult> allResults = search(0, true);
+  const std::vector<TestResult> beamResults = search(1, true);
+
+  const auto weightSum = [](const TestResult & result) {
+    Weight sum = 0;
+    for (const auto& state : result.m_states) {
+      sum += std::get<2>(state);
+    }
+    return sum;
+  };
+  const auto isPrefix = [](const TestResult & prefix, const TestResult & result) {
+    return prefix.m_states.size() <= result.m_states.size() and
+           std::equal(prefix.m_states.begin(), prefix.m_states.end(), result.m_states.begin());
+  };
+
+  // The beam is a single path, each result is the path up to one length
+  ASSERT_GT(beamResults.size(), 2u);
+  for (unsigned int iResult = 0; iResult < beamResults.size(); ++iResult) {
+    EXPECT_EQ(iResult + 1, beamResults[iResult].m_states.size());
+    EXPECT_TRUE(isPrefix(beamResults[iResult], beamResults.back()));
+    EXPECT_NE(std::find(allResults.begin(), allResults.end(), beamResults[iResult]), allResults.end());
+  }
+
+  // Each step takes the best extension of the path kept before
+  for (unsigned int iResult = 1; iResult < beamResults.size(); ++iResult) {
+    for (const TestResult& result : allResults) {
+      if (result.m_states.size() == iResult + 1 and isPrefix(beamResults[iResult - 1], result)) {
+        EXPECT_LE(weightSum(result), weightSum(beamResults[iResult]));
+      }
+    }
+  }
+}
@@ -0,0 +1,85 @@
+##########################################################################
+# basf2 (Belle II Analysis Software Framework)                           #
+# Author: The Belle II Collaboration                                     #
+#                                                                        #
+# See git log for contributors and copyright holders.                    #
+# This file is licensed under LGPL-3.0, see LICENSE.md.                  #
+##########################################################################
+
+# Time per event of the CATFinder on synthetic high background CDC hit sets.
+# Mu pair events are simulated without beam background, afterwards a given number of
+# random noise CDCHits on distinct wires is added to every event before the CDC wire hits
+# are prepared and the CATFinder is run. The mean time per event of the CATFinder is printed
+# for every number of noise hits.
+
+import random
+
+import basf2 as b2
+import generators as ge
+import simulation as si
+
+numberOfEvents = 50
+numbersOfNoiseHits = [0, 1000, 2000, 4000, 8000]
+
+#: Number of layers and wires per layer of each superlayer
+superLayers = [(8, 160), (6, 160), (6, 192), (6, 224), (6, 256), (6, 288), (6, 320), (6, 352), (6, 384)]
+
+
+class AddNoiseCDCHits(b2.Module):
+    """Add random CDCHits on wires without a hit"""
+
+    def __init__(self, nNoiseHits):
+        """Constructor with the number of noise hits per event"""
+        super().__init__()
+        #: Number of noise hits per event
+        self.nNoiseHits = nNoiseHits
+        #: All wires as (superlayer, layer, wire)
+        self.wires = [(iSuperLayer, iLayer, iWire)
+                      for iSuperLayer, (nLayers, nWires) in enumerate(superLayers)
+                      for iLayer in range(nLayers)
+                      for iWire in range(nWires)]
+
+    def initialize(self):
+        """Require the CDCHits"""
+        import ROOT  # noqa
+        #: The CDCHits
+        self.cdcHits = ROOT.Belle2.PyStoreArray("CDCHits")
+        self.cdcHits.isRequired()
+
+    def event(self):
+        """Add the noise hits"""
+        usedWires = set()
+        for cdcHit in self.cdcHits:
+            usedWires.add((cdcHit.getISuperLayer(), cdcHit.getILayer(), cdcHit.getIWire()))
+        freeWires = [wire for wire in self.wires if wire not in usedWires]
+        for iSuperLayer, iLayer, iWire in random.sample(freeWires, min(self.nNoiseHits, len(freeWires))):
+            cdcHit = self.cdcHits.appendNew()
+            cdcHit.setWireID(iSuperLayer, iLayer, iWire)
+            cdcHit.setTDCCount(random.randint(4000, 5000))
+            cdcHit.setADCCount(random.randint(10, 200))
+
+
+def runCATFinder(nNoiseHits):
+    """Run the CATFinder on mu pair events with the given number of noise hits and return the time per event"""
+    b2.set_random_seed("cat")
+    random.seed(42)
+    path = b2.create_path()
+    path.add_module("EventInfoSetter", evtNumList=numberOfEvents)
+    ge.add_kkmc_generator(path, "mu-mu+")
+    si.add_simulation(path, bkgOverlay=False)
+    path.add_module(AddNoiseCDCHits(nNoiseHits))
+    path.add_module("TFCDC_WireHitPreparer",
+                    wirePosition="aligned",
+                    flightTimeEstimation="outwards",
+                    filter="all")
+    catFinder = path.add_module("CATFinder")
+    b2.process(path, calculateStatistics=True)
+
+    return b2.statistics.get(catFinder).time_mean(b2.statistics.EVENT) * 1e-6
+
+
+results = {nNoiseHits: runCATFinder(nNoiseHits) for nNoiseHits in numbersOfNoiseHits}
+
+print("noise hits, CATFinder [ms/event]")
+for nNoiseHits, time in results.items():
+    print(f"{nNoiseHits:10} {time:18.3f}")
@@ -0,0 +1,98 @@
+##########################################################################
+# basf2 (Belle II Analysis Software Framework)                           #
+# Author: The Belle II Collaboration                                     #
+#                                                                        #
+# See git log for contributors and copyright holders.                    #
+# This file is licensed under LGPL-3.0, see LICENSE.md.                  #
+##########################################################################
+
+# Speed and efficiency of the overlap resolution methods of the SVDOverlapResolver
+# (parameter ResolveMethod: "greedy", "hopfield" and "independentSet") on increasingly noisy events.
+# BBbar events are simulated with the beam background scaled by 0, 1, 2 and 4, afterwards the SVD only
+# VXDTF2 track finding is run on every sample with every method. Printed are the mean time per event of the
+# SVDOverlapResolver, the fraction of MC tracks found and the fraction of found tracks not matched to a MC track.
+# Needs the beam background files, see background.get_background_files().
+
+import basf2 as b2
+import background
+from simulation import add_simulation
+from tracking import add_hit_preparation_modules, add_vxd_track_finding_vxdtf2, add_mc_matcher
+from ROOT import Belle2
+
+numberOfEvents = 100
+backgroundScaleFactors = [0, 1, 2, 4]
+resolveMethods = ["greedy", "hopfield", "independentSet"]
+
+
+def simulate(scaleFactor, fileName):
+    """Simulate BBbar events with the beam background scaled by the given factor"""
+    path = b2.create_path()
+    path.add_module("EventInfoSetter", expList=0, runList=1, evtNumList=numberOfEvents)
+    path.add_module("EvtGenInput")
+    if scaleFactor > 0:
+        add_simulation(path, bkgfiles=background.get_background_files(), bkgOverlay=False)
+        b2.set_module_parameters(path, "BeamBkgMixer", overallScaleFactor=scaleFactor)
+    else:
+        add_simulation(path, bkgOverlay=False)
+    path.add_module("RootOutput", outputFileName=fileName,
+                    branchNames=["EventMetaData", "SVDShaperDigits", "SVDTrueHits", "SVDSimHits", "MCParticles"])
+    b2.process(path)
+
+
+class CountMatchedTracks(b2.Module):
+    """Count the MC tracks, the found MC tracks and the found tracks not matched to a MC track"""
+
+    def __init__(self):
+        """Start counting at 0"""
+        super().__init__()
+        #: number of MC tracks
+        self.nMCTracks = 0
+        #: number of MC tracks with a matched found track
+        self.nFoundMCTracks = 0
+        #: number of found tracks
+        self.nTracks = 0
+        #: number of found tracks which are neither matched nor clones
+        self.nFakeTracks = 0
+
+    def event(self):
+        """Add the tracks of the event"""
+        for mcRecoTrack in Belle2.PyStoreArray("MCRecoTracks"):
+            self.nMCTracks += 1
+            if mcRecoTrack.getRelated("RecoTracks"):
+                self.nFoundMCTracks += 1
+        for recoTrack in Belle2.PyStoreArray("RecoTracks"):
+            self.nTracks += 1
+            if recoTrack.getMatchingStatus() not in (Belle2.RecoTrack.c_matched, Belle2.RecoTrack.c_clone):
+                self.nFakeTracks += 1
+
+
+def findTracks(fileName, resolveMethod):
+    """Run the SVD only VXDTF2 with the given overlap resolution method"""
+    path = b2.create_path()
+    path.add_module("RootInput", inputFileName=fileName)
+    path.add_module("Gearbox")
+    path.add_module("Geometry", useDB=True)
+    add_hit_preparation_modules(path, components=["SVD"])
+    add_vxd_track_finding_vxdtf2(path, components=["SVD"])
+    b2.set_module_parameters(path, "SVDOverlapResolver", ResolveMethod=resolveMethod)
+    add_mc_matcher(path, components=["SVD"], relate_tracks_to_mcparticles=False)
+    counter = CountMatchedTracks()
+    path.add_module(counter)
+    b2.process(path, calculateStatistics=True)
+
+    overlapResolver = next(module for module in path.modules() if module.type() == "SVDOverlapResolver")
+    return (b2.statistics.get(overlapResolver).time_mean(b2.statistics.EVENT) * 1e-6,
+            counter.nFoundMCTracks / max(counter.nMCTracks, 1),
+            counter.nFakeTracks / max(counter.nTracks, 1))
+
+
+results = {}
+for scaleFactor in backgroundScaleFactors:
+    fileName = f"overlapResolverBenchmark_bkg{scaleFactor}.root"
+    simulate(scaleFactor, fileName)
+    for resolveMethod in resolveMethods:
+        results[scaleFactor, resolveMethod] = findTracks(fileName, resolveMethod)
+
+print("background scale, method, overlap resolver [ms/event], finding efficiency, fake rate")
+for (scaleFactor, resolveMethod), (time, efficiency, fakeRate) in results.items():
+    print(f"{scaleFactor:16} {resolveMethod:>14} {time:26.3f} {efficiency:18.3f} {fakeRate:9.3f}")
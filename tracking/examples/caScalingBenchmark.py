@@ -0,0 +1,70 @@
+##########################################################################
+# basf2 (Belle II Analysis Software Framework)                           #
+# Author: The Belle II Collaboration                                     #
+#                                                                        #
+# See git log for contributors and copyright holders.                    #
+# This file is licensed under LGPL-3.0, see LICENSE.md.                  #
+##########################################################################
+
+# Scaling of the cellular automata of the CDC track finding with the number of threads
+# (parameters FacetPathCaThreads and SegmentPairRelationCaThreads) on increasingly noisy events.
+# BBbar events are simulated with the beam background scaled by 0, 1, 2 and 4, afterwards the
+# CDC segment and track finding is run on every sample with 0 (depth first automaton), 1, 2, 4 and 8 threads.
+# The mean time per event of the two automaton modules is printed at the end.
+# Needs the beam background files, see background.get_background_files().
+
+import basf2 as b2
+import background
+from simulation import add_simulation
+
+numberOfEvents = 100
+backgroundScaleFactors = [0, 1, 2, 4]
+numbersOfThreads = [0, 1, 2, 4, 8]
+
+
+def simulate(scaleFactor, fileName):
+    """Simulate BBbar events with the beam background scaled by the given factor"""
+    path = b2.create_path()
+    path.add_module("EventInfoSetter", expList=0, runList=1, evtNumList=numberOfEvents)
+    path.add_module("EvtGenInput")
+    if scaleFactor > 0:
+        add_simulation(path, bkgfiles=background.get_background_files(), bkgOverlay=False)
+        b2.set_module_parameters(path, "BeamBkgMixer", overallScaleFactor=scaleFactor)
+    else:
+        add_simulation(path, bkgOverlay=False)
+    path.add_module("RootOutput", outputFileName=fileName, branchNames=["EventMetaData", "CDCHits", "MCParticles"])
+    b2.process(path)
+
+
+def findTracks(fileName, nThreads):
+    """Run the CDC segment and track finding with the given number of threads of the cellular automata"""
+    path = b2.create_path()
+    path.add_module("RootInput", inputFileName=fileName)
+    path.add_module("Gearbox")
+    path.add_module("Geometry", useDB=True)
+    path.add_module("TFCDC_WireHitPreparer",
+                    wirePosition="aligned",
+                    flightTimeEstimation="outwards",
+                    filter="all")
+    path.add_module("TFCDC_ClusterPreparer",
+                    ClusterFilter="all",
+                    ClusterFilterParameters={})
+    segmentFinder = path.add_module("TFCDC_SegmentFinderFacetAutomaton",
+                                    FacetPathCaThreads=nThreads)
+    trackFinder = path.add_module("TFCDC_TrackFinderSegmentPairAutomaton",
+                                  SegmentPairRelationCaThreads=nThreads)
+    b2.process(path, calculateStatistics=True)
+
+    return [b2.statistics.get(module).time_mean(b2.statistics.EVENT) * 1e-6 for module in (segmentFinder, trackFinder)]
+
+
+results = {}
+for scaleFactor in backgroundScaleFactors:
+    fileName = f"caScalingBenchmark_bkg{scaleFactor}.root"
+    simulate(scaleFactor, fileName)
+    for nThreads in numbersOfThreads:
+        results[scaleFactor, nThreads] = findTracks(fileName, nThreads)
+
+print("background scale, threads, segment finder [ms/event], segment pair track finder [ms/event]")
+for (scaleFactor, nThreads), (segmentTime, trackTime) in results.items():
+    print(f"{scaleFactor:16} {nThreads:8} {segmentTime:28.3f} {trackTime:38.3f}")
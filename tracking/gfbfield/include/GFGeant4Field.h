@@ -30,8 +30,24 @@ public:
    */
   TVector3 get(const TVector3& position) const override
   {
+    double field[3];
+    get(position.X(), position.Y(), position.Z(), field[0], field[1], field[2]);
+    return TVector3(field[0], field[1], field[2]);
+  }
+
+  /** Getter for the magnetic field without the TVector3 conversions.
+   *
+   *  Uses the precomputed field grid of the BFieldManager if one is set up (see SetupGenfitExtrapolation).
+   */
+  void get(const double& posX, const double& posY, const double& posZ, double& Bx, double& By, double& Bz) const override
+  {
+    const double position[3] = {posX, posY, posZ};
     static double conversion{1. / Belle2::Unit::kGauss};
-    return Belle2::B2Vector3D(Belle2::BFieldManager::getField(ROOT::Math::XYZVector(position)) * conversion);
+    double field[3];
+    Belle2::BFieldManager::getGridField(position, field);
+    Bx = field[0] * conversion;
+    By = field[1] * conversion;
+    Bz = field[2] * conversion;
   }
 };
 
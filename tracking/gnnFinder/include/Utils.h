@@ -9,7 +9,10 @@
 
 #include <Math/Vector3D.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <vector>
 
 namespace Belle2::GNNFinder::Utils {
@@ -209,6 +212,107 @@ namespace Belle2::GNNFinder::Utils {
     ~HitOrderer() = default;
   };
 
+  /**
+  * @class LatentSpaceGrid
+  * @brief Uniform grid over points in the three dimensional latent (clustering) space.
+  *
+  * Used by the condensation step to find the points close to a condensation point without
+  * looping over all points of the event. The points are sorted into cubic cells with the
+  * given size, which are hashed into a number of buckets proportional to the number of points,
+  * so the grid works for any extent of the latent space. A query visits the 27 cells around
+  * the query point and hence returns all points closer than the cell size, but also farther
+  * ones, which have to be rejected by the caller.
+  *
+  * The grid is meant to be rebuilt every event, the memory is kept between the builds.
+  */
+  class LatentSpaceGrid {
+  public:
+    /**
+     * @brief Sorts the points into the cells.
+     *
+     * Points with non finite coordinates are ignored.
+     *
+     * @param coordinates Coordinates of all points, three consecutive values per point.
+     * @param pointIndices Indices of the points to insert.
+     * @param cellSize Size of the cells, must be at least the largest radius queried later.
+     */
+    void build(const float* coordinates, const std::vector<unsigned int>& pointIndices, const float cellSize);
+
+    /**
+     * @brief Calls the function with the index of every point in the cells around the query point.
+     *
+     * Every point is passed at most once, in no particular order.
+     * Nothing is passed for non finite query points.
+     *
+     * @param point Coordinates of the query point.
+     * @param function Function taking the index of a point.
+     */
+    template<class AFunction>
+    void forEachNearbyPoint(const float* point, AFunction&& function) const
+    {
+      if (m_bucketOffsets.empty())
+        return;
+      int64_t cell[3];
+      if (not getCell(point, cell))
+        return;
+
+      // Neighbouring cells can share a bucket, so visit each bucket only once
+      uint32_t visitedBuckets[27];
+      unsigned int nVisitedBuckets = 0;
+      for (int64_t dx = -1; dx <= 1; ++dx) {
+        for (int64_t dy = -1; dy <= 1; ++dy) {
+          for (int64_t dz = -1; dz <= 1; ++dz) {
+            const uint32_t bucket = getBucket(cell[0] + dx, cell[1] + dy, cell[2] + dz);
+            bool visited = false;
+            for (unsigned int iVisited = 0; iVisited < nVisitedBuckets; ++iVisited) {
+              visited |= visitedBuckets[iVisited] == bucket;
+            }
+            if (visited)
+              continue;
+            visitedBuckets[nVisitedBuckets++] = bucket;
+            for (uint32_t iEntry = m_bucketOffsets[bucket]; iEntry < m_bucketOffsets[bucket + 1]; ++iEntry) {
+              function(m_pointIndices[iEntry]);
+            }
+          }
+        }
+      }
+    }
+
+  private:
+    /** Computes the cell of a point, returns false for non finite coordinates. */
+    bool getCell(const float* point, int64_t* cell) const
+    {
+      for (int iDim = 0; iDim < 3; ++iDim) {
+        if (not std::isfinite(point[iDim]))
+          return false;
+        // Far away points share the outermost cells, which only costs some distance checks
+        const double scaledCoordinate = std::clamp(static_cast<double>(point[iDim]) * m_inverseCellSize, -1e9, 1e9);
+        cell[iDim] = static_cast<int64_t>(std::floor(scaledCoordinate));
+      }
+      return true;
+    }
+
+    /** Hashes a cell to a bucket. */
+    uint32_t getBucket(const int64_t cellX, const int64_t cellY, const int64_t cellZ) const
+    {
+      const uint64_t hash = static_cast<uint64_t>(cellX) * 73856093u
+                            ^ static_cast<uint64_t>(cellY) * 19349663u
+                            ^ static_cast<uint64_t>(cellZ) * 83492791u;
+      return static_cast<uint32_t>(hash & m_bucketMask);
+    }
+
+    /** Inverse of the cell size. */
+    double m_inverseCellSize = 1.;
+    /** Number of buckets minus one, the number of buckets is a power of two. */
+    uint64_t m_bucketMask = 0;
+    /** Start of the points of each bucket in m_pointIndices, one more entry than buckets. */
+    std::vector<uint32_t> m_bucketOffsets;
+    /** Indices of the points sorted by bucket. */
+    std::vector<unsigned int> m_pointIndices;
+    /** Bucket of each inserted point, only used during the build. */
+    std::vector<uint32_t> m_pointBuckets;
+  };
+
   /**
    * @brief Finds the first intersection of a straight-line ray with a cylinder of given radius.
    *
@@ -206,6 +206,48 @@ std::vector<int> HitOrderer::orderHits(const double startingX, const double star
   return sortedIndices;
 }
 
+void LatentSpaceGrid::build(const float* coordinates, const std::vector<unsigned int>& pointIndices, const float cellSize)
+{
+  B2ASSERT("The cells of the LatentSpaceGrid need a positive size", cellSize > 0);
+  // Slightly larger cells, so that rounding cannot move a point at a distance of exactly cellSize two cells away
+  m_inverseCellSize = 1. / (cellSize * (1. + 1e-6));
+
+  // About two buckets per point keeps the number of points per bucket small
+  uint64_t nBuckets = 1;
+  while (nBuckets < 2 * pointIndices.size())
+    nBuckets *= 2;
+  m_bucketMask = nBuckets - 1;
+
+  // Counting sort of the points by bucket
+  m_bucketOffsets.assign(nBuckets + 1, 0);
+  m_pointBuckets.clear();
+  int64_t cell[3];
+  for (unsigned int pointIndex : pointIndices) {
+    if (not getCell(coordinates + 3 * pointIndex, cell)) {
+      m_pointBuckets.push_back(nBuckets);
+      continue;
+    }
+    const uint32_t bucket = getBucket(cell[0], cell[1], cell[2]);
+    m_pointBuckets.push_back(bucket);
+    ++m_bucketOffsets[bucket + 1];
+  }
+  for (uint64_t iBucket = 0; iBucket < nBuckets; ++iBucket)
+    m_bucketOffsets[iBucket + 1] += m_bucketOffsets[iBucket];
+
+  // Fill the buckets, which moves each offset to the end of its bucket
+  m_pointIndices.resize(m_bucketOffsets[nBuckets]);
+  for (unsigned int i = 0; i < pointIndices.size(); ++i) {
+    const uint32_t bucket = m_pointBuckets[i];
+    if (bucket == nBuckets)
+      continue;
+    m_pointIndices[m_bucketOffsets[bucket]++] = pointIndices[i];
+  }
+  // Shift the offsets back to the start of each bucket
+  for (uint64_t iBucket = nBuckets; iBucket > 0; --iBucket)
+    m_bucketOffsets[iBucket] = m_bucketOffsets[iBucket - 1];
+  m_bucketOffsets[0] = 0;
+}
+
 std::pair<double, double> Belle2::GNNFinder::Utils::intersectCylinderXY(const ROOT::Math::XYZVector& pos,
     const ROOT::Math::XYZVector& mom,
     const double targetR)
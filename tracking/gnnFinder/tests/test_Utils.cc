@@ -8,8 +8,13 @@
 
 #include <tracking/gnnFinder/Utils.h>
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
 #include <numbers>
+#include <numeric>
+#include <random>
+#include <vector>
 
 #include <Math/Vector3D.h>
 
@@ -180,4 +185,66 @@ namespace {
     EXPECT_NEAR(y1, y2, 1e-9);
   }
 
+  TEST(LatentSpaceGridTest, FindsAllPointsInRadius)
+  {
+    // Random points in a region much larger than the cells, two of them with non finite coordinates
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> coordinate(-5, 5);
+    const unsigned int nPoints = 2000;
+    std::vector<float> coordinates(3 * nPoints);
+    for (float& value : coordinates)
+      value = coordinate(generator);
+    coordinates[0] = std::numeric_limits<float>::quiet_NaN();
+    coordinates[4] = std::numeric_limits<float>::infinity();
+    std::vector<unsigned int> pointIndices(nPoints);
+    std::iota(pointIndices.begin(), pointIndices.end(), 0);
+
+    const float radius = 0.4;
+    LatentSpaceGrid grid;
+    grid.build(coordinates.data(), pointIndices, radius);
+
+    auto distance = [&coordinates](unsigned int i, unsigned int j) {
+      return std::hypot(coordinates[3 * i] - coordinates[3 * j], coordinates[3 * i + 1] - coordinates[3 * j + 1],
+                        coordinates[3 * i + 2] - coordinates[3 * j + 2]);
+    };
+
+    for (unsigned int iQuery = 2; iQuery < nPoints; iQuery += 7) {
+      std::vector<unsigned int> nFound(nPoints, 0);
+      grid.forEachNearbyPoint(coordinates.data() + 3 * iQuery, [&nFound](unsigned int i) { ++nFound[i]; });
+      for (unsigned int i = 0; i < nPoints; ++i) {
+        EXPECT_LE(nFound[i], 1u);
+        if (distance(iQuery, i) < radius) {
+          EXPECT_EQ(nFound[i], 1u);
+        }
+      }
+      // Points with non finite coordinates are never found
+      EXPECT_EQ(nFound[0], 0u);
+      EXPECT_EQ(nFound[1], 0u);
+    }
+
+    // Nothing is found around points with non finite coordinates
+    unsigned int nFound = 0;
+    grid.forEachNearbyPoint(coordinates.data(), [&nFound](unsigned int) { ++nFound; });
+    EXPECT_EQ(nFound, 0u);
+  }
+
+  TEST(LatentSpaceGridTest, OnlyInsertedPoints)
+  {
+    // Three points at the same position, only two of them inserted
+    const std::vector<float> coordinates = {1, 2, 3, 1, 2, 3, 1, 2, 3};
+    LatentSpaceGrid grid;
+    grid.build(coordinates.data(), {2, 0}, 1.0);
+
+    std::vector<unsigned int> found;
+    grid.forEachNearbyPoint(coordinates.data(), [&found](unsigned int i) { found.push_back(i); });
+    std::sort(found.begin(), found.end());
+    EXPECT_EQ(found, (std::vector<unsigned int> {0, 2}));
+
+    // Rebuilding without points leaves the grid empty
+    grid.build(coordinates.data(), {}, 1.0);
+    found.clear();
+    grid.forEachNearbyPoint(coordinates.data(), [&found](unsigned int i) { found.push_back(i); });
+    EXPECT_TRUE(found.empty());
+  }
+
 }
@@ -11,9 +11,14 @@
 
 #include <framework/datastore/StoreArray.h>
 #include <mva/methods/ONNX.h>
+#include <tracking/gnnFinder/Utils.h>
 #include <tracking/trackingUtilities/eventdata/hits/CDCWireHit.h>
 #include <tracking/trackingUtilities/rootification/StoreWrappedObjPtr.h>
 
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 namespace Belle2 {
 
   class CDCHit;
@@ -106,6 +111,9 @@ namespace Belle2 {
     /** Number of input features per node for the GNN model. */
     unsigned int m_nInputFeatures = 0;
 
+    /** Number of input features per node filled by the module. */
+    static constexpr unsigned int c_nFilledFeatures = 7;
+
     /** Dimensionality of the latent space used by the GNN. */
     unsigned int m_latentSpaceNDim = 0;
 
@@ -141,6 +149,48 @@ namespace Belle2 {
 
     /** ONNX inference session. */
     std::unique_ptr<MVA::ONNX::Session> m_session;
+
+    /** Input tensor with the features per hit, reshaped every event. */
+    std::shared_ptr<MVA::ONNX::Tensor<float>> m_inputTensor;
+
+    /** Output tensor with the condensation score per hit. */
+    std::shared_ptr<MVA::ONNX::Tensor<float>> m_betaTensor;
+
+    /** Output tensor with the coordinates per hit in the latent space. */
+    std::shared_ptr<MVA::ONNX::Tensor<float>> m_coordinatesTensor;
+
+    /** Output tensor with the predicted momentum per hit. */
+    std::shared_ptr<MVA::ONNX::Tensor<float>> m_momentumTensor;
+
+    /** Output tensor with the predicted vertex per hit. */
+    std::shared_ptr<MVA::ONNX::Tensor<float>> m_vertexTensor;
+
+    /** Output tensor with the predicted charge per hit. */
+    std::shared_ptr<MVA::ONNX::Tensor<float>> m_chargeTensor;
+
+    /** Index in the CDCWireHit vector of each tensor row. */
+    std::vector<unsigned int> m_tensorIndexToHitIndex;
+
+    /** Tensor rows of the condensation point candidates sorted by decreasing beta. */
+    std::vector<unsigned int> m_betaIndices;
+
+    /** Tensor rows of the accepted condensation points. */
+    std::vector<unsigned int> m_conPointIndices;
+
+    /** Whether a condensation point candidate has been accepted, per tensor row. */
+    std::vector<uint8_t> m_isConPoint;
+
+    /** Tensor rows of all hits. */
+    std::vector<unsigned int> m_allIndices;
+
+    /** Tensor rows of the hits attached to the current condensation point. */
+    std::vector<unsigned int> m_attachedIndices;
+
+    /** Grid of the condensation point candidates with the size of the exclusion radius. */
+    GNNFinder::Utils::LatentSpaceGrid m_conPointGrid;
+
+    /** Grid of all hits with the size of the attachment radius. */
+    GNNFinder::Utils::LatentSpaceGrid m_hitGrid;
   };
 
 }
@@ -53,6 +53,14 @@ void CATFinderModule::initialize()
   m_CDCHits.registerRelationTo(m_CDCRecoTracks);
   m_recoHitInformations.registerRelationTo(m_CDCHits);
   m_CDCRecoTracks.registerRelationTo(m_recoHitInformations);
+
+  // The tensors are reshaped to the number of hits of each event, which keeps their memory
+  m_inputTensor       = Tensor<float>::make_shared({0, 1});
+  m_betaTensor        = Tensor<float>::make_shared({0, 1});
+  m_coordinatesTensor = Tensor<float>::make_shared({0, 3});
+  m_momentumTensor    = Tensor<float>::make_shared({0, 3});
+  m_vertexTensor      = Tensor<float>::make_shared({0, 3});
+  m_chargeTensor      = Tensor<float>::make_shared({0, 1});
 }
 
 void CATFinderModule::beginRun()
@@ -87,6 +95,11 @@ void CATFinderModule::beginRun()
   m_outputTVertexName       = parameters->getOutputTVertexName();
   m_outputTChargeName       = parameters->getOutputTChargeName();
 
+  // The hit features are filled below, any further ones are left at zero
+  if (m_nInputFeatures < c_nFilledFeatures)
+    B2FATAL("CATFinderParameters expects " << m_nInputFeatures << " input features, but at least "
+            << c_nFilledFeatures << " are needed");
+
   // Get the weightfile and initialize the ONNX session
 
   m_session = std::make_unique<MVA::ONNX::Session>(filename.c_str());
@@ -109,24 +122,19 @@ void CATFinderModule::event()
   if (nHits == 0)
     return;
 
-  // Input tensore: features per hit
-  auto input_t    = Tensor<float>::make_shared({nHits, m_nInputFeatures});
-  // Output tensor: condensation score
-  auto beta_t     = Tensor<float>::make_shared({nHits, 1});
-  // Output tensor: predicted coordinates in the latent space
-  auto coord_t    = Tensor<float>::make_shared({nHits, 3});
-  // Output tensor: predicted momentum
-  auto momentum_t = Tensor<float>::make_shared({nHits, 3});
-  // Output tensor: predicted "vertex"
-  auto vertex_t   = Tensor<float>::make_shared({nHits, 3});
-  // Output tensor: predicted charge
-  auto charge_t   = Tensor<float>::make_shared({nHits, 1});
+  // Reuse the tensors of the previous events, only their shape changes
+  m_inputTensor->reshape({nHits, m_nInputFeatures});
+  m_betaTensor->reshape({nHits, 1});
+  m_coordinatesTensor->reshape({nHits, 3});
+  m_momentumTensor->reshape({nHits, 3});
+  m_vertexTensor->reshape({nHits, 3});
+  m_chargeTensor->reshape({nHits, 1});
 
   // Map from tensor row index back to the original wireHitVector index,
   // needed later when adding CDC hits to the RecoTrack
-  std::vector<unsigned int> tensorIndexToHitIndex;
-  tensorIndexToHitIndex.reserve(nHits);
+  m_tensorIndexToHitIndex.clear();
 
+  float* inputFeatures = m_inputTensor->data();
   unsigned int iHit = 0;
   for (unsigned int iWireHit = 0; iWireHit < wireHitVector.size(); ++iWireHit) {
 
@@ -148,16 +156,18 @@ void CATFinderModule::event()
     const B2Vector3D posForward  = cdcGeometryPar.wireForwardPosition(clayer, wire, wirePos);
     const B2Vector3D posBackward = cdcGeometryPar.wireBackwardPosition(clayer, wire, wirePos);
 
-    // Prepare the tensor
-    input_t->at({iHit, 0}) = 0.5 * (posForward.x() + posBackward.x()) / m_spatialCoordinatesScale;
-    input_t->at({iHit, 1}) = 0.5 * (posForward.y() + posBackward.y()) / m_spatialCoordinatesScale;
-    input_t->at({iHit, 2}) = tdc_scaled;
-    input_t->at({iHit, 3}) = adc_clipped;
-    input_t->at({iHit, 4}) = static_cast<double>(cdcHit->getISuperLayer()) / m_slayerScale;
-    input_t->at({iHit, 5}) = static_cast<double>(clayer)                   / m_clayerScale;
-    input_t->at({iHit, 6}) = static_cast<double>(cdcHit->getILayer())      / m_layerScale;
-
-    tensorIndexToHitIndex.push_back(iWireHit);
+    // Fill the row of the tensor, features beyond the ones set here stay zero
+    float* features = inputFeatures + static_cast<size_t>(iHit) * m_nInputFeatures;
+    std::fill(features, features + m_nInputFeatures, 0.f);
+    features[0] = 0.5 * (posForward.x() + posBackward.x()) / m_spatialCoordinatesScale;
+    features[1] = 0.5 * (posForward.y() + posBackward.y()) / m_spatialCoordinatesScale;
+    features[2] = tdc_scaled;
+    features[3] = adc_clipped;
+    features[4] = static_cast<double>(cdcHit->getISuperLayer()) / m_slayerScale;
+    features[5] = static_cast<double>(clayer)                   / m_clayerScale;
+    features[6] = static_cast<double>(cdcHit->getILayer())      / m_layerScale;
+
+    m_tensorIndexToHitIndex.push_back(iWireHit);
     ++iHit;
   }
 
@@ -167,65 +177,84 @@ void CATFinderModule::event()
 
   // Run the GNN inference
   m_session->run(
-  {{m_inputTFeaturesName, input_t}},
-  {{m_outputTBetaName, beta_t}, {m_outputTCoordinatesName, coord_t}, {m_outputTMomentumName, momentum_t}, {m_outputTVertexName, vertex_t}, {m_outputTChargeName, charge_t}}
+  {{m_inputTFeaturesName, m_inputTensor}},
+  {{m_outputTBetaName, m_betaTensor}, {m_outputTCoordinatesName, m_coordinatesTensor}, {m_outputTMomentumName, m_momentumTensor}, {m_outputTVertexName, m_vertexTensor}, {m_outputTChargeName, m_chargeTensor}}
   );
 
-  // Build an index array sorted by descending beta so we process the most probable condensation points first
-  std::vector<unsigned int> betaIndices(nHits);
-  std::iota(betaIndices.begin(), betaIndices.end(), 0);
-  std::sort(betaIndices.begin(), betaIndices.end(),
-  [&](unsigned int i1, unsigned int i2) { return beta_t->at({i1, 0}) > beta_t->at({i2, 0}); });
+  const float* betas = m_betaTensor->data();
+  const float* coordinates = m_coordinatesTensor->data();
 
-  // A hit is a candidate condensation point only if its beta exceeds the threshold
-  std::vector<uint8_t> selectedBetas(nHits);
-  for (unsigned int i = 0; i < nHits; ++i)
-    selectedBetas[i] = static_cast<uint8_t>(beta_t->at({i, 0}) > m_tBeta);
+  // Squared distance in the latent space, accumulated in the same way for every pair of hits
+  auto squaredDistance = [coordinates](unsigned int i, unsigned int j) {
+    double d = 0.0;
+    for (unsigned int iDim = 0; iDim < 3; ++iDim) {
+      const float delta = coordinates[3 * i + iDim] - coordinates[3 * j + iDim];
+      d += delta * delta;
+    }
+    return d;
+  };
+
+  // A hit is a candidate condensation point only if its beta exceeds the threshold.
+  // Sort the candidates by descending beta so we process the most probable condensation points first
+  m_betaIndices.clear();
+  for (unsigned int i = 0; i < nHits; ++i) {
+    if (betas[i] > m_tBeta)
+      m_betaIndices.push_back(i);
+  }
+  std::stable_sort(m_betaIndices.begin(), m_betaIndices.end(),
+  [betas](unsigned int i1, unsigned int i2) { return betas[i1] > betas[i2]; });
 
   // A new condensation point is accepted only if it lies farther than m_tDistance
-  // from every already-accepted point in latent coordinate space
-  std::vector<unsigned int> conPointIndices;
-  const float thresholdSquared = m_tDistance * m_tDistance;
-
-  // Returns true if hit i is outside the exclusion radius of every accepted condensation point
-  auto isOutOfRadius = [&](unsigned int i) {
-    for (unsigned int iConPoint : conPointIndices) {
-      double d = 0.0;
-      d += (coord_t->at({i, 0}) - coord_t->at({iConPoint, 0})) * (coord_t->at({i, 0}) - coord_t->at({iConPoint, 0}));
-      d += (coord_t->at({i, 1}) - coord_t->at({iConPoint, 1})) * (coord_t->at({i, 1}) - coord_t->at({iConPoint, 1}));
-      d += (coord_t->at({i, 2}) - coord_t->at({iConPoint, 2})) * (coord_t->at({i, 2}) - coord_t->at({iConPoint, 2}));
-      if (d <= thresholdSquared)
-        return false;
+  // from every already-accepted point in latent coordinate space.
+  // Only the candidates in the neighbouring cells of the grid have to be checked.
+  const double thresholdSquared = m_tDistance * m_tDistance;
+  m_conPointGrid.build(coordinates, m_betaIndices, m_tDistance != 0 ? std::abs(m_tDistance) : 1.f);
+  m_isConPoint.assign(nHits, 0);
+  m_conPointIndices.clear();
+  for (unsigned int iBeta : m_betaIndices) {
+    bool isOutOfRadius = true;
+    m_conPointGrid.forEachNearbyPoint(coordinates + 3 * iBeta, [&](unsigned int iConPoint) {
+      if (m_isConPoint[iConPoint] and squaredDistance(iBeta, iConPoint) <= thresholdSquared)
+        isOutOfRadius = false;
+    });
+    if (isOutOfRadius) {
+      // Accept as a new condensation point
+      m_isConPoint[iBeta] = 1;
+      m_conPointIndices.push_back(iBeta);
     }
-    return true;
-  };
+  }
+  B2DEBUG(29, "Condensation points in the event: " << m_conPointIndices.size());
 
-  for (unsigned int i = 0; i < betaIndices.size(); ++i) {
-    unsigned int iBeta = betaIndices[i];
-    if (!selectedBetas[iBeta])
-      continue;  // Below the beta threshold: not a condensation point candidate
-    if (conPointIndices.empty() or isOutOfRadius(iBeta))
-      conPointIndices.push_back(iBeta);  // Accept as a new condensation point
-    else
-      selectedBetas[iBeta] = 0;  // Too close to an existing seed: let's discard it
+  // Grid of all hits to find the ones close to each condensation point
+  if (m_maxRadius > 0) {
+    m_allIndices.resize(nHits);
+    std::iota(m_allIndices.begin(), m_allIndices.end(), 0);
+    m_hitGrid.build(coordinates, m_allIndices, m_maxRadius);
   }
-  B2DEBUG(29, "Condensation points in the event: " << conPointIndices.size());
 
   // Convert the condensation points into RecoTracks: one condensation point -> one RecoTrack
-  for (unsigned int iConPoint : conPointIndices) {
-
-    std::vector<GNNFinder::Utils::KDTHit> kdtHits;
-    kdtHits.reserve(nHits);
+  for (unsigned int iConPoint : m_conPointIndices) {
 
     // Collect all hits whose clustering coordinates fall within m_maxRadius of this seed
-    for (unsigned int i = 0; i < nHits; ++i) {
-      const double dx = coord_t->at({iConPoint, 0}) - coord_t->at({i, 0});
-      const double dy = coord_t->at({iConPoint, 1}) - coord_t->at({i, 1});
-      const double dz = coord_t->at({iConPoint, 2}) - coord_t->at({i, 2});
-      if (std::hypot(dx, dy, dz) < m_maxRadius) {
-        // Store the wire X and Y coordinatres together with the tensor row index for later lookup
-        kdtHits.push_back({input_t->at({i, 0}), input_t->at({i, 1}), static_cast<int>(i)});
-      }
+    m_attachedIndices.clear();
+    if (m_maxRadius > 0) {
+      m_hitGrid.forEachNearbyPoint(coordinates + 3 * iConPoint, [&](unsigned int i) {
+        const double dx = coordinates[3 * iConPoint + 0] - coordinates[3 * i + 0];
+        const double dy = coordinates[3 * iConPoint + 1] - coordinates[3 * i + 1];
+        const double dz = coordinates[3 * iConPoint + 2] - coordinates[3 * i + 2];
+        if (std::hypot(dx, dy, dz) < m_maxRadius)
+          m_attachedIndices.push_back(i);
+      });
+      // Keep the order of the tensor rows independent of the grid
+      std::sort(m_attachedIndices.begin(), m_attachedIndices.end());
+    }
+
+    std::vector<GNNFinder::Utils::KDTHit> kdtHits;
+    kdtHits.reserve(m_attachedIndices.size());
+    for (unsigned int i : m_attachedIndices) {
+      // Store the wire X and Y coordinatres together with the tensor row index for later lookup
+      const float* features = inputFeatures + static_cast<size_t>(i) * m_nInputFeatures;
+      kdtHits.push_back({features[0], features[1], static_cast<int>(i)});
     }
 
     // Reject tracks with too few hits
@@ -234,12 +263,12 @@ void CATFinderModule::event()
 
     // Retrieve predicted momentum, vertex and charge from the condensation point's output
     const ROOT::Math::XYZVector momentum(
-      momentum_t->at({iConPoint, 0}), momentum_t->at({iConPoint, 1}), momentum_t->at({iConPoint, 2}));
+      m_momentumTensor->at({iConPoint, 0}), m_momentumTensor->at({iConPoint, 1}), m_momentumTensor->at({iConPoint, 2}));
     const ROOT::Math::XYZVector position(
-      vertex_t->at({iConPoint, 0}) * m_spatialCoordinatesScale,
-      vertex_t->at({iConPoint, 1}) * m_spatialCoordinatesScale,
-      vertex_t->at({iConPoint, 2}) * m_spatialCoordinatesScale);
-    const int charge = (charge_t->at({iConPoint, 0}) >= 0.5) ? 1 : -1;
+      m_vertexTensor->at({iConPoint, 0}) * m_spatialCoordinatesScale,
+      m_vertexTensor->at({iConPoint, 1}) * m_spatialCoordinatesScale,
+      m_vertexTensor->at({iConPoint, 2}) * m_spatialCoordinatesScale);
+    const int charge = (m_chargeTensor->at({iConPoint, 0}) >= 0.5) ? 1 : -1;
 
     B2DEBUG(29, LogVar("Condensation point", iConPoint) << LogVar("Attached hits", kdtHits.size())
             << LogVar("Momentum", std::sqrt(momentum.Mag2())) << LogVar("Vertex", std::sqrt(position.Mag2()))
@@ -273,7 +302,7 @@ void CATFinderModule::event()
     // Add CDC hits in the sorted order
     int iRecoTrackHit = 0;
     for (int tensorIndex : sortedIndices) {
-      cdcRecotrack->addCDCHit(wireHitVector[tensorIndexToHitIndex[tensorIndex]].getHit(), iRecoTrackHit);
+      cdcRecotrack->addCDCHit(wireHitVector[m_tensorIndexToHitIndex[tensorIndex]].getHit(), iRecoTrackHit);
       ++iRecoTrackHit;
     }
   }
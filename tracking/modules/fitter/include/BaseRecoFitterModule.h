@@ -10,6 +10,7 @@
 #include <framework/core/Module.h>
 #include <framework/datastore/StoreArray.h>
 #include <tracking/dataobjects/RecoTrack.h>
+#include <memory>
 #include <string>
 
 namespace genfit {
@@ -18,6 +19,8 @@ namespace genfit {
 
 
 namespace Belle2 {
+  class ParallelTrackFitter;
+  class TrackFitter;
 
   /** A base class for all modules that implement a fitter for reco tracks. */
   class BaseRecoFitterModule : public Module {
@@ -28,6 +31,11 @@ namespace Belle2 {
      */
     BaseRecoFitterModule();
 
+    /**
+     * Destructor, defined in the source file for the forward declared members.
+     */
+    ~BaseRecoFitterModule();
+
     /**
      * Initialize the store ararys and check for the material effects.
      */
@@ -38,6 +46,11 @@ namespace Belle2 {
      */
     void event() override;
 
+    /**
+     * Stop the fitting threads.
+     */
+    void terminate() override;
+
 
   protected:
     /**
@@ -52,6 +65,12 @@ namespace Belle2 {
     virtual std::shared_ptr<genfit::AbsFitter> createFitter() const = 0;
 
   private:
+    /** Create a TrackFitter with the settings of this module. */
+    std::unique_ptr<TrackFitter> createTrackFitter() const;
+
+    /** Fit all tracks of the event with the ParallelTrackFitter. */
+    void fitInParallel();
+
     /** StoreArray name of the input and output reco tracks. */
     std::string m_param_recoTracksStoreArrayName = "RecoTracks";
     /** StoreArray name of the PXD hits. */
@@ -76,7 +95,13 @@ namespace Belle2 {
     /** if true resets the charge seed of the RecoTrack if track fit prefers the other charge */
     bool m_correctSeedCharge = false;
 
+    /** Number of threads for fitting the tracks of one event. */
+    unsigned int m_param_numberOfThreads = 1;
+
     StoreArray<RecoTrack> m_recoTracks; /**< RecoTracks StoreArray */
+
+    /** Fitter distributing the tracks over the threads, only used for more than one thread */
+    std::unique_ptr<ParallelTrackFitter> m_parallelFitter;
   };
 }
 
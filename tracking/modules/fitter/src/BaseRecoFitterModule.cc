@@ -13,6 +13,7 @@
 #include <genfit/FieldManager.h>
 
 #include <tracking/trackFitting/fitter/base/TrackFitter.h>
+#include <tracking/trackFitting/fitter/base/ParallelTrackFitter.h>
 #include <tracking/dbobjects/DAFConfiguration.h>
 
 #include <simulation/monopoles/MonopoleConstants.h>
@@ -56,8 +57,14 @@ BaseRecoFitterModule::BaseRecoFitterModule() :
   addParam("correctSeedCharge", m_correctSeedCharge,
            "If true changes seed charge of the RecoTrack to the one found by the track fit (if it differs).",
            m_correctSeedCharge);
+
+  addParam("numberOfThreads", m_param_numberOfThreads,
+           "Number of threads for fitting the tracks of one event. The results do not depend on the number of threads.",
+           m_param_numberOfThreads);
 }
 
+BaseRecoFitterModule::~BaseRecoFitterModule() = default;
+
 void BaseRecoFitterModule::initialize()
 {
   m_recoTracks.isRequired(m_param_recoTracksStoreArrayName);
@@ -73,17 +80,39 @@ void BaseRecoFitterModule::initialize()
   genfit::MaterialEffects::getInstance()->setMagCharge(Monopoles::monopoleMagCharge);
 }
 
+void BaseRecoFitterModule::terminate()
+{
+  m_parallelFitter.reset();
+}
 
-void BaseRecoFitterModule::event()
+std::unique_ptr<TrackFitter> BaseRecoFitterModule::createTrackFitter() const
 {
-  // The used fitting algorithm class.
-  TrackFitter fitter(DAFConfiguration::c_Default, m_param_pxdHitsStoreArrayName, m_param_svdHitsStoreArrayName,
-                     m_param_cdcHitsStoreArrayName, m_param_bklmHitsStoreArrayName, m_param_eklmHitsStoreArrayName);
+  auto fitter = std::make_unique<TrackFitter>(DAFConfiguration::c_Default, m_param_pxdHitsStoreArrayName,
+                                              m_param_svdHitsStoreArrayName, m_param_cdcHitsStoreArrayName,
+                                              m_param_bklmHitsStoreArrayName, m_param_eklmHitsStoreArrayName);
 
   const std::shared_ptr<genfit::AbsFitter>& genfitFitter = createFitter();
   if (genfitFitter) {
-    fitter.resetFitter(genfitFitter);
+    fitter->resetFitter(genfitFitter);
   }
+  return fitter;
+}
+
+
+void BaseRecoFitterModule::event()
+{
+  if (m_param_numberOfThreads > 1) {
+    // The threads are started in the event loop, as they would not survive the fork of the parallel processing
+    if (not m_parallelFitter) {
+      m_parallelFitter = std::make_unique<ParallelTrackFitter>(m_param_numberOfThreads);
+    }
+    fitInParallel();
+    return;
+  }
+
+  // The used fitting algorithm class.
+  const std::unique_ptr<TrackFitter> trackFitter = createTrackFitter();
+  const TrackFitter& fitter = *trackFitter;
 
   B2DEBUG(29, "Number of reco track candidates to process: " << m_recoTracks.getEntries());
   unsigned int recoTrackCounter = 0;
@@ -172,3 +201,75 @@ void BaseRecoFitterModule::event()
     recoTrackCounter += 1;
   } // loop tracks
 }
+
+void BaseRecoFitterModule::fitInParallel()
+{
+  // The same steps as in event(), but each step is done for all tracks at once
+  m_parallelFitter->resetFitters([this]() { return createTrackFitter(); });
+
+  std::vector<RecoTrack*> recoTracks;
+  for (RecoTrack& recoTrack : m_recoTracks) {
+    if (recoTrack.getNumberOfTotalHits() < 3) {
+      B2WARNING("Genfit2Module: only " << recoTrack.getNumberOfTotalHits() << " were assigned to the Track! " <<
+                "This Track will not be fitted!");
+      continue;
+    }
+    recoTracks.push_back(&recoTrack);
+  }
+  B2DEBUG(29, "Number of reco track candidates to fit in " << m_parallelFitter->getNumberOfThreads() << " threads: " <<
+          recoTracks.size());
+
+  std::vector<bool> flippedCharge(recoTracks.size(), false);
+  for (const unsigned int pdgCodeToUseForFitting : m_param_pdgCodesToUseForFitting) {
+    if (pdgCodeToUseForFitting != Monopoles::c_monopolePDGCode) {
+      Const::ChargedStable particleUsedForFitting(pdgCodeToUseForFitting);
+      const std::vector<bool> wasFitSuccessful = m_parallelFitter->fit(recoTracks, particleUsedForFitting, m_param_resortHits);
+
+      // only flip if the current fit was the cardinal rep. and seed charge differs from fitted charge
+      for (size_t index = 0; index < recoTracks.size(); ++index) {
+        RecoTrack& recoTrack = *recoTracks[index];
+        if (m_correctSeedCharge && wasFitSuccessful[index]
+            && recoTrack.getCardinalRepresentation() == recoTrack.getTrackRepresentationForPDG(pdgCodeToUseForFitting)) {
+          flippedCharge[index] = flippedCharge[index]
+                                 or recoTrack.getChargeSeed() != recoTrack.getMeasuredStateOnPlaneFromFirstHit().getCharge();
+        }
+      }
+    } else {
+      // Different call signature for monopoles in order not to change Const::ChargedStable types
+      m_parallelFitter->fit(recoTracks, pdgCodeToUseForFitting, m_param_resortHits);
+    }
+
+    for (RecoTrack* recoTrack : recoTracks) {
+      if (!recoTrack->getTrackRepresentationForPDG(pdgCodeToUseForFitting)) {
+        B2FATAL("TrackRepresentation for PDG id " << pdgCodeToUseForFitting << " not present in RecoTrack although it " <<
+                "should have been created.");
+      }
+    }
+  }
+
+  // if charge has been flipped reset seed charge and refit all track representations, one representation after the other.
+  // As in event(), every representation is refitted by its particle type, so with the charge of the new seed.
+  std::vector<RecoTrack*> flippedTracks;
+  std::vector<size_t> numberOfRepresentations;
+  for (size_t index = 0; index < recoTracks.size(); ++index) {
+    if (flippedCharge[index]) {
+      recoTracks[index]->setChargeSeed(-recoTracks[index]->getChargeSeed());
+      flippedTracks.push_back(recoTracks[index]);
+      numberOfRepresentations.push_back(recoTracks[index]->getRepresentations().size());
+    }
+  }
+  for (size_t representation = 0; not flippedTracks.empty(); ++representation) {
+    std::vector<RecoTrack*> tracksToRefit;
+    std::vector<Const::ChargedStable> particlesUsedForFitting;
+    for (size_t index = 0; index < flippedTracks.size(); ++index) {
+      if (representation < numberOfRepresentations[index]) {
+        tracksToRefit.push_back(flippedTracks[index]);
+        particlesUsedForFitting.emplace_back(abs(flippedTracks[index]->getRepresentations()[representation]->getPDG()));
+      }
+    }
+    if (tracksToRefit.empty()) {
+      break;
+    }
+    m_parallelFitter->fit(tracksToRefit, particlesUsedForFitting);
+  }
+}
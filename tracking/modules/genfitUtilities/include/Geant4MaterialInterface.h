@@ -13,6 +13,7 @@
 #include "genfit/AbsMaterialInterface.h"
 
 class G4VPhysicalVolume;
+class G4Material;
 
 namespace Belle2 {
 
@@ -29,6 +30,10 @@ namespace Belle2 {
     Geant4MaterialInterface();
     ~Geant4MaterialInterface() override;
 
+    /** @brief New instance with its own navigator in the same geometry, e.g. for another thread
+     */
+    genfit::AbsMaterialInterface* clone() const override;
+
     /** @brief Initialize the navigator at given position and with given
         direction.  Returns true if the volume changed.
      */
@@ -39,6 +44,10 @@ namespace Belle2 {
      */
     genfit::Material getMaterialParameters() override;
 
+    /** @brief Convert the parameters of a Geant4 material to the genfit units
+     */
+    static genfit::Material convertMaterial(const G4Material* material);
+
     /** @brief Make a step (following the curvature) until step length
      * sMax or the next boundary is reached.  After making a step to a
      * boundary, the position has to be beyond the boundary, i.e. the
@@ -8,8 +8,11 @@
 #pragma once
 
 #include <framework/core/Module.h>
+#include <tracking/trackFitting/materialMap/MaterialMap.h>
 
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace Belle2 {
   /** Setup material handling and magnetic fields for use by genfit's extrapolation code
@@ -27,14 +30,28 @@ namespace Belle2 {
     void initialize() override;
 
   private:
+    /** Read the material map from file or, if requested, create it from the geometry and write it to the file. */
+    std::shared_ptr<const MaterialMap> getMaterialMap() const;
+
     /** Whether or not this module will raise an error if the geometry is
     * already present. This can be used to add the geometry multiple times if
     * it's not clear if it's already present in another path */
     bool m_ignoreIfPresent = true;
 
-    /// choice of geometry representation: 'TGeo' or 'Geant4'.
+    /// choice of geometry representation: 'TGeo', 'Geant4' or 'MaterialMap'.
     std::string m_geometry = "Geant4";
 
+    /// File to read the material map from (or to write it to if m_createMaterialMap is set). Required for 'MaterialMap'.
+    std::string m_materialMapFile = "";
+    /// Create the material map from the geometry and write it to m_materialMapFile instead of reading it
+    bool m_createMaterialMap = false;
+    /// Extent of the material map: outer radius, lower and upper z edge (in cm)
+    std::vector<double> m_materialMapRange = {120., -85., 165.};
+    /// Number of material map bins in r, phi and z
+    std::vector<unsigned int> m_materialMapBins = {240, 90, 125};
+    /// Number of radial rays per phi-z column of voxels and axis when creating the material map
+    unsigned int m_materialMapRays = 4;
+
     /// Switch on/off ALL material effects in Genfit. "true" overwrites "true" flags for the individual effects.
     bool m_noEffects = false;
     /// Determines if calculation of energy loss is on/off in Genfit
@@ -49,6 +66,12 @@ namespace Belle2 {
     bool m_noiseBrems = true;
     /// Determines if the magnetic field cache is on/off in Genfit
     bool m_useBFieldCache = false;
+    /// Use a precomputed grid of the magnetic field in the tracking volume
+    bool m_useBFieldGrid = false;
+    /// Extent of the magnetic field grid: half width in x and y, lower and upper z edge (in cm)
+    std::vector<double> m_bFieldGridRange = {120., -90., 170.};
+    /// Distance between the nodes of the magnetic field grid (in cm)
+    double m_bFieldGridSpacing = 2.;
     /// Multiple scattering model
     std::string m_mscModel = "Highland";
   };
@@ -0,0 +1,80 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#pragma once
+
+#include <tracking/modules/genfitUtilities/Geant4MaterialInterface.h>
+#include <tracking/trackFitting/materialMap/MaterialMap.h>
+
+#include "genfit/AbsMaterialInterface.h"
+
+#include <cstdint>
+#include <memory>
+
+namespace Belle2 {
+
+  /**
+   * @brief AbsMaterialInterface implementation using a precomputed MaterialMap.
+   *
+   * Inside the volume covered by the map the material is looked up in the voxel grid and
+   * the next boundary is the next change of the (averaged) voxel material along the track.
+   * Outside of the map everything is forwarded to the Geant4MaterialInterface.
+   */
+  class VoxelizedMaterialInterface : public genfit::AbsMaterialInterface {
+
+  public:
+
+    /// Use the given map inside its volume and the Geant4 navigation outside of it.
+    explicit VoxelizedMaterialInterface(std::shared_ptr<const MaterialMap> materialMap);
+    ~VoxelizedMaterialInterface() override;
+
+    /** @brief New instance sharing the material map, with its own Geant4 navigator
+     */
+    genfit::AbsMaterialInterface* clone() const override;
+
+    /**
+     * @brief Fill a material map with the volume averaged materials of the Geant4 geometry.
+     *
+     * Every phi-z column of voxels is crossed by raysPerAxis^2 equally spaced radial rays, which are
+     * followed through all volume boundaries with the Geant4 navigator. Along r the volumes are
+     * therefore exact, also for layers much thinner than a voxel, in phi and z they are sampled by the rays.
+     */
+    static std::unique_ptr<MaterialMap> createMaterialMap(const MaterialMap::Binning& binning, unsigned int raysPerAxis);
+
+    /** @brief Initialize the navigator at given position and with given
+        direction.  Returns true if the material changed.
+     */
+    bool initTrack(double posX, double posY, double posZ,
+                   double dirX, double dirY, double dirZ) override;
+
+    /** @brief Get material parameters in current material
+     */
+    genfit::Material getMaterialParameters() override;
+
+    /** @brief Make a step (following the curvature) until step length
+     * sMax or the next change of the voxel material is reached. After making a step to a
+     * boundary, the position is beyond the boundary. The actual step made is returned.
+     */
+    double findNextBoundary(const genfit::RKTrackRep* rep,
+                            const genfit::M1x7& state7,
+                            double sMax,
+                            bool varField = true) override;
+
+  private:
+
+    /** the precomputed material map */
+    std::shared_ptr<const MaterialMap> m_materialMap;
+
+    /** the full geometry navigation used outside of the map */
+    Geant4MaterialInterface m_geant4Interface;
+
+    /** index of the current material in the map, MaterialMap::c_noMaterial if outside of the map */
+    std::uint32_t m_currentMaterial = MaterialMap::c_noMaterial;
+  };
+
+}
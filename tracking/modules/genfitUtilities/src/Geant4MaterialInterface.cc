@@ -279,6 +279,13 @@ Geant4MaterialInterface::~Geant4MaterialInterface()
 {
 }
 
+genfit::AbsMaterialInterface* Geant4MaterialInterface::clone() const
+{
+  Geant4MaterialInterface* copy = new Geant4MaterialInterface();
+  copy->setDebugLvl(debugLvl_);
+  return copy;
+}
+
 
 bool
 Geant4MaterialInterface::initTrack(double posX, double posY, double posZ,
@@ -305,8 +312,13 @@ Geant4MaterialInterface::getMaterialParameters()
 {
   assert(currentVolume_);
 
-  const G4Material* mat = currentVolume_->GetLogicalVolume()->GetMaterial();
+  return convertMaterial(currentVolume_->GetLogicalVolume()->GetMaterial());
+}
 
+
+genfit::Material
+Geant4MaterialInterface::convertMaterial(const G4Material* mat)
+{
   double density, Z, A, radiationLength, mEE;
   if (mat->GetNumberOfElements() == 1) {
     Z = mat->GetZ();
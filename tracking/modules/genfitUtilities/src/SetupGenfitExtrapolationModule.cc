@@ -8,6 +8,12 @@
 
 #include <tracking/modules/genfitUtilities/SetupGenfitExtrapolationModule.h>
 #include <tracking/modules/genfitUtilities/Geant4MaterialInterface.h>
+#include <tracking/modules/genfitUtilities/VoxelizedMaterialInterface.h>
+
+#include <framework/database/DBObjPtr.h>
+#include <framework/gearbox/Unit.h>
+#include <framework/geometry/BFieldManager.h>
+#include <geometry/dbobjects/GeoConfiguration.h>
 
 #include <geometry/GeometryManager.h>
 
@@ -17,8 +23,8 @@
 #include <genfit/TGeoMaterialInterface.h>
 #include <genfit/IO.h>
 
-#include <boost/iostreams/stream_buffer.hpp>
-#include <boost/iostreams/concepts.hpp>
+#include <streambuf>
+#include <string>
 
 #include <TGeoManager.h>
 
@@ -28,38 +34,69 @@ REG_MODULE(SetupGenfitExtrapolation)
 
 namespace {
 
-  //! Stream that writes to Belle II logging system at the debug level
-  //! given by the template parameter.
+  //! Stream buffer that writes to Belle II logging system at the debug level
+  //! given by the template parameter. The text is collected per thread until the
+  //! stream is flushed, so the streams of several threads can share the buffer.
   template<size_t T_level>
-  class genfitSink : public boost::iostreams::sink {
-  public:
-    //! The actual function that does the writing.
-    std::streamsize write(const char* s, std::streamsize n)
+  class genfitStreamBuf : public std::streambuf {
+  protected:
+    //! Collect a single character.
+    int_type overflow(int_type c) override
+    {
+      if (!traits_type::eq_int_type(c, traits_type::eof())) {
+        getText().push_back(traits_type::to_char_type(c));
+      }
+      return traits_type::not_eof(c);
+    }
+
+    //! Collect several characters.
+    std::streamsize xsputn(const char* s, std::streamsize n) override
     {
-      B2DEBUG(T_level, s);
+      getText().append(s, n);
       return n;
     }
+
+    //! The actual function that does the writing.
+    int sync() override
+    {
+      std::string& text = getText();
+      if (!text.empty()) {
+        B2DEBUG(T_level, text);
+        text.clear();
+      }
+      return 0;
+    }
+
+  private:
+    //! The text written by this thread and not yet flushed.
+    static std::string& getText()
+    {
+      thread_local std::string text;
+      return text;
+    }
   };
 
-  //! Sink for debug output.
-  genfitSink<200> debugSink;
   //! Buffer for debug output.
-  boost::iostreams::stream_buffer<genfitSink<200> > debugStreamBuf(debugSink);
-  //! Sink for error output.
-  genfitSink<100> errorSink;
+  genfitStreamBuf<200> debugStreamBuf;
   //! Buffer for error output.
-  boost::iostreams::stream_buffer<genfitSink<100> > errorStreamBuf(errorSink);
-  //! Sink for output from ...::Print() calls.
-  genfitSink<150> printSink;
+  genfitStreamBuf<100> errorStreamBuf;
   //! Buffer for output from ...::Print() calls.
-  boost::iostreams::stream_buffer<genfitSink<150> > printStreamBuf(printSink);
+  genfitStreamBuf<150> printStreamBuf;
+
+  //! Key identifying the geometry a material map was created for: the geometry payload. Empty if there is none.
+  std::string getGeometryKey()
+  {
+    DBObjPtr<GeoConfiguration> geometryConfig;
+    if (!geometryConfig.isValid()) {
+      return "";
+    }
+    return geometryConfig.getName() + ":" + std::to_string(geometryConfig.getRevision()) + ":" + geometryConfig.getChecksum();
+  }
 
   //! Directs output from genfit into the Belle II logging system.
   void setupGenfitStreams()
   {
-    genfit::debugOut.rdbuf(&debugStreamBuf);
-    genfit::errorOut.rdbuf(&errorStreamBuf);
-    genfit::printOut.rdbuf(&printStreamBuf);
+    genfit::setStreamBuffers(&debugStreamBuf, &errorStreamBuf, &printStreamBuf);
   }
 }
 
@@ -78,7 +115,22 @@ SetupGenfitExtrapolationModule::SetupGenfitExtrapolationModule() :
 
   //input
   addParam("whichGeometry", m_geometry,
-           "Which geometry should be used, either 'TGeo' or 'Geant4'", m_geometry);
+           "Which geometry should be used, either 'TGeo', 'Geant4' or 'MaterialMap'. 'MaterialMap' uses a precomputed "
+           "voxel map of the material inside the range given by materialMapRange and Geant4 outside of it", m_geometry);
+  addParam("materialMapFile", m_materialMapFile,
+           "File with the material map, required for 'MaterialMap'. It has to match the geometry payload and the binning. "
+           "Validate a new map with tracking-compare-material-map before using it.", m_materialMapFile);
+  addParam("createMaterialMap", m_createMaterialMap,
+           "Create the material map from the geometry and write it to materialMapFile instead of reading it. "
+           "This takes long and is meant to be done once per geometry, not in every job.", m_createMaterialMap);
+  addParam("materialMapRange", m_materialMapRange,
+           "Volume covered by the material map: [outer radius, lower z, upper z] in cm", m_materialMapRange);
+  addParam("materialMapBins", m_materialMapBins,
+           "Number of bins of the material map in [r, phi, z]", m_materialMapBins);
+  addParam("materialMapRays", m_materialMapRays,
+           "Number of radial rays per voxel in phi and in z along which the geometry is integrated when creating "
+           "the material map",
+           m_materialMapRays);
 
   // Energy loss, multiple scattering configuration.
   addParam("energyLossBetheBloch", m_energyLossBetheBloch,
@@ -98,6 +150,13 @@ SetupGenfitExtrapolationModule::SetupGenfitExtrapolationModule() :
            "Multiple scattering model", m_mscModel);
   addParam("useBFieldCache", m_useBFieldCache, "activate the usage of the magnetic field cache",
            m_useBFieldCache);
+  addParam("useBFieldGrid", m_useBFieldGrid, "Interpolate the magnetic field for the extrapolation from a precomputed "
+           "Cartesian grid inside the range given by bFieldGridRange instead of evaluating all field components.",
+           m_useBFieldGrid);
+  addParam("bFieldGridRange", m_bFieldGridRange, "Volume covered by the magnetic field grid: "
+           "[half width in x and y, lower z, upper z] in cm", m_bFieldGridRange);
+  addParam("bFieldGridSpacing", m_bFieldGridSpacing, "Distance between the nodes of the magnetic field grid in cm",
+           m_bFieldGridSpacing);
 }
 
 void SetupGenfitExtrapolationModule::initialize()
@@ -118,6 +177,17 @@ void SetupGenfitExtrapolationModule::initialize()
   // A parameter is added here to switch off the usage of the cache until the problem
   // is fixed upstream.
   genfit::FieldManager::getInstance()->useCache(m_useBFieldCache);
+  if (m_useBFieldGrid) {
+    if (m_bFieldGridRange.size() != 3) {
+      B2FATAL("bFieldGridRange needs exactly three entries.");
+    }
+    BFieldGrid::Binning binning;
+    binning.xyMax = m_bFieldGridRange[0] * Unit::cm;
+    binning.zMin = m_bFieldGridRange[1] * Unit::cm;
+    binning.zMax = m_bFieldGridRange[2] * Unit::cm;
+    binning.spacing = m_bFieldGridSpacing * Unit::cm;
+    BFieldManager::setGrid(binning);
+  }
 
   if (!geometry::GeometryManager::getInstance().getTopVolume()) {
     B2FATAL("No geometry set up so far. Load the geometry module.");
@@ -132,8 +202,10 @@ void SetupGenfitExtrapolationModule::initialize()
     genfit::MaterialEffects::getInstance()->init(new genfit::TGeoMaterialInterface());
   } else if (m_geometry == "Geant4") {
     genfit::MaterialEffects::getInstance()->init(new Geant4MaterialInterface());
+  } else if (m_geometry == "MaterialMap") {
+    genfit::MaterialEffects::getInstance()->init(new VoxelizedMaterialInterface(getMaterialMap()));
   } else {
-    B2FATAL("Invalid choice of geometry interface.  Please use 'TGeo' or 'Geant4'.");
+    B2FATAL("Invalid choice of geometry interface.  Please use 'TGeo', 'Geant4' or 'MaterialMap'.");
   }
 
   // activate / deactivate material effects in genfit
@@ -148,3 +220,43 @@ void SetupGenfitExtrapolationModule::initialize()
     genfit::MaterialEffects::getInstance()->setMscModel(m_mscModel);
   }
 }
+
+std::shared_ptr<const MaterialMap> SetupGenfitExtrapolationModule::getMaterialMap() const
+{
+  if (m_materialMapRange.size() != 3 or m_materialMapBins.size() != 3) {
+    B2FATAL("materialMapRange and materialMapBins need exactly three entries each.");
+  }
+  MaterialMap::Binning binning;
+  binning.rMax = m_materialMapRange[0];
+  binning.zMin = m_materialMapRange[1];
+  binning.zMax = m_materialMapRange[2];
+  binning.nR = m_materialMapBins[0];
+  binning.nPhi = m_materialMapBins[1];
+  binning.nZ = m_materialMapBins[2];
+
+  if (m_materialMapFile.empty()) {
+    B2FATAL("whichGeometry='MaterialMap' needs a material map file (materialMapFile). "
+            "Create it once for the geometry with createMaterialMap=True.");
+  }
+  const std::string geometryKey = getGeometryKey();
+  if (geometryKey.empty()) {
+    B2FATAL("There is no geometry payload to check the material map file against, cannot use the material map.");
+  }
+
+  if (m_createMaterialMap) {
+    std::shared_ptr<const MaterialMap> materialMap = VoxelizedMaterialInterface::createMaterialMap(binning, m_materialMapRays);
+    if (!materialMap->write(m_materialMapFile, geometryKey)) {
+      B2FATAL("Could not write the material map to " << m_materialMapFile);
+    }
+    B2INFO("Material map written to " << m_materialMapFile);
+    return materialMap;
+  }
+
+  auto materialMap = MaterialMap::read(m_materialMapFile, geometryKey, binning);
+  if (!materialMap) {
+    B2FATAL("No usable material map in " << m_materialMapFile << ". Create it for this geometry and binning with "
+            "createMaterialMap=True.");
+  }
+  B2INFO("Using the material map from " << m_materialMapFile);
+  return materialMap;
+}
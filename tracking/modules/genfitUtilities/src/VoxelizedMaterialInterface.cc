@@ -0,0 +1,225 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+#include <tracking/modules/genfitUtilities/VoxelizedMaterialInterface.h>
+#include <framework/logging/Logger.h>
+#include <geometry/GeometryManager.h>
+
+#include "genfit/RKTrackRep.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "G4ThreeVector.hh"
+#include "G4Navigator.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+
+using namespace Belle2;
+
+VoxelizedMaterialInterface::VoxelizedMaterialInterface(std::shared_ptr<const MaterialMap> materialMap)
+  : m_materialMap(std::move(materialMap))
+{
+}
+
+VoxelizedMaterialInterface::~VoxelizedMaterialInterface()
+{
+}
+
+genfit::AbsMaterialInterface* VoxelizedMaterialInterface::clone() const
+{
+  VoxelizedMaterialInterface* copy = new VoxelizedMaterialInterface(m_materialMap);
+  copy->setDebugLvl(debugLvl_);
+  return copy;
+}
+
+
+std::unique_ptr<MaterialMap>
+VoxelizedMaterialInterface::createMaterialMap(const MaterialMap::Binning& binning, unsigned int raysPerAxis)
+{
+  G4VPhysicalVolume* world = geometry::GeometryManager::getInstance().getTopVolume();
+  if (!world) {
+    B2FATAL("No geometry set up so far. Load the geometry module.");
+  }
+  G4Navigator navigator;
+  navigator.SetWorldVolume(world);
+
+  auto materialMap = std::make_unique<MaterialMap>(binning);
+  B2INFO("Creating the material map with " << materialMap->getNumberOfVoxels() << " voxels and " << raysPerAxis * raysPerAxis
+         << " radial rays per phi-z column of voxels.");
+
+  const double rWidth = binning.rMax / binning.nR;
+  const double phiWidth = 2 * M_PI / binning.nPhi;
+  const double zWidth = (binning.zMax - binning.zMin) / binning.nZ;
+  // shortest step along a ray, so that we never get stuck on a boundary
+  const double minStep = 1e-6; // cm
+
+  // volume (in units of rWidth^2 / 2 per ray) of every Geant4 material in every r bin of the current column
+  std::vector<std::map<const G4Material*, double>> volumes(binning.nR);
+  std::map<const G4Material*, genfit::Material> convertedMaterials;
+  std::vector<genfit::Material> materials;
+  std::vector<double> materialVolumes;
+  for (std::uint32_t iPhi = 0; iPhi < binning.nPhi; ++iPhi) {
+    for (std::uint32_t iZ = 0; iZ < binning.nZ; ++iZ) {
+      for (auto& binVolumes : volumes) {
+        binVolumes.clear();
+      }
+
+      for (unsigned int jPhi = 0; jPhi < raysPerAxis; ++jPhi) {
+        for (unsigned int jZ = 0; jZ < raysPerAxis; ++jZ) {
+          const double phi = (iPhi + (jPhi + 0.5) / raysPerAxis) * phiWidth;
+          const double z = binning.zMin + (iZ + (jZ + 0.5) / raysPerAxis) * zWidth;
+          const G4ThreeVector direction(std::cos(phi), std::sin(phi), 0);
+          const auto pointAt = [&](double radius) {
+            return G4ThreeVector(radius * std::cos(phi), radius * std::sin(phi), z) * CLHEP::cm;
+          };
+
+          // Follow the ray from the axis to the outer radius and add the volume element
+          // r dr of every piece of it to the r bins it crosses.
+          double r = 0;
+          G4VPhysicalVolume* volume = navigator.LocateGlobalPointAndSetup(pointAt(r), &direction, false, false);
+          while (r < binning.rMax) {
+            double safety;
+            double step = navigator.ComputeStep(pointAt(r), direction, (binning.rMax - r) * CLHEP::cm, safety);
+            const bool geometricallyLimited = step != kInfinity;
+            step = geometricallyLimited ? std::max(step / CLHEP::cm, minStep) : binning.rMax - r;
+            const double rEnd = std::min(r + step, binning.rMax);
+
+            const G4Material* material = (volume ? volume : world)->GetLogicalVolume()->GetMaterial();
+            for (auto iR = static_cast<std::uint32_t>(r / rWidth); iR < binning.nR and iR * rWidth < rEnd; ++iR) {
+              const double rLow = std::max(r, iR * rWidth) / rWidth;
+              const double rHigh = std::min(rEnd, (iR + 1) * rWidth) / rWidth;
+              volumes[iR][material] += rHigh * rHigh - rLow * rLow;
+            }
+
+            r = rEnd;
+            if (geometricallyLimited) {
+              navigator.SetGeometricallyLimitedStep();
+            }
+            volume = navigator.LocateGlobalPointAndSetup(pointAt(r), &direction, true);
+          }
+        }
+      }
+
+      for (std::uint32_t iR = 0; iR < binning.nR; ++iR) {
+        materials.clear();
+        materialVolumes.clear();
+        for (const auto& [material, volume] : volumes[iR]) {
+          auto converted = convertedMaterials.find(material);
+          if (converted == convertedMaterials.end()) {
+            converted = convertedMaterials.emplace(material, Geant4MaterialInterface::convertMaterial(material)).first;
+          }
+          materials.push_back(converted->second);
+          materialVolumes.push_back(volume);
+        }
+        materialMap->setMaterial(materialMap->getVoxelIndex(iR, iPhi, iZ), MaterialMap::average(materials, materialVolumes));
+      }
+    }
+  }
+
+  B2INFO("Material map created with " << materialMap->getNumberOfMaterials() << " distinct materials.");
+  return materialMap;
+}
+
+
+bool
+VoxelizedMaterialInterface::initTrack(double posX, double posY, double posZ,
+                                      double dirX, double dirY, double dirZ)
+{
+  const std::uint32_t material = m_materialMap->getMaterialIndex(posX, posY, posZ);
+  if (material == MaterialMap::c_noMaterial) {
+    const bool wasInside = m_currentMaterial != MaterialMap::c_noMaterial;
+    m_currentMaterial = material;
+    // always keep the navigator in sync when we are outside of the map
+    return m_geant4Interface.initTrack(posX, posY, posZ, dirX, dirY, dirZ) or wasInside;
+  }
+
+  const bool materialChanged = material != m_currentMaterial;
+  m_currentMaterial = material;
+  return materialChanged;
+}
+
+
+genfit::Material
+VoxelizedMaterialInterface::getMaterialParameters()
+{
+  if (m_currentMaterial == MaterialMap::c_noMaterial) {
+    return m_geant4Interface.getMaterialParameters();
+  }
+  return m_materialMap->getMaterial(m_currentMaterial);
+}
+
+
+double
+VoxelizedMaterialInterface::findNextBoundary(const genfit::RKTrackRep* rep,
+                                             const genfit::M1x7& stateOrig,
+                                             double sMax, // signed
+                                             bool varField)
+{
+  if (m_currentMaterial == MaterialMap::c_noMaterial) {
+    return m_geant4Interface.findNextBoundary(rep, stateOrig, sMax, varField);
+  }
+
+  const double delta(1.E-2); // cm, precision of the boundary position
+  const double epsilon(1.E-1); // cm, allowed upper bound on arch deviation from straight line
+
+  const int stepSign(sMax < 0 ? -1 : 1);
+  const double maxStep = std::fabs(sMax);
+  const double startX = stateOrig[0], startY = stateOrig[1], startZ = stateOrig[2];
+  const double dirX = stepSign * stateOrig[3], dirY = stepSign * stateOrig[4], dirZ = stepSign * stateOrig[5];
+  const auto materialAt = [&](double s) {
+    return m_materialMap->getMaterialIndex(startX + s * dirX, startY + s * dirY, startZ + s * dirZ);
+  };
+
+  // Walk along the straight line in steps smaller than the voxels until the material changes,
+  // then narrow the position of the change down by bisection.
+  double inside = 0; // the material is unchanged up to here
+  double boundary = maxStep;
+  while (inside < maxStep) {
+    const double next = std::min(maxStep, inside + m_materialMap->getStepSize(startX + inside * dirX, startY + inside * dirY,
+                                                                               startZ + inside * dirZ));
+    if (materialAt(next) != m_currentMaterial) {
+      double outside = next;
+      while (outside - inside > delta) {
+        const double middle = 0.5 * (inside + outside);
+        if (materialAt(middle) == m_currentMaterial) {
+          inside = middle;
+        } else {
+          outside = middle;
+        }
+      }
+      boundary = outside;
+      break;
+    }
+    inside = next;
+  }
+
+  // The straight line is only a good estimate as long as the curved track stays close to it.
+  // Otherwise take a shorter step, the caller will ask again from there.
+  double step = boundary;
+  genfit::M1x3 SA;
+  while (step > delta) {
+    genfit::M1x7 state7 = stateOrig;
+    rep->RKPropagate(state7, nullptr, SA, stepSign * step, varField);
+    const double dist2 = (std::pow(state7[0] - startX, 2)
+                          + std::pow(state7[1] - startY, 2)
+                          + std::pow(state7[2] - startZ, 2));
+    // Maximal lateral deviation² of the curved path from the straight line
+    const double maxDeviation2 = 0.25 * (step * step - dist2);
+    if (maxDeviation2 <= epsilon * epsilon) {
+      break;
+    }
+    step *= 0.5;
+  }
+
+  B2DEBUG(20, "   next material change in the map @ " << stepSign * boundary << ", step " << stepSign * step);
+  return stepSign * step;
+}
@@ -15,10 +15,12 @@
 #include <tracking/dataobjects/RecoTrack.h>
 
 #include <framework/geometry/B2Vector3.h>
+#include <memory>
 #include <vector>
 #include <string>
 
 namespace Belle2 {
+  class ParallelTrackFitter;
 
   /**
    * Takes RecoTracks coming from the event reconstructions and fits them
@@ -40,7 +42,19 @@ namespace Belle2 {
     /// Build/fit the track fit results.
     void event() override;
 
+    /// Stop the fitting threads.
+    void terminate() override;
+
+    /// Destructor, defined in the source file for the forward declared members.
+    ~TrackCreatorModule();
+
   private:
+    /// Check whether the track should be fitted with the given hypothesis according to the TrackFitMomentumRange
+    bool isInTrackFitMomentumRange(RecoTrack& recoTrack, int pdg) const;
+
+    /// Fit the tracks of the event with the ParallelTrackFitter, the same as in event() but for all tracks at once.
+    void fitInParallel(bool fromTrackCreator);
+
     // Input
     /// Name of collection holding the RecoTracks (input).
     std::string m_recoTrackColName = "";
@@ -79,7 +93,13 @@ namespace Belle2 {
     /// TrackFitMomentumRange Database OjbPtr
     DBObjPtr<TrackFitMomentumRange> m_trackFitMomentumRange;
 
+    /// Number of threads for fitting the tracks of one event
+    unsigned int m_numberOfThreads = 1;
+
     StoreArray<RecoTrack> m_RecoTracks; /**< RecoTracks StoreArray */
 
+    /// Fitter distributing the tracks over the threads, only used for more than one thread
+    std::unique_ptr<ParallelTrackFitter> m_parallelFitter;
+
   };
 }
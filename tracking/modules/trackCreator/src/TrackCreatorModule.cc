@@ -15,6 +15,9 @@
 
 #include <tracking/trackFitting/trackBuilder/factories/TrackBuilder.h>
 #include <tracking/trackFitting/fitter/base/TrackFitter.h>
+#include <tracking/trackFitting/fitter/base/ParallelTrackFitter.h>
+
+#include <algorithm>
 
 using namespace Belle2;
 
@@ -55,9 +58,12 @@ TrackCreatorModule::TrackCreatorModule() :
   addParam("stopOnSuccessfulTrackFit", m_stopOnSuccessfulTrackFit, "Flag to stop creating new tracks when a particle hypothesis "
            "leads to a successful track fit. Switched off by default (fit all given pdg codes) but turned on before HLT filter for optimzation",
            m_stopOnSuccessfulTrackFit);
-
+  addParam("numberOfThreads", m_numberOfThreads, "Number of threads for fitting the tracks of one event. "
+           "The results do not depend on the number of threads.", m_numberOfThreads);
 }
 
+TrackCreatorModule::~TrackCreatorModule() = default;
+
 void TrackCreatorModule::initialize()
 {
   m_RecoTracks.isRequired(m_recoTrackColName);
@@ -99,30 +105,19 @@ void TrackCreatorModule::event()
 
   // Here, the last parameter is fromTrackCreator, necessary to set the priority of eventT0
   const bool fromTrackCreator = !m_trackFitResultColName.ends_with("_flipped");
+
+  if (m_numberOfThreads > 1) {
+    fitInParallel(fromTrackCreator);
+    return;
+  }
+
   TrackFitter trackFitter(DAFConfiguration::c_Default, "", "", "", "", "", true, fromTrackCreator);
   TrackBuilder trackBuilder(m_trackColName, m_trackFitResultColName, m_beamSpotAsTVector, m_beamAxisAsTVector);
   for (auto& recoTrack : m_RecoTracks) {
     for (const auto& pdg : m_pdgCodes) {
       // Does not refit in case the particle hypotheses demanded in this module have already been fitted before.
       // Otherwise fits them with the default fitter.
-
-      double initialTotalMomentum = recoTrack.getMomentumSeed().R(); // this is the MomentumSeed
-      if (!m_useSeedForTrackFitMomentumRange) {
-        // if we decide to use the previous track fit momentum for the trackFitMomentumRange selection
-        if (recoTrack.wasFitSuccessful()) {
-          // If the previous fit has been successful
-          genfit::MeasuredStateOnPlane msop = recoTrack.getMeasuredStateOnPlaneFromFirstHit();
-          initialTotalMomentum =  recoTrack.getCardinalRepresentation()->getMomMag(msop);
-        } else {
-          B2DEBUG(25, "No previous successful fit, using seed value instead");
-        }
-      }
-
-      B2DEBUG(25, "Trying to fit with PDG = " << pdg);
-      B2DEBUG(25, "PDG hypothesis: " << pdg << "\tMomentum cut: " << m_trackFitMomentumRange->getMomentumRange(
-                pdg) << "\tSeed p: " << initialTotalMomentum);
-
-      if (initialTotalMomentum <= m_trackFitMomentumRange->getMomentumRange(pdg)) {
+      if (isInTrackFitMomentumRange(recoTrack, pdg)) {
         trackFitter.fit(recoTrack, Const::ParticleType(abs(pdg)));
       }
       if (m_stopOnSuccessfulTrackFit) {
@@ -134,3 +129,68 @@ void TrackCreatorModule::event()
     trackBuilder.storeTrackFromRecoTrack(recoTrack, m_useClosestHitToIP);
   }
 }
+
+void TrackCreatorModule::fitInParallel(bool fromTrackCreator)
+{
+  // The threads are started in the event loop, as they would not survive the fork of the parallel processing
+  if (not m_parallelFitter) {
+    m_parallelFitter = std::make_unique<ParallelTrackFitter>(m_numberOfThreads);
+  }
+  m_parallelFitter->resetFitters([fromTrackCreator]() {
+    return std::make_unique<TrackFitter>(DAFConfiguration::c_Default, "", "", "", "", "", true, fromTrackCreator);
+  });
+
+  std::vector<RecoTrack*> remainingTracks;
+  for (auto& recoTrack : m_RecoTracks) {
+    remainingTracks.push_back(&recoTrack);
+  }
+
+  // one hypothesis after the other for all tracks, so every track sees the same sequence of fits as in event()
+  for (const auto& pdg : m_pdgCodes) {
+    std::vector<RecoTrack*> tracksToFit;
+    for (RecoTrack* recoTrack : remainingTracks) {
+      if (isInTrackFitMomentumRange(*recoTrack, pdg)) {
+        tracksToFit.push_back(recoTrack);
+      }
+    }
+    m_parallelFitter->fit(tracksToFit, Const::ChargedStable(abs(pdg)));
+
+    if (m_stopOnSuccessfulTrackFit) {
+      remainingTracks.erase(std::remove_if(remainingTracks.begin(), remainingTracks.end(), [](RecoTrack * recoTrack) {
+        return recoTrack->wasFitSuccessful();
+      }), remainingTracks.end());
+    }
+  }
+
+  // the tracks are stored in the order of the RecoTracks
+  TrackBuilder trackBuilder(m_trackColName, m_trackFitResultColName, m_beamSpotAsTVector, m_beamAxisAsTVector);
+  for (auto& recoTrack : m_RecoTracks) {
+    trackBuilder.storeTrackFromRecoTrack(recoTrack, m_useClosestHitToIP);
+  }
+}
+
+bool TrackCreatorModule::isInTrackFitMomentumRange(RecoTrack& recoTrack, int pdg) const
+{
+  double initialTotalMomentum = recoTrack.getMomentumSeed().R(); // this is the MomentumSeed
+  if (!m_useSeedForTrackFitMomentumRange) {
+    // if we decide to use the previous track fit momentum for the trackFitMomentumRange selection
+    if (recoTrack.wasFitSuccessful()) {
+      // If the previous fit has been successful
+      genfit::MeasuredStateOnPlane msop = recoTrack.getMeasuredStateOnPlaneFromFirstHit();
+      initialTotalMomentum =  recoTrack.getCardinalRepresentation()->getMomMag(msop);
+    } else {
+      B2DEBUG(25, "No previous successful fit, using seed value instead");
+    }
+  }
+
+  B2DEBUG(25, "Trying to fit with PDG = " << pdg);
+  B2DEBUG(25, "PDG hypothesis: " << pdg << "\tMomentum cut: " << m_trackFitMomentumRange->getMomentumRange(
+            pdg) << "\tSeed p: " << initialTotalMomentum);
+
+  return initialTotalMomentum <= m_trackFitMomentumRange->getMomentumRange(pdg);
+}
+
+void TrackCreatorModule::terminate()
+{
+  m_parallelFitter.reset();
+}
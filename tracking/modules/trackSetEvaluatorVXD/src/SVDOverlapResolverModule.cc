@@ -16,6 +16,7 @@
 #include <tracking/trackFindingVXD/trackSetEvaluator/OverlapMatrixCreator.h>
 #include <tracking/trackFindingVXD/trackSetEvaluator/HopfieldNetwork.h>
 #include <tracking/trackFindingVXD/trackSetEvaluator/Scrooge.h>
+#include <tracking/trackFindingVXD/trackSetEvaluator/IndependentSetSelector.h>
 #include <tracking/trackFindingVXD/trackSetEvaluator/OverlapResolverNodeInfo.h>
 
 #include <vxd/geometry/SensorInfoBase.h>
@@ -35,8 +36,8 @@ SVDOverlapResolverModule::SVDOverlapResolverModule() : Module()
 
   addParam("NameSVDClusters", m_nameSVDClusters, "Name of expected StoreArray.", std::string(""));
 
-  addParam("ResolveMethod", m_resolveMethod, "Strategy used to resolve overlaps. Currently implemented are \"greedy\" and "
-           " \"hopfield\" ", std::string("greedy"));
+  addParam("ResolveMethod", m_resolveMethod, "Strategy used to resolve overlaps. Currently implemented are \"greedy\", "
+           "\"hopfield\" and \"independentSet\" (greedy selection improved by a local search).", std::string("greedy"));
 
   addParam("minActivityState", m_minActivityState, "Sets the minimal value of activity for acceptance. (0,1)",
            float(0.7));
@@ -48,8 +49,9 @@ void SVDOverlapResolverModule::initialize()
   m_spacePointTrackCands.isRequired(m_nameSpacePointTrackCands);
   m_svdClusters.isRequired(m_nameSVDClusters);
 
-  B2ASSERT("ResolveMethod has to be either 'greedy' or 'hopfield'. Selected ResolveMethod: " << m_resolveMethod,
-           m_resolveMethod == "greedy" || m_resolveMethod == "hopfield");
+  B2ASSERT("ResolveMethod has to be either 'greedy', 'hopfield' or 'independentSet'. Selected ResolveMethod: "
+           << m_resolveMethod,
+           m_resolveMethod == "greedy" || m_resolveMethod == "hopfield" || m_resolveMethod == "independentSet");
 }
 
 void SVDOverlapResolverModule::event()
@@ -123,6 +125,11 @@ void SVDOverlapResolverModule::event()
     if (hopfieldNetwork.doHopfield(qiTrackOverlap, maxIterations) == maxIterations) {
       B2WARNING("Hopfield Network failed converge.");
     }
+
+  } else if (m_resolveMethod == "independentSet") {
+    //select non overlapping candidates with a large sum of quality indicators
+    IndependentSetSelector independentSetSelector;
+    independentSetSelector.performSelection(qiTrackOverlap);
   }
 
   for (auto&& track : qiTrackOverlap) {
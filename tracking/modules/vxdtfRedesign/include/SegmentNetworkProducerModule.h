@@ -118,6 +118,18 @@ namespace Belle2 {
     void buildSegmentNetwork();
 
 
+    /** Stops the filling of the network of TrackNodes after a limit was exceeded: the event is marked as aborted.
+     *  Returns true if the SegmentNetwork should be built anyway from the TrackNodes linked so far.
+     */
+    bool stopTrackNodeNetwork(unsigned int nLinked, unsigned int nAdded);
+
+
+    /** Stops the filling of the SegmentNetwork after a limit was exceeded: the event is marked as aborted and the
+     *  SegmentNetwork is cleared, unless the network built so far should be kept.
+     */
+    void stopSegmentNetwork(unsigned int nLinked, unsigned int nAdded);
+
+
   protected:
     /** Module Parameters */
     /// Vector with SpacePoint storeArray names.
@@ -165,6 +177,9 @@ namespace Belle2 {
     /// Maximal number of added hit connections; if exceeded, filling of HitNetwork will be stopped and the event skipped.
     unsigned int m_PARAMmaxTrackNodeAddedConnections = 200000;
 
+    /// If true, the networks built so far are kept if one of their limits is exceeded instead of skipping the event.
+    bool m_PARAMkeepTruncatedSegmentNetwork = false;
+
 
     /** Member Variables */
     /// Vector for coordinates of virtual IP.
@@ -100,6 +100,13 @@ SegmentNetworkProducerModule::SegmentNetworkProducerModule() : Module()
            m_PARAMmaxTrackNodeAddedConnections,
            "Maximal number of added Hit connections; if exceeded, the event execution will be skipped.",
            m_PARAMmaxTrackNodeAddedConnections);
+
+  addParam("keepTruncatedSegmentNetwork",
+           m_PARAMkeepTruncatedSegmentNetwork,
+           "If true and one of the limits of the network of TrackNodes or of the SegmentNetwork is exceeded, the networks "
+           "built so far are kept and processed by the following modules instead of skipping the event. "
+           "The event is marked as aborted anyway.",
+           m_PARAMkeepTruncatedSegmentNetwork);
 }
 
 void SegmentNetworkProducerModule::initialize()
@@ -314,6 +321,9 @@ bool SegmentNetworkProducerModule::buildTrackNodeNetwork()
   DirectedNodeNetwork<Belle2::TrackNode, VoidMetaInfo>& hitNetwork = m_network->accessHitNetwork();
 
   unsigned int nLinked = 0, nAdded = 0;
+  const std::string stopMessage = m_PARAMkeepTruncatedSegmentNetwork ?
+                                  "! VXDTF2 continues with the network of TrackNodes built so far." :
+                                  "! The event will be skipped and not be processed.";
 
   // loop over outer sectors to get their hits(->outerHits) and inner sectors
   for (auto* outerSector : activeSectorNetwork.getNodes()) {
@@ -381,19 +391,13 @@ bool SegmentNetworkProducerModule::buildTrackNodeNetwork()
 
           if (nLinked > m_PARAMmaxTrackNodeConnections) {
             B2WARNING("Number of TrackNodeConnections has exceeded maximal size limit of " << m_PARAMmaxTrackNodeConnections
-                      << "! The event will be skipped and not be processed. The number of connections was = " << nLinked);
-            m_eventLevelTrackingInfo->setVXDTF2AbortionFlag();
-            m_network->set_trackNodeConnections(nLinked);
-            m_network->set_trackNodeAddedConnections(nAdded);
-            return false;
+                      << stopMessage << " The number of connections was = " << nLinked);
+            return stopTrackNodeNetwork(nLinked, nAdded);
           }
           if (nAdded > m_PARAMmaxTrackNodeAddedConnections) {
             B2WARNING("Number of added TrackNodeConnections has exceeded maximal size limit of " << m_PARAMmaxTrackNodeAddedConnections
-                      << "! The event will be skipped and not be processed. The number of connections was = " << nAdded);
-            m_eventLevelTrackingInfo->setVXDTF2AbortionFlag();
-            m_network->set_trackNodeConnections(nLinked);
-            m_network->set_trackNodeAddedConnections(nAdded);
-            return false;
+                      << stopMessage << " The number of connections was = " << nAdded);
+            return stopTrackNodeNetwork(nLinked, nAdded);
           }
         }
       }
@@ -418,6 +422,9 @@ void SegmentNetworkProducerModule::buildSegmentNetwork()
   DirectedNodeNetwork<Segment<Belle2::TrackNode>, CACell>& segmentNetwork = m_network->accessSegmentNetwork();
   std::deque<Belle2::Segment<Belle2::TrackNode>>& segments = m_network->accessSegments();
   unsigned int nLinked = 0, nAdded = 0;
+  const std::string stopMessage = m_PARAMkeepTruncatedSegmentNetwork ?
+                                  ". VXDTF2 continues with the SegmentNetwork built so far." :
+                                  ". VXDTF2 will skip the event and the SegmentNetwork is cleared.";
 
   for (DirectedNode<TrackNode, VoidMetaInfo>* outerHit : hitNetwork.getNodes()) {
     const std::vector<DirectedNode<TrackNode, VoidMetaInfo>*>& centerHits = outerHit->getInnerNodes();
@@ -505,31 +512,19 @@ void SegmentNetworkProducerModule::buildSegmentNetwork()
         }
 
         if (nLinked > m_PARAMmaxSegmentConnections) {
-          B2WARNING("Number of SegmentConnections exceeds the limit of " << m_PARAMmaxSegmentConnections
-                    << ". VXDTF2 will skip the event and the SegmentNetwork is cleared.");
-          m_eventLevelTrackingInfo->setVXDTF2AbortionFlag();
-          m_network->set_segmentConnections(nLinked);
-          m_network->set_segmentAddedConnections(nAdded);
-          m_network->clear();
+          B2WARNING("Number of SegmentConnections exceeds the limit of " << m_PARAMmaxSegmentConnections << stopMessage);
+          stopSegmentNetwork(nLinked, nAdded);
           return;
         }
         if (nAdded > m_PARAMmaxSegmentAddedConnections) {
-          B2WARNING("Number of added SegmentConnections exceeds the limit of " << m_PARAMmaxSegmentAddedConnections
-                    << ". VXDTF2 will skip the event and the SegmentNetwork is cleared.");
-          m_eventLevelTrackingInfo->setVXDTF2AbortionFlag();
-          m_network->set_segmentConnections(nLinked);
-          m_network->set_segmentAddedConnections(nAdded);
-          m_network->clear();
+          B2WARNING("Number of added SegmentConnections exceeds the limit of " << m_PARAMmaxSegmentAddedConnections << stopMessage);
+          stopSegmentNetwork(nLinked, nAdded);
           return;
         }
         if (segments.size() > m_PARAMmaxNetworkSize) {
           B2WARNING("SegmentNetwork size exceeds the limit of " << m_PARAMmaxNetworkSize
-                    << ". Network size is " << segmentNetwork.size()
-                    << ". VXDTF2 will skip the event and the SegmentNetwork is cleared.");
-          m_eventLevelTrackingInfo->setVXDTF2AbortionFlag();
-          m_network->set_segmentConnections(nLinked);
-          m_network->set_segmentAddedConnections(nAdded);
-          m_network->clear();
+                    << ". Network size is " << segmentNetwork.size() << stopMessage);
+          stopSegmentNetwork(nLinked, nAdded);
           return;
         }
       }
@@ -544,3 +539,23 @@ void SegmentNetworkProducerModule::buildSegmentNetwork()
     DNN::printCANetwork<Segment<Belle2::TrackNode>>(segmentNetwork, "CA" + fileName);
   }
 }
+
+
+bool SegmentNetworkProducerModule::stopTrackNodeNetwork(unsigned int nLinked, unsigned int nAdded)
+{
+  m_eventLevelTrackingInfo->setVXDTF2AbortionFlag();
+  m_network->set_trackNodeConnections(nLinked);
+  m_network->set_trackNodeAddedConnections(nAdded);
+  return m_PARAMkeepTruncatedSegmentNetwork;
+}
+
+
+void SegmentNetworkProducerModule::stopSegmentNetwork(unsigned int nLinked, unsigned int nAdded)
+{
+  m_eventLevelTrackingInfo->setVXDTF2AbortionFlag();
+  m_network->set_segmentConnections(nLinked);
+  m_network->set_segmentAddedConnections(nAdded);
+  if (not m_PARAMkeepTruncatedSegmentNetwork) {
+    m_network->clear();
+  }
+}
@@ -1198,7 +1198,7 @@ def add_vxd_track_finding_vxdtf2(
     if filter_overlapping:
         overlapResolver = register_module('SVDOverlapResolver')
         overlapResolver.param('NameSpacePointTrackCands', nameSPTCs)
-        overlapResolver.param('ResolveMethod', 'greedy')  # other option is  'hopfield'
+        overlapResolver.param('ResolveMethod', 'greedy')  # other options are 'hopfield' and 'independentSet'
         overlapResolver.param('NameSVDClusters', svd_clusters)
         path.add_module(overlapResolver)
 
@@ -0,0 +1,135 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#include <tracking/trackFitting/materialMap/MaterialMap.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+using namespace Belle2;
+
+namespace {
+  /// Binning used in all tests: 10 cm in r, 4 bins in phi, 5 cm in z
+  MaterialMap::Binning getTestBinning()
+  {
+    MaterialMap::Binning binning;
+    binning.rMax = 100;
+    binning.zMin = -50;
+    binning.zMax = 50;
+    binning.nR = 10;
+    binning.nPhi = 4;
+    binning.nZ = 20;
+    return binning;
+  }
+
+  /// Test the voxel lookup and the inverse
+  TEST(MaterialMap, Voxels)
+  {
+    const MaterialMap materialMap(getTestBinning());
+    EXPECT_EQ(materialMap.getNumberOfVoxels(), 10u * 4u * 20u);
+
+    EXPECT_EQ(materialMap.getVoxel(0, 0, 100), MaterialMap::c_noMaterial);
+    EXPECT_EQ(materialMap.getVoxel(0, 0, -50.1), MaterialMap::c_noMaterial);
+    EXPECT_EQ(materialMap.getVoxel(80, 80, 0), MaterialMap::c_noMaterial);
+
+    // first r, first phi (0-90 degree) and the z bin from 0 to 5 cm
+    EXPECT_EQ(materialMap.getVoxel(1, 1, 1), 10u);
+    // second phi bin (90-180 degree)
+    EXPECT_EQ(materialMap.getVoxel(-1, 1, 1), 30u);
+    // last phi bin (270-360 degree): negative angles are mapped to the end
+    EXPECT_EQ(materialMap.getVoxel(1, -1, 1), 70u);
+
+    EXPECT_EQ(materialMap.getVoxelIndex(0, 0, 10), 10u);
+    EXPECT_EQ(materialMap.getVoxelIndex(9, 3, 19), 799u);
+
+    for (std::uint32_t voxel : {0u, 123u, 799u}) {
+      const auto center = materialMap.getPointInVoxel(voxel, 0.5, 0.5, 0.5);
+      EXPECT_EQ(materialMap.getVoxel(center[0], center[1], center[2]), voxel);
+      const auto corner = materialMap.getPointInVoxel(voxel, 0.01, 0.99, 0.01);
+      EXPECT_EQ(materialMap.getVoxel(corner[0], corner[1], corner[2]), voxel);
+    }
+
+    // half of the smallest voxel extent, but never smaller than the phi bin at the first r bin
+    EXPECT_DOUBLE_EQ(materialMap.getStepSize(0, 0, 0), 2.5);
+    EXPECT_DOUBLE_EQ(materialMap.getStepSize(90, 0, 0), 2.5);
+  }
+
+  /// Test the averaging of materials
+  TEST(MaterialMap, Average)
+  {
+    const genfit::Material silicon(2.33, 14, 28.0855, 9.37, 173);
+    const genfit::Material vacuum(1e-25, 1, 1.008, 1e25, 19.2);
+
+    const genfit::Material single = MaterialMap::average({silicon}, {2});
+    EXPECT_NEAR(single.density, silicon.density, 1e-12);
+    EXPECT_NEAR(single.Z, silicon.Z, 1e-12);
+    EXPECT_NEAR(single.A, silicon.A, 1e-12);
+    EXPECT_NEAR(single.radiationLength, silicon.radiationLength, 1e-12);
+    EXPECT_NEAR(single.mEE, silicon.mEE, 1e-9);
+
+    // a quarter silicon: the number of radiation lengths and the electrons stay the same
+    const genfit::Material mixed = MaterialMap::average({silicon, vacuum}, {1, 3});
+    EXPECT_NEAR(mixed.density, silicon.density / 4, 1e-12);
+    EXPECT_NEAR(mixed.radiationLength, silicon.radiationLength * 4, 1e-9);
+    EXPECT_NEAR(mixed.density * mixed.Z / mixed.A, silicon.density * silicon.Z / silicon.A / 4, 1e-12);
+    EXPECT_NEAR(mixed.mEE, silicon.mEE, 1e-6);
+
+    // a 50 um silicon layer in a 5 mm voxel: crossing the voxel gives the radiation lengths of the layer
+    const genfit::Material thinLayer = MaterialMap::average({vacuum, silicon, vacuum}, {0.2, 0.005, 0.295});
+    EXPECT_NEAR(0.5 / thinLayer.radiationLength, 0.005 / silicon.radiationLength, 1e-12);
+    EXPECT_NEAR(thinLayer.density * 0.5, silicon.density * 0.005, 1e-12);
+
+    // only vacuum
+    const genfit::Material empty = MaterialMap::average({vacuum, vacuum}, {1, 1});
+    EXPECT_NEAR(empty.density, vacuum.density, 1e-30);
+  }
+
+  /// Test the material table and writing and reading back the map
+  TEST(MaterialMap, WriteAndRead)
+  {
+    MaterialMap materialMap(getTestBinning());
+    const genfit::Material silicon(2.33, 14, 28.0855, 9.37, 173);
+    const genfit::Material air(0.0012, 7.3, 14.7, 30390, 85.7);
+    for (std::uint32_t voxel = 0; voxel < materialMap.getNumberOfVoxels(); ++voxel) {
+      materialMap.setMaterial(voxel, voxel % 2 ? silicon : air);
+    }
+    // nearly the same material again
+    materialMap.setMaterial(1, genfit::Material(2.33000001, 14, 28.0855, 9.37, 173));
+    EXPECT_EQ(materialMap.getNumberOfMaterials(), 2u);
+
+    const auto center = materialMap.getPointInVoxel(1, 0.5, 0.5, 0.5);
+    const std::uint32_t index = materialMap.getMaterialIndex(center[0], center[1], center[2]);
+    EXPECT_DOUBLE_EQ(materialMap.getMaterial(index).radiationLength, silicon.radiationLength);
+    EXPECT_EQ(materialMap.getMaterialIndex(0, 0, 100), MaterialMap::c_noMaterial);
+
+    const std::string fileName = "materialMapTest-" + std::to_string(getpid()) + ".bin";
+    ASSERT_TRUE(materialMap.write(fileName, "geometry:1"));
+
+    EXPECT_EQ(MaterialMap::read(fileName, "geometry:2", getTestBinning()), nullptr);
+    MaterialMap::Binning otherBinning = getTestBinning();
+    otherBinning.nPhi = 8;
+    EXPECT_EQ(MaterialMap::read(fileName, "geometry:1", otherBinning), nullptr);
+
+    const auto readMap = MaterialMap::read(fileName, "geometry:1", getTestBinning());
+    ASSERT_NE(readMap, nullptr);
+    EXPECT_EQ(readMap->getNumberOfMaterials(), 2u);
+    for (std::uint32_t voxel = 0; voxel < materialMap.getNumberOfVoxels(); ++voxel) {
+      const auto point = materialMap.getPointInVoxel(voxel, 0.5, 0.5, 0.5);
+      const std::uint32_t readIndex = readMap->getMaterialIndex(point[0], point[1], point[2]);
+      EXPECT_DOUBLE_EQ(readMap->getMaterial(readIndex).density,
+                       materialMap.getMaterial(materialMap.getMaterialIndex(point[0], point[1], point[2])).density);
+    }
+    std::remove(fileName.c_str());
+
+    EXPECT_EQ(MaterialMap::read(fileName, "geometry:1", getTestBinning()), nullptr);
+  }
+}
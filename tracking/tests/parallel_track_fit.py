@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+
+##########################################################################
+# basf2 (Belle II Analysis Software Framework)                           #
+# Author: The Belle II Collaboration                                     #
+#                                                                        #
+# See git log for contributors and copyright holders.                    #
+# This file is licensed under LGPL-3.0, see LICENSE.md.                  #
+##########################################################################
+
+"""
+Fits the same events with one and with several threads and requires identical fit results,
+with and without the correction of the seed charge.
+"""
+
+from basf2 import set_random_seed, create_path, process, Module, B2FATAL
+from ROOT import Belle2
+from simulation import add_simulation
+from tracking import add_tracking_reconstruction
+
+
+class CollectFitResults(Module):
+    """Collect the fit results of all RecoTracks and Tracks"""
+
+    def __init__(self):
+        """Constructor"""
+        super().__init__()
+        #: list of the fit results per event
+        self.results = []
+
+    def event(self):
+        """Store the fit status of the RecoTracks and the parameters of all TrackFitResults"""
+        recoTracks = []
+        for recoTrack in Belle2.PyStoreArray('RecoTracks'):
+            fitted = recoTrack.wasFitSuccessful()
+            chi2 = recoTrack.getTrackFitStatus().getChi2() if fitted else 0
+            cardinalPDG = recoTrack.getCardinalRepresentation().getPDG() if fitted else 0
+            recoTracks.append((fitted, chi2, recoTrack.getNumberOfTrackingHits(), recoTrack.getChargeSeed(), cardinalPDG,
+                               sorted(rep.getPDG() for rep in recoTrack.getRepresentations())))
+        trackFitResults = []
+        for result in Belle2.PyStoreArray('TrackFitResults'):
+            trackFitResults.append((result.getParticleType().getPDGCode(), result.getPValue(),
+                                    result.getD0(), result.getPhi0(), result.getOmega(),
+                                    result.getZ0(), result.getTanLambda()))
+        self.results.append((recoTracks, trackFitResults))
+
+
+def fit(numberOfThreads, correctSeedCharge):
+    """Simulate and reconstruct the same events with the given number of fitting threads"""
+    set_random_seed(12345)
+    components = ['PXD', 'SVD', 'CDC']
+
+    main = create_path()
+    main.add_module('EventInfoSetter', evtNumList=[10])
+    main.add_module('ParticleGun', pdgCodes=[211, -211, 13, -13], nTracks=8)
+    add_simulation(main, components=components)
+    add_tracking_reconstruction(main, components=components)
+    for module in main.modules():
+        if module.type() in ['DAFRecoFitter', 'KalmanRecoFitter', 'TrackCreator']:
+            module.param('numberOfThreads', numberOfThreads)
+        if module.type() in ['DAFRecoFitter', 'KalmanRecoFitter']:
+            module.param('correctSeedCharge', correctSeedCharge)
+    collector = CollectFitResults()
+    main.add_module(collector)
+
+    process(main)
+    return collector.results
+
+
+if __name__ == "__main__":
+    for correctSeedCharge in [False, True]:
+        singleThread = fit(1, correctSeedCharge)
+        multiThread = fit(4, correctSeedCharge)
+
+        if singleThread != multiThread:
+            for event, (single, multi) in enumerate(zip(singleThread, multiThread)):
+                if single != multi:
+                    B2FATAL(f"Different fit results with one and with several threads in event {event} "
+                            f"(correctSeedCharge={correctSeedCharge})")
+            B2FATAL(f"Different number of events with one and with several threads (correctSeedCharge={correctSeedCharge})")
+        if not any(trackFitResults for recoTracks, trackFitResults in singleThread):
+            B2FATAL("No tracks were fitted, the test is meaningless")
@@ -0,0 +1,92 @@
+#!/usr/bin/env python3
+
+##########################################################################
+# basf2 (Belle II Analysis Software Framework)                           #
+# Author: The Belle II Collaboration                                     #
+#                                                                        #
+# See git log for contributors and copyright holders.                    #
+# This file is licensed under LGPL-3.0, see LICENSE.md.                  #
+##########################################################################
+
+"""
+Exceeds the limits of the SegmentNetworkProducer on the network of TrackNodes and on the SegmentNetwork and checks
+that the networks built so far are kept with keepTruncatedSegmentNetwork and dropped without it.
+"""
+
+from basf2 import set_random_seed, create_path, process, Module, B2FATAL
+from ROOT import Belle2
+from simulation import add_simulation
+from svd import add_svd_reconstruction
+from tracking.path_utils import add_vxd_track_finding_vxdtf2
+
+
+class CollectNetworks(Module):
+    """Collect the size of the networks of all events"""
+
+    def __init__(self):
+        """Constructor"""
+        super().__init__()
+        #: list of (aborted, number of TrackNode connections, number of Segment connections,
+        #: number of nodes in the SegmentNetwork) per event
+        self.networks = []
+
+    def event(self):
+        """Store the abortion flag of the VXDTF2 and the size of the networks"""
+        aborted = Belle2.PyStoreObj('EventLevelTrackingInfo').obj().hasVXDTF2AbortionFlag()
+        network = Belle2.PyStoreObj('SegmentNetwork').obj()
+        self.networks.append((aborted, network.get_trackNodeConnections(), network.get_segmentConnections(),
+                              network.sizeSegmentNetwork()))
+
+
+def run(**parameters):
+    """Simulate the same events and run the VXDTF2 with the given parameters of the SegmentNetworkProducer"""
+    set_random_seed(12345)
+    components = ['SVD']
+
+    main = create_path()
+    main.add_module('EventInfoSetter', evtNumList=[5])
+    main.add_module('ParticleGun', pdgCodes=[211, -211], nTracks=10)
+    add_simulation(main, components=components)
+    add_svd_reconstruction(main)
+    add_vxd_track_finding_vxdtf2(main, components=components)
+    for module in main.modules():
+        if module.type() == 'SegmentNetworkProducer':
+            for name, value in parameters.items():
+                module.param(name, value)
+    collector = CollectNetworks()
+    main.add_module(collector)
+
+    process(main)
+    return collector.networks
+
+
+if __name__ == "__main__":
+    reference = run()
+    if any(aborted for aborted, _, _, _ in reference):
+        B2FATAL("The VXDTF2 aborted an event without lowered limits")
+    if min(nSegments for _, _, _, nSegments in reference) == 0:
+        B2FATAL("An event without a SegmentNetwork, the test is meaningless")
+
+    # limits which are exceeded in every event
+    trackNodeLimit = min(nConnections for _, nConnections, _, _ in reference) // 2
+    segmentLimit = min(nConnections for _, _, nConnections, _ in reference) // 2
+
+    for keep in [True, False]:
+        truncated = run(maxHitConnections=trackNodeLimit, keepTruncatedSegmentNetwork=keep)
+        if not all(aborted and nConnections == trackNodeLimit + 1 for aborted, nConnections, _, _ in truncated):
+            B2FATAL(f"The limit on the TrackNode connections was not applied (keepTruncatedSegmentNetwork={keep})")
+        # the SegmentNetwork is only built from the truncated network of TrackNodes if it is kept
+        builtSegments = [nSegments > 0 for _, _, _, nSegments in truncated]
+        if keep and not any(builtSegments):
+            B2FATAL("No SegmentNetwork was built from the kept network of TrackNodes")
+        if not keep and any(builtSegments):
+            B2FATAL("A SegmentNetwork was built although the event should be skipped")
+
+        truncated = run(maxConnections=segmentLimit, keepTruncatedSegmentNetwork=keep)
+        if not all(aborted for aborted, _, _, _ in truncated):
+            B2FATAL(f"The limit on the Segment connections was not applied (keepTruncatedSegmentNetwork={keep})")
+        for _, _, nConnections, nSegments in truncated:
+            if keep and not (nConnections == segmentLimit + 1 and nSegments > 0):
+                B2FATAL("The truncated SegmentNetwork was not kept")
+            if not keep and nSegments > 0:
+                B2FATAL("The truncated SegmentNetwork was not cleared")
@@ -100,6 +100,10 @@ namespace Belle2 {
 
       /// Parameter to define precision of quadtree search in case of straight pass
       double m_param_precision = 0.00000001;
+
+    private:
+      /// Quad tree processor of the pass, kept over the events to reuse its node pool
+      std::unique_ptr<AxialHitQuadTreeProcessor> m_qtProcessor;
     };
   }
 }
@@ -95,6 +95,7 @@ void AxialTrackCreatorHitLegendre::exposeParameters(ModuleParamList* moduleParam
 void AxialTrackCreatorHitLegendre::initialize()
 {
   Super::initialize();
+  m_qtProcessor = constructQTProcessor(m_pass);
 }
 
 void AxialTrackCreatorHitLegendre::apply(const std::vector<const TrackingUtilities::CDCWireHit*>& axialWireHits,
@@ -109,10 +110,9 @@ void AxialTrackCreatorHitLegendre::apply(const std::vector<const TrackingUtiliti
     unusedAxialWireHits.push_back(wireHit);
   }
 
-  // Create quadtree processor
-  std::unique_ptr<AxialHitQuadTreeProcessor> qtProcessor = constructQTProcessor(m_pass);
-  qtProcessor->seed(unusedAxialWireHits);
-//   qtProcessor->drawHits(unusedAxialWireHits, 9);
+  // Fill the quadtree processor
+  m_qtProcessor->seed(unusedAxialWireHits);
+//   m_qtProcessor->drawHits(unusedAxialWireHits, 9);
 
   // Create object which contains interface between quadtree processor and track processor (module)
   std::unique_ptr<BaseCandidateReceiver> receiver;
@@ -123,7 +123,10 @@ void AxialTrackCreatorHitLegendre::apply(const std::vector<const TrackingUtiliti
   }
 
   // Start candidate finding
-  this->executeRelaxation(std::ref(*receiver), *qtProcessor);
+  this->executeRelaxation(std::ref(*receiver), *m_qtProcessor);
+
+  // The nodes stay in the pool of the processor for the next event
+  m_qtProcessor->clear();
 
   const std::vector<CDCTrack>& newTracks = receiver->getTracks();
   tracks.insert(tracks.end(), newTracks.begin(), newTracks.end());
@@ -71,6 +71,8 @@ void SegmentCreatorFacetAutomaton::exposeParameters(ModuleParamList* moduleParam
                                 m_param_allSingleAliases,
                                 "Switch to activate the write out of all available orientations of single facet segments.",
                                 m_param_allSingleAliases);
+
+  m_cellularPathFinder.exposeParameters(moduleParamList, prefixed(prefix, "FacetPath"));
 }
 
 void SegmentCreatorFacetAutomaton::apply(
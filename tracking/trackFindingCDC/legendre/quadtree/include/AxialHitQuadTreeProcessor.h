@@ -14,6 +14,7 @@
 
 #include <Math/Vector2D.h>
 
+#include <cstddef>
 #include <vector>
 
 namespace Belle2 {
@@ -55,6 +56,14 @@ namespace Belle2 {
                                 const YSpan& curvSpan,
                                 const TrackingUtilities::LookupTable<ROOT::Math::XYVector>* cosSinLookupTable);
 
+      /**
+       *  Set up a cleared processor of the off-origin extension for a new local origin and phase space part.
+       *  The memory of the processor is reused, so one processor can serve all the road searches.
+       */
+      void setOffOrigin(const ROOT::Math::XYVector& localOrigin,
+                        const YSpan& curvSpan,
+                        const TrackingUtilities::LookupTable<ROOT::Math::XYVector>* cosSinLookupTable);
+
     protected: // Section of specialized functions
       /**
        * lastLevel depends on curvature of the track candidate
@@ -78,6 +87,18 @@ namespace Belle2 {
        */
       bool isInNode(QuadTree* node, const TrackingUtilities::CDCWireHit* wireHit) const final;
 
+      /**
+       * Same decision as isInNode for many hits at once.
+       * Uses the hit properties precomputed in prepareItems, the loop over the hits is vectorizable.
+       */
+      void areInNodes(const std::vector<QuadTree*>& nodes, const std::vector<Item*>& items,
+                      std::vector<char>& inNode) const final;
+
+      /**
+       * Precompute the position relative to the local origin, the drift length and derived quantities of all hits.
+       */
+      void prepareItems() final;
+
     protected: // Implementation details
       /**
        * Check derivative of the sinogram.
@@ -123,6 +144,42 @@ namespace Belle2 {
        *  This option should automatically split back to back tracks in the low curvature regions
        */
       bool m_twoSidedPhaseSpace;
+
+      /**
+       *  Properties of many hits stored as separate arrays, one entry per hit.
+       *  Used for the precomputed properties of all items and for the properties of the hits checked in areInNodes.
+       */
+      struct HitArrays {
+        /// Resize all arrays
+        void resize(std::size_t nHits)
+        {
+          x.resize(nHits);
+          y.resize(nHits);
+          driftLength.resize(nHits);
+          r2.resize(nHits);
+        }
+
+        /// x position relative to the local origin
+        std::vector<double> x;
+        /// y position relative to the local origin
+        std::vector<double> y;
+        /// Drift length
+        std::vector<double> driftLength;
+        /// Squared distance to the local origin minus the squared drift length
+        std::vector<double> r2;
+      };
+
+      /// Precomputed properties of all items, indexed by the position of the item in m_items
+      HitArrays m_itemHits;
+
+      /// Properties of the hits checked in areInNodes, stored contiguously
+      mutable HitArrays m_checkedHits;
+
+      /// Whether the hits checked in areInNodes are in a node, not taking the extremum of the sinogram into account
+      mutable std::vector<char> m_crossesNode;
+
+      /// Whether the extremum of the sinogram of the hits checked in areInNodes has to be checked
+      mutable std::vector<char> m_checkExtremum;
     };
   }
 }
@@ -11,6 +11,7 @@
 
 #include <Math/Vector2D.h>
 
+#include <memory>
 #include <vector>
 
 namespace Belle2 {
@@ -18,6 +19,7 @@ namespace Belle2 {
     class CDCWireHit;
   }
   namespace TrackFindingCDC {
+    class AxialHitQuadTreeProcessor;
 
     /**
      *  Class performs extension (adding new hits) of given candidate using conformal transformation w.r.t point on the trajectory
@@ -28,6 +30,9 @@ namespace Belle2 {
       /// Constructor
       explicit OffOriginExtension(std::vector<const TrackingUtilities::CDCWireHit*> allAxialWireHits, double levelPrecision = 9);
 
+      /// Destructor
+      ~OffOriginExtension();
+
       /// Main entry point for the post processing call from the QuadTreeProcessor
       void operator()(const std::vector<const TrackingUtilities::CDCWireHit*>& inputWireHits, void* qt) final;
 
@@ -48,6 +53,9 @@ namespace Belle2 {
 
       /// Precision level for the width of the off origin hough search
       double m_levelPrecision;
+
+      /// Quad tree processor of the road search, set up again for every search to reuse its memory
+      std::unique_ptr<AxialHitQuadTreeProcessor> m_qtProcessor;
       //.5 - 0.24 * exp(-4.13118 * TrackCandidate::convertRhoToPt(fabs(track_par.second)) + 2.74);
     };
   }
@@ -36,6 +36,12 @@ namespace Belle2 {
       QuadTreeItem& operator=(QuadTreeItem const& copy) = delete;
 
     public:
+      /// Moving is fine, the items are stored in a vector of the QuadTreeProcessor
+      QuadTreeItem(QuadTreeItem&& other) = default;
+
+      /// Moving is fine, the items are stored in a vector of the QuadTreeProcessor
+      QuadTreeItem& operator=(QuadTreeItem&& other) = default;
+
       /// Returns the underlying data.
       AData* getPointer() const
       {
@@ -10,6 +10,8 @@
 
 #include <framework/logging/Logger.h>
 
+#include <array>
+#include <cstddef>
 #include <vector>
 
 namespace Belle2 {
@@ -40,8 +42,62 @@ namespace Belle2 {
       /// Type to store the minimum and maximum of the two bins in Y direction
       using YBinBounds = std::array<AY, 4>;
 
-      /// Type of the child node structure for this node.
-      using Children = std::vector<This>;
+      /**
+       * Type of the child node structure for this node.
+       * The children of a node are stored next to each other in the node pool of the QuadTreeProcessor,
+       * this is only a view on them.
+       */
+      class Children {
+      public:
+        /// Empty range
+        Children() = default;
+
+        /// Range of nChildren nodes starting at firstChild
+        Children(This* firstChild, int nChildren)
+          : m_begin(firstChild)
+          , m_end(firstChild + nChildren)
+        {
+        }
+
+        /// First child
+        This* begin() const
+        {
+          return m_begin;
+        }
+
+        /// Behind the last child
+        This* end() const
+        {
+          return m_end;
+        }
+
+        /// Number of children
+        std::size_t size() const
+        {
+          return m_end - m_begin;
+        }
+
+        /// Check whether there are no children
+        bool empty() const
+        {
+          return m_begin == m_end;
+        }
+
+        /// Access to the iChild-th child
+        This& operator[](std::size_t iChild) const
+        {
+          return m_begin[iChild];
+        }
+
+      private:
+        /// First child
+        This* m_begin = nullptr;
+        /// Behind the last child
+        This* m_end = nullptr;
+      };
+
+      /// Number of children of every node
+      static constexpr int c_nChildren = (std::tuple_size<XBinBounds>::value / 2) * (std::tuple_size<YBinBounds>::value / 2);
 
       /**
        *  Constructor setting up the potential division points.
@@ -69,6 +125,19 @@ namespace Belle2 {
         B2ASSERT("QuadTree datastructure only supports levels < 255", level < 255);
       }
 
+      /**
+       *  Set up the node again with new spans, as if it was newly constructed.
+       *  The memory already reserved for the items is kept, which is the point of reusing nodes from a pool.
+       */
+      void reset(XSpan xSpan, YSpan ySpan, int level, This* parent)
+      {
+        std::vector<AItem*> items;
+        items.swap(m_items);
+        *this = This(xSpan, ySpan, level, parent);
+        items.clear();
+        m_items.swap(items);
+      }
+
       /** Insert item into node */
       void insertItem(AItem* item)
       {
@@ -105,14 +174,20 @@ namespace Belle2 {
         return m_children;
       }
 
+      /** Set the children of this node, they are owned by the node pool of the QuadTreeProcessor */
+      void setChildren(This* firstChild, int nChildren)
+      {
+        m_children = Children(firstChild, nChildren);
+      }
+
       /**
-       *  Clear items which the node holds and destroy all children below this node.
-       *  This method must only be called on the root node, for fast QuadTree reusage
+       *  Forget all children below this node.
+       *  This method must only be called on the root node, for fast QuadTree reusage.
+       *  The nodes themselves are kept in the node pool of the QuadTreeProcessor.
        */
       void clearChildren()
       {
-        // automatically removes all lower level objects
-        m_children.clear();
+        m_children = Children();
         m_filled = false;
       }
 
@@ -218,8 +293,8 @@ namespace Belle2 {
       /// Vector of items which belongs to the node
       std::vector<AItem*> m_items;
 
-      /// Pointers to the children nodes
-      std::vector<This> m_children;
+      /// The children nodes
+      Children m_children;
 
       /// bins range on r
       YBinBounds m_yBinBounds;
@@ -13,11 +13,12 @@
 #include <tracking/trackingUtilities/utilities/Algorithms.h>
 
 #include <algorithm>
+#include <array>
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <map>
 #include <vector>
-#include <deque>
 #include <utility>
 
 namespace Belle2 {
@@ -31,6 +32,10 @@ namespace Belle2 {
      * It provides some functions to create, fill, clear and postprocess a quad tree.
      * If you want to use your own class as a quad tree item, you have to overload this processor.
      * You have provide only the two functions isInNode and createChild.
+     *
+     * The nodes below the root node are taken from a pool of contiguous blocks, which is kept when the
+     * processor is cleared. The decision which items belong to which child nodes is taken for all items
+     * of a node at once (see areInNodes), so processors can provide a vectorized implementation.
      */
     template<typename AX, typename AY, class AData>
     class QuadTreeProcessor {
@@ -94,6 +99,8 @@ namespace Belle2 {
         m_quadTree->clearChildren();
         m_quadTree->clearItems();
         m_items.clear();
+        m_nUsedNodeBlocks = 0;
+        m_nNodesInBlock = 0;
       }
 
       /**
@@ -101,10 +108,14 @@ namespace Belle2 {
        */
       void seed(const std::vector<AData*>& datas)
       {
-        // Create the items
+        B2ASSERT("The QuadTreeProcessor has to be cleared before it is seeded again", m_items.empty());
+
+        // Create the items, the nodes point to them so the vector must not grow afterwards
+        m_items.reserve(datas.size());
         for (AData* data : datas) {
           m_items.emplace_back(data);
         }
+        this->prepareItems();
 
         // Creating the seed level
         long nSeedBins = pow(2, m_seedLevel);
@@ -117,7 +128,7 @@ namespace Belle2 {
         for (int level = 0; level < m_seedLevel; ++level) {
           for (QuadTree* node : m_seededTrees) {
             if (node->getChildren().empty()) {
-              this->createChildren(node, node->getChildren());
+              this->createChildren(node);
             }
             for (QuadTree& child :  node->getChildren()) {
               nextSeededTrees.push_back(&child);
@@ -128,15 +139,14 @@ namespace Belle2 {
         }
 
         // Fill the seed level with the items
+        m_unusedItems.clear();
+        for (Item& item : m_items) {
+          if (item.isUsed()) continue;
+          m_unusedItems.push_back(&item);
+        }
         for (QuadTree* seededTree : m_seededTrees) {
-          seededTree->reserveItems(m_items.size());
-
-          for (Item& item : m_items) {
-            if (item.isUsed()) continue;
-            if (isInNode(seededTree, item.getPointer())) {
-              seededTree->insertItem(&item);
-            }
-          }
+          m_nodesToFill.assign(1, seededTree);
+          fillNodes(m_nodesToFill, m_unusedItems);
         }
       }
 
@@ -212,7 +222,7 @@ namespace Belle2 {
         }
 
         if (node->getChildren().empty()) {
-          this->createChildren(node, node->getChildren());
+          this->createChildren(node);
         }
 
         if (!node->checkFilled()) {
@@ -220,20 +230,21 @@ namespace Belle2 {
           node->setFilled();
         }
 
-        std::vector<QuadTree*> children;
+        std::array<QuadTree*, QuadTree::c_nChildren> children;
+        int nChildren = 0;
         for (QuadTree& child : node->getChildren()) {
-          children.push_back(&child);
+          children[nChildren++] = &child;
         }
         const auto compareNItems = [](const QuadTree * lhs, const QuadTree * rhs) {
           return lhs->getNItems() < rhs->getNItems();
         };
 
         // Explicitly count down the children
-        const int nChildren = children.size();
-        for (int iChild = 0; iChild < nChildren; ++iChild) {
-          auto itHeaviestChild = std::max_element(children.begin(), children.end(), compareNItems);
+        for (; nChildren > 0; --nChildren) {
+          auto itChildrenEnd = children.begin() + nChildren;
+          auto itHeaviestChild = std::max_element(children.begin(), itChildrenEnd, compareNItems);
           QuadTree* heaviestChild = *itHeaviestChild;
-          children.erase(itHeaviestChild);
+          std::copy(itHeaviestChild + 1, itChildrenEnd, itHeaviestChild);
           // After we have processed some children we need to get rid of the already used hits in all the children,
           // because this can change the number of items drastically
           erase_remove_if(heaviestChild->getItems(), [&](Item * hit) { return hit->isUsed(); });
@@ -243,41 +254,81 @@ namespace Belle2 {
 
       /**
        * Creates the sub node of a given node. This function is called by fillGivenTree.
-       * To calculate the spans of the children nodes the user-defined function createChiildWithParent is used.
+       * To calculate the spans of the children nodes the user-defined function createChild is used.
+       * The children are taken from the node pool, where they are stored next to each other.
        */
-      void createChildren(QuadTree* node, QuadTreeChildren& m_children) const
+      void createChildren(QuadTree* node)
       {
+        const std::size_t nChildren = node->getXNbins() * node->getYNbins();
+        if (m_nUsedNodeBlocks == 0 or m_nNodesInBlock + nChildren > c_nodesPerBlock) {
+          if (m_nUsedNodeBlocks == m_nodeBlocks.size()) {
+            m_nodeBlocks.emplace_back();
+            // Never grows beyond this size, so the nodes keep their addresses
+            m_nodeBlocks.back().reserve(c_nodesPerBlock);
+          }
+          ++m_nUsedNodeBlocks;
+          m_nNodesInBlock = 0;
+        }
+
+        std::vector<QuadTree>& nodeBlock = m_nodeBlocks[m_nUsedNodeBlocks - 1];
+        const std::size_t firstChild = m_nNodesInBlock;
         for (int i = 0; i < node->getXNbins(); ++i) {
           for (int j = 0; j < node->getYNbins(); ++j) {
             const XYSpans& xySpans = createChild(node, i, j);
             const XSpan& xSpan = xySpans.first;
             const YSpan& ySpan = xySpans.second;
-            m_children.push_back(QuadTree(xSpan, ySpan, node->getLevel() + 1, node));
+            if (m_nNodesInBlock < nodeBlock.size()) {
+              // Reuse a node from before the last clear
+              nodeBlock[m_nNodesInBlock].reset(xSpan, ySpan, node->getLevel() + 1, node);
+            } else {
+              nodeBlock.emplace_back(xSpan, ySpan, node->getLevel() + 1, node);
+            }
+            ++m_nNodesInBlock;
           }
         }
+        node->setChildren(&nodeBlock[firstChild], nChildren);
       }
 
       /**
        * This function is called by fillGivenTree and fills the items into the corresponding children.
-       * For this the user-defined method isInNode is called.
+       * For this the user-defined method areInNodes is called.
        */
       void fillChildren(QuadTree* node, const std::vector<Item*>& items)
       {
-        const size_t neededSize = 2 * items.size();
-        for (QuadTree& child : node->getChildren()) {
-          child.reserveItems(neededSize);
-        }
-
+        m_unusedItems.clear();
         for (Item* item : items) {
           if (item->isUsed()) continue;
+          m_unusedItems.push_back(item);
+        }
+
+        m_nodesToFill.clear();
+        for (QuadTree& child : node->getChildren()) {
+          m_nodesToFill.push_back(&child);
+        }
+        fillNodes(m_nodesToFill, m_unusedItems);
+        afterFillDebugHook(node->getChildren());
+      }
 
-          for (QuadTree& child : node->getChildren()) {
-            if (isInNode(&child, item->getPointer())) {
-              child.insertItem(item);
+      /**
+       * Insert the items into all the given nodes they belong to.
+       * The items keep their order in every node.
+       */
+      void fillNodes(const std::vector<QuadTree*>& nodes, const std::vector<Item*>& items)
+      {
+        const std::size_t nItems = items.size();
+        m_inNode.assign(nodes.size() * nItems, 0);
+        this->areInNodes(nodes, items, m_inNode);
+
+        for (std::size_t iNode = 0; iNode < nodes.size(); ++iNode) {
+          QuadTree* node = nodes[iNode];
+          const char* inNode = m_inNode.data() + iNode * nItems;
+          node->reserveItems(node->getNItems() + std::count(inNode, inNode + nItems, 1));
+          for (std::size_t iItem = 0; iItem < nItems; ++iItem) {
+            if (inNode[iItem]) {
+              node->insertItem(items[iItem]);
             }
           }
         }
-        afterFillDebugHook(node->getChildren());
       }
 
       /**
@@ -325,6 +376,35 @@ namespace Belle2 {
        */
       virtual bool isInNode(QuadTree* node, AData* item) const = 0;
 
+      /**
+       * Decide for several nodes and items at once, which item belongs into which node.
+       * The default implementation calls isInNode for every combination.
+       * Override it, if the decision can be done faster for many items at once, e.g. vectorized.
+       * @param nodes  nodes to be filled
+       * @param items  items to be filled into the nodes or not, none of them is used
+       * @param[out] inNode  set to 1 at iNode * items.size() + iItem if the item belongs into the node,
+       *                     it has the correct size and is initialized to 0
+       */
+      virtual void areInNodes(const std::vector<QuadTree*>& nodes, const std::vector<Item*>& items,
+                              std::vector<char>& inNode) const
+      {
+        const std::size_t nItems = items.size();
+        for (std::size_t iNode = 0; iNode < nodes.size(); ++iNode) {
+          for (std::size_t iItem = 0; iItem < nItems; ++iItem) {
+            inNode[iNode * nItems + iItem] = isInNode(nodes[iNode], items[iItem]->getPointer());
+          }
+        }
+      }
+
+      /**
+       * Called by seed after the items have been created.
+       * Override it to precompute properties of the items needed by isInNode or areInNodes.
+       * The index of an item is its position in m_items.
+       */
+      virtual void prepareItems()
+      {
+      }
+
       /**
        * Function which checks if given node is leaf
        * Implemented as virtual to keep possibility of changing lastLevel values depending on region is phase-space
@@ -374,7 +454,7 @@ namespace Belle2 {
       std::unique_ptr<QuadTree> m_quadTree;
 
       /// Storage space for the items that are referenced by the quad tree nodes
-      std::deque<Item> m_items;
+      std::vector<Item> m_items;
 
       /**
        * Vector of QuadTrees
@@ -384,6 +464,27 @@ namespace Belle2 {
       std::vector<QuadTree*> m_seededTrees;
 
     private:
+      /// Number of nodes in each block of the node pool
+      static constexpr std::size_t c_nodesPerBlock = 1024;
+
+      /// Pool of the nodes below the root node. The blocks never grow beyond c_nodesPerBlock nodes.
+      std::vector<std::vector<QuadTree>> m_nodeBlocks;
+
+      /// Number of blocks of the node pool in use, new children are taken from the last of them
+      std::size_t m_nUsedNodeBlocks = 0;
+
+      /// Number of nodes in use in the last used block of the node pool
+      std::size_t m_nNodesInBlock = 0;
+
+      /// Temporary list of the nodes to be filled
+      std::vector<QuadTree*> m_nodesToFill;
+
+      /// Temporary list of the items to be filled into the nodes
+      std::vector<Item*> m_unusedItems;
+
+      /// Temporary result of areInNodes
+      std::vector<char> m_inNode;
+
       /// The last level to be filled
       int m_lastLevel;
 
@@ -11,6 +11,7 @@
 #include <tracking/trackingUtilities/geometry/VectorUtil.h>
 
 #include <array>
+#include <cstddef>
 #include <vector>
 
 #include <Math/Vector2D.h>
@@ -119,6 +120,17 @@ AxialHitQuadTreeProcessor::AxialHitQuadTreeProcessor(const ROOT::Math::XYVector&
   m_twoSidedPhaseSpace = false;
 }
 
+void AxialHitQuadTreeProcessor::setOffOrigin(const ROOT::Math::XYVector& localOrigin,
+                                             const YSpan& curvSpan,
+                                             const LookupTable<ROOT::Math::XYVector>* cosSinLookupTable)
+{
+  B2ASSERT("The off-origin processor has to be cleared before it is set up again", m_items.empty());
+  B2ASSERT("Only the off-origin processor can be moved", getLastLevel() == 0 and not m_twoSidedPhaseSpace);
+  m_quadTree->reset({0, cosSinLookupTable->getNPoints() - 1}, curvSpan, 0, nullptr);
+  m_localOrigin = localOrigin;
+  m_cosSinLookupTable = cosSinLookupTable;
+}
+
 
 bool AxialHitQuadTreeProcessor::isLeaf(QuadTree* node) const
 {
@@ -261,6 +273,113 @@ bool AxialHitQuadTreeProcessor::isInNode(QuadTree* node, const CDCWireHit* wireH
   return false;
 }
 
+void AxialHitQuadTreeProcessor::prepareItems()
+{
+  m_itemHits.resize(m_items.size());
+  for (std::size_t iItem = 0; iItem < m_items.size(); ++iItem) {
+    const CDCWireHit* wireHit = m_items[iItem].getPointer();
+    const double& l = wireHit->getRefDriftLength();
+    const ROOT::Math::XYVector& pos2D = wireHit->getRefPos2D() - m_localOrigin;
+    m_itemHits.x[iItem] = pos2D.X();
+    m_itemHits.y[iItem] = pos2D.Y();
+    m_itemHits.driftLength[iItem] = l;
+    m_itemHits.r2[iItem] = pos2D.Mag2() - l * l;
+  }
+}
+
+void AxialHitQuadTreeProcessor::areInNodes(const std::vector<QuadTree*>& nodes, const std::vector<Item*>& items,
+                                           std::vector<char>& inNode) const
+{
+  // Collect the precomputed properties of the hits, so that the loop over the hits runs over contiguous arrays
+  const std::size_t nHits = items.size();
+  m_checkedHits.resize(nHits);
+  for (std::size_t iHit = 0; iHit < nHits; ++iHit) {
+    const std::size_t iItem = items[iHit] - m_items.data();
+    m_checkedHits.x[iHit] = m_itemHits.x[iItem];
+    m_checkedHits.y[iHit] = m_itemHits.y[iItem];
+    m_checkedHits.driftLength[iHit] = m_itemHits.driftLength[iItem];
+    m_checkedHits.r2[iHit] = m_itemHits.r2[iItem];
+  }
+  m_crossesNode.resize(nHits);
+  m_checkExtremum.resize(nHits);
+
+  const double* x = m_checkedHits.x.data();
+  const double* y = m_checkedHits.y.data();
+  const double* driftLength = m_checkedHits.driftLength.data();
+  const double* r2 = m_checkedHits.r2.data();
+  char* crossesNode = m_crossesNode.data();
+  char* extremumToCheck = m_checkExtremum.data();
+
+  for (std::size_t iNode = 0; iNode < nodes.size(); ++iNode) {
+    QuadTree* node = nodes[iNode];
+
+    // Everything below does the same computations as isInNode with the same precision, just for all hits at once
+    const bool checkForward = node->getLevel() <= 4 and m_twoSidedPhaseSpace and node->getYMin() > -c_curlCurv and
+                              node->getYMax() < c_curlCurv;
+
+    // get top and bottom borders of the node
+    const float yMin = node->getYMin();
+    const float yMax = node->getYMax();
+
+    // get left and right borders of the node
+    const ROOT::Math::XYVector& thetaVecMin = m_cosSinLookupTable->at(node->getXMin());
+    const ROOT::Math::XYVector& thetaVecMax = m_cosSinLookupTable->at(node->getXMax());
+    const double cosMin = thetaVecMin.X();
+    const double sinMin = thetaVecMin.Y();
+    const double cosMax = thetaVecMax.X();
+    const double sinMax = thetaVecMax.Y();
+
+    // No branches in this loop, so that it can be vectorized
+    for (std::size_t iHit = 0; iHit < nHits; ++iHit) {
+      const double l = driftLength[iHit];
+      const float rMin = yMin * r2[iHit] / 2;
+      const float rMax = yMax * r2[iHit] / 2;
+
+      // compute sinograms at the left and right borders of the node
+      const float rHitMin = cosMin * x[iHit] + sinMin * y[iHit];
+      const float rHitMax = cosMax * x[iHit] + sinMax * y[iHit];
+      const float rHitMinRight = rHitMin - l;
+      const float rHitMaxRight = rHitMax - l;
+      const float rHitMinLeft = rHitMin + l;
+      const float rHitMaxLeft = rHitMax + l;
+
+      // Compare distance signs from sinograms to the node
+      const float distRight00 = rMin - rHitMinRight;
+      const float distRight01 = rMin - rHitMaxRight;
+      const float distRight10 = rMax - rHitMinRight;
+      const float distRight11 = rMax - rHitMaxRight;
+      const float distLeft00 = rMin - rHitMinLeft;
+      const float distLeft01 = rMin - rHitMaxLeft;
+      const float distLeft10 = rMax - rHitMinLeft;
+      const float distLeft11 = rMax - rHitMaxLeft;
+      const bool sameSignRight = ((distRight00 > 0) & (distRight01 > 0) & (distRight10 > 0) & (distRight11 > 0)) |
+                                 ((distRight00 < 0) & (distRight01 < 0) & (distRight10 < 0) & (distRight11 < 0));
+      const bool sameSignLeft = ((distLeft00 > 0) & (distLeft01 > 0) & (distLeft10 > 0) & (distLeft11 > 0)) |
+                                ((distLeft00 < 0) & (distLeft01 < 0) & (distLeft10 < 0) & (distLeft11 < 0));
+      const bool crosses = (not sameSignRight) | (not sameSignLeft);
+
+      // derivatives of the sinogram at the borders, they also locate the extremum
+      const float rMinD = cosMin * y[iHit] - sinMin * x[iHit];
+      const float rMaxD = cosMax * y[iHit] - sinMax * x[iHit];
+      const bool hasExtremum = rMinD * rMaxD < 0;
+      const bool isForward = ((rMinD > 0) & (rMaxD * rMinD >= 0)) | (rMaxD * rMinD < 0);
+      const bool accepted = (not checkForward) | isForward;
+
+      crossesNode[iHit] = accepted & crosses;
+      extremumToCheck[iHit] = accepted & (not crosses) & hasExtremum;
+    }
+
+    char* hitsInNode = inNode.data() + iNode * nHits;
+    for (std::size_t iHit = 0; iHit < nHits; ++iHit) {
+      hitsInNode[iHit] = crossesNode[iHit];
+      // Rare case, done hit by hit
+      if (extremumToCheck[iHit]) {
+        hitsInNode[iHit] = checkExtremum(node, items[iHit]->getPointer());
+      }
+    }
+  }
+}
+
 bool AxialHitQuadTreeProcessor::checkDerivative(QuadTree* node, const CDCWireHit* wireHit) const
 {
   const ROOT::Math::XYVector& pos2D = wireHit->getRefPos2D() - m_localOrigin;
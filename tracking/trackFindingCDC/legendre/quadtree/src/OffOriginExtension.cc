@@ -32,6 +32,8 @@ OffOriginExtension::OffOriginExtension(std::vector<const CDCWireHit*> allAxialWi
 {
 }
 
+OffOriginExtension::~OffOriginExtension() = default;
+
 void OffOriginExtension::operator()(const std::vector<const CDCWireHit*>& inputWireHits,
                                     void* qt __attribute__((unused)))
 {
@@ -106,9 +108,14 @@ OffOriginExtension::getHitsWRTtoRefPos(const ROOT::Math::XYVector& refPos, float
   YSpan curvSpan{curv - curvPrecision, curv + curvPrecision};
   LookupTable<ROOT::Math::XYVector> thetaSpan(&VectorUtil::Phi, 1, theta - thetaPrecision, theta + thetaPrecision);
 
-  AxialHitQuadTreeProcessor qtProcessor(refPos, curvSpan, &thetaSpan);
-  qtProcessor.seed(m_allAxialWireHits);
+  if (m_qtProcessor) {
+    m_qtProcessor->setOffOrigin(refPos, curvSpan, &thetaSpan);
+  } else {
+    m_qtProcessor = std::make_unique<AxialHitQuadTreeProcessor>(refPos, curvSpan, &thetaSpan);
+  }
+  m_qtProcessor->seed(m_allAxialWireHits);
 
-  std::vector<const CDCWireHit*> newWireHits = qtProcessor.getAssignedItems();
+  std::vector<const CDCWireHit*> newWireHits = m_qtProcessor->getAssignedItems();
+  m_qtProcessor->clear();
   return newWireHits;
 }
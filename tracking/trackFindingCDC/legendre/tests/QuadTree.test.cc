@@ -10,6 +10,7 @@
 #include <tracking/trackFindingCDC/legendre/quadtree/AxialHitQuadTreeProcessor.h>
 #include <tracking/trackFindingCDC/legendre/precisionFunctions/PrecisionUtil.h>
 
+#include <random>
 #include <vector>
 #include <gtest/gtest.h>
 
@@ -19,6 +20,17 @@ using namespace TrackingUtilities;
 
 namespace {
 
+  /// Processor giving access to the decisions which hits belong to which nodes
+  class AxialHitQuadTreeProcessorTester : public AxialHitQuadTreeProcessor {
+  public:
+    using AxialHitQuadTreeProcessor::AxialHitQuadTreeProcessor;
+    using AxialHitQuadTreeProcessor::isInNode;
+    using AxialHitQuadTreeProcessor::areInNodes;
+
+    /// The items created by seed
+    std::vector<Item>& getItems() { return m_items; }
+  };
+
   TEST_F(TrackFindingCDCTestWithSimpleSimulation, legendre_QuadTreeTest)
   {
     using XYSpans = AxialHitQuadTreeProcessor::XYSpans;
@@ -71,4 +83,95 @@ namespace {
     EXPECT_GE(candidates[0].size(), 30);
     EXPECT_GE(candidates[1].size(), 30);
   }
+
+  TEST_F(TrackFindingCDCTestWithSimpleSimulation, legendre_QuadTreeReuseTest)
+  {
+    using XYSpans = AxialHitQuadTreeProcessor::XYSpans;
+    const int maxTheta = std::pow(2, PrecisionUtil::getLookupGridLevel());
+    XYSpans xySpans({0, maxTheta}, {0., 0.15});
+    PrecisionUtil::PrecisionFunction precisionFunction = &PrecisionUtil::getOriginCurvPrecision;
+
+    using Candidate = std::vector<const CDCWireHit*>;
+    std::vector<Candidate> candidates;
+    auto candidateReceiver = [&candidates](const Candidate & candidate, void*) {
+      candidates.push_back(candidate);
+    };
+
+    this->loadPreparedEvent();
+    AxialHitQuadTreeProcessor qtProcessor(13, 4, xySpans, precisionFunction);
+
+    // The second search reuses the nodes of the first one from the node pool and has to give the same result
+    std::vector<std::vector<Candidate>> candidatesPerSearch;
+    for (int iSearch = 0; iSearch < 2; ++iSearch) {
+      candidates.clear();
+      for (const CDCWireHit* wireHit : m_axialWireHits) {
+        (*wireHit)->unsetTakenFlag();
+        (*wireHit)->unsetMaskedFlag();
+      }
+      qtProcessor.clear();
+      qtProcessor.seed(m_axialWireHits);
+      qtProcessor.fill(candidateReceiver, 30);
+      candidatesPerSearch.push_back(candidates);
+    }
+
+    ASSERT_EQ(m_mcTracks.size(), candidatesPerSearch[0].size());
+    EXPECT_EQ(candidatesPerSearch[0], candidatesPerSearch[1]);
+  }
+
+  TEST_F(TrackFindingCDCTestWithSimpleSimulation, legendre_QuadTreeAreInNodesTest)
+  {
+    using QuadTree = AxialHitQuadTreeProcessor::QuadTree;
+    using Item = AxialHitQuadTreeProcessor::Item;
+    using XYSpans = AxialHitQuadTreeProcessor::XYSpans;
+    const long maxTheta = std::pow(2, PrecisionUtil::getLookupGridLevel());
+
+    // a two sided curvature span also exercises the check of the forward direction
+    XYSpans xySpans({0, maxTheta}, { -0.02, 0.14});
+    AxialHitQuadTreeProcessorTester qtProcessor(12, 4, xySpans, &PrecisionUtil::getOriginCurvPrecision);
+
+    this->loadPreparedEvent();
+    qtProcessor.seed(m_axialWireHits);
+
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<long> thetaDistribution(0, maxTheta);
+    std::uniform_real_distribution<float> curvDistribution(-0.15, 0.15);
+    std::uniform_int_distribution<int> levelDistribution(0, 12);
+    std::bernoulli_distribution takeItem(0.7);
+
+    for (int iTry = 0; iTry < 20; ++iTry) {
+      // random nodes of any size and level
+      std::vector<QuadTree> nodeStorage;
+      nodeStorage.reserve(16);
+      for (int iNode = 0; iNode < 16; ++iNode) {
+        long theta1 = thetaDistribution(generator);
+        long theta2 = thetaDistribution(generator);
+        float curv1 = curvDistribution(generator);
+        float curv2 = curvDistribution(generator);
+        if (theta1 > theta2) std::swap(theta1, theta2);
+        if (curv1 > curv2) std::swap(curv1, curv2);
+        nodeStorage.emplace_back(QuadTree::XSpan{theta1, theta2}, QuadTree::YSpan{curv1, curv2},
+                                 levelDistribution(generator), nullptr);
+      }
+      std::vector<QuadTree*> nodes;
+      for (QuadTree& node : nodeStorage) {
+        nodes.push_back(&node);
+      }
+
+      // a random subset of the items
+      std::vector<Item*> items;
+      for (Item& item : qtProcessor.getItems()) {
+        if (takeItem(generator)) items.push_back(&item);
+      }
+
+      std::vector<char> inNode(nodes.size() * items.size(), 0);
+      qtProcessor.areInNodes(nodes, items, inNode);
+
+      for (std::size_t iNode = 0; iNode < nodes.size(); ++iNode) {
+        for (std::size_t iItem = 0; iItem < items.size(); ++iItem) {
+          EXPECT_EQ(bool(inNode[iNode * items.size() + iItem]), qtProcessor.isInNode(nodes[iNode], items[iItem]->getPointer()))
+              << "node " << iNode << ", item " << iItem << ", try " << iTry;
+        }
+      }
+    }
+  }
 }
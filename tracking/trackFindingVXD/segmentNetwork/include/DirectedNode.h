@@ -32,7 +32,7 @@ namespace Belle2 {
     /** ************************* CONSTRUCTORS ************************* */
     /** Protected constructor. accepts an entry which can not be changed any more */
     explicit DirectedNode(EntryType& entry) :
-      m_entry(entry), m_metaInfo(MetaInfoType()), m_family(-1)
+      m_entry(&entry), m_metaInfo(MetaInfoType()), m_family(-1)
     {
       // Reserve some space for the vectors, TODO: can still be fine-tuned
       m_innerNodes.reserve(10);
@@ -47,6 +47,17 @@ namespace Belle2 {
 
 
     /** ************************* INTERNAL MEMBER FUNCTIONS ************************* */
+    /** Reuses the node for a new entry as if it was newly constructed, the memory of the links is kept */
+    void reset(EntryType& entry)
+    {
+      m_innerNodes.clear();
+      m_outerNodes.clear();
+      m_entry = &entry;
+      m_metaInfo = MetaInfoType();
+      m_family = -1;
+    }
+
+
     /** Adds new links to the inward direction */
     void addInnerNode(DirectedNode<EntryType, MetaInfoType>& newNode)
     {
@@ -64,16 +75,16 @@ namespace Belle2 {
   public:
     /** ************************* OPERATORS ************************* */
     /** == -operator - compares if two nodes are identical */
-    bool operator == (const DirectedNode& b) const { return (m_entry == b.getConstEntry()); }
+    bool operator == (const DirectedNode& b) const { return (*m_entry == b.getConstEntry()); }
 
     /** != -operator - compares if two nodes are not identical */
-    bool operator != (const DirectedNode& b) const { return !(m_entry == b.getConstEntry()); }
+    bool operator != (const DirectedNode& b) const { return !(*m_entry == b.getConstEntry()); }
 
     /** == -operator - compares if the entry passed is identical with the one linked in this node */
-    bool operator == (const EntryType& b) const { return (m_entry == b); }
+    bool operator == (const EntryType& b) const { return (*m_entry == b); }
 
     /** == -operator - compares if the entry passed is not identical with the one linked in this node */
-    bool operator != (const EntryType& b) const { return !(m_entry == b); }
+    bool operator != (const EntryType& b) const { return !(*m_entry == b); }
 
 
     /** ************************* PUBLIC MEMBER FUNCTIONS ************************* */
@@ -85,10 +96,10 @@ namespace Belle2 {
     std::vector<DirectedNode<EntryType, MetaInfoType>*>& getOuterNodes() { return m_outerNodes; }
 
     /** Allows access to stored entry */
-    EntryType& getEntry() { return m_entry; }
+    EntryType& getEntry() { return *m_entry; }
 
     /** Allows const access to stored entry (needed for external operator overload */
-    const EntryType& getConstEntry() const { return m_entry; }
+    const EntryType& getConstEntry() const { return *m_entry; }
 
     /** Returns Pointer to this node */
     DirectedNode<EntryType, MetaInfoType>* getPtr() { return this; }
@@ -110,8 +121,8 @@ namespace Belle2 {
     /** Carries all links to outer nodes */
     std::vector<DirectedNode<EntryType, MetaInfoType>*> m_outerNodes;
 
-    /** Entry can be of any type, DirectedNode is just the carrier */
-    EntryType& m_entry;
+    /** Entry can be of any type, DirectedNode is just the carrier (pointer to be able to reuse the node) */
+    EntryType* m_entry;
 
     /** Contains a MetaInfo for doing extra-stuff (whatever you need) */
     MetaInfoType m_metaInfo;
@@ -12,12 +12,19 @@
 #include <tracking/trackFindingVXD/segmentNetwork/DirectedNode.h>
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
 namespace Belle2 {
   /** Network of directed nodes of the type EntryType
+   *
+   * The nodes are taken from a pool, which is kept when the network is cleared or destroyed and reused by the
+   * next network of the same type in the same thread. Like this the nodes and the memory of their links are
+   * only allocated in the first events and in events larger than all events before.
+   *
    * @tparam EntryType : type of the directe nodes
    * @tparam MetaInfoType : meta info type of the nodes
    */
@@ -42,14 +49,10 @@ namespace Belle2 {
     }
 
 
-    /** destructor taking care of cleaning up the pointer-mess
-     *  WARNING only needed when using classic pointers for the nodes! */
+    /** Destructor, gives the nodes back to the pool */
     ~DirectedNodeNetwork()
     {
-      for (auto nodePointer : m_nodeMap) {
-        delete nodePointer.second;
-      }
-      m_nodeMap.clear();
+      clear();
     }
 
 
@@ -60,7 +63,7 @@ namespace Belle2 {
     {
       if (m_nodeMap.count(nodeID) == 0) {
         // cppcheck-suppress stlFindInsert
-        m_nodeMap.emplace(nodeID, new Node(newEntry));
+        m_nodeMap.emplace(nodeID, createNode(newEntry));
         m_isFinalized = false;
         return true;
       }
@@ -150,12 +153,22 @@ namespace Belle2 {
     void clear()
     {
       m_nodes.clear();
+      m_innerEnds.clear();
+      m_outerEnds.clear();
       // Clearing the unordered_map is important as the following modules will process the event
       // if it still contains entries.
-      for (auto nodePointer : m_nodeMap) {
-        delete nodePointer.second;
-      }
       m_nodeMap.clear();
+      m_isFinalized = false;
+
+      std::vector<std::unique_ptr<Node>>& pool = getPool();
+      for (std::unique_ptr<Node>& node : m_ownedNodes) {
+        if (pool.size() >= c_maxPooledNodes) break;
+        // do not keep the memory of the links of extremely connected nodes
+        if (node->m_innerNodes.capacity() > c_maxPooledLinks) std::vector<Node*>().swap(node->m_innerNodes);
+        if (node->m_outerNodes.capacity() > c_maxPooledLinks) std::vector<Node*>().swap(node->m_outerNodes);
+        pool.push_back(std::move(node));
+      }
+      m_ownedNodes.clear();
     }
 
 
@@ -214,6 +227,29 @@ namespace Belle2 {
 
   protected:
     /** ************************* INTERNAL MEMBER FUNCTIONS ************************* */
+    /** Pool of unused nodes of this network type in this thread */
+    static std::vector<std::unique_ptr<Node>>& getPool()
+    {
+      static thread_local std::vector<std::unique_ptr<Node>> pool;
+      return pool;
+    }
+
+
+    /** Takes a node from the pool or creates a new one if the pool is empty */
+    Node* createNode(EntryType& newEntry)
+    {
+      std::vector<std::unique_ptr<Node>>& pool = getPool();
+      if (pool.empty()) {
+        m_ownedNodes.emplace_back(new Node(newEntry));
+      } else {
+        m_ownedNodes.push_back(std::move(pool.back()));
+        pool.pop_back();
+        m_ownedNodes.back()->reset(newEntry);
+      }
+      return m_ownedNodes.back().get();
+    }
+
+
     /** links nodes with each other. returns true if everything went well, returns false, if not  */
     static bool createLink(Node& outerNode, Node& innerNode)
     {
@@ -247,6 +283,15 @@ namespace Belle2 {
     }
 
     /** ************************* DATA MEMBERS ************************* */
+    /** Maximal number of nodes kept in the pool, the nodes of larger networks are deleted */
+    static constexpr std::size_t c_maxPooledNodes = 40000;
+
+    /** Links of nodes with more memory for links are not kept in the pool */
+    static constexpr std::size_t c_maxPooledLinks = 64;
+
+    /** Owns the nodes of the network, they are given back to the pool when the network is cleared */
+    std::vector<std::unique_ptr<Node>> m_ownedNodes;
+
     /** carries all nodes */
     std::unordered_map<NodeID, Node*> m_nodeMap;
 
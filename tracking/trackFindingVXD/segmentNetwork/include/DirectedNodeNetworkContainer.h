@@ -84,6 +84,8 @@ namespace Belle2 {
     int sizeTrackNodes() { return m_trackNodes.size(); }
     /** Returns number of segments found. */
     int sizeSegments() { return m_segments.size(); }
+    /** Returns number of nodes in the SegmentNetwork. */
+    int sizeSegmentNetwork() { return m_SegmentNetwork.size(); }
 
     /** Returns number of trackNodes collected. */
     int get_trackNodesCollected() { return m_trackNodesCollected; }
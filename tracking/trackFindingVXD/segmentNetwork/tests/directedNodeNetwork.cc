@@ -20,6 +20,7 @@
 #include <tracking/spacePointCreation/SpacePointTrackCand.h>
 
 
+#include <algorithm>
 #include <array>
 #include <iostream>
 #include <deque>
@@ -483,6 +484,56 @@ namespace DirectedNodeNetworkTests {
   }
 
 
+  /** testing that cleared and destroyed networks give their nodes to the next networks, which behave like new ones */
+  TEST_F(DirectedNodeNetworkTest, ReuseNodesOfClearedNetworks)
+  {
+    std::array<int, 5> intArray  = { { 2, 5, 3, 4, 99} };
+    std::array<int, 5> intArray2  = { { 144, 121, 33, 35, 31415} };
+    std::vector<DirectedNode<int, VoidMetaInfo>*> nodesOfFirstNetwork;
+
+    {
+      DirectedNodeNetwork<int, VoidMetaInfo> intNetwork;
+      for (int& entry : intArray) intNetwork.addNode(entry, entry);
+      for (unsigned int index = 1; index < intArray.size(); index++) {
+        EXPECT_TRUE(intNetwork.linkNodes(intArray.at(index - 1), intArray.at(index)));
+      }
+      nodesOfFirstNetwork = intNetwork.getNodes();
+      EXPECT_EQ(5, nodesOfFirstNetwork.size());
+
+      // after clearing, the network can be filled again as if it was new
+      intNetwork.clear();
+      EXPECT_EQ(0, intNetwork.size());
+      EXPECT_EQ(0, intNetwork.getNodes().size());
+      EXPECT_EQ(0, intNetwork.getOuterEnds().size());
+      for (int& entry : intArray2) intNetwork.addNode(entry, entry);
+      EXPECT_TRUE(intNetwork.linkNodes(intArray2.at(0), intArray2.at(1)));
+      EXPECT_EQ(5, intNetwork.size());
+      EXPECT_EQ(4, intNetwork.getOuterEnds().size());
+      EXPECT_EQ(4, intNetwork.getInnerEnds().size());
+      for (int& entry : intArray2) {
+        DirectedNode<int, VoidMetaInfo>* node = intNetwork.getNode(entry);
+        ASSERT_NE(nullptr, node);
+        EXPECT_EQ(entry, node->getEntry());
+        EXPECT_EQ(-1, node->getFamily());
+        // the nodes of the first filling are reused
+        EXPECT_NE(std::find(nodesOfFirstNetwork.begin(), nodesOfFirstNetwork.end(), node), nodesOfFirstNetwork.end());
+      }
+      EXPECT_EQ(1, intNetwork.getNode(intArray2.at(0))->getInnerNodes().size());
+      EXPECT_EQ(0, intNetwork.getNode(intArray2.at(0))->getOuterNodes().size());
+      EXPECT_EQ(0, intNetwork.getNode(intArray2.at(4))->getInnerNodes().size());
+    }
+
+    // a new network of the same type reuses the nodes of the destroyed one
+    DirectedNodeNetwork<int, VoidMetaInfo> newNetwork;
+    EXPECT_TRUE(newNetwork.addNode(intArray.at(0), intArray.at(0)));
+    DirectedNode<int, VoidMetaInfo>* node = newNetwork.getNode(intArray.at(0));
+    EXPECT_NE(std::find(nodesOfFirstNetwork.begin(), nodesOfFirstNetwork.end(), node), nodesOfFirstNetwork.end());
+    EXPECT_EQ(intArray.at(0), node->getEntry());
+    EXPECT_EQ(0, node->getInnerNodes().size());
+    EXPECT_EQ(0, node->getOuterNodes().size());
+  }
+
+
   /** testing full functionality of the DirectedNodeNetwork when filled with a complex type (including storing on the storeArray).
    * This is stored in the DirectedNetworkContainer, which will actually be used by some modules.
    *  This test is intended as a usage example to find out how to use this network. */
@@ -0,0 +1,200 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+#pragma once
+
+#include <tracking/trackFindingVXD/trackSetEvaluator/OverlapResolverNodeInfo.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace Belle2 {
+  /** Selects a set of non overlapping candidates with a large sum of quality indicators
+   *  (approximate maximum weight independent set of the sparse overlap graph).
+   *
+   *  The candidates are first selected greedily in the order of decreasing quality indicator, which gives the same
+   *  result as the Scrooge for distinct quality indicators. Afterwards a local search replaces single selected candidates by several of their
+   *  overlapping candidates, if these do not overlap with any other selected candidate and have a larger sum of
+   *  quality indicators. Every replacement increases the sum of quality indicators and the number of passes over
+   *  the selected candidates is limited, so the run time is bounded and grows linearly with the number of overlaps.
+   *
+   *  The activityState of the selected candidates is set to 1, the one of all others to 0.
+   */
+  class IndependentSetSelector {
+  public:
+    /** Constructor with the maximal number of passes of the local search, 0 gives the greedy selection */
+    explicit IndependentSetSelector(unsigned int maxLocalSearchPasses = 10) :
+      m_maxLocalSearchPasses(maxLocalSearchPasses)
+    {}
+
+    /** Sets the activityState of the selected candidates to 1 and of all others to 0.
+     *  Overlaps with track indices not in the vector are ignored.
+     *  @return the number of replacements done by the local search
+     */
+    unsigned int performSelection(std::vector<OverlapResolverNodeInfo>& overlapResolverNodeInfo)
+    {
+      const unsigned int nNodes = overlapResolverNodeInfo.size();
+      buildGraph(overlapResolverNodeInfo);
+
+      // greedy selection in the order of decreasing weight
+      std::vector<unsigned int> order(nNodes);
+      for (unsigned int iNode = 0; iNode < nNodes; ++iNode) order[iNode] = iNode;
+      std::stable_sort(order.begin(), order.end(), [this](unsigned int lhs, unsigned int rhs) {
+        return m_weights[lhs] > m_weights[rhs];
+      });
+
+      m_selected.assign(nNodes, false);
+      m_nSelectedNeighbours.assign(nNodes, 0);
+      for (unsigned int iNode : order) {
+        if (m_nSelectedNeighbours[iNode] == 0) select(iNode);
+      }
+
+      // local search: replace a selected node by its neighbours only overlapping with it, if they are heavier
+      unsigned int nReplacements = 0;
+      std::vector<unsigned int> candidates;
+      std::vector<unsigned int> replacements;
+      m_blocked.assign(nNodes, false);
+      for (unsigned int iPass = 0; iPass < m_maxLocalSearchPasses; ++iPass) {
+        bool improved = false;
+        // start with the lightest selected nodes, which are most likely replaceable
+        for (auto itNode = order.rbegin(); itNode != order.rend(); ++itNode) {
+          const unsigned int iNode = *itNode;
+          if (not m_selected[iNode]) continue;
+
+          candidates.clear();
+          for (unsigned int iEdge = m_offsets[iNode]; iEdge < m_offsets[iNode + 1]; ++iEdge) {
+            const unsigned int iNeighbour = m_neighbours[iEdge];
+            if (m_nSelectedNeighbours[iNeighbour] == 1) candidates.push_back(iNeighbour);
+          }
+          if (candidates.empty()) continue;
+          std::sort(candidates.begin(), candidates.end(), [this](unsigned int lhs, unsigned int rhs) {
+            return m_weights[lhs] > m_weights[rhs] or (m_weights[lhs] == m_weights[rhs] and lhs < rhs);
+          });
+
+          // greedy independent subset of the candidates
+          replacements.clear();
+          float replacementWeight = 0;
+          for (unsigned int iCandidate : candidates) {
+            if (m_blocked[iCandidate]) continue;
+            replacements.push_back(iCandidate);
+            replacementWeight += m_weights[iCandidate];
+            for (unsigned int iEdge = m_offsets[iCandidate]; iEdge < m_offsets[iCandidate + 1]; ++iEdge) {
+              m_blocked[m_neighbours[iEdge]] = true;
+            }
+          }
+          for (unsigned int iReplacement : replacements) {
+            for (unsigned int iEdge = m_offsets[iReplacement]; iEdge < m_offsets[iReplacement + 1]; ++iEdge) {
+              m_blocked[m_neighbours[iEdge]] = false;
+            }
+          }
+
+          if (replacementWeight <= m_weights[iNode]) continue;
+          deselect(iNode);
+          for (unsigned int iReplacement : replacements) select(iReplacement);
+          ++nReplacements;
+          improved = true;
+        }
+        if (not improved) break;
+      }
+
+      for (unsigned int iNode = 0; iNode < nNodes; ++iNode) {
+        overlapResolverNodeInfo[iNode].activityState = m_selected[iNode] ? 1 : 0;
+      }
+      return nReplacements;
+    }
+
+  private:
+    /** Builds the adjacency of the nodes in compressed form from the overlaps given as track indices */
+    void buildGraph(const std::vector<OverlapResolverNodeInfo>& overlapResolverNodeInfo)
+    {
+      const unsigned int nNodes = overlapResolverNodeInfo.size();
+      m_weights.resize(nNodes);
+      unsigned int maxTrackIndex = 0;
+      for (const OverlapResolverNodeInfo& info : overlapResolverNodeInfo) {
+        maxTrackIndex = std::max<unsigned int>(maxTrackIndex, info.trackIndex);
+      }
+      m_nodeOfTrack.assign(maxTrackIndex + 1, c_noNode);
+      for (unsigned int iNode = 0; iNode < nNodes; ++iNode) {
+        m_nodeOfTrack[overlapResolverNodeInfo[iNode].trackIndex] = iNode;
+        m_weights[iNode] = overlapResolverNodeInfo[iNode].qualityIndicator;
+      }
+
+      // the overlaps are made symmetric and unique
+      m_edges.clear();
+      for (unsigned int iNode = 0; iNode < nNodes; ++iNode) {
+        for (unsigned short trackIndex : overlapResolverNodeInfo[iNode].overlaps) {
+          if (trackIndex > maxTrackIndex or m_nodeOfTrack[trackIndex] == c_noNode) continue;
+          const unsigned int iNeighbour = m_nodeOfTrack[trackIndex];
+          if (iNeighbour == iNode) continue;
+          m_edges.emplace_back(iNode, iNeighbour);
+          m_edges.emplace_back(iNeighbour, iNode);
+        }
+      }
+      std::sort(m_edges.begin(), m_edges.end());
+      m_edges.erase(std::unique(m_edges.begin(), m_edges.end()), m_edges.end());
+
+      m_offsets.assign(nNodes + 1, 0);
+      m_neighbours.clear();
+      for (const std::pair<unsigned int, unsigned int>& edge : m_edges) {
+        ++m_offsets[edge.first + 1];
+        m_neighbours.push_back(edge.second);
+      }
+      for (unsigned int iNode = 0; iNode < nNodes; ++iNode) {
+        m_offsets[iNode + 1] += m_offsets[iNode];
+      }
+    }
+
+    /** Adds the node to the selection */
+    void select(unsigned int iNode)
+    {
+      m_selected[iNode] = true;
+      for (unsigned int iEdge = m_offsets[iNode]; iEdge < m_offsets[iNode + 1]; ++iEdge) {
+        ++m_nSelectedNeighbours[m_neighbours[iEdge]];
+      }
+    }
+
+    /** Removes the node from the selection */
+    void deselect(unsigned int iNode)
+    {
+      m_selected[iNode] = false;
+      for (unsigned int iEdge = m_offsets[iNode]; iEdge < m_offsets[iNode + 1]; ++iEdge) {
+        --m_nSelectedNeighbours[m_neighbours[iEdge]];
+      }
+    }
+
+    /** Marker for track indices without node */
+    static constexpr unsigned int c_noNode = static_cast<unsigned int>(-1);
+
+    /** Maximal number of passes of the local search over all selected nodes */
+    unsigned int m_maxLocalSearchPasses;
+
+    /** Node of each track index */
+    std::vector<unsigned int> m_nodeOfTrack;
+
+    /** Quality indicators of the nodes */
+    std::vector<float> m_weights;
+
+    /** Overlapping pairs of nodes in both orders */
+    std::vector<std::pair<unsigned int, unsigned int>> m_edges;
+
+    /** Start of the neighbours of each node in m_neighbours */
+    std::vector<unsigned int> m_offsets;
+
+    /** Neighbours of all nodes */
+    std::vector<unsigned int> m_neighbours;
+
+    /** Whether the node is selected */
+    std::vector<char> m_selected;
+
+    /** Number of selected neighbours of each node */
+    std::vector<unsigned int> m_nSelectedNeighbours;
+
+    /** Nodes overlapping with a replacement node during the local search */
+    std::vector<char> m_blocked;
+  };
+}
@@ -0,0 +1,140 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <tracking/trackFindingVXD/trackSetEvaluator/IndependentSetSelector.h>
+#include <tracking/trackFindingVXD/trackSetEvaluator/OverlapResolverNodeInfo.h>
+#include <tracking/trackFindingVXD/trackSetEvaluator/Scrooge.h>
+
+#include <algorithm>
+#include <random>
+
+using namespace std;
+using namespace Belle2;
+
+
+/// Test of the IndependentSetSelector
+class IndependentSetSelectorTest : public ::testing::Test {
+protected:
+  /** Random candidates with random overlaps
+   * @param nCandidates: number of candidates
+   * @param nOverlaps: number of overlaps created per candidate
+   * @param seed: seed of the random numbers
+   * @return candidates with symmetric overlaps
+   */
+  vector<OverlapResolverNodeInfo> getInput(unsigned int nCandidates, unsigned int nOverlaps, unsigned int seed)
+  {
+    mt19937 generator(seed);
+    uniform_int_distribution<unsigned short> otherIndex(0, nCandidates - 1);
+    uniform_real_distribution<float> qualityIndicator(0, 1);
+
+    vector<vector<unsigned short>> overlaps(nCandidates);
+    for (unsigned short ii = 0; ii < nCandidates; ii++) {
+      for (unsigned int jj = 0; jj < nOverlaps; jj++) {
+        unsigned short other = otherIndex(generator);
+        if (other == ii) continue;
+        overlaps[ii].push_back(other);
+        overlaps[other].push_back(ii);
+      }
+    }
+
+    vector<OverlapResolverNodeInfo> candidates;
+    for (unsigned short ii = 0; ii < nCandidates; ii++) {
+      candidates.emplace_back(qualityIndicator(generator), ii, overlaps[ii], 1);
+    }
+    return candidates;
+  }
+
+  /** Sum of the quality indicators of the active candidates, fails if two active candidates overlap */
+  float getSelectedQuality(const vector<OverlapResolverNodeInfo>& candidates)
+  {
+    vector<char> active(candidates.size(), false);
+    for (const OverlapResolverNodeInfo& candidate : candidates) {
+      active[candidate.trackIndex] = candidate.activityState > 0.5;
+    }
+    float quality = 0;
+    for (const OverlapResolverNodeInfo& candidate : candidates) {
+      if (not active[candidate.trackIndex]) continue;
+      quality += candidate.qualityIndicator;
+      for (unsigned short other : candidate.overlaps) {
+        EXPECT_FALSE(active[other]) << "Active candidates " << candidate.trackIndex << " and " << other << " overlap";
+      }
+    }
+    return quality;
+  }
+};
+
+
+/// Without local search the selection is the same as the one of the Scrooge
+TEST_F(IndependentSetSelectorTest, GreedyIsScrooge)
+{
+  vector<OverlapResolverNodeInfo> scroogeCandidates = getInput(300, 3, 1);
+  vector<OverlapResolverNodeInfo> candidates = scroogeCandidates;
+
+  Scrooge scrooge;
+  scrooge.performSelection(scroogeCandidates);
+  IndependentSetSelector selector(0);
+  EXPECT_EQ(0, selector.performSelection(candidates));
+
+  vector<char> activeInScrooge(scroogeCandidates.size(), false);
+  for (const OverlapResolverNodeInfo& candidate : scroogeCandidates) {
+    activeInScrooge[candidate.trackIndex] = candidate.activityState > 0.5;
+  }
+  for (const OverlapResolverNodeInfo& candidate : candidates) {
+    EXPECT_EQ(bool(activeInScrooge[candidate.trackIndex]), candidate.activityState > 0.5);
+  }
+}
+
+
+/// The local search gives a valid selection at least as good as the greedy one
+TEST_F(IndependentSetSelectorTest, LocalSearchImproves)
+{
+  unsigned int nReplacements = 0;
+  for (unsigned int seed = 0; seed < 10; seed++) {
+    vector<OverlapResolverNodeInfo> greedyCandidates = getInput(1000, 2, seed);
+    vector<OverlapResolverNodeInfo> candidates = greedyCandidates;
+
+    IndependentSetSelector greedySelector(0);
+    greedySelector.performSelection(greedyCandidates);
+    IndependentSetSelector selector;
+    nReplacements += selector.performSelection(candidates);
+
+    const float greedyQuality = getSelectedQuality(greedyCandidates);
+    const float quality = getSelectedQuality(candidates);
+    EXPECT_GE(quality, greedyQuality);
+
+    // the selection is maximal: every inactive candidate overlaps with an active one
+    vector<char> active(candidates.size(), false);
+    for (const OverlapResolverNodeInfo& candidate : candidates) {
+      active[candidate.trackIndex] = candidate.activityState > 0.5;
+    }
+    for (const OverlapResolverNodeInfo& candidate : candidates) {
+      if (active[candidate.trackIndex]) continue;
+      EXPECT_TRUE(any_of(candidate.overlaps.begin(), candidate.overlaps.end(),
+                         [&active](unsigned short other) { return active[other]; }));
+    }
+  }
+  EXPECT_GT(nReplacements, 0);
+}
+
+
+/// A candidate overlapping with two better disjoint candidates is replaced by them
+TEST_F(IndependentSetSelectorTest, ReplaceByTwo)
+{
+  vector<OverlapResolverNodeInfo> candidates;
+  candidates.emplace_back(0.9, 0, vector<unsigned short> {1, 2}, 1);
+  candidates.emplace_back(0.6, 1, vector<unsigned short> {0}, 1);
+  candidates.emplace_back(0.5, 2, vector<unsigned short> {0}, 1);
+
+  IndependentSetSelector selector;
+  EXPECT_EQ(1, selector.performSelection(candidates));
+  EXPECT_EQ(0, candidates[0].activityState);
+  EXPECT_EQ(1, candidates[1].activityState);
+  EXPECT_EQ(1, candidates[2].activityState);
+}
@@ -0,0 +1,105 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+#pragma once
+
+#include <tracking/trackFitting/fitter/base/TrackFitter.h>
+#include <framework/gearbox/Const.h>
+#include <framework/utilities/ParallelJobs.h>
+
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace genfit {
+  class AbsTrackRep;
+  class MaterialEffects;
+}
+
+namespace Belle2 {
+  class RecoTrack;
+
+  /**
+   * Fit many RecoTracks with several threads.
+   *
+   * The fit of every track is done in the three steps of the TrackFitter: the creation of the measurements
+   * (TrackFitter::prepareFit) and the synchronisation of the hit information (TrackFitter::finishFit) access the
+   * DataStore and run in the calling thread. Only the genfit fits (TrackFitter::fitPrepared) are distributed over
+   * the threads of a ParallelJobs. Every thread uses its own TrackFitter and its own genfit::MaterialEffects with a
+   * clone of the material interface. The magnetic field is shared.
+   *
+   * Each track is fitted by exactly one thread and all hypotheses of a track are fitted in the order of the calls,
+   * so the results are the same as with TrackFitter::fit() and do not depend on the number of threads.
+   *
+   *   ParallelTrackFitter parallelFitter(4);
+   *   // e.g. in every event, as the fitters read their settings from the database
+   *   parallelFitter.resetFitters([]() { return std::make_unique<TrackFitter>(); });
+   *   std::vector<bool> results = parallelFitter.fit(recoTracks, Const::pion);
+   *
+   * If the material interface can not be cloned, everything is done in the calling thread.
+   */
+  class ParallelTrackFitter {
+  public:
+    /// Function creating the TrackFitter of one thread
+    using FitterFactory = std::function<std::unique_ptr<TrackFitter>()>;
+
+    /**
+     * Use nThreads threads, the calling thread does its share of the fits as well.
+     * Needs an initialized genfit::MaterialEffects (SetupGenfitExtrapolationModule).
+     */
+    explicit ParallelTrackFitter(unsigned int nThreads);
+
+    /// Delete the material effects of the worker threads.
+    ~ParallelTrackFitter();
+
+    /// No copies of the threads.
+    ParallelTrackFitter(const ParallelTrackFitter&) = delete;
+
+    /// No copies of the threads.
+    ParallelTrackFitter& operator=(const ParallelTrackFitter&) = delete;
+
+    /// Number of threads used for the fits, including the calling thread.
+    unsigned int getNumberOfThreads() const { return m_jobs.getNumThreads(); }
+
+    /// Create a new TrackFitter for every thread. Needs to be called before the first fit.
+    void resetFitters(const FitterFactory& createFitter);
+
+    /**
+     * Fit every track with the given track representation, which has to be part of the track.
+     * Returns for every track whether the fit was successful, see TrackFitter::fit(RecoTrack&, genfit::AbsTrackRep*, bool).
+     */
+    std::vector<bool> fit(const std::vector<RecoTrack*>& recoTracks,
+                          const std::vector<genfit::AbsTrackRep*>& trackRepresentations,
+                          bool resortHits = false);
+
+    /// Fit every track with the given particle hypothesis, see TrackFitter::fit(RecoTrack&, const Const::ChargedStable&, bool).
+    std::vector<bool> fit(const std::vector<RecoTrack*>& recoTracks, const Const::ChargedStable& particleType,
+                          bool resortHits = false);
+
+    /// Same as above, but with one particle hypothesis per track.
+    std::vector<bool> fit(const std::vector<RecoTrack*>& recoTracks, const std::vector<Const::ChargedStable>& particleTypes,
+                          bool resortHits = false);
+
+    /// Same as above, but hypothesis set by pdg code, see TrackFitter::fit(RecoTrack&, const int, bool).
+    std::vector<bool> fit(const std::vector<RecoTrack*>& recoTracks, int pdgCode, bool resortHits = false);
+
+  private:
+    /// Create the material effects of nThreads - 1 worker threads, none if the material interface can not be cloned.
+    static std::vector<genfit::MaterialEffects*> createMaterialEffects(unsigned int nThreads);
+
+    /// One TrackFitter per thread, the first one is used in the calling thread.
+    std::vector<std::unique_ptr<TrackFitter>> m_fitters;
+    /// The material effects of the worker threads (the calling thread uses the global instance).
+    std::vector<genfit::MaterialEffects*> m_materialEffects;
+    /// The threads doing the fits, one more than material effects of the worker threads.
+    ParallelJobs m_jobs;
+
+    /// Tracks and representations to fit with genfit.
+    std::vector<std::pair<RecoTrack*, const genfit::AbsTrackRep*>> m_tracksToFit;
+  };
+}
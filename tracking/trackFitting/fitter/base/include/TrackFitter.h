@@ -256,6 +256,31 @@ namespace Belle2 {
      */
     bool fit(RecoTrack& recoTrack, bool resortHits = false) const;
 
+    /**
+     * First part of fit(): create the measurements and decide whether the track has to be fitted at all.
+     * This accesses the DataStore and must therefore be called from the main thread.
+     *
+     * Returns true if the track needs to be fitted with fitPrepared(). Otherwise nothing is to be done and
+     * wasFitSuccessful is set to the result of the already present fit.
+     */
+    bool prepareFit(RecoTrack& recoTrack, genfit::AbsTrackRep* trackRepresentation, bool& wasFitSuccessful) const;
+
+    /**
+     * Second part of fit(): only the genfit fit of a track prepared with prepareFit().
+     * This does not access the DataStore, so different tracks can be fitted in different threads
+     * if every thread uses its own TrackFitter and its own genfit::MaterialEffects (see ParallelTrackFitter).
+     * The gErrorIgnoreLevel is not changed here.
+     */
+    void fitPrepared(RecoTrack& recoTrack, const genfit::AbsTrackRep& trackRepresentation, bool resortHits = false) const;
+
+    /**
+     * Last part of fit(): synchronise the hit information with the fit result.
+     * This accesses the DataStore and must therefore be called from the main thread.
+     *
+     * Return bool if the track was successful.
+     */
+    bool finishFit(RecoTrack& recoTrack, const genfit::AbsTrackRep& trackRepresentation) const;
+
     /**
      * Reset the internal measurement creator storage to the default settings.
      * The measurements will not be recreated if the dirty flag is not set (the hit content did not change).
@@ -0,0 +1,132 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+#include <tracking/trackFitting/fitter/base/ParallelTrackFitter.h>
+#include <tracking/dataobjects/RecoTrack.h>
+
+#include <framework/logging/Logger.h>
+
+#include <genfit/MaterialEffects.h>
+
+#include <TError.h>
+
+using namespace Belle2;
+
+std::vector<genfit::MaterialEffects*> ParallelTrackFitter::createMaterialEffects(unsigned int nThreads)
+{
+  std::vector<genfit::MaterialEffects*> materialEffects;
+  for (unsigned int thread = 1; thread < nThreads; ++thread) {
+    genfit::MaterialEffects* threadMaterialEffects = genfit::MaterialEffects::createThreadInstance();
+    if (not threadMaterialEffects) {
+      B2WARNING("The genfit material interface can not be used in several threads, all tracks are fitted in one thread.");
+      for (genfit::MaterialEffects* created : materialEffects) {
+        genfit::MaterialEffects::deleteThreadInstance(created);
+      }
+      return {};
+    }
+    materialEffects.push_back(threadMaterialEffects);
+  }
+  return materialEffects;
+}
+
+ParallelTrackFitter::ParallelTrackFitter(unsigned int nThreads) :
+  m_materialEffects(createMaterialEffects(nThreads)),
+  m_jobs(m_materialEffects.size() + 1)
+{
+}
+
+ParallelTrackFitter::~ParallelTrackFitter()
+{
+  // the worker threads are idle, they do not use their material effects any more
+  for (genfit::MaterialEffects* materialEffects : m_materialEffects) {
+    genfit::MaterialEffects::deleteThreadInstance(materialEffects);
+  }
+}
+
+void ParallelTrackFitter::resetFitters(const FitterFactory& createFitter)
+{
+  m_fitters.clear();
+  for (unsigned int thread = 0; thread < getNumberOfThreads(); ++thread) {
+    m_fitters.push_back(createFitter());
+  }
+}
+
+std::vector<bool> ParallelTrackFitter::fit(const std::vector<RecoTrack*>& recoTracks, const Const::ChargedStable& particleType,
+                                           bool resortHits)
+{
+  return fit(recoTracks, std::vector<Const::ChargedStable>(recoTracks.size(), particleType), resortHits);
+}
+
+std::vector<bool> ParallelTrackFitter::fit(const std::vector<RecoTrack*>& recoTracks,
+                                           const std::vector<Const::ChargedStable>& particleTypes, bool resortHits)
+{
+  B2ASSERT("Need one particle type per track.", recoTracks.size() == particleTypes.size());
+
+  std::vector<genfit::AbsTrackRep*> trackRepresentations;
+  trackRepresentations.reserve(recoTracks.size());
+  for (size_t index = 0; index < recoTracks.size(); ++index) {
+    const int currentPdgCode = TrackFitter::createCorrectPDGCodeForChargedStable(particleTypes[index], *recoTracks[index]);
+    trackRepresentations.push_back(RecoTrackGenfitAccess::createOrReturnRKTrackRep(*recoTracks[index], currentPdgCode));
+  }
+  return fit(recoTracks, trackRepresentations, resortHits);
+}
+
+std::vector<bool> ParallelTrackFitter::fit(const std::vector<RecoTrack*>& recoTracks, int pdgCode, bool resortHits)
+{
+  std::vector<genfit::AbsTrackRep*> trackRepresentations;
+  trackRepresentations.reserve(recoTracks.size());
+  for (RecoTrack* recoTrack : recoTracks) {
+    trackRepresentations.push_back(RecoTrackGenfitAccess::createOrReturnRKTrackRep(*recoTrack, pdgCode));
+  }
+  return fit(recoTracks, trackRepresentations, resortHits);
+}
+
+std::vector<bool> ParallelTrackFitter::fit(const std::vector<RecoTrack*>& recoTracks,
+                                           const std::vector<genfit::AbsTrackRep*>& trackRepresentations,
+                                           bool resortHits)
+{
+  B2ASSERT("ParallelTrackFitter::resetFitters() has to be called before fitting.", not m_fitters.empty());
+  B2ASSERT("Need one track representation per track.", recoTracks.size() == trackRepresentations.size());
+
+  const TrackFitter& mainFitter = *m_fitters.front();
+  std::vector<bool> results(recoTracks.size(), false);
+
+  // measurements and dirty check, this uses the DataStore
+  std::vector<size_t> fittedTracks;
+  m_tracksToFit.clear();
+  for (size_t index = 0; index < recoTracks.size(); ++index) {
+    bool wasFitSuccessful = false;
+    if (mainFitter.prepareFit(*recoTracks[index], trackRepresentations[index], wasFitSuccessful)) {
+      fittedTracks.push_back(index);
+      m_tracksToFit.emplace_back(recoTracks[index], trackRepresentations[index]);
+    } else {
+      results[index] = wasFitSuccessful;
+    }
+  }
+  if (m_tracksToFit.empty()) {
+    return results;
+  }
+
+  const auto previousSetting = gErrorIgnoreLevel; // Save current log level
+  gErrorIgnoreLevel = m_fitters.front()->getgErrorIgnoreLevel(); // Set the log level defined in the TrackFitter
+
+  m_jobs.run(m_tracksToFit.size(), [this, resortHits](size_t job, unsigned thread) {
+    if (thread > 0) {
+      genfit::MaterialEffects::setThreadInstance(m_materialEffects[thread - 1]);
+    }
+    m_fitters[thread]->fitPrepared(*m_tracksToFit[job].first, *m_tracksToFit[job].second, resortHits);
+  });
+
+  gErrorIgnoreLevel = previousSetting; // Restore previous setting
+
+  // hit synchronisation in the order of the tracks, this uses the DataStore
+  for (size_t job = 0; job < m_tracksToFit.size(); ++job) {
+    results[fittedTracks[job]] = mainFitter.finishFit(*m_tracksToFit[job].first, *m_tracksToFit[job].second);
+  }
+  m_tracksToFit.clear();
+  return results;
+}
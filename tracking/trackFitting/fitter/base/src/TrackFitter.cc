@@ -69,6 +69,12 @@ bool TrackFitter::fit(RecoTrack& recoTrack, const int pdgCode, bool resortHits)
 }
 
 bool TrackFitter::fitWithoutCheck(RecoTrack& recoTrack, const genfit::AbsTrackRep& trackRepresentation, bool resortHits) const
+{
+  fitPrepared(recoTrack, trackRepresentation, resortHits);
+  return finishFit(recoTrack, trackRepresentation);
+}
+
+void TrackFitter::fitPrepared(RecoTrack& recoTrack, const genfit::AbsTrackRep& trackRepresentation, bool resortHits) const
 {
   // Fit the track
   try {
@@ -81,7 +87,10 @@ bool TrackFitter::fitWithoutCheck(RecoTrack& recoTrack, const genfit::AbsTrackRe
   }
 
   recoTrack.setDirtyFlag(false);
+}
 
+bool TrackFitter::finishFit(RecoTrack& recoTrack, const genfit::AbsTrackRep& trackRepresentation) const
+{
   // Do the hits synchronisation
   const std::vector<RecoHitInformation*>& relatedRecoHitInformation = recoTrack.getRecoHitInformations();
 
@@ -105,10 +114,11 @@ bool TrackFitter::fitWithoutCheck(RecoTrack& recoTrack, const genfit::AbsTrackRe
   return recoTrack.wasFitSuccessful(&trackRepresentation);
 }
 
-bool TrackFitter::fit(RecoTrack& recoTrack, genfit::AbsTrackRep* trackRepresentation, bool resortHits) const
+bool TrackFitter::prepareFit(RecoTrack& recoTrack, genfit::AbsTrackRep* trackRepresentation, bool& wasFitSuccessful) const
 {
   B2ASSERT("No fitter was loaded! Have you reset the fitter to an invalid one?", m_fitter);
 
+  wasFitSuccessful = false;
   const bool measurementAdderNeedsTrackRefit = m_measurementAdder.addMeasurements(recoTrack);
 
   if (RecoTrackGenfitAccess::getGenfitTrack(recoTrack).getNumPoints() == 0) {
@@ -125,7 +135,18 @@ bool TrackFitter::fit(RecoTrack& recoTrack, genfit::AbsTrackRep* trackRepresenta
       and recoTrack.hasTrackFitStatus(trackRepresentation) and recoTrack.getTrackFitStatus(trackRepresentation)->isFitted()) {
     B2DEBUG(100, "Hit content did not change, track representation is already present and you used only default parameters." <<
             "I will not fit the track again. If you still want to do so, set the dirty flag of the track.");
-    return recoTrack.wasFitSuccessful(trackRepresentation);
+    wasFitSuccessful = recoTrack.wasFitSuccessful(trackRepresentation);
+    return false;
+  }
+
+  return true;
+}
+
+bool TrackFitter::fit(RecoTrack& recoTrack, genfit::AbsTrackRep* trackRepresentation, bool resortHits) const
+{
+  bool wasFitSuccessful = false;
+  if (not prepareFit(recoTrack, trackRepresentation, wasFitSuccessful)) {
+    return wasFitSuccessful;
   }
 
   const auto previousSetting = gErrorIgnoreLevel; // Save current log level
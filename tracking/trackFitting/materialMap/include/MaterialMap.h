@@ -0,0 +1,120 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+#pragma once
+
+#include <genfit/Material.h>
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Belle2 {
+
+  /**
+   * Precomputed map of the (averaged) material parameters on a cylindrical (r, phi, z) voxel grid.
+   *
+   * Each voxel stores the index of its material in a table of distinct materials, so looking up
+   * the material at a position is a few arithmetic operations instead of a navigation in the full
+   * geometry. The material of a voxel is the volume weighted average of the materials in it (see average()),
+   * which keeps the number of radiation lengths and the electrons in the voxel.
+   *
+   * The map does not know anything about the geometry itself: it is filled by the user
+   * (VoxelizedMaterialInterface::createMaterialMap() integrates the Geant4 geometry), written to a file
+   * once and read back from it in the reconstruction jobs.
+   */
+  class MaterialMap {
+  public:
+    /// Extent and number of bins of the voxel grid. r starts at 0, phi covers the full circle.
+    struct Binning {
+      double rMax = 0; /**< outer radius of the grid in cm. */
+      double zMin = 0; /**< lower z edge of the grid in cm. */
+      double zMax = 0; /**< upper z edge of the grid in cm. */
+      unsigned int nR = 0; /**< number of bins in r. */
+      unsigned int nPhi = 0; /**< number of bins in phi. */
+      unsigned int nZ = 0; /**< number of bins in z. */
+
+      /// Are the two binnings the same?
+      bool operator==(const Binning& other) const
+      {
+        return rMax == other.rMax and zMin == other.zMin and zMax == other.zMax and nR == other.nR and nPhi == other.nPhi
+               and nZ == other.nZ;
+      }
+    };
+
+    /// Index returned for positions outside of the grid and for voxels not filled yet
+    static constexpr std::uint32_t c_noMaterial = 0xffffffff;
+
+    /// Create an empty map with the given binning
+    explicit MaterialMap(const Binning& binning);
+
+    /// Return the binning of the grid
+    const Binning& getBinning() const { return m_binning; }
+    /// Return the total number of voxels
+    std::uint32_t getNumberOfVoxels() const { return m_voxels.size(); }
+    /// Return the number of distinct materials
+    std::uint32_t getNumberOfMaterials() const { return m_materials.size(); }
+
+    /// Return the voxel containing the given point (in cm) or c_noMaterial if it is outside of the grid
+    std::uint32_t getVoxel(double x, double y, double z) const;
+    /// Return the voxel with the given bin numbers in r, phi and z
+    std::uint32_t getVoxelIndex(std::uint32_t iR, std::uint32_t iPhi, std::uint32_t iZ) const
+    {
+      return (iR * m_binning.nPhi + iPhi) * m_binning.nZ + iZ;
+    }
+    /**
+     * Return a point (in cm) inside the given voxel. The relative coordinates (each between 0 and 1)
+     * give the position along r, phi and z inside the voxel, 0.5 for all of them is the voxel center.
+     */
+    std::array<double, 3> getPointInVoxel(std::uint32_t voxel, double relativeR, double relativePhi, double relativeZ) const;
+    /// Return a step length (in cm) small enough not to jump over a voxel at the given point
+    double getStepSize(double x, double y, double z) const;
+
+    /// Set the material of the given voxel
+    void setMaterial(std::uint32_t voxel, const genfit::Material& material);
+    /// Return the material index of the voxel containing the given point (c_noMaterial if outside)
+    std::uint32_t getMaterialIndex(double x, double y, double z) const
+    {
+      const std::uint32_t voxel = getVoxel(x, y, z);
+      return voxel == c_noMaterial ? c_noMaterial : m_voxels[voxel];
+    }
+    /// Return the material with the given index
+    const genfit::Material& getMaterial(std::uint32_t index) const { return m_materials[index]; }
+
+    /**
+     * Average materials filling the given (relative) volumes of a voxel:
+     * the density is averaged, the radiation length such that the number of radiation lengths stays the same,
+     * Z weighted by mass, A such that the electron density stays the same and the logarithm of the mean
+     * excitation energy weighted with the electron density (as for a compound).
+     */
+    static genfit::Material average(const std::vector<genfit::Material>& materials, const std::vector<double>& volumes);
+
+    /// Write the map together with the key identifying the geometry to a file. Returns false on failure.
+    bool write(const std::string& fileName, const std::string& key) const;
+    /// Read a map from file. Returns nullptr if the file does not exist, is broken or was written for another key or binning.
+    static std::unique_ptr<MaterialMap> read(const std::string& fileName, const std::string& key, const Binning& binning);
+
+  private:
+    /// Binning of the grid
+    Binning m_binning;
+    /// Bin width in r
+    double m_rWidth;
+    /// Bin width in phi
+    double m_phiWidth;
+    /// Bin width in z
+    double m_zWidth;
+    /// Material index of every voxel. The voxel index is (iR * nPhi + iPhi) * nZ + iZ.
+    std::vector<std::uint32_t> m_voxels;
+    /// Table of distinct materials
+    std::vector<genfit::Material> m_materials;
+    /// Lookup of the (rounded) material parameters to the index in m_materials, only used while filling
+    std::map<std::array<double, 5>, std::uint32_t> m_materialIndices;
+  };
+}
@@ -0,0 +1,207 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+#include <tracking/trackFitting/materialMap/MaterialMap.h>
+#include <framework/logging/Logger.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+using namespace Belle2;
+
+namespace {
+  /// Marker at the beginning of a material map file
+  constexpr char c_fileMagic[8] = {'B', '2', 'M', 'A', 'T', 'M', 'A', 'P'};
+  /// Version of the file format
+  constexpr std::uint32_t c_fileVersion = 2;
+
+  /// Round to four significant digits, so that nearly identical averaged materials share one table entry
+  double roundParameter(double value)
+  {
+    if (value == 0 or not std::isfinite(value)) {
+      return value;
+    }
+    const double scale = std::pow(10., 3 - std::floor(std::log10(std::fabs(value))));
+    return std::round(value * scale) / scale;
+  }
+
+  /// Write a plain value to the stream
+  template<class T>
+  void writeValue(std::ostream& stream, const T& value)
+  {
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  /// Read a plain value from the stream
+  template<class T>
+  T readValue(std::istream& stream)
+  {
+    T value{};
+    stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return value;
+  }
+}
+
+MaterialMap::MaterialMap(const Binning& binning) :
+  m_binning(binning),
+  m_rWidth(binning.rMax / binning.nR),
+  m_phiWidth(2 * M_PI / binning.nPhi),
+  m_zWidth((binning.zMax - binning.zMin) / binning.nZ),
+  m_voxels(static_cast<std::size_t>(binning.nR) * binning.nPhi * binning.nZ, c_noMaterial)
+{
+  B2ASSERT("The material map needs at least one bin in every direction", binning.nR > 0 and binning.nPhi > 0 and binning.nZ > 0);
+  B2ASSERT("The material map needs a positive extent", binning.rMax > 0 and binning.zMax > binning.zMin);
+}
+
+std::uint32_t MaterialMap::getVoxel(double x, double y, double z) const
+{
+  if (z < m_binning.zMin or z >= m_binning.zMax) {
+    return c_noMaterial;
+  }
+  const double r = std::hypot(x, y);
+  if (r >= m_binning.rMax) {
+    return c_noMaterial;
+  }
+  double phi = std::atan2(y, x);
+  if (phi < 0) {
+    phi += 2 * M_PI;
+  }
+
+  const auto iR = std::min<std::uint32_t>(r / m_rWidth, m_binning.nR - 1);
+  const auto iPhi = std::min<std::uint32_t>(phi / m_phiWidth, m_binning.nPhi - 1);
+  const auto iZ = std::min<std::uint32_t>((z - m_binning.zMin) / m_zWidth, m_binning.nZ - 1);
+  return getVoxelIndex(iR, iPhi, iZ);
+}
+
+std::array<double, 3> MaterialMap::getPointInVoxel(std::uint32_t voxel, double relativeR, double relativePhi,
+                                                   double relativeZ) const
+{
+  const std::uint32_t iZ = voxel % m_binning.nZ;
+  const std::uint32_t iPhi = (voxel / m_binning.nZ) % m_binning.nPhi;
+  const std::uint32_t iR = voxel / m_binning.nZ / m_binning.nPhi;
+
+  const double r = (iR + relativeR) * m_rWidth;
+  const double phi = (iPhi + relativePhi) * m_phiWidth;
+  const double z = m_binning.zMin + (iZ + relativeZ) * m_zWidth;
+  return {r * std::cos(phi), r * std::sin(phi), z};
+}
+
+double MaterialMap::getStepSize(double x, double y, double) const
+{
+  // The phi bins get arbitrarily small at the center. Below one r bin the
+  // material does not change much with phi, so do not go below this size.
+  const double r = std::max(std::hypot(x, y), m_rWidth);
+  return 0.5 * std::min({m_rWidth, m_zWidth, r * m_phiWidth});
+}
+
+void MaterialMap::setMaterial(std::uint32_t voxel, const genfit::Material& material)
+{
+  const genfit::Material rounded(roundParameter(material.density), roundParameter(material.Z), roundParameter(material.A),
+                                 roundParameter(material.radiationLength), roundParameter(material.mEE));
+  const std::array<double, 5> key{rounded.density, rounded.Z, rounded.A, rounded.radiationLength, rounded.mEE};
+
+  auto [position, inserted] = m_materialIndices.emplace(key, m_materials.size());
+  if (inserted) {
+    m_materials.push_back(rounded);
+  }
+  m_voxels.at(voxel) = position->second;
+}
+
+genfit::Material MaterialMap::average(const std::vector<genfit::Material>& materials, const std::vector<double>& volumes)
+{
+  B2ASSERT("Cannot average zero materials", not materials.empty());
+  B2ASSERT("Every material needs a volume", materials.size() == volumes.size());
+
+  double totalVolume = 0;
+  double mass = 0;
+  double inverseRadiationLength = 0;
+  double massWeightedZ = 0;
+  double electrons = 0;
+  double logExcitationEnergy = 0;
+  for (std::size_t i = 0; i < materials.size(); ++i) {
+    const genfit::Material& material = materials[i];
+    const double volume = volumes[i];
+    totalVolume += volume;
+    mass += volume * material.density;
+    inverseRadiationLength += volume / material.radiationLength;
+    massWeightedZ += volume * material.density * material.Z;
+    const double materialElectrons = volume * material.density * material.Z / material.A;
+    electrons += materialElectrons;
+    logExcitationEnergy += materialElectrons * std::log(material.mEE);
+  }
+
+  // Only vacuum (or close to it) inside: nothing to average
+  if (mass <= 0 or electrons <= 0) {
+    return materials.front();
+  }
+
+  const double Z = massWeightedZ / mass;
+  return genfit::Material(mass / totalVolume, Z, Z * mass / electrons, totalVolume / inverseRadiationLength,
+                          std::exp(logExcitationEnergy / electrons));
+}
+
+bool MaterialMap::write(const std::string& fileName, const std::string& key) const
+{
+  std::ofstream stream(fileName, std::ios::binary | std::ios::trunc);
+  if (not stream) {
+    return false;
+  }
+
+  stream.write(c_fileMagic, sizeof(c_fileMagic));
+  writeValue(stream, c_fileVersion);
+  writeValue<std::uint32_t>(stream, key.size());
+  stream.write(key.data(), key.size());
+  writeValue(stream, m_binning);
+  writeValue<std::uint32_t>(stream, m_materials.size());
+  for (const genfit::Material& material : m_materials) {
+    writeValue(stream, std::array<double, 5> {material.density, material.Z, material.A, material.radiationLength, material.mEE});
+  }
+  stream.write(reinterpret_cast<const char*>(m_voxels.data()), m_voxels.size() * sizeof(std::uint32_t));
+  return static_cast<bool>(stream);
+}
+
+std::unique_ptr<MaterialMap> MaterialMap::read(const std::string& fileName, const std::string& key, const Binning& binning)
+{
+  std::ifstream stream(fileName, std::ios::binary);
+  if (not stream) {
+    return nullptr;
+  }
+
+  char magic[sizeof(c_fileMagic)];
+  stream.read(magic, sizeof(magic));
+  if (not stream or not std::equal(magic, magic + sizeof(magic), c_fileMagic) or readValue<std::uint32_t>(stream) != c_fileVersion) {
+    B2WARNING("The material map file " << fileName << " has an unknown format, ignoring it.");
+    return nullptr;
+  }
+
+  std::string fileKey(readValue<std::uint32_t>(stream), '\0');
+  stream.read(fileKey.data(), fileKey.size());
+  const auto fileBinning = readValue<Binning>(stream);
+  if (not stream or fileKey != key or not(fileBinning == binning)) {
+    B2INFO("The material map file " << fileName << " was created for another geometry or binning, ignoring it.");
+    return nullptr;
+  }
+
+  auto materialMap = std::make_unique<MaterialMap>(binning);
+  const auto nMaterials = readValue<std::uint32_t>(stream);
+  for (std::uint32_t index = 0; index < nMaterials and stream; index++) {
+    const auto parameters = readValue<std::array<double, 5>>(stream);
+    materialMap->m_materials.emplace_back(parameters[0], parameters[1], parameters[2], parameters[3], parameters[4]);
+  }
+  auto& voxels = materialMap->m_voxels;
+  stream.read(reinterpret_cast<char*>(voxels.data()), voxels.size() * sizeof(std::uint32_t));
+  if (not stream) {
+    B2WARNING("The material map file " << fileName << " is truncated, ignoring it.");
+    return nullptr;
+  }
+  if (std::any_of(voxels.begin(), voxels.end(), [nMaterials](std::uint32_t index) { return index != c_noMaterial and index >= nMaterials; })) {
+    B2WARNING("The material map file " << fileName << " is corrupted, ignoring it.");
+    return nullptr;
+  }
+  return materialMap;
+}
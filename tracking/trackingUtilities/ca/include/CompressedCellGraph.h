@@ -0,0 +1,295 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+#pragma once
+
+#include <tracking/trackingUtilities/ca/AutomatonCell.h>
+#include <tracking/trackingUtilities/numerics/Weight.h>
+
+#include <tracking/trackingUtilities/utilities/WeightedRelation.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace Belle2 {
+  namespace TrackingUtilities {
+
+    /**
+     *  Graph of cells with weighted relations in compressed sparse row form.
+     *
+     *  The cells are addressed by their index in the vector of cell holders the graph was built from.
+     *  The successors of cell i are m_successors[m_successorOffsets[i]] to m_successors[m_successorOffsets[i + 1] - 1]
+     *  in the order of the weighted relations, the predecessors are stored in the same way.
+     *
+     *  The graph can arrange the cells, which are not masked, in layers such that all successors of a cell are
+     *  in lower layers. All cells of one layer can then be processed independently of each other.
+     */
+    template<class ACellHolder>
+    class CompressedCellGraph {
+
+    public:
+      /**
+       *  Build the graph from the cells and their relations.
+       *  Relations without a cell on the to side are ignored, as are relations from cells not in the given cells.
+       *  If a relation points to a cell not in the given cells or a cell is given twice, the graph is marked as invalid.
+       */
+      void build(const std::vector<ACellHolder*>& cellHolders,
+                 const std::vector<WeightedRelation<ACellHolder>>& cellHolderRelations)
+      {
+        const int nCells = cellHolders.size();
+        m_cellHolders = cellHolders;
+        m_valid = true;
+
+        // Lookup of the index of a cell holder
+        m_sortedCellHolders.clear();
+        m_sortedCellHolders.reserve(nCells);
+        for (int iCell = 0; iCell < nCells; ++iCell) {
+          m_sortedCellHolders.emplace_back(cellHolders[iCell], iCell);
+        }
+        std::sort(m_sortedCellHolders.begin(), m_sortedCellHolders.end());
+        for (int iCell = 1; iCell < nCells; ++iCell) {
+          if (m_sortedCellHolders[iCell - 1].first == m_sortedCellHolders[iCell].first) {
+            m_valid = false;
+          }
+        }
+
+        // Translate the relations to pairs of indices
+        m_relationIndices.clear();
+        m_relationIndices.reserve(cellHolderRelations.size());
+        m_successorOffsets.assign(nCells + 1, 0);
+        m_predecessorOffsets.assign(nCells + 1, 0);
+        for (const WeightedRelation<ACellHolder>& relation : cellHolderRelations) {
+          if (not relation.getTo()) continue;
+          const int iFrom = getIndex(relation.getFrom());
+          if (iFrom < 0) continue;
+          const int iTo = getIndex(relation.getTo());
+          if (iTo < 0) {
+            m_valid = false;
+            continue;
+          }
+          m_relationIndices.push_back({iFrom, iTo, relation.getWeight()});
+          ++m_successorOffsets[iFrom + 1];
+          ++m_predecessorOffsets[iTo + 1];
+        }
+        for (int iCell = 0; iCell < nCells; ++iCell) {
+          m_successorOffsets[iCell + 1] += m_successorOffsets[iCell];
+          m_predecessorOffsets[iCell + 1] += m_predecessorOffsets[iCell];
+        }
+
+        // Fill the successors in the order of the relations and the predecessors
+        const int nRelations = m_relationIndices.size();
+        m_successors.resize(nRelations);
+        m_weights.resize(nRelations);
+        m_predecessors.resize(nRelations);
+        m_fill.assign(m_successorOffsets.begin(), m_successorOffsets.end() - 1);
+        for (const IndexedRelation& relation : m_relationIndices) {
+          const int iSuccessor = m_fill[relation.from]++;
+          m_successors[iSuccessor] = relation.to;
+          m_weights[iSuccessor] = relation.weight;
+        }
+        m_fill.assign(m_predecessorOffsets.begin(), m_predecessorOffsets.end() - 1);
+        for (const IndexedRelation& relation : m_relationIndices) {
+          m_predecessors[m_fill[relation.to]++] = relation.from;
+        }
+      }
+
+      /**
+       *  Arrange the cells, which are currently not masked, in layers.
+       *  Cells without unmasked successors go into the first layer, every other cell into the layer after its
+       *  highest successor.
+       *  @return false if the unmasked cells contain a cycle, in this case the layers are incomplete.
+       */
+      bool computeLayers()
+      {
+        const int nCells = m_cellHolders.size();
+        m_unmasked.resize(nCells);
+        m_nOpenSuccessors.assign(nCells, 0);
+        for (int iCell = 0; iCell < nCells; ++iCell) {
+          m_unmasked[iCell] = not m_cellHolders[iCell]->getAutomatonCell().hasMaskedFlag();
+        }
+
+        m_layerCells.clear();
+        m_layerOffsets.assign(1, 0);
+        int nUnmasked = 0;
+        for (int iCell = 0; iCell < nCells; ++iCell) {
+          if (not m_unmasked[iCell]) continue;
+          ++nUnmasked;
+          for (int iSuccessor = m_successorOffsets[iCell]; iSuccessor < m_successorOffsets[iCell + 1]; ++iSuccessor) {
+            m_nOpenSuccessors[iCell] += m_unmasked[m_successors[iSuccessor]];
+          }
+          if (m_nOpenSuccessors[iCell] == 0) {
+            m_layerCells.push_back(iCell);
+          }
+        }
+        m_layerOffsets.push_back(m_layerCells.size());
+
+        // Each layer releases the predecessors whose last open successor it contained
+        for (int iLayer = 0; m_layerOffsets[iLayer] < m_layerOffsets[iLayer + 1]; ++iLayer) {
+          for (int iLayerCell = m_layerOffsets[iLayer]; iLayerCell < m_layerOffsets[iLayer + 1]; ++iLayerCell) {
+            const int iCell = m_layerCells[iLayerCell];
+            for (int iPredecessor = m_predecessorOffsets[iCell];
+                 iPredecessor < m_predecessorOffsets[iCell + 1];
+                 ++iPredecessor) {
+              const int iFrom = m_predecessors[iPredecessor];
+              if (not m_unmasked[iFrom]) continue;
+              if (--m_nOpenSuccessors[iFrom] == 0) {
+                m_layerCells.push_back(iFrom);
+              }
+            }
+          }
+          m_layerOffsets.push_back(m_layerCells.size());
+        }
+        // The last layer is always empty
+        m_layerOffsets.pop_back();
+
+        return static_cast<int>(m_layerCells.size()) == nUnmasked;
+      }
+
+      /// Whether the graph represents all given relations
+      bool isValid() const
+      {
+        return m_valid;
+      }
+
+      /// Number of cells
+      int size() const
+      {
+        return m_cellHolders.size();
+      }
+
+      /// The cell holder with the given index
+      ACellHolder* getCellHolder(int iCell) const
+      {
+        return m_cellHolders[iCell];
+      }
+
+      /// The cell holders in the order of the indices
+      const std::vector<ACellHolder*>& getCellHolders() const
+      {
+        return m_cellHolders;
+      }
+
+      /// Offsets of the successors of every cell, one more entry than cells
+      const std::vector<int>& getSuccessorOffsets() const
+      {
+        return m_successorOffsets;
+      }
+
+      /// Indices of the successors of all cells
+      const std::vector<int>& getSuccessors() const
+      {
+        return m_successors;
+      }
+
+      /// Weights of the relations to the successors
+      const std::vector<Weight>& getWeights() const
+      {
+        return m_weights;
+      }
+
+      /// Offsets of the predecessors of every cell, one more entry than cells
+      const std::vector<int>& getPredecessorOffsets() const
+      {
+        return m_predecessorOffsets;
+      }
+
+      /// Indices of the predecessors of all cells
+      const std::vector<int>& getPredecessors() const
+      {
+        return m_predecessors;
+      }
+
+      /// Whether the cells were unmasked in the last computeLayers()
+      const std::vector<char>& getUnmasked() const
+      {
+        return m_unmasked;
+      }
+
+      /// Number of layers of the last computeLayers()
+      int getNLayers() const
+      {
+        return m_layerOffsets.size() - 1;
+      }
+
+      /// Offsets of the layers in the layer cells, one more entry than layers
+      const std::vector<int>& getLayerOffsets() const
+      {
+        return m_layerOffsets;
+      }
+
+      /// Indices of the cells ordered by layer
+      const std::vector<int>& getLayerCells() const
+      {
+        return m_layerCells;
+      }
+
+    private:
+      /// Index of the cell holder or -1 if it is not part of the graph
+      int getIndex(const ACellHolder* cellHolder) const
+      {
+        auto itCellHolder = std::lower_bound(m_sortedCellHolders.begin(), m_sortedCellHolders.end(),
+                                             std::make_pair(cellHolder, 0));
+        if (itCellHolder == m_sortedCellHolders.end() or itCellHolder->first != cellHolder) return -1;
+        return itCellHolder->second;
+      }
+
+    private:
+      /// A relation between cells given by their indices
+      struct IndexedRelation {
+        /// Index of the cell on the from side
+        int from;
+        /// Index of the cell on the to side
+        int to;
+        /// Weight of the relation
+        Weight weight;
+      };
+
+      /// The cell holders
+      std::vector<ACellHolder*> m_cellHolders;
+
+      /// The cell holders sorted by address with their index
+      std::vector<std::pair<const ACellHolder*, int>> m_sortedCellHolders;
+
+      /// Whether all relations are represented
+      bool m_valid = false;
+
+      /// Offsets of the successors of every cell
+      std::vector<int> m_successorOffsets;
+
+      /// Indices of the successors
+      std::vector<int> m_successors;
+
+      /// Weights of the relations to the successors
+      std::vector<Weight> m_weights;
+
+      /// Offsets of the predecessors of every cell
+      std::vector<int> m_predecessorOffsets;
+
+      /// Indices of the predecessors
+      std::vector<int> m_predecessors;
+
+      /// Whether the cells are not masked
+      std::vector<char> m_unmasked;
+
+      /// Number of unmasked successors not yet placed in a layer
+      std::vector<int> m_nOpenSuccessors;
+
+      /// Offsets of the layers in m_layerCells
+      std::vector<int> m_layerOffsets;
+
+      /// Indices of the cells ordered by layer
+      std::vector<int> m_layerCells;
+
+      /// Temporary relations with the indices of the cells
+      std::vector<IndexedRelation> m_relationIndices;
+
+      /// Temporary fill positions while building
+      std::vector<int> m_fill;
+    };
+  }
+}
@@ -8,6 +8,8 @@
 #pragma once
 
 #include <tracking/trackingUtilities/ca/CellularAutomaton.h>
+#include <tracking/trackingUtilities/ca/ParallelCellularAutomaton.h>
+#include <tracking/trackingUtilities/ca/CompressedCellGraph.h>
 #include <tracking/trackingUtilities/ca/CellularPathFollower.h>
 
 #include <tracking/trackingUtilities/ca/Path.h>
@@ -18,6 +20,7 @@
 #include <framework/core/ModuleParamList.h>
 #include <framework/logging/Logger.h>
 
+#include <memory>
 #include <vector>
 
 namespace Belle2 {
@@ -61,6 +64,12 @@ namespace Belle2 {
                                       "The minimal path length to that is written to output",
                                       m_param_minPathLength);
 
+        moduleParamList->addParameter(prefixed(prefix, "caThreads"),
+                                      m_param_caThreads,
+                                      "Number of threads of the cellular automaton. "
+                                      "0 uses the depth first automaton, "
+                                      "n > 0 the layer by layer automaton with n threads, which gives the same result.",
+                                      m_param_caThreads);
       }
 
       /// Applies the cellular automaton to the collection and its relations
@@ -101,9 +110,22 @@ namespace Belle2 {
           cellHolder->unsetAndForwardMaskedFlag();
         }
 
+        // The layer by layer automaton reuses the graph in all passes, only the masked cells change.
+        if (m_param_caThreads > 0) {
+          if (not m_parallelCellularAutomaton or
+              static_cast<int>(m_parallelCellularAutomaton->getNumberOfThreads()) != m_param_caThreads) {
+            m_parallelCellularAutomaton = std::make_unique<ParallelCellularAutomaton<ACellHolder>>(m_param_caThreads);
+          }
+          m_cellGraph.build(cellHolders, cellHolderRelations);
+        }
+
         B2DEBUG(25, "Apply multipass cellular automat");
         do {
-          m_cellularAutomaton.applyTo(cellHolders, cellHolderRelations);
+          if (m_param_caThreads > 0) {
+            m_parallelCellularAutomaton->applyTo(m_cellGraph, cellHolderRelations);
+          } else {
+            m_cellularAutomaton.applyTo(cellHolders, cellHolderRelations);
+          }
 
           auto lessStartCellState = [this](ACellHolder * lhs, ACellHolder * rhs) {
             const AutomatonCell& lhsCell = lhs->getAutomatonCell();
@@ -165,6 +187,12 @@ namespace Belle2 {
       /// The cellular automaton to be used.
       CellularAutomaton<ACellHolder> m_cellularAutomaton;
 
+      /// The layer by layer cellular automaton, created at the first use with the requested number of threads.
+      std::unique_ptr<ParallelCellularAutomaton<ACellHolder>> m_parallelCellularAutomaton;
+
+      /// Graph of the cells for the layer by layer cellular automaton.
+      CompressedCellGraph<ACellHolder> m_cellGraph;
+
       /// The path follower used to extract the path from the graph processed by the cellular automaton.
       CellularPathFollower<ACellHolder> m_cellularPathFollower;
 
@@ -173,6 +201,9 @@ namespace Belle2 {
 
       /// The minimal path length to write to output
       int m_param_minPathLength = 0;
+
+      /// Number of threads of the cellular automaton, 0 for the depth first automaton
+      int m_param_caThreads = 0;
     };
   }
 }
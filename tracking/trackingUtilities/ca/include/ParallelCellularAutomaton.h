@@ -0,0 +1,214 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+#pragma once
+
+#include <tracking/trackingUtilities/ca/CellularAutomaton.h>
+#include <tracking/trackingUtilities/ca/CompressedCellGraph.h>
+#include <tracking/trackingUtilities/ca/AutomatonCell.h>
+#include <tracking/trackingUtilities/numerics/Weight.h>
+
+#include <tracking/trackingUtilities/utilities/WeightedRelation.h>
+
+#include <framework/logging/Logger.h>
+#include <framework/utilities/ParallelJobs.h>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace Belle2 {
+
+  namespace TrackingUtilities {
+    /**
+     *  Implements the weighted cellular automaton algorithm layer by layer instead of depth first.
+     *
+     *  The unmasked cells are arranged in layers (see CompressedCellGraph::computeLayers), such that the final state
+     *  of all successors of a cell is known, when the layer of the cell is processed. The cells of one layer are
+     *  independent of each other and are distributed over several threads, if the layer is large enough.
+     *
+     *  Every cell gets the same state and flags as in the depth first CellularAutomaton. If the graph contains
+     *  a cycle, the result of the depth first algorithm depends on the order of the traversal, so in this case
+     *  the depth first CellularAutomaton is used.
+     *
+     *  The layers are distributed with ParallelJobs, whose worker threads are started at the first application
+     *  (to be compatible with the forking of the multiprocessing). They do not touch anything but the cells of
+     *  the current layer.
+     */
+    template<class ACellHolder>
+    class ParallelCellularAutomaton {
+
+    public:
+      /// Use nThreads threads including the calling thread
+      explicit ParallelCellularAutomaton(unsigned int nThreads = 1)
+        : m_jobs(nThreads)
+      {
+      }
+
+      /// No copies of the threads
+      ParallelCellularAutomaton(const ParallelCellularAutomaton&) = delete;
+
+      /// No copies of the threads
+      ParallelCellularAutomaton& operator=(const ParallelCellularAutomaton&) = delete;
+
+      /**
+       *  Applies the cellular automaton to the collection of cells and its neighborhood
+       *  @param cellHolders             The range based iterable containing the cells.
+       *  @param cellHolderRelations     The weighted relations between the cells.
+       *  @return                        The cell holder with the highest cell state found.
+       */
+      ACellHolder* applyTo(const std::vector<ACellHolder*>& cellHolders,
+                           const std::vector<WeightedRelation<ACellHolder>>& cellHolderRelations)
+      {
+        m_graph.build(cellHolders, cellHolderRelations);
+        return applyTo(m_graph, cellHolderRelations);
+      }
+
+      /**
+       *  Applies the cellular automaton to a graph built before, e.g. to reuse it in several passes.
+       *  @param graph                   Graph built from the cells and the relations.
+       *  @param cellHolderRelations     The weighted relations the graph was built from.
+       *  @return                        The cell holder with the highest cell state found.
+       */
+      ACellHolder* applyTo(CompressedCellGraph<ACellHolder>& graph,
+                           const std::vector<WeightedRelation<ACellHolder>>& cellHolderRelations)
+      {
+        const std::vector<ACellHolder*>& cellHolders = graph.getCellHolders();
+        if (not graph.isValid() or not graph.computeLayers()) {
+          B2DEBUG(25, "Cycle or relation outside of the cells detected, using the depth first cellular automaton");
+          return m_cellularAutomaton.applyTo(cellHolders, cellHolderRelations);
+        }
+
+        // Set all cell states to -inf and the non permanent flags to unset.
+        for (ACellHolder* cellHolder : cellHolders) {
+          AutomatonCell& cell = cellHolder->getAutomatonCell();
+          cell.unsetTemporaryFlags();
+          if (cell.hasMaskedFlag()) continue;
+          cell.setCellState(NAN);
+        }
+
+        const std::vector<int>& layerOffsets = graph.getLayerOffsets();
+        for (int iLayer = 0; iLayer < graph.getNLayers(); ++iLayer) {
+          const int begin = layerOffsets[iLayer];
+          const int end = layerOffsets[iLayer + 1];
+          if (m_jobs.getNumThreads() > 1 and end - begin >= c_minCellsForThreads) {
+            updateLayerInThreads(graph, begin, end);
+          } else {
+            updateCells(graph, begin, end);
+          }
+        }
+
+        auto lessStartCellState = [](ACellHolder * lhs, ACellHolder * rhs) {
+          const AutomatonCell& lhsCell = lhs->getAutomatonCell();
+          const AutomatonCell& rhsCell = rhs->getAutomatonCell();
+          return (std::make_pair(lhsCell.hasStartFlag(), lhsCell.getCellState()) <
+                  std::make_pair(rhsCell.hasStartFlag(), rhsCell.getCellState()));
+        };
+
+        auto itStartCellHolder =
+          std::max_element(cellHolders.begin(), cellHolders.end(), lessStartCellState);
+        if (itStartCellHolder == cellHolders.end()) return nullptr;
+        if (not(*itStartCellHolder)->getAutomatonCell().hasStartFlag()) return nullptr;
+        return *itStartCellHolder;
+      }
+
+      /// Number of threads used including the calling thread
+      unsigned int getNumberOfThreads() const
+      {
+        return m_jobs.getNumThreads();
+      }
+
+    private:
+      /**
+       *  Updates the state of a cell from the final states of its successors.
+       *  Same as CellularAutomaton::updateState, the start flag is set if no unmasked cell points to the cell.
+       */
+      static void updateCell(const CompressedCellGraph<ACellHolder>& graph, int iCell)
+      {
+        const std::vector<char>& unmasked = graph.getUnmasked();
+        const std::vector<int>& successorOffsets = graph.getSuccessorOffsets();
+        const std::vector<int>& successors = graph.getSuccessors();
+        const std::vector<Weight>& weights = graph.getWeights();
+        AutomatonCell& cell = graph.getCellHolder(iCell)->getAutomatonCell();
+
+        Weight maxStateWithContinuation = NAN;
+        bool isPriorityPath = false;
+        for (int iSuccessor = successorOffsets[iCell]; iSuccessor < successorOffsets[iCell + 1]; ++iSuccessor) {
+          const int iNeighbor = successors[iSuccessor];
+          // Skip masked continuations
+          if (not unmasked[iNeighbor]) continue;
+
+          const AutomatonCell& neighborCell = graph.getCellHolder(iNeighbor)->getAutomatonCell();
+          Weight stateWithContinuation = neighborCell.getCellState() + weights[iSuccessor];
+
+          // Remember only the maximum value of all neighbors
+          if (std::isnan(maxStateWithContinuation) or maxStateWithContinuation < stateWithContinuation) {
+            maxStateWithContinuation = stateWithContinuation;
+            isPriorityPath = neighborCell.hasPriorityFlag() or neighborCell.hasPriorityPathFlag();
+          }
+        }
+
+        if (std::isnan(maxStateWithContinuation)) {
+          // No valid neighbor contributed a connection to the cell
+          maxStateWithContinuation = 0;
+        }
+        maxStateWithContinuation += cell.getCellWeight();
+
+        const std::vector<int>& predecessorOffsets = graph.getPredecessorOffsets();
+        const std::vector<int>& predecessors = graph.getPredecessors();
+        bool isStart = true;
+        for (int iPredecessor = predecessorOffsets[iCell]; iPredecessor < predecessorOffsets[iCell + 1]; ++iPredecessor) {
+          if (unmasked[predecessors[iPredecessor]]) {
+            isStart = false;
+            break;
+          }
+        }
+
+        cell.setCellState(maxStateWithContinuation);
+        cell.setPriorityPathFlag(isPriorityPath);
+        cell.setStartFlag(isStart);
+        cell.setAssignedFlag();
+      }
+
+      /// Update the cells of the layer cells from begin to end
+      static void updateCells(const CompressedCellGraph<ACellHolder>& graph, int begin, int end)
+      {
+        const std::vector<int>& layerCells = graph.getLayerCells();
+        for (int iLayerCell = begin; iLayerCell < end; ++iLayerCell) {
+          updateCell(graph, layerCells[iLayerCell]);
+        }
+      }
+
+      /// Update the cells of one layer in all threads, in chunks of cells
+      void updateLayerInThreads(const CompressedCellGraph<ACellHolder>& graph, int begin, int end)
+      {
+        const int nChunks = (end - begin + c_chunkSize - 1) / c_chunkSize;
+        m_jobs.run(nChunks, [&graph, begin, end](size_t chunk) {
+          const int chunkBegin = begin + chunk * c_chunkSize;
+          updateCells(graph, chunkBegin, std::min(chunkBegin + c_chunkSize, end));
+        });
+      }
+
+    private:
+      /// Number of cells handed to a thread at once
+      static constexpr int c_chunkSize = 64;
+
+      /// Layers with less cells are processed in the calling thread only
+      static constexpr int c_minCellsForThreads = 4 * c_chunkSize;
+
+      /// Memory for the graph of the cells
+      CompressedCellGraph<ACellHolder> m_graph;
+
+      /// Depth first cellular automaton for graphs with cycles
+      CellularAutomaton<ACellHolder> m_cellularAutomaton;
+
+      /// The threads updating the cells of a layer
+      ParallelJobs m_jobs;
+    };
+  }
+}
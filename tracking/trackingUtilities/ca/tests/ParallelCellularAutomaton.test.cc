@@ -0,0 +1,146 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+#include <gtest/gtest.h>
+
+#include <tracking/trackingUtilities/ca/ParallelCellularAutomaton.h>
+#include <tracking/trackingUtilities/ca/CellularAutomaton.h>
+#include <tracking/trackingUtilities/ca/WithAutomatonCell.h>
+
+#include <algorithm>
+#include <random>
+#include <tuple>
+#include <vector>
+
+using namespace Belle2;
+using namespace TrackingUtilities;
+
+namespace {
+  using Element = WithAutomatonCell<int>;
+
+  /// Random acyclic graph with masked and priority cells
+  struct RandomGraph {
+    /// Create the graph from rows of cells, relations only point to cells in the next two rows
+    RandomGraph(int nRows, int nCellsPerRow, int nRelationsPerCell, unsigned int seed)
+    {
+      const int nCells = nRows * nCellsPerRow;
+      std::mt19937 generator(seed);
+      std::uniform_real_distribution<float> weight(-1, 3);
+      std::uniform_int_distribution<int> percent(0, 99);
+      for (int iCell = 0; iCell < nCells; ++iCell) {
+        m_elements.emplace_back(iCell);
+        AutomatonCell& cell = m_elements.back().getAutomatonCell();
+        cell.setCellWeight(weight(generator));
+        cell.setMaskedFlag(percent(generator) < 10);
+        cell.setPriorityFlag(percent(generator) < 5);
+      }
+      for (Element& element : m_elements) {
+        m_elementPtrs.push_back(&element);
+      }
+      for (int iCell = 0; iCell < nCells - nCellsPerRow; ++iCell) {
+        const int iNextRow = iCell / nCellsPerRow + 1;
+        std::uniform_int_distribution<int> to(iNextRow * nCellsPerRow, std::min(nCells, (iNextRow + 2) * nCellsPerRow) - 1);
+        for (int iRelation = 0; iRelation < nRelationsPerCell; ++iRelation) {
+          m_relations.emplace_back(&m_elements[iCell], weight(generator), &m_elements[to(generator)]);
+        }
+      }
+      std::sort(m_relations.begin(), m_relations.end());
+    }
+
+    /// Cell states and flags after the application of an automaton
+    std::vector<std::tuple<float, bool, bool, bool>> getCellStates() const
+    {
+      std::vector<std::tuple<float, bool, bool, bool>> cellStates;
+      for (const Element& element : m_elements) {
+        const AutomatonCell& cell = element.getAutomatonCell();
+        cellStates.emplace_back(cell.hasMaskedFlag() ? 0 : cell.getCellState(),
+                                cell.hasStartFlag(), cell.hasPriorityPathFlag(), cell.hasAssignedFlag());
+      }
+      return cellStates;
+    }
+
+    /// The cells
+    std::vector<Element> m_elements;
+    /// Pointers to the cells
+    std::vector<Element*> m_elementPtrs;
+    /// Sorted relations between the cells
+    std::vector<WeightedRelation<Element>> m_relations;
+  };
+}
+
+TEST(TrackingUtilitiesTest, ParallelCellularAutomaton_sameAsDepthFirst)
+{
+  CellularAutomaton<Element> cellularAutomaton;
+  for (unsigned int nThreads : {1u, 4u}) {
+    ParallelCellularAutomaton<Element> parallelCellularAutomaton(nThreads);
+    for (unsigned int seed = 0; seed < 5; ++seed) {
+      RandomGraph graph(10, 1000, 2, seed);
+      Element* expected = cellularAutomaton.applyTo(graph.m_elementPtrs, graph.m_relations);
+      const auto expectedCellStates = graph.getCellStates();
+
+      Element* result = parallelCellularAutomaton.applyTo(graph.m_elementPtrs, graph.m_relations);
+      EXPECT_EQ(expected, result);
+      EXPECT_TRUE(expectedCellStates == graph.getCellStates());
+    }
+  }
+}
+
+TEST(TrackingUtilitiesTest, ParallelCellularAutomaton_graphReuse)
+{
+  RandomGraph graph(10, 500, 3, 42);
+  CompressedCellGraph<Element> cellGraph;
+  cellGraph.build(graph.m_elementPtrs, graph.m_relations);
+  ASSERT_TRUE(cellGraph.isValid());
+
+  CellularAutomaton<Element> cellularAutomaton;
+  ParallelCellularAutomaton<Element> parallelCellularAutomaton(2);
+  for (int iPass = 0; iPass < 3; ++iPass) {
+    Element* expected = cellularAutomaton.applyTo(graph.m_elementPtrs, graph.m_relations);
+    const auto expectedCellStates = graph.getCellStates();
+
+    Element* result = parallelCellularAutomaton.applyTo(cellGraph, graph.m_relations);
+    EXPECT_EQ(expected, result);
+    EXPECT_TRUE(expectedCellStates == graph.getCellStates());
+
+    // Mask more cells as the multipass path finder does
+    for (int iCell = iPass; iCell < 5000; iCell += 7) {
+      graph.m_elements[iCell].getAutomatonCell().setMaskedFlag();
+    }
+  }
+}
+
+TEST(TrackingUtilitiesTest, ParallelCellularAutomaton_cycle)
+{
+  std::vector<Element> elements;
+  for (int iCell = 0; iCell < 4; ++iCell) {
+    elements.emplace_back(iCell);
+  }
+  std::vector<Element*> elementPtrs;
+  for (Element& element : elements) {
+    element.getAutomatonCell().setCellWeight(1);
+    elementPtrs.push_back(&element);
+  }
+
+  std::vector<WeightedRelation<Element>> relations;
+  relations.emplace_back(&elements[0], 1, &elements[1]);
+  relations.emplace_back(&elements[1], 1, &elements[2]);
+  relations.emplace_back(&elements[2], 1, &elements[1]);
+  relations.emplace_back(&elements[2], 1, &elements[3]);
+  std::sort(relations.begin(), relations.end());
+
+  CompressedCellGraph<Element> cellGraph;
+  cellGraph.build(elementPtrs, relations);
+  EXPECT_TRUE(cellGraph.isValid());
+  EXPECT_FALSE(cellGraph.computeLayers());
+
+  // The depth first automaton is used for graphs with cycles
+  CellularAutomaton<Element> cellularAutomaton;
+  Element* expected = cellularAutomaton.applyTo(elementPtrs, relations);
+  ParallelCellularAutomaton<Element> parallelCellularAutomaton(2);
+  Element* result = parallelCellularAutomaton.applyTo(elementPtrs, relations);
+  EXPECT_EQ(expected, result);
+}
@@ -128,18 +128,29 @@ namespace Belle2 {
     std::vector<float> MVA<AFilter>::predict(const std::vector<Object*>& objs)
     {
       const int nFeature = m_namedVariables.size();
-      const int nRows    = objs.size();
-      auto allFeatures = std::unique_ptr<float[]>(new float[nRows * nFeature]);
-      size_t iRow = 0;
-      for (const auto& obj : objs) {
-        if (Super::getVarSet().extract(obj)) {
+      auto allFeatures = std::unique_ptr<float[]>(new float[objs.size() * nFeature]);
+      // Objects for which the variables can not be extracted get no row and a NAN prediction
+      std::vector<size_t> extractedObjs;
+      extractedObjs.reserve(objs.size());
+      for (size_t iObj = 0; iObj < objs.size(); iObj += 1) {
+        if (Super::getVarSet().extract(objs[iObj])) {
+          const size_t iRow = extractedObjs.size();
           for (int iFeature = 0; iFeature < nFeature; iFeature += 1) {
             allFeatures[nFeature * iRow + iFeature] = *m_namedVariables[iFeature];
           }
-          iRow += 1;
+          extractedObjs.push_back(iObj);
         }
       }
-      return m_mvaExpert->predict(allFeatures.get(), nFeature, nRows);
+
+      std::vector<float> out(objs.size(), NAN);
+      if (extractedObjs.empty()) {
+        return out;
+      }
+      const std::vector<float> predictions = m_mvaExpert->predict(allFeatures.get(), nFeature, extractedObjs.size());
+      for (size_t iRow = 0; iRow < extractedObjs.size(); iRow += 1) {
+        out[extractedObjs[iRow]] = predictions[iRow];
+      }
+      return out;
     }
 
     template <class AFilter>
@@ -9,6 +9,8 @@
 
 #include <tracking/trackingUtilities/numerics/Weight.h>
 
+#include <vector>
+
 namespace Belle2 {
 
   namespace TrackingUtilities {
@@ -28,6 +30,13 @@ namespace Belle2 {
 
       /// Invert the result
       Weight operator()(const typename AFilter::Object& obj) final;
+
+      /// Invert the results for all objects at once, as the filter may be faster on many objects
+      std::vector<float> operator()(const std::vector<Object*>& objs) final;
+
+    private:
+      /// Whether the results of the filter are inverted by the batch operator, which may call the single object operator
+      bool m_invertedByBatch = false;
     };
   }
 }
@@ -15,7 +15,23 @@ namespace Belle2 {
     template<class AFilter>
     Weight NegativeFilter<AFilter>::operator()(const typename AFilter::Object& obj)
     {
+      if (m_invertedByBatch) {
+        return Super::operator()(obj);
+      }
       return -Super::operator()(obj);
     }
+
+    template<class AFilter>
+    std::vector<float> NegativeFilter<AFilter>::operator()(const std::vector<Object*>& objs)
+    {
+      // The batch operator of the filter may use the single object operator, which must not invert the result then
+      m_invertedByBatch = true;
+      std::vector<float> out = Super::operator()(objs);
+      m_invertedByBatch = false;
+      for (float& res : out) {
+        res = -res;
+      }
+      return out;
+    }
   }
 }
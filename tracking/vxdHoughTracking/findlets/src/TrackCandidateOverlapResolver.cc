@@ -12,6 +12,7 @@
 #include <tracking/trackFindingVXD/trackSetEvaluator/OverlapMatrixCreator.h>
 #include <tracking/trackFindingVXD/trackSetEvaluator/HopfieldNetwork.h>
 #include <tracking/trackFindingVXD/trackSetEvaluator/Scrooge.h>
+#include <tracking/trackFindingVXD/trackSetEvaluator/IndependentSetSelector.h>
 #include <tracking/trackFindingVXD/trackSetEvaluator/OverlapResolverNodeInfo.h>
 #include <tracking/trackingUtilities/utilities/StringManipulation.h>
 #include <tracking/dbobjects/SVDHoughParameters.h>
@@ -35,7 +36,8 @@ void TrackCandidateOverlapResolver::exposeParameters(ModuleParamList* modulePara
   m_prefix = prefix;
 
   moduleParamList->addParameter(TrackingUtilities::prefixed(prefix, "ResolveMethod"), m_resolveMethod,
-                                "Strategy used to resolve overlaps. Currently implemented are \"greedy\" and \"hopfield\".",
+                                "Strategy used to resolve overlaps. Currently implemented are \"greedy\", \"hopfield\" "
+                                "and \"independentSet\" (greedy selection improved by a local search).",
                                 m_resolveMethod);
   moduleParamList->addParameter(TrackingUtilities::prefixed(prefix, "NameSVDClusters"), m_nameSVDClusters,
                                 "Name of expected SVDClusters StoreArray.", m_nameSVDClusters);
@@ -51,8 +53,9 @@ void TrackCandidateOverlapResolver::initialize()
 
   m_svdClusters.isRequired(m_nameSVDClusters);
 
-  B2ASSERT("ResolveMethod has to be either 'greedy' or 'hopfield'. Selected ResolveMethod: " << m_resolveMethod,
-           m_resolveMethod == "greedy" || m_resolveMethod == "hopfield");
+  B2ASSERT("ResolveMethod has to be either 'greedy', 'hopfield' or 'independentSet'. Selected ResolveMethod: "
+           << m_resolveMethod,
+           m_resolveMethod == "greedy" || m_resolveMethod == "hopfield" || m_resolveMethod == "independentSet");
 
 }
 
@@ -136,6 +139,11 @@ void TrackCandidateOverlapResolver::apply(std::vector<SpacePointTrackCand>& spac
     if (hopfieldNetwork.doHopfield(qiTrackOverlap, maxIterations) == maxIterations) {
       B2WARNING("Hopfield Network failed converge.");
     }
+
+  } else if (m_resolveMethod == "independentSet") {
+    //select non overlapping candidates with a large sum of quality indicators
+    IndependentSetSelector independentSetSelector;
+    independentSetSelector.performSelection(qiTrackOverlap);
   }
 
   for (auto&& track : qiTrackOverlap) {